@@ -66,7 +66,11 @@ static int execute_scenario(int argc, char* argv[])
     // Initialize ImPlot
     std::unique_ptr<Plot> plot;
 
-    if (opt.GetOptionSet("plot"))
+    if (opt.GetOptionSet("plot") && opt.GetOptionSet("throughput"))
+    {
+        LOG("Throughput mode, ignoring plot request");
+    }
+    else if (opt.GetOptionSet("plot"))
     {
         // Create and run plot in a separate thread as default
         plot = std::make_unique<Plot>(player->scenarioEngine, opt.GetOptionArg("plot") == "synchronous");
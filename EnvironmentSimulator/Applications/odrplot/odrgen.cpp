@@ -0,0 +1,143 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+/*
+ * This application generates synthetic road networks of any size, for scale testing of RoadManager and ScenarioEngine.
+ * See RoadGenerator.hpp for the network types.
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "CommonMini.hpp"
+#include "RoadGenerator.hpp"
+
+#define DEFAULT_GRID_SIZE        4
+#define DEFAULT_LANES            2
+#define DEFAULT_LANE_WIDTH       3.5
+#define DEFAULT_GRID_ROAD_LENGTH 200.0
+#define DEFAULT_HWY_ROAD_LENGTH  1000.0
+#define DEFAULT_VEHICLES         10
+#define DEFAULT_VEHICLE_SPACING  40.0
+#define DEFAULT_SPEED            20.0
+#define DEFAULT_DURATION         60.0
+
+using namespace roadgenerator;
+
+int main(int argc, char* argv[])
+{
+    SE_Options& opt = SE_Env::Inst().GetOptions();
+    opt.Reset();
+
+    opt.AddOption("grid", "Grid of size x size junctions (default network, size 4)", "size");
+    opt.AddOption("highway", "Highway of given number of road segments", "roads");
+    opt.AddOption("lanes", "Number of lanes per direction (default 2)", "number");
+    opt.AddOption("lane_width", "Lane width (default 3.5)", "width");
+    opt.AddOption("road_length", "Distance between junctions (default 200) or length of highway segments (default 1000)", "length");
+    opt.AddOption("geometry", "Road geometry: mix (line, spiral, arc and paramPoly3) or line (default mix)", "type");
+    opt.AddOption("odr", "OpenDRIVE output file", "filename", "generated.xodr");
+    opt.AddOption("osc", "OpenSCENARIO output file, referring to the OpenDRIVE file", "filename", "generated.xosc");
+    opt.AddOption("vehicles", "Number of vehicles in the scenario (default 10)", "number");
+    opt.AddOption("vehicle_spacing", "Min distance between vehicles (default 40)", "distance");
+    opt.AddOption("speed", "Mean vehicle speed, each vehicle +/-10% (default 20)", "speed");
+    opt.AddOption("controller", "Controller assigned to all vehicles, e.g. ACCController (default none)", "type");
+    opt.AddOption("duration", "Scenario duration (default 60)", "time");
+    opt.AddOption("seed", "Random seed for vehicle speeds (default 0)", "number");
+    opt.AddOption("help", "Show this help message");
+
+    if (opt.ParseArgs(argc, argv) != 0 || argc < 2 || opt.HasUnknownArgs())
+    {
+        if (opt.HasUnknownArgs())
+        {
+            opt.PrintUnknownArgs();
+        }
+        opt.PrintUsage();
+        return -1;
+    }
+
+    if (opt.GetOptionSet("help"))
+    {
+        opt.PrintUsage();
+        return 0;
+    }
+
+    Network     network;
+    bool        mix          = opt.GetOptionArg("geometry") != "line";
+    bool        highway      = opt.GetOptionSet("highway");
+    std::string odr_filename = opt.GetOptionSet("odr") ? opt.GetOptionArg("odr") : "generated.xodr";
+    std::string osc_filename = opt.GetOptionSet("osc") ? opt.GetOptionArg("osc") : "generated.xosc";
+    double      road_length  = highway ? DEFAULT_HWY_ROAD_LENGTH : DEFAULT_GRID_ROAD_LENGTH;
+
+    network.n_lanes    = opt.GetOptionSet("lanes") ? strtoi(opt.GetOptionArg("lanes")) : DEFAULT_LANES;
+    network.lane_width = opt.GetOptionSet("lane_width") ? strtod(opt.GetOptionArg("lane_width")) : DEFAULT_LANE_WIDTH;
+    if (opt.GetOptionSet("road_length"))
+    {
+        road_length = strtod(opt.GetOptionArg("road_length"));
+    }
+
+    if (highway)
+    {
+        if (CreateHighway(network, strtoi(opt.GetOptionArg("highway")), road_length, mix) != 0)
+        {
+            printf("Highway needs lanes of width > 0 and at least one road of length > 0\n");
+            return -1;
+        }
+    }
+    else
+    {
+        int size = opt.GetOptionSet("grid") ? strtoi(opt.GetOptionArg("grid")) : DEFAULT_GRID_SIZE;
+
+        if (CreateGrid(network, size, road_length, mix) != 0)
+        {
+            printf("Grid needs lanes of width > 0, size >= 2 and roads longer than the junctions\n");
+            return -1;
+        }
+    }
+
+    if (WriteOpenDRIVE(odr_filename, network) != 0)
+    {
+        printf("Failed to write %s\n", odr_filename.c_str());
+        return -1;
+    }
+
+    printf("Created %s: %d roads, %d junctions, %.1f km\n",
+           odr_filename.c_str(),
+           static_cast<int>(network.roads.size()),
+           static_cast<int>(network.junctions.size()),
+           1e-3 * network.GetTotalLength());
+
+    int    n_vehicles = opt.GetOptionSet("vehicles") ? strtoi(opt.GetOptionArg("vehicles")) : DEFAULT_VEHICLES;
+    double spacing    = opt.GetOptionSet("vehicle_spacing") ? strtod(opt.GetOptionArg("vehicle_spacing")) : DEFAULT_VEHICLE_SPACING;
+    int    n_created  = WriteOpenSCENARIO(osc_filename,
+                                          odr_filename,
+                                          network,
+                                          n_vehicles,
+                                          spacing,
+                                          opt.GetOptionSet("speed") ? strtod(opt.GetOptionArg("speed")) : DEFAULT_SPEED,
+                                          opt.GetOptionSet("duration") ? strtod(opt.GetOptionArg("duration")) : DEFAULT_DURATION,
+                                          opt.GetOptionArg("controller"),
+                                          opt.GetOptionSet("seed") ? static_cast<unsigned int>(strtoi(opt.GetOptionArg("seed"))) : 0);
+
+    if (n_created < 0)
+    {
+        printf("Failed to write %s\n", osc_filename.c_str());
+        return -1;
+    }
+
+    if (n_created < n_vehicles)
+    {
+        printf("Network has room for %d vehicles at spacing %.1f m, reducing from %d\n", n_created, spacing, n_vehicles);
+    }
+    printf("Created %s: %d vehicles\n", osc_filename.c_str(), n_created);
+
+    return 0;
+}
@@ -403,6 +403,8 @@ int main(int argc, char **argv)
     opt.AddOption("osi_points", "Show OSI road points (toggle during simulation by press 'y') ");
     opt.AddOption("path", "Search path prefix for assets, e.g. car and sign model files", "path");
     opt.AddOption("road_features", "Show OpenDRIVE road features (toggle during simulation by press 'o') ");
+    opt.AddOption("road_tile_cache", "Directory for caching generated road tiles, reused while the OpenDRIVE file and tile size are unchanged", "path");
+    opt.AddOption("road_tile_size", "Generate road 3D model in square tiles of given size (m), built on demand around the camera", "size");
     opt.AddOption("save_generated_model", "Save generated 3D model (n/a when a scenegraph is loaded)");
     opt.AddOption("seed", "Specify seed number for random generator", "number");
     opt.AddOption("speed_factor", "speed_factor <number>", "speed_factor", std::to_string(global_speed_factor));
@@ -0,0 +1,293 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "CollisionAnalysis.hpp"
+
+#define GHOST_CTRL_TYPE 100  // control type 100 indicates ghost
+
+using namespace scenarioengine;
+
+void scenarioengine::CollisionBoxFromPos(double x, double y, double h, const OSCBoundingBox& bb, CollisionBox& box)
+{
+    double c           = cos(h);
+    double s           = sin(h);
+    double half_length = static_cast<double>(bb.dimensions_.length_) / 2.0;
+    double half_width  = static_cast<double>(bb.dimensions_.width_) / 2.0;
+    double bb_x        = static_cast<double>(bb.center_.x_);
+    double bb_y        = static_cast<double>(bb.center_.y_);
+
+    box.axis[0][0] = c;
+    box.axis[0][1] = s;
+    box.axis[1][0] = -s;
+    box.axis[1][1] = c;
+
+    box.center[0] = x + bb_x * c - bb_y * s;
+    box.center[1] = y + bb_x * s + bb_y * c;
+
+    const double sign[4][2] = {{1.0, -1.0}, {1.0, 1.0}, {-1.0, 1.0}, {-1.0, -1.0}};
+    box.x_min               = LARGE_NUMBER;
+    box.x_max               = -LARGE_NUMBER;
+    for (int i = 0; i < 4; i++)
+    {
+        double lx        = sign[i][0] * half_length;
+        double ly        = sign[i][1] * half_width;
+        box.corner[i][0] = box.center[0] + lx * c - ly * s;
+        box.corner[i][1] = box.center[1] + lx * s + ly * c;
+        box.x_min        = MIN(box.x_min, box.corner[i][0]);
+        box.x_max        = MAX(box.x_max, box.corner[i][0]);
+    }
+
+    box.radius = sqrt(half_length * half_length + half_width * half_width);
+}
+
+double scenarioengine::CollisionRelativeSpeed(double speed0, double h0, double speed1, double h1)
+{
+    double dvx = speed1 * cos(h1) - speed0 * cos(h0);
+    double dvy = speed1 * sin(h1) - speed0 * sin(h0);
+
+    return sqrt(dvx * dvx + dvy * dvy);
+}
+
+bool scenarioengine::CollisionBoxesOverlap(const CollisionBox& box0, const CollisionBox& box1)
+{
+    // Broad-phase: bounding circles
+    double dx = box1.center[0] - box0.center[0];
+    double dy = box1.center[1] - box0.center[1];
+    double r  = box0.radius + box1.radius;
+    if (dx * dx + dy * dy > r * r)
+    {
+        return false;
+    }
+
+    // Separating axis test, the edge normals of rectangles are the two axes of each box
+    const CollisionBox* boxes[2] = {&box0, &box1};
+    for (int b = 0; b < 2; b++)
+    {
+        for (int a = 0; a < 2; a++)
+        {
+            const double* axis = boxes[b]->axis[a];
+            double        min0 = LARGE_NUMBER, max0 = -LARGE_NUMBER, min1 = LARGE_NUMBER, max1 = -LARGE_NUMBER;
+
+            for (int i = 0; i < 4; i++)
+            {
+                double p0 = axis[0] * box0.corner[i][0] + axis[1] * box0.corner[i][1];
+                double p1 = axis[0] * box1.corner[i][0] + axis[1] * box1.corner[i][1];
+                min0      = MIN(min0, p0);
+                max0      = MAX(max0, p0);
+                min1      = MIN(min1, p1);
+                max1      = MAX(max1, p1);
+            }
+
+            if (max0 < min1 || max1 < min0)
+            {
+                return false;  // separating axis found
+            }
+        }
+    }
+
+    return true;
+}
+
+int CollisionAnalysis::AnalyzeFile(const std::string& filename, std::vector<CollisionEvent>& events)
+{
+    std::ifstream file(filename, std::ifstream::binary);
+    if (file.fail())
+    {
+        LOG("Cannot open file: %s", filename.c_str());
+        return -1;
+    }
+
+    DatHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.version != DAT_FILE_FORMAT_VERSION)
+    {
+        LOG("Unsupported dat file %s, version %d (expected %d)", filename.c_str(), header.version, DAT_FILE_FORMAT_VERSION);
+        return -1;
+    }
+
+    frame_.clear();
+    overlaps_.clear();
+
+    FrameEntity entity;
+    while (file.read(reinterpret_cast<char*>(&entity.state), sizeof(entity.state)))
+    {
+        if (!frame_.empty())
+        {
+            float frame_time = frame_[0].state.info.timeStamp;
+            if (entity.state.info.timeStamp < frame_time && !NEAR_NUMBERSF(entity.state.info.timeStamp, frame_time))
+            {
+                continue;  // skip entries going back in time
+            }
+            else if (!NEAR_NUMBERSF(entity.state.info.timeStamp, frame_time))
+            {
+                AnalyzeFrame(filename, events);
+                frame_.clear();
+            }
+        }
+
+        if (entity.state.info.ctrl_type == GHOST_CTRL_TYPE || entity.state.info.visibilityMask == 0)
+        {
+            continue;
+        }
+
+        // keep latest instance of entries with same id and timestamp
+        for (size_t i = 0; i < frame_.size(); i++)
+        {
+            if (frame_[i].state.info.id == entity.state.info.id)
+            {
+                frame_.erase(frame_.begin() + static_cast<int>(i));
+                break;
+            }
+        }
+
+        CollisionBoxFromPos(static_cast<double>(entity.state.pos.x),
+                            static_cast<double>(entity.state.pos.y),
+                            static_cast<double>(entity.state.pos.h),
+                            entity.state.info.boundingbox,
+                            entity.box);
+        frame_.push_back(entity);
+    }
+
+    if (!frame_.empty())
+    {
+        AnalyzeFrame(filename, events);
+    }
+
+    return 0;
+}
+
+void CollisionAnalysis::AnalyzeFrame(const std::string& filename, std::vector<CollisionEvent>& events)
+{
+    // Sort and sweep along x-axis, only entities with overlapping x-intervals are tested further
+    order_.resize(frame_.size());
+    for (size_t i = 0; i < order_.size(); i++)
+    {
+        order_[i] = i;
+    }
+    std::sort(order_.begin(), order_.end(), [this](size_t a, size_t b) { return frame_[a].box.x_min < frame_[b].box.x_min; });
+
+    overlaps_next_.clear();
+    for (size_t i = 0; i < order_.size(); i++)
+    {
+        FrameEntity& e0 = frame_[order_[i]];
+        for (size_t j = i + 1; j < order_.size() && frame_[order_[j]].box.x_min <= e0.box.x_max; j++)
+        {
+            FrameEntity& e1 = frame_[order_[j]];
+
+            if (!CollisionBoxesOverlap(e0.box, e1.box))
+            {
+                continue;
+            }
+
+            FrameEntity*        first  = e0.state.info.id < e1.state.info.id ? &e0 : &e1;
+            FrameEntity*        second = first == &e0 ? &e1 : &e0;
+            std::pair<int, int> pair(first->state.info.id, second->state.info.id);
+            overlaps_next_.push_back(pair);
+
+            if (!std::binary_search(overlaps_.begin(), overlaps_.end(), pair))
+            {
+                // new overlap, register collision
+                double rel_speed = CollisionRelativeSpeed(static_cast<double>(first->state.info.speed),
+                                                          static_cast<double>(first->state.pos.h),
+                                                          static_cast<double>(second->state.info.speed),
+                                                          static_cast<double>(second->state.pos.h));
+                events.push_back({filename,
+                                  static_cast<double>(first->state.info.timeStamp),
+                                  pair.first,
+                                  pair.second,
+                                  first->state.info.name,
+                                  second->state.info.name,
+                                  rel_speed * 3.6,
+                                  GetAngleInIntervalMinusPIPlusPI(static_cast<double>(first->state.pos.h - second->state.pos.h)) * 180.0 / M_PI});
+            }
+        }
+    }
+
+    std::sort(overlaps_next_.begin(), overlaps_next_.end());
+    overlaps_.swap(overlaps_next_);
+}
+
+int CollisionAnalysis::AnalyzeFiles(const std::vector<std::string>& filenames, unsigned int n_threads, std::vector<CollisionEvent>& events)
+{
+    std::vector<std::vector<CollisionEvent>> file_events(filenames.size());
+    std::atomic<size_t>                      next_file(0);
+    std::atomic<int>                         n_failed(0);
+
+    if (n_threads == 0)
+    {
+        n_threads = MAX(1, std::thread::hardware_concurrency());
+    }
+    n_threads = MIN(n_threads, static_cast<unsigned int>(MAX(1, filenames.size())));
+
+    auto worker = [&]()
+    {
+        CollisionAnalysis analysis;  // one instance per thread, reusing its buffers between files
+        for (size_t i = next_file++; i < filenames.size(); i = next_file++)
+        {
+            if (analysis.AnalyzeFile(filenames[i], file_events[i]) != 0)
+            {
+                n_failed++;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < n_threads; i++)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // collect results in file order
+    for (auto& fe : file_events)
+    {
+        events.insert(events.end(), fe.begin(), fe.end());
+    }
+
+    return n_failed;
+}
+
+int CollisionAnalysis::WriteReport(const std::string& filename, const std::vector<CollisionEvent>& events)
+{
+    FILE* file = fopen(filename.c_str(), "w");
+    if (file == nullptr)
+    {
+        LOG("Failed to open collision report file %s", filename.c_str());
+        return -1;
+    }
+
+    fprintf(file, "file, time, id0, name0, id1, name1, rel_speed_kmh, angle_deg\n");
+    for (auto& e : events)
+    {
+        fprintf(file,
+                "%s, %.3f, %d, %s, %d, %s, %.3f, %.3f\n",
+                e.filename.c_str(),
+                e.time,
+                e.id0,
+                e.name0.c_str(),
+                e.id1,
+                e.name1.c_str(),
+                e.rel_speed,
+                e.angle);
+    }
+    fclose(file);
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "CommonMini.hpp"
+#include "ScenarioGateway.hpp"
+
+namespace scenarioengine
+{
+    // Oriented 2D bounding box of an entity, in world coordinates
+    typedef struct
+    {
+        double corner[4][2];  // front right, front left, rear left, rear right
+        double axis[2][2];    // normalized axes along length and width
+        double center[2];
+        double radius;        // radius of bounding circle, for quick rejection
+        double x_min;
+        double x_max;
+    } CollisionBox;
+
+    typedef struct
+    {
+        std::string filename;
+        double      time;
+        int         id0;
+        int         id1;
+        std::string name0;
+        std::string name1;
+        double      rel_speed;  // magnitude of velocity difference (km/h)
+        double      angle;      // heading difference (degrees, id0 to id1)
+    } CollisionEvent;
+
+    /**
+            Calculate oriented bounding box of an entity given its position and bounding box dimensions
+    */
+    void CollisionBoxFromPos(double x, double y, double h, const OSCBoundingBox& bb, CollisionBox& box);
+
+    /**
+            Check whether two boxes overlap, by bounding circles first and then separating axis test (SAT)
+            on the two axes of each box. No memory is allocated.
+    */
+    bool CollisionBoxesOverlap(const CollisionBox& box0, const CollisionBox& box1);
+
+    /**
+            Calculate relative speed of two entities, as magnitude of the difference of their velocity vectors
+            @param speed0 Speed of first entity (m/s), negative when reversing
+            @param h0 Heading of first entity (rad)
+            @param speed1 Speed of second entity (m/s)
+            @param h1 Heading of second entity (rad)
+            @return Relative speed (m/s)
+    */
+    double CollisionRelativeSpeed(double speed0, double h0, double speed1, double h1);
+
+    /**
+            Headless collision analysis of recordings (.dat files). Each recording is read frame by frame, and
+            overlapping entities are found by sort and sweep along x-axis followed by the box overlap test.
+            Ghost entities and entities invisible to traffic are ignored. A collision is reported once, when
+            two entities start to overlap.
+    */
+    class CollisionAnalysis
+    {
+    public:
+        /**
+                Analyze one recording
+                @param filename Recording (.dat)
+                @param events Found collisions are appended to this list
+                @return 0 on success else -1
+        */
+        int AnalyzeFile(const std::string& filename, std::vector<CollisionEvent>& events);
+
+        /**
+                Analyze multiple recordings in parallel
+                @param filenames Recordings (.dat)
+                @param n_threads Number of worker threads, 0 = number of hardware threads
+                @param events Found collisions, sorted by file and time
+                @return Number of files that failed to be analyzed
+        */
+        static int AnalyzeFiles(const std::vector<std::string>& filenames, unsigned int n_threads, std::vector<CollisionEvent>& events);
+
+        /**
+                Write collision report in CSV format
+                @return 0 on success else -1
+        */
+        static int WriteReport(const std::string& filename, const std::vector<CollisionEvent>& events);
+
+    private:
+        typedef struct
+        {
+            ObjectStateStructDat state;
+            CollisionBox         box;
+        } FrameEntity;
+
+        // buffers kept between frames and files to avoid allocations
+        std::vector<FrameEntity>         frame_;
+        std::vector<size_t>              order_;
+        std::vector<std::pair<int, int>> overlaps_;       // overlapping entity pairs of previous frame
+        std::vector<std::pair<int, int>> overlaps_next_;  // overlapping entity pairs of current frame
+
+        void AnalyzeFrame(const std::string& filename, std::vector<CollisionEvent>& events);
+    };
+
+}  // namespace scenarioengine
@@ -14,6 +14,7 @@
 #include "ScenarioGateway.hpp"
 #include "CommonMini.hpp"
 #include "dirent.h"
+#include <queue>
 
 using namespace scenarioengine;
 
@@ -79,26 +80,27 @@ Replay::Replay(std::string filename, bool clean) : time_(0.0), index_(0), repeat
     }
 }
 
-Replay::Replay(const std::string directory, const std::string scenario, std::string create_datfile)
-    : time_(0.0),
-      index_(0),
-      repeat_(false),
-      create_datfile_(create_datfile)
+// Sequential reader of one recording, holding only current frame and next entry in memory
+class scenarioengine::ReplayMergeInput
 {
-    GetReplaysFromDirectory(directory, scenario);
-    std::vector<std::pair<std::string, std::vector<ReplayEntry>>> scenarioData;
+public:
+    std::string              filename_;
+    DatHeader                header_;
+    std::vector<ReplayEntry> frame_;    // latest frame, repeated at each merged timestamp until next frame is reached
+    ReplayEntry              pending_;  // first entry of next frame
+    bool                     has_pending_;
 
-    for (size_t i = 0; i < scenarios_.size(); i++)
+    ReplayMergeInput(std::string filename) : filename_(filename), has_pending_(false), file_(), id_offset_(0)
     {
-        file_.open(scenarios_[i], std::ofstream::binary);
+        file_.open(filename, std::ofstream::binary);
         if (file_.fail())
         {
-            LOG("Cannot open file: %s", scenarios_[i].c_str());
-            throw std::invalid_argument(std::string("Cannot open file: ") + scenarios_[i]);
+            LOG("Cannot open file: %s", filename.c_str());
+            throw std::invalid_argument(std::string("Cannot open file: ") + filename);
         }
         file_.read(reinterpret_cast<char*>(&header_), sizeof(header_));
         LOG("Recording %s opened. dat version: %d odr: %s model: %s",
-            FileNameOf(scenarios_[i]).c_str(),
+            FileNameOf(filename).c_str(),
             header_.version,
             FileNameOf(header_.odr_filename).c_str(),
             FileNameOf(header_.model_filename).c_str());
@@ -106,52 +108,120 @@ Replay::Replay(const std::string directory, const std::string scenario, std::str
         if (header_.version != DAT_FILE_FORMAT_VERSION)
         {
             LOG_AND_QUIT("Version mismatch. %s is version %d while supported version is %d. Please re-create dat file.",
-                         scenarios_[i].c_str(),
+                         filename.c_str(),
                          header_.version,
                          DAT_FILE_FORMAT_VERSION);
         }
-        while (!file_.eof())
+
+        Advance();
+    }
+
+    // Shift ids of this recording, e.g. into a separate ID-group when merged with others
+    void SetIdOffset(int offset)
+    {
+        if (has_pending_)
+        {
+            pending_.state.info.id += offset - id_offset_;
+        }
+        id_offset_ = offset;
+    }
+
+    double GetPendingTime()
+    {
+        return has_pending_ ? static_cast<double>(pending_.state.info.timeStamp) : LARGE_NUMBER;
+    }
+
+    // Replace current frame by all entries up to given time. Same cleaning as Replay::CleanEntries() is applied
+    // on the fly, i.e. keep latest instance of entries with same id and timestamp
+    void ReadFrame(double time)
+    {
+        frame_.clear();
+        while (has_pending_ && static_cast<double>(pending_.state.info.timeStamp) < time + SMALL_NUMBER)
         {
-            ReplayEntry entry;
+            for (size_t i = 0; i < frame_.size(); i++)
+            {
+                if (frame_[i].state.info.id == pending_.state.info.id &&
+                    NEAR_NUMBERSF(frame_[i].state.info.timeStamp, pending_.state.info.timeStamp))
+                {
+                    frame_.erase(frame_.begin() + static_cast<int>(i));
+                    break;
+                }
+            }
+            frame_.push_back(pending_);
+            Advance();
+        }
+    }
 
-            file_.read(reinterpret_cast<char*>(&entry.state), sizeof(entry.state));
+private:
+    std::ifstream file_;
+    int           id_offset_;
 
-            if (!file_.eof())
+    // Read next entry, skipping any with decreasing timestamp
+    void Advance()
+    {
+        float last_time = has_pending_ ? pending_.state.info.timeStamp : -LARGE_NUMBERF;
+
+        has_pending_ = false;
+        while (file_.read(reinterpret_cast<char*>(&pending_.state), sizeof(pending_.state)))
+        {
+            if (!(pending_.state.info.timeStamp < last_time))
             {
-                data_.push_back(entry);
+                pending_.state.info.id += id_offset_;
+                has_pending_ = true;
+                break;
             }
         }
-        // pair <scenario name, scenario data>
-        scenarioData.push_back(std::make_pair(scenarios_[i], data_));
-        data_ = {};
-        file_.close();
     }
+};
+
+Replay::Replay(const std::string directory, const std::string scenario, std::string create_datfile)
+    : time_(0.0),
+      index_(0),
+      repeat_(false),
+      create_datfile_(create_datfile)
+{
+    GetReplaysFromDirectory(directory, scenario);
 
-    if (scenarioData.size() < 2)
+    if (scenarios_.size() < 2)
     {
         LOG_AND_QUIT("Too few scenarios loaded, use single replay feature instead\n");
     }
 
+    // Open all recordings, reading only the first entry of each
+    std::vector<std::unique_ptr<ReplayMergeInput>> inputs;
+    for (size_t i = 0; i < scenarios_.size(); i++)
+    {
+        inputs.push_back(std::make_unique<ReplayMergeInput>(scenarios_[i]));
+    }
+    header_ = inputs.back()->header_;
+
     // Scenario with smallest start time first
-    std::sort(scenarioData.begin(),
-              scenarioData.end(),
-              [](const auto& sce1, const auto& sce2) { return sce1.second[0].state.info.timeStamp < sce2.second[0].state.info.timeStamp; });
+    std::sort(inputs.begin(),
+              inputs.end(),
+              [](const auto& input1, const auto& input2) { return input1->GetPendingTime() < input2->GetPendingTime(); });
 
     // Log which scenario belongs to what ID-group (0, 100, 200 etc.)
-    for (size_t i = 0; i < scenarioData.size(); i++)
+    for (size_t i = 0; i < inputs.size(); i++)
     {
-        std::string scenario_tmp = scenarioData[i].first;
-        LOG("Scenarios corresponding to IDs (%d:%d): %s", i * 100, (i + 1) * 100 - 1, FileNameOf(scenario_tmp.c_str()).c_str());
+        LOG("Scenarios corresponding to IDs (%d:%d): %s", i * 100, (i + 1) * 100 - 1, FileNameOf(inputs[i]->filename_).c_str());
     }
 
-    // Ensure increasing timestamps. Remove any other entries.
-    for (auto& sce : scenarioData)
+    if (!create_datfile_.empty())
     {
-        CleanEntries(sce.second);
+        // Stream merged data directly to file, not keeping it in memory
+        std::ofstream data_file;
+        data_file.open(create_datfile_, std::ofstream::binary);
+        if (data_file.fail())
+        {
+            LOG("Cannot open file: %s", create_datfile_.c_str());
+            throw std::invalid_argument(std::string("Cannot open file: ") + create_datfile_);
+        }
+        data_file.write(reinterpret_cast<char*>(&header_), sizeof(header_));
+        MergeData(inputs, &data_file);
+        return;
     }
 
-    // Build remaining data in order.
-    BuildData(scenarioData);
+    MergeData(inputs, nullptr);
 
     if (data_.size() > 0)
     {
@@ -164,11 +234,6 @@ Replay::Replay(const std::string directory, const std::string scenario, std::str
         stopTime_  = data_.back().state.info.timeStamp;
         stopIndex_ = static_cast<unsigned int>(FindIndexAtTimestamp(stopTime_));
     }
-
-    if (!create_datfile_.empty())
-    {
-        CreateMergedDatfile(create_datfile_);
-    }
 }
 
 // Browse through replay-folder and appends strings of absolute path to matching scenario
@@ -509,96 +574,71 @@ void Replay::CleanEntries(std::vector<ReplayEntry>& entries)
     }
 }
 
-void Replay::BuildData(std::vector<std::pair<std::string, std::vector<ReplayEntry>>>& scenarios)
+void Replay::MergeData(std::vector<std::unique_ptr<ReplayMergeInput>>& inputs, std::ofstream* out)
 {
-    // Keep track of current index of each scenario
-    std::vector<int> cur_idx;
-    std::vector<int> next_idx;
+    // k-way merge over the recordings. A min-heap on timestamp of the next frame of each recording gives the next
+    // merged timestamp, at which each started recording contributes its latest frame (sample and hold).
+    typedef std::pair<double, size_t>                                            HeapItem;
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> heap;
+    std::vector<bool>                                                            active(inputs.size(), true);
 
-    for (size_t j = 0; j < scenarios.size(); j++)
+    for (size_t j = 0; j < inputs.size(); j++)
     {
-        cur_idx.push_back(0);
-        next_idx.push_back(0);
-    }
+        // Set scenario ID-group (0, 100, 200 etc.)
+        inputs[j]->SetIdOffset(static_cast<int>(j) * 100);
 
-    // Set scenario ID-group (0, 100, 200 etc.)
-    for (size_t j = 0; j < scenarios.size(); j++)
-    {
-        for (size_t k = 0; k < scenarios[j].second.size(); k++)
+        if (inputs[j]->has_pending_)
         {
-            // Set scenario ID-group (0, 100, 200 etc.)
-            scenarios[j].second[k].state.info.id += static_cast<int>(j) * 100;
+            heap.push(std::make_pair(inputs[j]->GetPendingTime(), j));
+        }
+        else
+        {
+            active[j] = false;
         }
     }
 
-    // Populate data_ based on first (with lowest timestamp) scenario
-    double cur_timestamp = static_cast<double>(scenarios[0].second[0].state.info.timeStamp);
-    while (cur_timestamp < LARGE_NUMBER - SMALL_NUMBER)
+    while (!heap.empty())
     {
-        // populate entries if all scenarios at current time step
-        double min_time_stamp = LARGE_NUMBER;
-        for (size_t j = 0; j < scenarios.size(); j++)
+        double cur_timestamp = heap.top().first;
+
+        // step all recordings having a new frame at current time
+        while (!heap.empty() && heap.top().first < cur_timestamp + SMALL_NUMBER)
         {
-            if (next_idx[j] != -1)
+            size_t j = heap.top().second;
+            heap.pop();
+            inputs[j]->ReadFrame(cur_timestamp);
+            if (inputs[j]->has_pending_)
             {
-                unsigned int k = static_cast<unsigned int>(cur_idx[j]);
-                for (; k < scenarios[j].second.size() && static_cast<double>(scenarios[j].second[k].state.info.timeStamp) < cur_timestamp + 1e-6; k++)
-                {
-                    // push entry with modified timestamp
-                    scenarios[j].second[k].state.info.timeStamp = static_cast<float>(cur_timestamp);
-                    data_.push_back(scenarios[j].second[k]);
-                }
+                heap.push(std::make_pair(inputs[j]->GetPendingTime(), j));
+            }
+        }
+
+        for (size_t j = 0; j < inputs.size(); j++)
+        {
+            if (!active[j])
+            {
+                continue;
+            }
 
-                if (k < scenarios[j].second.size())
+            for (auto& entry : inputs[j]->frame_)
+            {
+                // add entry with modified timestamp
+                entry.state.info.timeStamp = static_cast<float>(cur_timestamp);
+                if (out != nullptr)
                 {
-                    next_idx[j] = static_cast<int>(k);
-                    if (static_cast<double>(scenarios[j].second[k].state.info.timeStamp) < min_time_stamp)
-                    {
-                        min_time_stamp = static_cast<double>(scenarios[j].second[k].state.info.timeStamp);
-                    }
+                    out->write(reinterpret_cast<char*>(&entry.state), sizeof(entry.state));
                 }
                 else
                 {
-                    next_idx[j] = -1;
+                    data_.push_back(entry);
                 }
             }
-        }
 
-        if (min_time_stamp < LARGE_NUMBER - SMALL_NUMBER)
-        {
-            for (size_t j = 0; j < scenarios.size(); j++)
+            if (!inputs[j]->has_pending_)
             {
-                if (next_idx[j] > 0 && static_cast<double>(scenarios[j].second[static_cast<unsigned int>(next_idx[j])].state.info.timeStamp) <
-                                           min_time_stamp + SMALL_NUMBER)
-                {
-                    // time has reached next entry, step this scenario
-                    cur_idx[j] = next_idx[j];
-                }
+                // last frame added, recording ended
+                active[j] = false;
             }
         }
-
-        cur_timestamp = min_time_stamp;
-    }
-}
-
-void Replay::CreateMergedDatfile(const std::string filename)
-{
-    std::ofstream data_file_;
-    data_file_.open(filename, std::ofstream::binary);
-    if (data_file_.fail())
-    {
-        LOG("Cannot open file: %s", filename.c_str());
-        exit(-1);
-    }
-
-    data_file_.write(reinterpret_cast<char*>(&header_), sizeof(header_));
-
-    if (data_file_.is_open())
-    {
-        // Write status to file - for later replay
-        for (size_t i = 0; i < data_.size(); i++)
-        {
-            data_file_.write(reinterpret_cast<char*>(&data_[i].state), sizeof(data_[i].state));
-        }
     }
 }
\ No newline at end of file
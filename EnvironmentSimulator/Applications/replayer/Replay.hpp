@@ -14,11 +14,14 @@
 
 #include <string>
 #include <fstream>
+#include <memory>
 #include "CommonMini.hpp"
 #include "ScenarioGateway.hpp"
 
 namespace scenarioengine
 {
+    class ReplayMergeInput;
+
     typedef struct
     {
         ObjectStateStructDat state;
@@ -76,8 +79,6 @@ namespace scenarioengine
             repeat_ = repeat;
         }
         void CleanEntries(std::vector<ReplayEntry>& entries);
-        void BuildData(std::vector<std::pair<std::string, std::vector<ReplayEntry>>>& scenarios);
-        void CreateMergedDatfile(const std::string filename);
 
     private:
         std::ifstream            file_;
@@ -93,6 +94,13 @@ namespace scenarioengine
         std::string              create_datfile_;
 
         int FindIndexAtTimestamp(double timestamp, int startSearchIndex = 0);
+
+        /**
+                Merge recordings in timestamp order, streaming through each input file
+                @param inputs Recordings, ID-group (0, 100, 200 etc.) given by order
+                @param out If not nullptr, merged entries are written to this file instead of being stored in data_
+        */
+        void MergeData(std::vector<std::unique_ptr<ReplayMergeInput>>& inputs, std::ofstream* out);
     };
 
 }  // namespace scenarioengine
\ No newline at end of file
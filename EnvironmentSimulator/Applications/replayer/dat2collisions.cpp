@@ -0,0 +1,117 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+/*
+ * This application scans binary recordings for collisions between entities, without any viewer, and writes a report in CSV format
+ */
+
+#include <clocale>
+#include <algorithm>
+
+#include "CollisionAnalysis.hpp"
+#include "CommonMini.hpp"
+#include "dirent.h"
+
+using namespace scenarioengine;
+
+static int AddFilesInDirectory(const std::string& dir, std::vector<std::string>& filenames)
+{
+    DIR* directory = opendir(dir.c_str());
+    if (directory == nullptr)
+    {
+        printf("Couldn't open directory %s\n", dir.c_str());
+        return -1;
+    }
+
+    std::vector<std::string> files;
+    struct dirent*           file;
+    while ((file = readdir(directory)) != nullptr)
+    {
+        std::string filename = file->d_name;
+        if (file->d_type != DT_DIR && FileNameExtOf(filename) == ".dat")
+        {
+            files.emplace_back(CombineDirectoryPathAndFilepath(dir, filename));
+        }
+    }
+    closedir(directory);
+
+    std::sort(files.begin(), files.end());
+    filenames.insert(filenames.end(), files.begin(), files.end());
+
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    std::setlocale(LC_ALL, "C.UTF-8");
+
+    SE_Options& opt = SE_Env::Inst().GetOptions();
+    opt.Reset();
+
+    opt.AddOption("file", "Simulation recording data file (.dat) (multiple occurrences supported)", "filename");
+    opt.AddOption("dir", "Directory containing recordings, all .dat files will be analyzed (multiple occurrences supported)", "path");
+    opt.AddOption("report", "Collision report filename", "filename", "collisions.csv");
+    opt.AddOption("threads", "Number of worker threads, 0 = one per hardware thread", "number", "0");
+
+    if (opt.ParseArgs(argc, argv) != 0 || argc < 2 || opt.HasUnknownArgs())
+    {
+        if (opt.HasUnknownArgs())
+        {
+            opt.PrintUnknownArgs();
+        }
+        opt.PrintUsage();
+        return -1;
+    }
+
+    std::vector<std::string> filenames;
+    std::string              arg_str;
+
+    for (int i = 0; !(arg_str = opt.GetOptionArg("file", i)).empty(); i++)
+    {
+        filenames.push_back(arg_str);
+    }
+
+    for (int i = 0; !(arg_str = opt.GetOptionArg("dir", i)).empty(); i++)
+    {
+        if (AddFilesInDirectory(arg_str, filenames) != 0)
+        {
+            return -1;
+        }
+    }
+
+    if (filenames.empty())
+    {
+        printf("No recordings given\n");
+        opt.PrintUsage();
+        return -1;
+    }
+
+    unsigned int n_threads = static_cast<unsigned int>(std::max(0, strtoi(opt.GetOptionArg("threads"))));
+
+    SE_SystemTime               timer;
+    std::vector<CollisionEvent> events;
+    int                         n_failed = CollisionAnalysis::AnalyzeFiles(filenames, n_threads, events);
+
+    if (CollisionAnalysis::WriteReport(opt.GetOptionArg("report"), events) != 0)
+    {
+        return -1;
+    }
+
+    printf("Analyzed %d recording(s) in %.2f s, %d collision(s) found, %d file(s) failed. Report: %s\n",
+           static_cast<int>(filenames.size()),
+           timer.GetS(),
+           static_cast<int>(events.size()),
+           n_failed,
+           opt.GetOptionArg("report").c_str());
+
+    return n_failed > 0 ? -1 : 0;
+}
@@ -11,87 +11,167 @@
  */
 
 /*
- * This application uses the Replay class to read and binary recordings and print content in ascii format to stdout
+ * This application converts binary recordings into ascii format (csv). The recording is memory mapped and
+ * converted in blocks of entries by multiple threads, while the resulting text is written by a background thread.
  */
 
 #include <clocale>
+#include <thread>
+#include <algorithm>
 
-#include "Replay.hpp"
+#include "ScenarioGateway.hpp"
 #include "CommonMini.hpp"
 
 using namespace scenarioengine;
 
-#define MAX_LINE_LEN 2048
+#define MAX_LINE_LEN      2048
+#define ENTRIES_PER_BLOCK 16384  // number of entries converted in one go by each thread
+
+static void ConvertBlock(const ObjectStateStructDat* entries, size_t n_entries, std::string& out)
+{
+    out.clear();
+    for (size_t i = 0; i < n_entries; i++)
+    {
+        const ObjectStateStructDat& state = entries[i];
+
+        StrAppendFixed(out, static_cast<double>(state.info.timeStamp), 3);
+        out += ", ";
+        StrAppendInt(out, state.info.id);
+        out += ", ";
+        out.append(state.info.name, strnlen(state.info.name, NAME_LEN));
+        for (float value : {state.pos.x,
+                            state.pos.y,
+                            state.pos.z,
+                            state.pos.h,
+                            state.pos.p,
+                            state.pos.r,
+                            state.info.speed,
+                            state.info.wheel_angle,
+                            state.info.wheel_rot})
+        {
+            out += ", ";
+            StrAppendFixed(out, static_cast<double>(value), 3);
+        }
+        out += '\n';
+    }
+}
 
 int main(int argc, char** argv)
 {
-    Replay*     player;
-    static char line[MAX_LINE_LEN];
+    static char  line[MAX_LINE_LEN];
+    std::string  dat_filename;
+    unsigned int n_threads = 0;
 
     std::setlocale(LC_ALL, "C.UTF-8");
 
-    if (argc < 2)
+    for (int i = 1; i < argc; i++)
     {
-        printf("Usage: %s <filename>\n", argv[0]);
+        if (std::string(argv[i]) == "--threads" && i + 1 < argc)
+        {
+            n_threads = static_cast<unsigned int>(std::max(0, strtoi(argv[++i])));
+        }
+        else
+        {
+            dat_filename = argv[i];
+        }
+    }
+
+    if (dat_filename.empty())
+    {
+        printf("Usage: %s [--threads <number>] <filename>\n", argv[0]);
         return -1;
     }
 
-    std::string   filename = FileNameWithoutExtOf(argv[1]) + ".csv";
-    std::ofstream file;
-    file.open(filename);
-    if (!file.is_open())
+    if (n_threads == 0)
     {
-        printf("Failed to create file %s\n", filename.c_str());
+        n_threads = MAX(1, std::thread::hardware_concurrency());
+    }
+
+    SE_MappedFile dat_file;
+    if (dat_file.Open(dat_filename) != 0)
+    {
+        printf("Failed to open file %s\n", dat_filename.c_str());
         return -1;
     }
 
-    // Create replayer object for parsing the binary data file
-    try
+    DatHeader header;
+    if (dat_file.Size() < sizeof(header))
     {
-        player = new Replay(argv[1], false);
+        printf("File %s too small, missing header\n", dat_filename.c_str());
+        return -1;
     }
-    catch (const std::exception& e)
+    memcpy(&header, dat_file.Data(), sizeof(header));
+
+    if (header.version != DAT_FILE_FORMAT_VERSION)
     {
-        printf("%s", e.what());
+        printf("Version mismatch. %s is version %d while supported version is %d. Please re-create dat file.\n",
+               dat_filename.c_str(),
+               header.version,
+               DAT_FILE_FORMAT_VERSION);
+        return -1;
+    }
+
+    std::string        filename = FileNameWithoutExtOf(dat_filename) + ".csv";
+    SE_AsyncFileWriter file;
+    if (file.Open(filename) != 0)
+    {
+        printf("Failed to create file %s\n", filename.c_str());
         return -1;
     }
 
     // First output header and CSV labels
-    snprintf(line,
-             MAX_LINE_LEN,
-             "Version: %d, OpenDRIVE: %s, 3DModel: %s\n",
-             player->header_.version,
-             player->header_.odr_filename,
-             player->header_.model_filename);
-    file << line;
-    snprintf(line, MAX_LINE_LEN, "time, id, name, x, y, z, h, p, r, speed, wheel_angle, wheel_rot\n");
-    file << line;
-
-    // Then output all entries with comma separated values
-    for (size_t i = 0; i < player->data_.size(); i++)
+    int n = snprintf(line,
+                     MAX_LINE_LEN,
+                     "Version: %d, OpenDRIVE: %s, 3DModel: %s\n",
+                     header.version,
+                     header.odr_filename,
+                     header.model_filename);
+    file.Write(line, static_cast<size_t>(MIN(n, MAX_LINE_LEN - 1)));
+    n = snprintf(line, MAX_LINE_LEN, "time, id, name, x, y, z, h, p, r, speed, wheel_angle, wheel_rot\n");
+    file.Write(line, static_cast<size_t>(n));
+
+    // Then output all entries with comma separated values. Each round every thread converts one block, then
+    // the blocks are handed over to the file writer in order.
+    const ObjectStateStructDat* entries   = reinterpret_cast<const ObjectStateStructDat*>(dat_file.Data() + sizeof(header));
+    size_t                      n_entries = (dat_file.Size() - sizeof(header)) / sizeof(ObjectStateStructDat);
+    std::vector<std::string>    blocks(n_threads);
+    std::vector<std::thread>    threads;
+
+    for (size_t round_start = 0; round_start < n_entries; round_start += n_threads * ENTRIES_PER_BLOCK)
     {
-        ObjectStateStructDat* state = &player->data_[i].state;
-
-        snprintf(line,
-                 MAX_LINE_LEN,
-                 "%.3f, %d, %s, %.3f, %.3f, %.3f, %.3f, %.3f, %.3f, %.3f, %.3f, %.3f\n",
-                 static_cast<double>(state->info.timeStamp),
-                 state->info.id,
-                 state->info.name,
-                 static_cast<double>(state->pos.x),
-                 static_cast<double>(state->pos.y),
-                 static_cast<double>(state->pos.z),
-                 static_cast<double>(state->pos.h),
-                 static_cast<double>(state->pos.p),
-                 static_cast<double>(state->pos.r),
-                 static_cast<double>(state->info.speed),
-                 static_cast<double>(state->info.wheel_angle),
-                 static_cast<double>(state->info.wheel_rot));
-
-        file << line;
+        for (unsigned int i = 0; i < n_threads; i++)
+        {
+            size_t start = round_start + i * ENTRIES_PER_BLOCK;
+            if (start >= n_entries)
+            {
+                blocks[i].clear();
+                continue;
+            }
+            size_t count = MIN(static_cast<size_t>(ENTRIES_PER_BLOCK), n_entries - start);
+
+            if (i == n_threads - 1)
+            {
+                ConvertBlock(entries + start, count, blocks[i]);  // use main thread for last block
+            }
+            else
+            {
+                threads.emplace_back(ConvertBlock, entries + start, count, std::ref(blocks[i]));
+            }
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        threads.clear();
+
+        for (auto& block : blocks)
+        {
+            file.Write(block.data(), block.size());
+        }
     }
 
-    file.close();
+    file.Close();
 
-    delete player;
-}
\ No newline at end of file
+    return 0;
+}
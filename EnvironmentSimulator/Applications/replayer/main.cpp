@@ -379,6 +379,8 @@ int main(int argc, char** argv)
     opt.AddOption("repeat", "loop scenario");
     opt.AddOption("res_path", "Path to resources root folder - relative or absolut", "path");
     opt.AddOption("road_features", "Show OpenDRIVE road features");
+    opt.AddOption("road_tile_cache", "Directory for caching generated road tiles, reused while the OpenDRIVE file and tile size are unchanged", "path");
+    opt.AddOption("road_tile_size", "Generate road 3D model in square tiles of given size (m), built on demand around the camera", "size");
     opt.AddOption("save_merged", "Save merged data into one dat file, instead of viewing", "filename");
     opt.AddOption("start_time", "Start playing at timestamp", "ms");
     opt.AddOption("stop_time", "Stop playing at timestamp (set equal to time_start for single frame)", "ms");
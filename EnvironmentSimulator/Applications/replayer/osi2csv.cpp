@@ -0,0 +1,224 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+/*
+ * This application converts OSI ground truth trace files (.osi), as written by esmini --osi_file, into csv format.
+ * Same output as scripts/osi2csv.py. Messages are parsed and converted in parallel blocks from the memory mapped file.
+ */
+
+#include <clocale>
+#include <thread>
+#include <algorithm>
+
+#include "osi_groundtruth.pb.h"
+#include "CommonMini.hpp"
+
+#define MESSAGES_PER_BLOCK 256  // number of messages converted in one go by each thread
+
+typedef struct
+{
+    size_t       offset;
+    unsigned int size;
+} MessageRef;
+
+static void ConvertBlock(const char* data, const MessageRef* messages, size_t n_messages, std::string& out)
+{
+    osi3::GroundTruth gt;
+
+    out.clear();
+    for (size_t i = 0; i < n_messages; i++)
+    {
+        if (!gt.ParseFromArray(data + messages[i].offset, static_cast<int>(messages[i].size)))
+        {
+            printf("Failed to parse OSI message at offset %zu\n", messages[i].offset);
+            continue;
+        }
+
+        double time = static_cast<double>(gt.timestamp().seconds()) + 1e-9 * gt.timestamp().nanos();
+
+        for (int j = 0; j < gt.moving_object_size(); j++)
+        {
+            const osi3::MovingObject& o = gt.moving_object(j);
+            const osi3::BaseMoving&   b = o.base();
+
+            StrAppendFixed(out, time, 6);
+            out += ", ";
+            StrAppendInt(out, static_cast<long long>(o.id().value()));
+            out += ", obj";
+            StrAppendInt(out, static_cast<long long>(o.id().value()));
+            out += ", ";
+
+            switch (o.type())
+            {
+                case osi3::MovingObject_Type_TYPE_UNKNOWN:
+                    out += "UNKNOWN";
+                    break;
+                case osi3::MovingObject_Type_TYPE_OTHER:
+                    out += "OTHER";
+                    break;
+                case osi3::MovingObject_Type_TYPE_VEHICLE:
+                    if (o.vehicle_classification().has_type())
+                    {
+                        // skip "TYPE_" prefix
+                        out += osi3::MovingObject_VehicleClassification_Type_Name(o.vehicle_classification().type()).substr(5);
+                    }
+                    break;
+                case osi3::MovingObject_Type_TYPE_PEDESTRIAN:
+                    out += "PEDESTRIAN";
+                    break;
+                case osi3::MovingObject_Type_TYPE_ANIMAL:
+                    out += "ANIMAL";
+                    break;
+                default:
+                    out += "ERROR";
+            }
+
+            double wheel_angle = o.vehicle_attributes().wheel_data_size() > 0 ? o.vehicle_attributes().wheel_data(0).orientation().yaw() : 0.0;
+
+            for (double value : {b.position().x(),
+                                 b.position().y(),
+                                 b.position().z(),
+                                 b.velocity().x(),
+                                 b.velocity().y(),
+                                 b.velocity().z(),
+                                 b.acceleration().x(),
+                                 b.acceleration().y(),
+                                 b.acceleration().z(),
+                                 b.orientation().yaw(),
+                                 b.orientation().pitch(),
+                                 b.orientation().roll(),
+                                 b.orientation_rate().yaw(),
+                                 b.orientation_rate().pitch(),
+                                 b.orientation_rate().roll(),
+                                 b.orientation_acceleration().yaw(),
+                                 b.orientation_acceleration().pitch(),
+                                 b.orientation_acceleration().roll(),
+                                 sqrt(b.velocity().x() * b.velocity().x() + b.velocity().y() * b.velocity().y()),
+                                 wheel_angle,
+                                 0.0})  // wheel rotation not available
+            {
+                out += ", ";
+                StrAppendFixed(out, value, 6);
+            }
+            out += '\n';
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string  osi_filename;
+    unsigned int n_threads = 0;
+
+    std::setlocale(LC_ALL, "C.UTF-8");
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--threads" && i + 1 < argc)
+        {
+            n_threads = static_cast<unsigned int>(std::max(0, strtoi(argv[++i])));
+        }
+        else
+        {
+            osi_filename = argv[i];
+        }
+    }
+
+    if (osi_filename.empty())
+    {
+        printf("Usage: %s [--threads <number>] <filename>\n", argv[0]);
+        return -1;
+    }
+
+    if (n_threads == 0)
+    {
+        n_threads = MAX(1, std::thread::hardware_concurrency());
+    }
+
+    SE_MappedFile osi_file;
+    if (osi_file.Open(osi_filename) != 0)
+    {
+        printf("Failed to open file %s\n", osi_filename.c_str());
+        return -1;
+    }
+
+    // Find all messages, each one prefixed by its size
+    std::vector<MessageRef> messages;
+    size_t                  offset = 0;
+    while (offset + sizeof(unsigned int) <= osi_file.Size())
+    {
+        MessageRef msg;
+        memcpy(&msg.size, osi_file.Data() + offset, sizeof(msg.size));
+        msg.offset = offset + sizeof(msg.size);
+        if (msg.offset + msg.size > osi_file.Size())
+        {
+            printf("Truncated message at end of file, skipped\n");
+            break;
+        }
+        messages.push_back(msg);
+        offset = msg.offset + msg.size;
+    }
+
+    std::string        filename = FileNameWithoutExtOf(osi_filename) + ".csv";
+    SE_AsyncFileWriter file;
+    if (file.Open(filename) != 0)
+    {
+        printf("Failed to create file %s\n", filename.c_str());
+        return -1;
+    }
+
+    std::string labels =
+        "time, id, name, type, x, y, z, vx, vy, vz, ax, ay, az, h, p, r, vh, vp, vr, ah, ap, ar, speed, wheel_angle, wheel_rot\n";
+    file.Write(labels.data(), labels.size());
+
+    // Each round every thread converts one block of messages, then the blocks are handed over to the file writer in order
+    std::vector<std::string> blocks(n_threads);
+    std::vector<std::thread> threads;
+
+    for (size_t round_start = 0; round_start < messages.size(); round_start += n_threads * MESSAGES_PER_BLOCK)
+    {
+        for (unsigned int i = 0; i < n_threads; i++)
+        {
+            size_t start = round_start + i * MESSAGES_PER_BLOCK;
+            if (start >= messages.size())
+            {
+                blocks[i].clear();
+                continue;
+            }
+            size_t count = MIN(static_cast<size_t>(MESSAGES_PER_BLOCK), messages.size() - start);
+
+            if (i == n_threads - 1)
+            {
+                ConvertBlock(osi_file.Data(), &messages[start], count, blocks[i]);  // use main thread for last block
+            }
+            else
+            {
+                threads.emplace_back(ConvertBlock, osi_file.Data(), &messages[start], count, std::ref(blocks[i]));
+            }
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        threads.clear();
+
+        for (auto& block : blocks)
+        {
+            file.Write(block.data(), block.size());
+        }
+    }
+
+    file.Close();
+
+    return 0;
+}
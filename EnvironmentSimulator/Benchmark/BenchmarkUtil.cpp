@@ -0,0 +1,73 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include "BenchmarkUtil.hpp"
+#include "CommonMini.hpp"
+#include "RoadGenerator.hpp"
+#include "RoadManager.hpp"
+
+#define RING_LANES             2
+#define RING_LANE_WIDTH        3.5
+#define RING_VEHICLES_PER_ROAD 4
+#define RING_VEHICLE_SPACING   20.0
+#define RING_SPEED             20.0
+
+static int CreateRing(roadgenerator::Network& network, int n_roads)
+{
+    network.n_lanes    = RING_LANES;
+    network.lane_width = RING_LANE_WIDTH;
+
+    return roadgenerator::CreateRing(network, n_roads, BENCH_RING_ROAD_LENGTH);
+}
+
+std::string WriteRingRoad(int n_roads)
+{
+    roadgenerator::Network network;
+    std::string            filename = "bench_ring_" + std::to_string(n_roads) + ".xodr";
+
+    if (CreateRing(network, n_roads) != 0 || roadgenerator::WriteOpenDRIVE(filename, network) != 0)
+    {
+        LOG("Failed to create %s", filename.c_str());
+        return "";
+    }
+
+    return filename;
+}
+
+std::string WriteRingScenario(int n_vehicles)
+{
+    roadgenerator::Network network;
+    int                    n_roads       = MAX(10, (n_vehicles + RING_VEHICLES_PER_ROAD - 1) / RING_VEHICLES_PER_ROAD);
+    std::string            road_filename = "bench_ring_" + std::to_string(n_roads) + ".xodr";
+    std::string            filename      = "bench_ring_" + std::to_string(n_vehicles) + "_vehicles.xosc";
+
+    if (CreateRing(network, n_roads) != 0 || roadgenerator::WriteOpenDRIVE(road_filename, network) != 0 ||
+        roadgenerator::WriteOpenSCENARIO(filename, road_filename, network, n_vehicles, RING_VEHICLE_SPACING, RING_SPEED, 0.0, "", 0) != n_vehicles)
+    {
+        LOG("Failed to create %s", filename.c_str());
+        return "";
+    }
+
+    return filename;
+}
+
+bool LoadRoadNetwork(const std::string& filename)
+{
+    roadmanager::OpenDrive* odr = roadmanager::Position::GetOpenDrive();
+
+    if (odr != nullptr && odr->GetNumOfRoads() > 0 && odr->GetOpenDriveFilename() == filename)
+    {
+        return true;
+    }
+
+    return roadmanager::Position::LoadOpenDrive(filename.c_str());
+}
@@ -0,0 +1,39 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#pragma once
+
+#include <string>
+
+// Relative to the build folder of esmini_bench, same as for the unit tests
+#define BENCH_RESOURCES_PATH "../../../resources/"
+
+#define BENCH_RING_ROAD_LENGTH 100.0  // length of each road in synthetic ring networks (m)
+
+/**
+    Write OpenDRIVE file with given number of roads forming a ring, each road an arc with two lanes per direction.
+    Roads are connected end to start, so that objects can drive around forever. Created by RoadGenerator.
+    @return Filename of the network, written to current folder
+*/
+std::string WriteRingRoad(int n_roads);
+
+/**
+    Write OpenSCENARIO file with given number of vehicles driving around a ring network, without stop trigger.
+    Vehicles are evenly distributed over roads and lanes, driving at 20 m/s +/-10% using the default controller.
+    @return Filename of the scenario, written to current folder
+*/
+std::string WriteRingScenario(int n_vehicles);
+
+/**
+    Load the road network, unless already loaded
+*/
+bool LoadRoadNetwork(const std::string& filename);
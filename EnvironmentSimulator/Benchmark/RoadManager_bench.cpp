@@ -0,0 +1,160 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "BenchmarkUtil.hpp"
+#include "CommonMini.hpp"
+#include "RoadManager.hpp"
+
+using namespace roadmanager;
+
+#define N_SAMPLE_POINTS 1024
+
+struct SamplePoint
+{
+    double x;
+    double y;
+};
+
+// Points on random roads at random s and t, within the road or a bit outside
+static std::vector<SamplePoint> GetSamplePoints()
+{
+    std::mt19937                           generator(1);  // fixed seed, same points every run
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<SamplePoint>               points;
+    OpenDrive*                             odr = Position::GetOpenDrive();
+    Position                               pos;
+
+    for (int i = 0; i < N_SAMPLE_POINTS; i++)
+    {
+        Road* road = odr->GetRoadByIdx(static_cast<int>(unit(generator) * (odr->GetNumOfRoads() - 1) + 0.5));
+        pos.SetTrackPos(road->GetId(), unit(generator) * road->GetLength(), 20.0 * (unit(generator) - 0.5));
+        points.push_back({pos.GetX(), pos.GetY()});
+    }
+
+    return points;
+}
+
+static void XYZ2TrackPos(benchmark::State& state)
+{
+    std::vector<SamplePoint> points = GetSamplePoints();
+    Position                 pos;
+    size_t                   i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(pos.XYZ2TrackPos(points[i].x, points[i].y, 0.0));
+        i = (i + 1) % points.size();
+    }
+}
+
+static void BM_XYZ2TrackPos(benchmark::State& state, const char* odr_filename)
+{
+    if (!LoadRoadNetwork(std::string(BENCH_RESOURCES_PATH) + odr_filename))
+    {
+        state.SkipWithError("Failed to load road network");
+        return;
+    }
+    XYZ2TrackPos(state);
+}
+BENCHMARK_CAPTURE(BM_XYZ2TrackPos, fabriksgatan, "xodr/fabriksgatan.xodr");
+BENCHMARK_CAPTURE(BM_XYZ2TrackPos, soderleden, "xodr/soderleden.xodr");
+BENCHMARK_CAPTURE(BM_XYZ2TrackPos, multi_intersections, "xodr/multi_intersections.xodr");
+
+// Global search cost versus number of roads
+static void BM_XYZ2TrackPosRing(benchmark::State& state)
+{
+    if (!LoadRoadNetwork(WriteRingRoad(static_cast<int>(state.range(0)))))
+    {
+        state.SkipWithError("Failed to load road network");
+        return;
+    }
+    XYZ2TrackPos(state);
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_XYZ2TrackPosRing)->RangeMultiplier(10)->Range(10, 1000)->Complexity();
+
+// Typical object update, each point close to previous one, i.e. found on the current or a connected road
+static void BM_XYZ2TrackPosTracking(benchmark::State& state)
+{
+    if (!LoadRoadNetwork(WriteRingRoad(static_cast<int>(state.range(0)))))
+    {
+        state.SkipWithError("Failed to load road network");
+        return;
+    }
+
+    Position pos;
+    Position probe;
+    pos.SetLanePos(0, -1, 0.0, 0.0);
+    probe.SetLanePos(0, -1, 0.0, 0.0);
+
+    for (auto _ : state)
+    {
+        probe.MoveAlongS(2.0);
+        benchmark::DoNotOptimize(pos.XYZ2TrackPos(probe.GetX(), probe.GetY(), 0.0, Position::PosMode::UNDEFINED, true));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_XYZ2TrackPosTracking)->RangeMultiplier(10)->Range(10, 1000)->Complexity();
+
+static void BM_MoveAlongS(benchmark::State& state, const char* odr_filename, int road_id, int lane_id)
+{
+    std::string filename = odr_filename[0] == '\0' ? WriteRingRoad(100) : std::string(BENCH_RESOURCES_PATH) + odr_filename;
+
+    if (!LoadRoadNetwork(filename))
+    {
+        state.SkipWithError("Failed to load road network");
+        return;
+    }
+
+    Position pos;
+    pos.SetLanePos(road_id, lane_id, 0.0, 0.0);
+
+    for (auto _ : state)
+    {
+        if (static_cast<int>(pos.MoveAlongS(1.0)) < 0)
+        {
+            pos.SetLanePos(road_id, lane_id, 0.0, 0.0);  // end of road, start over
+        }
+    }
+}
+BENCHMARK_CAPTURE(BM_MoveAlongS, ring_100, "", 0, -1);
+BENCHMARK_CAPTURE(BM_MoveAlongS, fabriksgatan, "xodr/fabriksgatan.xodr", 0, 1);
+BENCHMARK_CAPTURE(BM_MoveAlongS, e6mini, "xodr/e6mini.xodr", 0, -3);
+// 200 geometries, 100 lane sections and 500 elevation, superelevation and lane offset entries on 2000 m
+BENCHMARK_CAPTURE(BM_MoveAlongS, dense_profiles, "../EnvironmentSimulator/Unittest/xodr/straight_2000m_dense_profiles.xodr", 1, -1);
+
+// Road distance between positions, versus number of roads in between
+static void BM_Delta(benchmark::State& state)
+{
+    if (!LoadRoadNetwork(WriteRingRoad(1000)))
+    {
+        state.SkipWithError("Failed to load road network");
+        return;
+    }
+
+    Position     pos_a;
+    Position     pos_b;
+    PositionDiff diff;
+    pos_a.SetLanePos(0, -1, 50.0, 0.0);
+    pos_b.SetLanePos(static_cast<int>(state.range(0)), -2, 50.0, 0.0);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(pos_a.Delta(&pos_b, diff));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_Delta)->RangeMultiplier(4)->Range(1, 256)->Complexity();
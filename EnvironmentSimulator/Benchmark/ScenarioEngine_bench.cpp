@@ -0,0 +1,175 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtil.hpp"
+#include "Parameters.hpp"
+#include "playerbase.hpp"
+#include "simple_expr.h"
+
+using namespace scenarioengine;
+
+#define BENCH_TIMESTEP 0.05
+
+static ScenarioPlayer* CreatePlayer(benchmark::State& state, const std::string& xosc_filename, const char* record_filename = nullptr)
+{
+    std::vector<const char*> args = {"esmini", "--osc", xosc_filename.c_str(), "--headless", "--disable_stdout", "--disable_log"};
+
+    if (record_filename != nullptr)
+    {
+        args.push_back("--record");
+        args.push_back(record_filename);
+    }
+    args.push_back("--fixed_timestep");
+    args.push_back("0.05");
+
+    ScenarioPlayer* player = new ScenarioPlayer(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+
+    if (player->Init() != 0)
+    {
+        delete player;
+        state.SkipWithError("Failed to initialize scenario");
+        return nullptr;
+    }
+
+    return player;
+}
+
+// Complete frames, i.e. what a headless batch run or library user pays per step
+static void BM_ScenarioFrame(benchmark::State& state)
+{
+    int             n_vehicles = static_cast<int>(state.range(0));
+    ScenarioPlayer* player     = CreatePlayer(state, WriteRingScenario(n_vehicles));
+
+    if (player == nullptr)
+    {
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        player->Frame(BENCH_TIMESTEP);
+    }
+
+    state.counters["steps/s"]        = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+    state.counters["entity_steps/s"] = benchmark::Counter(static_cast<double>(state.iterations() * n_vehicles), benchmark::Counter::kIsRate);
+    state.SetComplexityN(n_vehicles);
+
+    delete player;
+}
+BENCHMARK(BM_ScenarioFrame)->RangeMultiplier(10)->Range(1, 1000)->Complexity()->Unit(benchmark::kMicrosecond);
+
+static void BM_FreeSpaceDistance(benchmark::State& state)
+{
+    ScenarioPlayer* player = CreatePlayer(state, std::string(BENCH_RESOURCES_PATH) + "xosc/cut-in.xosc");
+
+    if (player == nullptr)
+    {
+        return;
+    }
+
+    for (int i = 0; i < 20; i++)
+    {
+        player->Frame(BENCH_TIMESTEP);  // get the cars going
+    }
+
+    Object* obj0 = player->scenarioEngine->entities_.object_[0];
+    Object* obj1 = player->scenarioEngine->entities_.object_[1];
+    double  lat_dist;
+    double  long_dist;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(obj0->FreeSpaceDistance(obj1, &lat_dist, &long_dist));
+    }
+
+    delete player;
+}
+BENCHMARK(BM_FreeSpaceDistance);
+
+// ${...} expression evaluation, compiled and cached versus parameter values substituted as text and parsed every time
+static void BM_Expression(benchmark::State& state, bool compiled)
+{
+    const std::string  expr = "($speed + 7) * 0.5 / ($acc + 1) - max($speed, 3)";
+    pugi::xml_document xml_doc;
+    pugi::xml_node     node = xml_doc.append_child("Expression");
+
+    node.append_attribute("value") = ("${" + expr + "}").c_str();
+
+    Parameters params;
+    params.parameterDeclarations_.Parameter.push_back({"speed", OSCParameterDeclarations::ParameterType::PARAM_TYPE_DOUBLE, {0, 5.0, "5.0", false}});
+    params.parameterDeclarations_.Parameter.push_back({"acc", OSCParameterDeclarations::ParameterType::PARAM_TYPE_DOUBLE, {0, 3.0, "3.0", false}});
+
+    for (auto _ : state)
+    {
+        if (compiled)
+        {
+            benchmark::DoNotOptimize(params.ReadAttribute(node, "value"));
+        }
+        else
+        {
+            ExprReturnStruct rs = eval_expr(params.ResolveParametersInString(expr).c_str());
+            benchmark::DoNotOptimize(rs._double);
+            clear_expr_result(&rs);
+        }
+    }
+}
+BENCHMARK_CAPTURE(BM_Expression, compiled, true);
+BENCHMARK_CAPTURE(BM_Expression, string, false);
+
+// Recording one frame of all objects to the .dat file
+static void BM_WriteStatesToFile(benchmark::State& state)
+{
+    int             n_vehicles = static_cast<int>(state.range(0));
+    ScenarioPlayer* player     = CreatePlayer(state, WriteRingScenario(n_vehicles), "bench.dat");
+
+    if (player == nullptr)
+    {
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        player->scenarioGateway->WriteStatesToFile();
+    }
+
+    state.SetBytesProcessed(state.iterations() * n_vehicles * static_cast<int64_t>(sizeof(ObjectStateStructDat)));
+
+    delete player;
+}
+BENCHMARK(BM_WriteStatesToFile)->RangeMultiplier(10)->Range(1, 1000);
+
+#ifdef _USE_OSI
+// Dynamic ground truth update and serialization of all objects
+static void BM_UpdateOSIGroundTruth(benchmark::State& state)
+{
+    int             n_vehicles = static_cast<int>(state.range(0));
+    ScenarioPlayer* player     = CreatePlayer(state, WriteRingScenario(n_vehicles));
+
+    if (player == nullptr)
+    {
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        player->osiReporter->UpdateOSIGroundTruth(player->scenarioGateway->objectState_);
+    }
+    state.SetComplexityN(n_vehicles);
+
+    delete player;
+}
+BENCHMARK(BM_UpdateOSIGroundTruth)->RangeMultiplier(10)->Range(1, 1000)->Complexity()->Unit(benchmark::kMicrosecond);
+#endif
@@ -160,6 +160,15 @@ static void copyStateFromScenarioGateway(SE_ScenarioObjectState *state, ObjectSt
     state->visibilityMask = gw_state->info.visibilityMask;
 }
 
+template <class T>
+static void setArrayValue(T *array, int index, T value)
+{
+    if (array != nullptr)
+    {
+        array[index] = value;
+    }
+}
+
 static int getObjectById(int object_id, Object *&obj)
 {
     if (player == nullptr)
@@ -492,6 +501,18 @@ extern "C"
         OSCParameterDistribution::Inst().Reset();
     }
 
+    SE_DLL_API int SE_SetParameterDistributionSampling(int method)
+    {
+        if (method < static_cast<int>(OSCParameterDistribution::SamplingMethod::RANDOM) ||
+            method > static_cast<int>(OSCParameterDistribution::SamplingMethod::SOBOL))
+        {
+            LOG("Invalid sampling method %d", method);
+            return -1;
+        }
+        OSCParameterDistribution::Inst().SetSamplingMethod(static_cast<OSCParameterDistribution::SamplingMethod>(method));
+        return 0;
+    }
+
     SE_DLL_API int SE_GetNumberOfPermutations()
     {
         return static_cast<int>(OSCParameterDistribution::Inst().GetNumPermutations());
@@ -784,6 +805,21 @@ extern "C"
         return ScenarioReader::parameters.getParameterValue(parameter->name, parameter->value);
     }
 
+    SE_DLL_API int SE_GetParameterHandle(const char *parameterName)
+    {
+        return ScenarioReader::parameters.GetParameterHandle(parameterName);
+    }
+
+    SE_DLL_API int SE_GetParameterByHandle(int handle, void *value)
+    {
+        return ScenarioReader::parameters.getParameterValueByHandle(handle, value);
+    }
+
+    SE_DLL_API int SE_SetParameterByHandle(int handle, const void *value)
+    {
+        return ScenarioReader::parameters.setParameterValueByHandle(handle, value);
+    }
+
     SE_DLL_API int SE_GetParameterInt(const char *parameterName, int *value)
     {
         return ScenarioReader::parameters.getParameterValueInt(parameterName, *value);
@@ -834,6 +870,21 @@ extern "C"
         return ScenarioReader::variables.getParameterValue(variable->name, variable->value);
     }
 
+    SE_DLL_API int SE_GetVariableHandle(const char *variableName)
+    {
+        return ScenarioReader::variables.GetParameterHandle(variableName);
+    }
+
+    SE_DLL_API int SE_GetVariableByHandle(int handle, void *value)
+    {
+        return ScenarioReader::variables.getParameterValueByHandle(handle, value);
+    }
+
+    SE_DLL_API int SE_SetVariableByHandle(int handle, const void *value)
+    {
+        return ScenarioReader::variables.setParameterValueByHandle(handle, value);
+    }
+
     SE_DLL_API int SE_GetVariableInt(const char *variableName, int *value)
     {
         return ScenarioReader::variables.getParameterValueInt(variableName, *value);
@@ -900,12 +951,39 @@ extern "C"
         SE_Env::Inst().SetCollisionDetection(mode);
     }
 
+    SE_DLL_API void SE_SetKPIFilePath(const char *filename)
+    {
+        SE_Env::Inst().SetKPIFilePath(filename != nullptr ? filename : "");
+    }
+
+    SE_DLL_API void SE_SetKPIEntityFilePath(const char *filename)
+    {
+        SE_Env::Inst().SetKPIEntityFilePath(filename != nullptr ? filename : "");
+    }
+
+    SE_DLL_API void SE_SetStopCriteria(bool stopOnCollision, double stopAtTTC)
+    {
+        SE_Env::Inst().SetStopCriteria(stopOnCollision, stopAtTTC);
+    }
+
+    SE_DLL_API void SE_SetScenarioTemplateMode(bool mode)
+    {
+        SE_Env::Inst().SetScenarioTemplateMode(mode);
+    }
+
     SE_DLL_API int SE_Step()
     {
         if (player != nullptr)
         {
-            player->SetFixedTimestep(-1.0);
-            player->Frame();
+            if (player->GetRealtimeScheduler() != nullptr)
+            {
+                player->Frame(player->GetRealtimeScheduler()->GetPeriod());  // fixed timestep, paced by the scheduler
+            }
+            else
+            {
+                player->SetFixedTimestep(-1.0);
+                player->Frame();
+            }
             return 0;
         }
         else
@@ -928,6 +1006,38 @@ extern "C"
         }
     }
 
+    SE_DLL_API void *SE_SaveState()
+    {
+        if (player == nullptr)
+        {
+            return nullptr;
+        }
+
+        SE_StateSnapshot *state = new SE_StateSnapshot;
+        if (player->scenarioEngine->SaveState(*state) != 0)
+        {
+            delete state;
+            return nullptr;
+        }
+
+        return state;
+    }
+
+    SE_DLL_API int SE_RestoreState(void *handle)
+    {
+        if (player == nullptr || handle == nullptr)
+        {
+            return -1;
+        }
+
+        return player->scenarioEngine->RestoreState(*static_cast<SE_StateSnapshot *>(handle));
+    }
+
+    SE_DLL_API void SE_DeleteState(void *handle)
+    {
+        delete static_cast<SE_StateSnapshot *>(handle);
+    }
+
     SE_DLL_API float SE_GetSimulationTime()
     {
         if (player == nullptr)
@@ -958,6 +1068,30 @@ extern "C"
         return static_cast<float>(SE_getSimTimeStep(time_stamp, 0.001, 0.1));
     }
 
+    SE_DLL_API int SE_GetRealtimeStats(SE_RealtimeStats *stats)
+    {
+        if (player == nullptr || player->GetRealtimeScheduler() == nullptr || stats == nullptr)
+        {
+            return -1;
+        }
+
+        static_assert(SE_REALTIME_HISTOGRAM_BINS == RT_HISTOGRAM_BINS, "histogram size mismatch");
+        RealtimeStats rt_stats = player->GetRealtimeScheduler()->GetStats();
+
+        stats->n_frames           = rt_stats.n_frames;
+        stats->n_deadline_misses  = rt_stats.n_deadline_misses;
+        stats->exec_time_min      = static_cast<float>(rt_stats.exec_time_min);
+        stats->exec_time_avg      = static_cast<float>(rt_stats.exec_time_avg);
+        stats->exec_time_max      = static_cast<float>(rt_stats.exec_time_max);
+        stats->wakeup_latency_max = static_cast<float>(rt_stats.wakeup_latency_max);
+        for (int i = 0; i < SE_REALTIME_HISTOGRAM_BINS; i++)
+        {
+            stats->exec_time_histogram[i] = rt_stats.exec_time_histogram[i];
+        }
+
+        return 0;
+    }
+
     SE_DLL_API void SE_SetObjectPositionMode(int object_id, SE_PositionModeType type, int mode)
     {
         if (player != nullptr)
@@ -1174,6 +1308,64 @@ extern "C"
         return 0;
     }
 
+    SE_DLL_API int SE_ReportObjectPosBatch(int          n,
+                                           const int   *object_ids,
+                                           float        timestamp,
+                                           const float *x,
+                                           const float *y,
+                                           const float *z,
+                                           const float *h,
+                                           const float *p,
+                                           const float *r)
+    {
+        if (player == nullptr || object_ids == nullptr || x == nullptr || y == nullptr || h == nullptr)
+        {
+            return -1;
+        }
+
+        int retval = 0;
+        for (int i = 0; i < n; i++)
+        {
+            ObjectState *obj_state = player->scenarioGateway->getObjectStatePtrById(object_ids[i]);
+            if (obj_state == nullptr)
+            {
+                LOG("Invalid object_id (%d)", object_ids[i]);
+                retval = -1;
+                continue;
+            }
+
+            player->scenarioGateway->updateObjectWorldPos(obj_state,
+                                                          timestamp,
+                                                          x[i],
+                                                          y[i],
+                                                          z != nullptr ? z[i] : std::nanf(""),
+                                                          h[i],
+                                                          p != nullptr ? p[i] : std::nanf(""),
+                                                          r != nullptr ? r[i] : std::nanf(""));
+        }
+
+        return retval;
+    }
+
+    SE_DLL_API int SE_ReportObjectSpeedBatch(int n, const int *object_ids, const float *speed)
+    {
+        if (player == nullptr || object_ids == nullptr || speed == nullptr)
+        {
+            return -1;
+        }
+
+        int retval = 0;
+        for (int i = 0; i < n; i++)
+        {
+            if (player->scenarioGateway->updateObjectSpeed(object_ids[i], 0.0, speed[i]) != 0)
+            {
+                retval = -1;
+            }
+        }
+
+        return retval;
+    }
+
     SE_DLL_API int SE_ReportObjectLateralPosition(int object_id, float t)
     {
         Object *obj = nullptr;
@@ -1309,6 +1501,38 @@ extern "C"
         return 0;
     }
 
+    // The post functions may be called from any thread, so don't look up the object here. Unknown ids are reported
+    // when the values are applied.
+    SE_DLL_API int SE_PostObjectPos(int object_id, float timestamp, float x, float y, float z, float h, float p, float r)
+    {
+        if (player == nullptr)
+        {
+            return -1;
+        }
+
+        return player->scenarioGateway->postObjectWorldPos(object_id, timestamp, x, y, z, h, p, r);
+    }
+
+    SE_DLL_API int SE_PostObjectSpeed(int object_id, float speed)
+    {
+        if (player == nullptr)
+        {
+            return -1;
+        }
+
+        return player->scenarioGateway->postObjectSpeed(object_id, speed);
+    }
+
+    SE_DLL_API int SE_PostObjectWheelStatus(int object_id, float rotation, float angle)
+    {
+        if (player == nullptr)
+        {
+            return -1;
+        }
+
+        return player->scenarioGateway->postObjectWheelStatus(object_id, angle, rotation);
+    }
+
     SE_DLL_API int SE_SetSnapLaneTypes(int object_id, int laneTypes)
     {
         Object *obj = nullptr;
@@ -1399,6 +1623,44 @@ extern "C"
         return -1;
     }
 
+    SE_DLL_API int SE_GetAllObjectStates(SE_StateArrays *states)
+    {
+        if (player == nullptr || states == nullptr)
+        {
+            return -1;
+        }
+
+        int n_objects     = player->scenarioGateway->getNumberOfObjects();
+        states->n_objects = MIN(n_objects, states->capacity);
+
+        for (int i = 0; i < states->n_objects; i++)
+        {
+            ObjectStateStruct &gw_state = player->scenarioGateway->getObjectStatePtrByIdx(i)->state_;
+
+            setArrayValue(states->id, i, gw_state.info.id);
+            setArrayValue(states->ctrl_type, i, gw_state.info.ctrl_type);
+            setArrayValue(states->x, i, static_cast<float>(gw_state.pos.GetX()));
+            setArrayValue(states->y, i, static_cast<float>(gw_state.pos.GetY()));
+            setArrayValue(states->z, i, static_cast<float>(gw_state.pos.GetZ()));
+            setArrayValue(states->h, i, static_cast<float>(gw_state.pos.GetH()));
+            setArrayValue(states->p, i, static_cast<float>(gw_state.pos.GetP()));
+            setArrayValue(states->r, i, static_cast<float>(gw_state.pos.GetR()));
+            setArrayValue(states->speed, i, static_cast<float>(gw_state.info.speed));
+            setArrayValue(states->roadId, i, gw_state.pos.GetTrackId());
+            setArrayValue(states->junctionId, i, gw_state.pos.GetJunctionId());
+            setArrayValue(states->laneId, i, gw_state.pos.GetLaneId());
+            setArrayValue(states->laneOffset, i, static_cast<float>(gw_state.pos.GetOffset()));
+            setArrayValue(states->s, i, static_cast<float>(gw_state.pos.GetS()));
+            setArrayValue(states->t, i, static_cast<float>(gw_state.pos.GetT()));
+            setArrayValue(states->wheel_angle, i, static_cast<float>(gw_state.info.wheel_angle));
+            setArrayValue(states->wheel_rot, i, static_cast<float>(gw_state.info.wheel_rot));
+            setArrayValue(states->objectType, i, gw_state.info.obj_type);
+            setArrayValue(states->visibilityMask, i, gw_state.info.visibilityMask);
+        }
+
+        return n_objects;
+    }
+
     SE_DLL_API int SE_GetOverrideActionStatus(int object_id, SE_OverrideActionList *list)
     {
         Object *obj = nullptr;
@@ -2309,6 +2571,21 @@ extern "C"
         return -1;
     }
 
+    SE_DLL_API int SE_SetImageCaptureMode(int nrOfBuffers, const char *fileFormat)
+    {
+        std::string format = fileFormat != nullptr ? ToLower(fileFormat) : SE_Env::Inst().GetImageFileFormat();
+
+        if (nrOfBuffers < 1 || (format != "tga" && format != "png" && format != "ppm" && format != "raw"))
+        {
+            LOG("Unsupported image capture mode: %d buffers, format %s", nrOfBuffers, format.c_str());
+            return -1;
+        }
+
+        SE_Env::Inst().SetImageCaptureMode(nrOfBuffers, format);
+
+        return 0;
+    }
+
     SE_DLL_API int SE_FetchImage(SE_Image *img)
     {
 #ifdef _USE_OSG
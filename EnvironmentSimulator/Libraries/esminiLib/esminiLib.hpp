@@ -52,6 +52,47 @@ typedef struct
     int   visibilityMask;  // bitmask according to Object::Visibility (1 = Graphics, 2 = Traffic, 4 = Sensors)
 } SE_ScenarioObjectState;
 
+// States of all objects, as structure of arrays. All arrays are provided by the caller, each with room for
+// capacity elements. Set any array pointer to nullptr to skip that value.
+typedef struct
+{
+    int    capacity;        // number of elements in each array
+    int    n_objects;       // number of objects filled in, set by SE_GetAllObjectStates()
+    int   *id;              // object id
+    int   *ctrl_type;       // 0: DefaultController 1: External. Further values see Controller::Type enum
+    float *x;               // global x coordinate of position
+    float *y;               // global y coordinate of position
+    float *z;               // global z coordinate of position
+    float *h;               // heading/yaw in global coordinate system
+    float *p;               // pitch in global coordinate system
+    float *r;               // roll in global coordinate system
+    float *speed;           // speed
+    int   *roadId;          // road ID
+    int   *junctionId;      // Junction ID (-1 if not in a junction)
+    int   *laneId;          // lane ID
+    float *laneOffset;      // lateral offset from lane center
+    float *s;               // longitudinal position in road coordinate system
+    float *t;               // lateral position in road coordinate system
+    float *wheel_angle;     // Steering angle of the wheel
+    float *wheel_rot;       // Rotation angle of the wheel
+    int   *objectType;      // Main type according to entities.hpp / Object / Type
+    int   *visibilityMask;  // bitmask according to Object::Visibility (1 = Graphics, 2 = Traffic, 4 = Sensors)
+} SE_StateArrays;
+
+#define SE_REALTIME_HISTOGRAM_BINS 11
+
+// Frame timing in realtime mode (--realtime option), see SE_GetRealtimeStats()
+typedef struct
+{
+    int   n_frames;
+    int   n_deadline_misses;                                // frames not finished within their timestep
+    float exec_time_min;                                    // execution time of a frame (s), excluding the wait for next frame
+    float exec_time_avg;                                    // average execution time (s)
+    float exec_time_max;                                    // max execution time (s)
+    float wakeup_latency_max;                               // max delay from deadline until the next frame actually started (s)
+    int   exec_time_histogram[SE_REALTIME_HISTOGRAM_BINS];  // number of frames per 10% of timestep, last bin for overruns
+} SE_RealtimeStats;
+
 // asciidoc tag::SE_RoadInfo_struct[]
 typedef struct
 {
@@ -401,6 +442,13 @@ extern "C"
     */
     SE_DLL_API void SE_ResetParameterDistribution();
 
+    /**
+            Specify how stochastic parameter distributions are sampled. Samples are reproducible given the randomSeed of the distribution file.
+            @param method 0=random (default) 1=latin hypercube 2=sobol sequence
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_SetParameterDistributionSampling(int method);
+
     /**
             Get the number of parameter value permutations. Call AFTER SE_Init.
             @return -1 on error else number of permutations
@@ -480,6 +528,28 @@ extern "C"
     */
     SE_DLL_API int SE_Step();
 
+    /**
+            Save complete simulation state in memory, e.g. entity states, controllers, storyboard, parameters and random generator.
+            Restore it with SE_RestoreState() to explore alternative continuations without re-simulating from start.
+            @return Handle to the saved state, release with SE_DeleteState(). 0 if failed.
+    */
+    SE_DLL_API void *SE_SaveState();
+
+    /**
+            Restore simulation state saved by SE_SaveState(). Same state can be restored any number of times.
+            Only valid for the scenario instance it was saved from, with same set of entities. Fails, without changing
+            the simulation, for a snapshot of any previous instance, e.g. from before SE_Close() and SE_Init().
+            @param handle Handle from SE_SaveState()
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_RestoreState(void *handle);
+
+    /**
+            Release state saved by SE_SaveState()
+            @param handle Handle from SE_SaveState()
+    */
+    SE_DLL_API void SE_DeleteState(void *handle);
+
     /**
             Stop simulation gracefully. Two purposes: 1. Release memory and 2. Prepare for next simulation, e.g. reset object lists.
     */
@@ -497,6 +567,37 @@ extern "C"
     */
     SE_DLL_API void SE_CollisionDetection(bool mode);
 
+    /**
+    Specify CSV file to which key performance indicators (KPIs) are appended at SE_Close, one row per run.
+    Columns: scenario, permutation, end_time, stop_reason, collision, collision_time, min_ttc, min_gap, max_decel,
+    aggregated over all entities. Call BEFORE SE_Init.
+    @param filename KPI file path, "" to disable
+    */
+    SE_DLL_API void SE_SetKPIFilePath(const char *filename);
+
+    /**
+    Specify CSV file to which KPIs of each entity are appended at SE_Close, one row per entity and run.
+    Columns: scenario, permutation, entity, collision_time, min_ttc, min_gap, max_decel. Call BEFORE SE_Init.
+    @param filename KPI entity file path, "" to disable
+    */
+    SE_DLL_API void SE_SetKPIEntityFilePath(const char *filename);
+
+    /**
+    Specify criteria for terminating the scenario early. Call BEFORE SE_Init.
+    @param stopOnCollision true=stop at first collision between any entities
+    @param stopAtTTC Stop when time-to-collision of any entity falls below this value (s), set < 0 to disable
+    */
+    SE_DLL_API void SE_SetStopCriteria(bool stopOnCollision, double stopAtTTC);
+
+    /**
+    Enable or disable scenario template mode. When enabled, the parsed scenario, catalog files and road network are kept
+    in memory, so that subsequent SE_Init calls for the same scenario (e.g. parameter permutations) only re-instantiate
+    entities and storyboard from the current parameter values. Call BEFORE SE_Init. The mode stays in effect over
+    SE_Close and following SE_Init calls until disabled.
+    @param mode true=enable, false=disable
+    */
+    SE_DLL_API void SE_SetScenarioTemplateMode(bool mode);
+
     /**
             Get simulation time in seconds - float (32 bit) precision
     */
@@ -514,6 +615,13 @@ extern "C"
     */
     SE_DLL_API float SE_GetSimTimeStep();
 
+    /**
+            Get frame timing statistics when running in realtime mode, i.e. initialized with --realtime <timestep>
+            @param stats Pointer to struct to fill in
+            @return 0 if successful, -1 if not in realtime mode
+    */
+    SE_DLL_API int SE_GetRealtimeStats(SE_RealtimeStats *stats);
+
     /**
             Is esmini about to quit?
             @return 0 if not, 1 if yes, -1 if some error e.g. scenario not loaded
@@ -587,6 +695,31 @@ extern "C"
     */
     SE_DLL_API int SE_GetParameter(SE_Parameter *parameter);
 
+    /**
+            Get a handle to a named parameter, for fast repeated access without name lookup
+            The handle is valid as long as the scenario is loaded. After SE_Close or a new SE_Init
+            it is rejected (the access functions return -1), so fetch new handles after each SE_Init
+            @param parameterName Name of the parameter
+            @return handle >= 0 if successful, -1 if not found
+    */
+    SE_DLL_API int SE_GetParameterHandle(const char *parameterName);
+
+    /**
+            Get value of parameter referred to by handle, see SE_GetParameterHandle
+            @param handle Handle of the parameter
+            @param value Pointer to value, type according to parameter declaration (see SE_Parameter)
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_GetParameterByHandle(int handle, void *value);
+
+    /**
+            Set value of parameter referred to by handle, see SE_GetParameterHandle
+            @param handle Handle of the parameter
+            @param value Pointer to value, type according to parameter declaration (see SE_Parameter)
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_SetParameterByHandle(int handle, const void *value);
+
     /**
             Get typed value of named parameter
             @parameterName Name of the parameter
@@ -656,6 +789,31 @@ extern "C"
     */
     SE_DLL_API int SE_GetVariable(SE_Variable *variable);
 
+    /**
+            Get a handle to a named variable, for fast repeated access without name lookup
+            The handle is valid as long as the scenario is loaded. After SE_Close or a new SE_Init
+            it is rejected (the access functions return -1), so fetch new handles after each SE_Init
+            @param variableName Name of the variable
+            @return handle >= 0 if successful, -1 if not found
+    */
+    SE_DLL_API int SE_GetVariableHandle(const char *variableName);
+
+    /**
+            Get value of variable referred to by handle, see SE_GetVariableHandle
+            @param handle Handle of the variable
+            @param value Pointer to value, type according to variable declaration (see SE_Variable)
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_GetVariableByHandle(int handle, void *value);
+
+    /**
+            Set value of variable referred to by handle, see SE_GetVariableHandle
+            @param handle Handle of the variable
+            @param value Pointer to value, type according to variable declaration (see SE_Variable)
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_SetVariableByHandle(int handle, const void *value);
+
     /**
             Get typed value of named variable
             @variableName Name of the variable
@@ -841,6 +999,39 @@ extern "C"
     */
     SE_DLL_API int SE_ReportObjectSpeed(int object_id, float speed);
 
+    /**
+            Report position in cartesian coordinates for multiple objects in one call, see SE_ReportObjectPos().
+            Lookup is fastest when objects are given in the same order as SE_GetId() / SE_GetAllObjectStates()
+            @param n Number of objects, i.e. number of elements in each array
+            @param object_ids Id of each object
+            @param timestamp Timestamp (not really used yet, OK to set 0)
+            @param x X coordinates
+            @param y Y coordinates
+            @param z Z coordinates, set nullptr to ignore, i.e. re-use current values
+            @param h Headings / yaw
+            @param p Pitch, set nullptr to ignore, i.e. re-use current values
+            @param r Roll, set nullptr to ignore, i.e. re-use current values
+            @return 0 if successful, -1 if any object failed (remaining objects are still updated)
+    */
+    SE_DLL_API int SE_ReportObjectPosBatch(int          n,
+                                           const int   *object_ids,
+                                           float        timestamp,
+                                           const float *x,
+                                           const float *y,
+                                           const float *z,
+                                           const float *h,
+                                           const float *p,
+                                           const float *r);
+
+    /**
+            Report longitudinal speed for multiple objects in one call, see SE_ReportObjectSpeed()
+            @param n Number of objects, i.e. number of elements in each array
+            @param object_ids Id of each object
+            @param speed Speed in forward direction of each entity
+            @return 0 if successful, -1 if any object failed (remaining objects are still updated)
+    */
+    SE_DLL_API int SE_ReportObjectSpeedBatch(int n, const int *object_ids, const float *speed);
+
     /**
             Report object lateral position relative road centerline. Useful for an external lateral controller.
             @param object_id Id of the object
@@ -912,6 +1103,39 @@ extern "C"
     */
     SE_DLL_API int SE_ReportObjectWheelStatus(int object_id, float rotation, float angle);
 
+    /**
+            Thread safe version of SE_ReportObjectPos(), for reporting from another thread than the one calling SE_Step().
+            Does not wait for an ongoing step, the position is applied at start of next step. If posted several times
+            in between, the latest one is applied.
+            @param object_id Id of the object
+            @param timestamp Timestamp (not really used yet, OK to set 0)
+            @param x X coordinate
+            @param y Y coordinate
+            @param z Z coordinate, set std::nanf("") to ignore, i.e. re-use current value (#include <cmath>)
+            @param h Heading / yaw
+            @param p Pitch, set std::nanf("") to ignore, i.e. re-use current value (#include <cmath>)
+            @param r Roll, set std::nanf("") to ignore, i.e. re-use current value (#include <cmath>)
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_PostObjectPos(int object_id, float timestamp, float x, float y, float z, float h, float p, float r);
+
+    /**
+            Thread safe version of SE_ReportObjectSpeed(), see SE_PostObjectPos()
+            @param object_id Id of the object
+            @param speed Speed in forward direction of the enitity
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_PostObjectSpeed(int object_id, float speed);
+
+    /**
+            Thread safe version of SE_ReportObjectWheelStatus(), see SE_PostObjectPos()
+            @param object_id Id of the object
+            @param rotation Wheel rotation
+            @param angle Wheel steering angle
+            @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_PostObjectWheelStatus(int object_id, float rotation, float angle);
+
     /**
             Specify which lane types the position object snaps to (is aware of)
             @param object_id Id of the object
@@ -957,6 +1181,13 @@ extern "C"
     */
     SE_DLL_API int SE_GetObjectState(int object_id, SE_ScenarioObjectState *state);
 
+    /**
+            Get the state of all objects in one call, in same order as SE_GetId()
+            @param states Pointer to a SE_StateArrays struct, with capacity and arrays set by the caller
+            @return Total number of objects, which might exceed states->capacity, -1 on error e.g. scenario not initialized
+    */
+    SE_DLL_API int SE_GetAllObjectStates(SE_StateArrays *states);
+
     /**
             Get the overrideActionStatus of specified object
             @param objectId Id of the object
@@ -1447,6 +1678,17 @@ extern "C"
     */
     SE_DLL_API int SE_SaveImagesToFile(int nrOfFrames);
 
+    /**
+    Specify how rendered images are captured, both for SE_SaveImagesToFile() and SE_FetchImage()
+    With more than one buffer, images are read back asynchronously, i.e. without stalling the rendering. Then SE_FetchImage()
+    will not wait for the current frame but return the most recently completed one, nrOfBuffers - 1 frames behind.
+    Saved images are always encoded and written to disk by a background thread.
+    @param nrOfBuffers Number of frames in flight, 1 = synchronous (default), 2 or 3 typically enough for asynchronous mode
+    @param fileFormat File format of saved images: "tga" (default), "png" (uncompressed), "ppm" or "raw" (no header)
+    @return 0 if successful, -1 if not
+    */
+    SE_DLL_API int SE_SetImageCaptureMode(int nrOfBuffers, const char *fileFormat);
+
     /**
     Fetch captured image from RAM (internal memory)
     @param image Pointer/reference to a SE_Image which will be filled in, even image data pointer
@@ -19,6 +19,8 @@
 #include <sstream>
 #include <locale>
 #include <array>
+#include <charconv>
+#include <sys/stat.h>
 
 // UDP network includes
 #ifndef _WIN32
@@ -27,6 +29,8 @@
 #include <arpa/inet.h>
 #include <netdb.h>  /* Needed for getaddrinfo() and freeaddrinfo() */
 #include <unistd.h> /* Needed for close() */
+#include <sys/mman.h>
+#include <fcntl.h>
 #else
 #include <winsock2.h>
 #include <Ws2tcpip.h>
@@ -194,6 +198,52 @@ bool FileExists(const char* fileName)
     return infile.good();
 }
 
+int GetFileStatus(const char* fileName, long long& mod_time, long long& size)
+{
+    struct stat file_status;
+
+    if (stat(fileName, &file_status) != 0)
+    {
+        return -1;
+    }
+
+#if defined(__APPLE__)
+    mod_time = static_cast<long long>(file_status.st_mtimespec.tv_sec) * 1000000000LL + file_status.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+    mod_time = static_cast<long long>(file_status.st_mtime) * 1000000000LL;  // seconds resolution only
+#else
+    mod_time = static_cast<long long>(file_status.st_mtim.tv_sec) * 1000000000LL + file_status.st_mtim.tv_nsec;
+#endif
+    size = static_cast<long long>(file_status.st_size);
+
+    return 0;
+}
+
+unsigned long long FileContentHash(const char* fileName)
+{
+    FILE* file = fopen(fileName, "rb");
+    if (file == nullptr)
+    {
+        return 0;
+    }
+
+    unsigned long long hash = 14695981039346656037ULL;  // FNV offset basis
+    unsigned char      buf[4096];
+    size_t             n;
+
+    while ((n = fread(buf, 1, sizeof(buf), file)) > 0)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            hash ^= buf[i];
+            hash *= 1099511628211ULL;  // FNV prime
+        }
+    }
+    fclose(file);
+
+    return hash;
+}
+
 std::string CombineDirectoryPathAndFilepath(std::string dir_path, std::string file_path)
 {
     std::string path = file_path;
@@ -637,6 +687,42 @@ double strtod(std::string s)
     return atof(s.c_str());
 }
 
+void StrAppendFixed(std::string& str, double value, int decimals)
+{
+    char buf[64];
+#if defined(__cpp_lib_to_chars) || (defined(_MSC_VER) && _MSC_VER >= 1924)
+    std::to_chars_result result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, decimals);
+    if (result.ec == std::errc())
+    {
+        str.append(buf, static_cast<size_t>(result.ptr - buf));
+        return;
+    }
+#endif
+    // fallback for compilers lacking floating point to_chars, or very large numbers
+    int n = snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    if (n < 0)
+    {
+        return;
+    }
+    else if (n < static_cast<int>(sizeof(buf)))
+    {
+        str.append(buf, static_cast<size_t>(n));
+    }
+    else
+    {
+        std::vector<char> large_buf(static_cast<size_t>(n) + 1);
+        snprintf(large_buf.data(), large_buf.size(), "%.*f", decimals, value);
+        str.append(large_buf.data(), static_cast<size_t>(n));
+    }
+}
+
+void StrAppendInt(std::string& str, long long value)
+{
+    char                 buf[24];
+    std::to_chars_result result = std::to_chars(buf, buf + sizeof(buf), value);
+    str.append(buf, static_cast<size_t>(result.ptr - buf));
+}
+
 void StrCopy(char* dest, const char* src, size_t size, bool terminate)
 {
     memcpy(dest, src, size);
@@ -1366,10 +1452,7 @@ CSV_Logger::CSV_Logger() : data_index_(0), callback_(nullptr)
 
 CSV_Logger::~CSV_Logger()
 {
-    if (file_.is_open())
-    {
-        file_.close();
-    }
+    Close();
 
     callback_ = 0;
 }
@@ -1488,7 +1571,16 @@ void CSV_Logger::LogVehicleData(bool        isendline,
                  collisions);
 
     // Add lines horizontally until the endline is reached
-    if (isendline == false)
+    if (async_file_.IsOpen())
+    {
+        async_file_.Write(data_entry, strlen(data_entry));
+        if (isendline)
+        {
+            async_file_.Write("\n", 1);
+            data_index_++;
+        }
+    }
+    else if (isendline == false)
     {
         file_ << data_entry;
     }
@@ -1524,12 +1616,9 @@ void CSV_Logger::SetCallback(FuncPtr callback)
 
 // instantiator
 // Filename and vehicle number are used for dynamic header creation
-void CSV_Logger::Open(std::string scenario_filename, int numvehicles, std::string csv_filename)
+void CSV_Logger::Open(std::string scenario_filename, int numvehicles, std::string csv_filename, bool buffered)
 {
-    if (file_.is_open())
-    {
-        file_.close();
-    }
+    Close();
 
     file_.open(csv_filename);
     if (file_.fail())
@@ -1625,9 +1714,26 @@ void CSV_Logger::Open(std::string scenario_filename, int numvehicles, std::strin
 
     file_.flush();
 
+    if (buffered)
+    {
+        // Header is written, let the background writer append the data rows
+        file_.close();
+        async_file_.Open(csv_filename, true);
+    }
+
     callback_ = 0;
 }
 
+void CSV_Logger::Close()
+{
+    if (file_.is_open())
+    {
+        file_.close();
+    }
+
+    async_file_.Close();
+}
+
 CSV_Logger& CSV_Logger::Inst()
 {
     static CSV_Logger instance_;
@@ -1695,6 +1801,389 @@ void SE_Mutex::Unlock()
 #endif
 }
 
+SE_AsyncFileWriter::SE_AsyncFileWriter(size_t chunk_size, size_t max_pending_chunks)
+    : file_(nullptr),
+      chunk_size_(chunk_size),
+      max_pending_chunks_(max_pending_chunks)
+#if (defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+#else
+      ,
+      quit_(false)
+#endif
+{
+}
+
+SE_AsyncFileWriter::~SE_AsyncFileWriter()
+{
+    Close();
+}
+
+int SE_AsyncFileWriter::Open(const std::string& filename, bool append)
+{
+    Close();
+
+    file_ = FileOpen(filename.c_str(), append ? "ab" : "wb");
+    if (file_ == nullptr)
+    {
+        LOG("Cannot open file: %s", filename.c_str());
+        return -1;
+    }
+
+    buf_.clear();
+    buf_.reserve(chunk_size_);
+
+#if (defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+#else
+    quit_   = false;
+    thread_ = std::thread(&SE_AsyncFileWriter::WriterLoop, this);
+#endif
+
+    return 0;
+}
+
+void SE_AsyncFileWriter::Write(const char* data, size_t size)
+{
+    if (file_ == nullptr)
+    {
+        return;
+    }
+
+    buf_.append(data, size);
+
+    if (buf_.size() >= chunk_size_)
+    {
+        HandOver();
+    }
+}
+
+void SE_AsyncFileWriter::HandOver()
+{
+    if (buf_.empty())
+    {
+        return;
+    }
+
+#if (defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+    fwrite(buf_.data(), 1, buf_.size(), file_);
+    buf_.clear();
+#else
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        // Limit memory usage by waiting for the writer in case it has fallen far behind
+        cv_.wait(lock, [this] { return pending_.size() < max_pending_chunks_; });
+
+        pending_.push_back(std::move(buf_));
+    }
+    cv_.notify_all();
+
+    buf_ = std::string();
+    buf_.reserve(chunk_size_);
+#endif
+}
+
+void SE_AsyncFileWriter::WriterLoop()
+{
+#if (defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+#else
+    std::vector<std::string> chunks;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            cv_.wait(lock, [this] { return !pending_.empty() || quit_; });
+
+            if (pending_.empty())
+            {
+                break;  // quit requested and all data written
+            }
+            chunks.swap(pending_);
+        }
+        cv_.notify_all();
+
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            fwrite(chunks[i].data(), 1, chunks[i].size(), file_);
+        }
+        chunks.clear();
+    }
+#endif
+}
+
+void SE_AsyncFileWriter::Close()
+{
+    if (file_ == nullptr)
+    {
+        return;
+    }
+
+    HandOver();
+
+#if (defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+#else
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+#endif
+
+    fclose(file_);
+    file_ = nullptr;
+}
+
+SE_MappedFile::SE_MappedFile()
+    : data_(nullptr),
+      size_(0),
+#ifdef _WIN32
+      file_(INVALID_HANDLE_VALUE),
+      mapping_(nullptr)
+#else
+      fd_(-1)
+#endif
+{
+}
+
+SE_MappedFile::~SE_MappedFile()
+{
+    Close();
+}
+
+int SE_MappedFile::Open(const std::string& filename)
+{
+    Close();
+
+#ifdef _WIN32
+    file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+        LOG("Cannot open file: %s", filename.c_str());
+        return -1;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_, &file_size))
+    {
+        LOG("Cannot get size of file: %s", filename.c_str());
+        Close();
+        return -1;
+    }
+    size_ = static_cast<size_t>(file_size.QuadPart);
+
+    if (size_ > 0)
+    {
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ != nullptr)
+        {
+            data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        }
+    }
+#else
+    fd_ = open(filename.c_str(), O_RDONLY);
+    if (fd_ < 0)
+    {
+        LOG("Cannot open file: %s", filename.c_str());
+        return -1;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd_, &file_stat) != 0)
+    {
+        LOG("Cannot get size of file: %s", filename.c_str());
+        Close();
+        return -1;
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+
+    if (size_ > 0)
+    {
+        void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (data != MAP_FAILED)
+        {
+            data_ = static_cast<const char*>(data);
+            madvise(data, size_, MADV_SEQUENTIAL);
+        }
+    }
+#endif
+
+    if (size_ > 0 && data_ == nullptr)
+    {
+        LOG("Failed to map file: %s", filename.c_str());
+        Close();
+        return -1;
+    }
+
+    return 0;
+}
+
+void SE_MappedFile::Close()
+{
+#ifdef _WIN32
+    if (data_ != nullptr)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_ != nullptr)
+    {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+    }
+    if (file_ != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (data_ != nullptr)
+    {
+        munmap(const_cast<char*>(data_), size_);
+    }
+    if (fd_ >= 0)
+    {
+        close(fd_);
+        fd_ = -1;
+    }
+#endif
+
+    data_ = nullptr;
+    size_ = 0;
+}
+
+SE_AsyncImageWriter::SE_AsyncImageWriter(size_t max_pending_images)
+    : max_pending_images_(max_pending_images)
+#if (defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+#else
+      ,
+      busy_(false),
+      quit_(false)
+#endif
+{
+}
+
+SE_AsyncImageWriter::~SE_AsyncImageWriter()
+{
+#if (defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+#else
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+#endif
+}
+
+void SE_AsyncImageWriter::Write(const std::string&   filename,
+                                int                  width,
+                                int                  height,
+                                const unsigned char* data,
+                                int                  pixelSize,
+                                int                  pixelFormat,
+                                bool                 upsidedown)
+{
+#if (defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+    SE_WriteImage(filename.c_str(), width, height, data, pixelSize, pixelFormat, upsidedown);
+#else
+    size_t size = static_cast<size_t>(width * height * pixelSize);
+    Image  image;
+
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        // Limit memory usage by waiting for the writer in case it has fallen far behind
+        cv_.wait(lock, [this] { return pending_.size() < max_pending_images_; });
+
+        if (!spare_.empty())
+        {
+            image = std::move(spare_.back());
+            spare_.pop_back();
+        }
+    }
+
+    // Copy outside lock, not to block the writer thread
+    image.filename    = filename;
+    image.width       = width;
+    image.height      = height;
+    image.pixelSize   = pixelSize;
+    image.pixelFormat = pixelFormat;
+    image.upsidedown  = upsidedown;
+    image.data.assign(data, data + size);
+
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        pending_.push_back(std::move(image));
+
+        if (!thread_.joinable())
+        {
+            thread_ = std::thread(&SE_AsyncImageWriter::WriterLoop, this);
+        }
+    }
+    cv_.notify_all();
+#endif
+}
+
+void SE_AsyncImageWriter::Flush()
+{
+#if (defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+#else
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [this] { return pending_.empty() && !busy_; });
+#endif
+}
+
+void SE_AsyncImageWriter::WriterLoop()
+{
+#if (defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+#else
+    std::vector<Image> images;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+
+            // hand back written images for reuse of the buffers
+            for (size_t i = 0; i < images.size() && spare_.size() < max_pending_images_; i++)
+            {
+                spare_.push_back(std::move(images[i]));
+            }
+            images.clear();
+            busy_ = false;
+            cv_.notify_all();
+
+            cv_.wait(lock, [this] { return !pending_.empty() || quit_; });
+
+            if (pending_.empty())
+            {
+                break;  // quit requested and all images written
+            }
+            images.swap(pending_);
+            busy_ = true;
+        }
+        cv_.notify_all();
+
+        for (size_t i = 0; i < images.size(); i++)
+        {
+            Image& img = images[i];
+            if (SE_WriteImage(img.filename.c_str(), img.width, img.height, img.data.data(), img.pixelSize, img.pixelFormat, img.upsidedown) != 0)
+            {
+                LOG("Failed to write image %s", img.filename.c_str());
+            }
+        }
+    }
+#endif
+}
+
 void SE_Option::Usage()
 {
     if (!default_value_.empty())
@@ -2044,6 +2533,190 @@ int SE_WriteTGA(const char* filename, int width, int height, const unsigned char
     return 0;
 }
 
+static uint32_t PNG_CRC(uint32_t crc, const unsigned char* data, size_t size)
+{
+    static uint32_t table[256] = {0};
+
+    if (table[1] == 0)
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+static void PNG_PutU32(std::vector<unsigned char>& buf, uint32_t value)
+{
+    buf.push_back(static_cast<unsigned char>(value >> 24));
+    buf.push_back(static_cast<unsigned char>(value >> 16));
+    buf.push_back(static_cast<unsigned char>(value >> 8));
+    buf.push_back(static_cast<unsigned char>(value));
+}
+
+static void PNG_WriteChunk(FILE* file, const char* type, const std::vector<unsigned char>& data)
+{
+    std::vector<unsigned char> header;
+    PNG_PutU32(header, static_cast<uint32_t>(data.size()));
+    header.insert(header.end(), type, type + 4);
+
+    uint32_t crc = PNG_CRC(0, &header[4], 4);
+    crc          = PNG_CRC(crc, data.data(), data.size());
+
+    std::vector<unsigned char> footer;
+    PNG_PutU32(footer, crc);
+
+    fwrite(header.data(), 1, header.size(), file);
+    fwrite(data.data(), 1, data.size(), file);
+    fwrite(footer.data(), 1, footer.size(), file);
+}
+
+int SE_WritePNG(const char* filename, int width, int height, const unsigned char* data, int pixelSize, int pixelFormat, bool upsidedown)
+{
+    if (pixelSize != 3)
+    {
+        LOG("PNG PixelSize %d not supported yet, only 3", pixelSize);
+        return -2;
+    }
+
+    if (pixelFormat != static_cast<int>(PixelFormat::BGR) && pixelFormat != static_cast<int>(PixelFormat::RGB))
+    {
+        LOG("PNG PixelFormat 0x%x not supported yet, only 0x%x (RGB) and 0x%x (BGR)", pixelFormat, PixelFormat::RGB, PixelFormat::BGR);
+        return -3;
+    }
+
+    FILE* file = FileOpen(filename, "wb");
+
+    if (file == nullptr)
+    {
+        return -1;
+    }
+
+    const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    fwrite(signature, 1, 8, file);
+
+    std::vector<unsigned char> ihdr;
+    PNG_PutU32(ihdr, static_cast<uint32_t>(width));
+    PNG_PutU32(ihdr, static_cast<uint32_t>(height));
+    ihdr.push_back(8);  // bit depth
+    ihdr.push_back(2);  // color type RGB
+    ihdr.push_back(0);  // compression method
+    ihdr.push_back(0);  // filter method
+    ihdr.push_back(0);  // no interlace
+    PNG_WriteChunk(file, "IHDR", ihdr);
+
+    // Image data, each line starting with filter type byte (0 = none)
+    size_t                     line_size = static_cast<size_t>(3 * width + 1);
+    std::vector<unsigned char> raw(line_size * static_cast<size_t>(height));
+    for (int i = 0; i < height; i++)
+    {
+        const unsigned char* src = &data[static_cast<size_t>(pixelSize * width * (upsidedown ? height - i - 1 : i))];
+        unsigned char*       dst = &raw[line_size * static_cast<size_t>(i)];
+
+        dst[0] = 0;
+        if (pixelFormat == static_cast<int>(PixelFormat::RGB))
+        {
+            memcpy(&dst[1], src, static_cast<size_t>(3 * width));
+        }
+        else
+        {
+            for (int j = 0; j < width; j++)
+            {
+                dst[1 + 3 * j]     = src[3 * j + 2];
+                dst[1 + 3 * j + 1] = src[3 * j + 1];
+                dst[1 + 3 * j + 2] = src[3 * j];
+            }
+        }
+    }
+
+    // zlib stream made of uncompressed (stored) deflate blocks, max 65535 bytes each
+    std::vector<unsigned char> idat = {0x78, 0x01};
+    idat.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    uint32_t adler_a = 1, adler_b = 0;
+    size_t   pos     = 0;
+    do
+    {
+        size_t   len  = MIN(raw.size() - pos, static_cast<size_t>(65535));
+        uint16_t len_ = static_cast<uint16_t>(len);
+        uint16_t nlen = static_cast<uint16_t>(~len_);
+        idat.push_back(pos + len >= raw.size() ? 1 : 0);  // final block flag
+        idat.push_back(static_cast<unsigned char>(len_ & 0xFF));
+        idat.push_back(static_cast<unsigned char>(len_ >> 8));
+        idat.push_back(static_cast<unsigned char>(nlen & 0xFF));
+        idat.push_back(static_cast<unsigned char>(nlen >> 8));
+        idat.insert(idat.end(), raw.begin() + static_cast<long>(pos), raw.begin() + static_cast<long>(pos + len));
+
+        for (size_t i = pos; i < pos + len; i++)
+        {
+            adler_a = (adler_a + raw[i]) % 65521;
+            adler_b = (adler_b + adler_a) % 65521;
+        }
+        pos += len;
+    } while (pos < raw.size());
+    PNG_PutU32(idat, (adler_b << 16) | adler_a);
+    PNG_WriteChunk(file, "IDAT", idat);
+
+    PNG_WriteChunk(file, "IEND", std::vector<unsigned char>());
+
+    fclose(file);
+
+    return 0;
+}
+
+int SE_WriteRAW(const char* filename, int width, int height, const unsigned char* data, int pixelSize)
+{
+    FILE* file = FileOpen(filename, "wb");
+
+    if (file == nullptr)
+    {
+        return -1;
+    }
+
+    fwrite(data, static_cast<unsigned int>(width * height * pixelSize), 1, file);
+    fclose(file);
+
+    return 0;
+}
+
+int SE_WriteImage(const char* filename, int width, int height, const unsigned char* data, int pixelSize, int pixelFormat, bool upsidedown)
+{
+    std::string ext = ToLower(FileNameExtOf(filename));
+
+    if (ext == ".tga")
+    {
+        return SE_WriteTGA(filename, width, height, data, pixelSize, pixelFormat, upsidedown);
+    }
+    else if (ext == ".png")
+    {
+        return SE_WritePNG(filename, width, height, data, pixelSize, pixelFormat, upsidedown);
+    }
+    else if (ext == ".ppm")
+    {
+        return SE_WritePPM(filename, width, height, data, pixelSize, pixelFormat, upsidedown);
+    }
+    else if (ext == ".raw")
+    {
+        return SE_WriteRAW(filename, width, height, data, pixelSize);
+    }
+
+    LOG("Unsupported image file format: %s", filename);
+
+    return -4;
+}
+
 int SE_ReadCSVFile(const char* filename, std::vector<std::vector<std::string>>& content, int skip_lines)
 {
     // Cred: https://java2blog.com/read-csv-file-in-cpp/
@@ -21,6 +21,10 @@
 #include <condition_variable>
 #include <cstring>
 #include <map>
+#include <memory>
+#include <type_traits>
+#include <typeindex>
+#include <algorithm>
 
 #ifndef _WIN32
 #include <inttypes.h>
@@ -314,6 +318,20 @@ std::string GetModelFilenameById(int model_id);
 */
 bool FileExists(const char* fileName);
 
+/**
+        Get last modification time and size of file
+        @param mod_time Time in nanoseconds since epoch, actual resolution depends on platform and file system
+        @param size File size in bytes
+        @return 0 on success, -1 if file not found
+*/
+int GetFileStatus(const char* fileName, long long& mod_time, long long& size);
+
+/**
+        Calculate a hash value (64 bit FNV-1a) of the file content, e.g. for keying cached data derived from the file
+        @return Hash value, or 0 if file could not be read
+*/
+unsigned long long FileContentHash(const char* fileName);
+
 /**
         Concatenate a directory path and a file path
 */
@@ -705,6 +723,145 @@ private:
     bool flag;
 };
 
+// File writer handing over data in large chunks to a background thread, so that the calling (simulation)
+// thread never waits for disk I/O. Data is written in the order it was provided. On platforms lacking
+// std::thread support data is written directly instead.
+class SE_AsyncFileWriter
+{
+public:
+    SE_AsyncFileWriter(size_t chunk_size = 1 << 20, size_t max_pending_chunks = 16);
+    ~SE_AsyncFileWriter();
+
+    /**
+        Open file for writing. Any already open file will first be closed.
+        @param filename Path to file
+        @param append If true data will be added to existing file content, else the file is truncated
+        @return 0 on success, -1 if the file could not be opened
+    */
+    int Open(const std::string& filename, bool append = false);
+
+    /**
+        Queue data for writing. Returns immediately unless the writer thread has fallen far behind.
+    */
+    void Write(const char* data, size_t size);
+
+    /**
+        Write any remaining data, stop the writer thread and close the file
+    */
+    void Close();
+
+    bool IsOpen()
+    {
+        return file_ != nullptr;
+    }
+
+private:
+    void HandOver();
+    void WriterLoop();
+
+    FILE*       file_;
+    size_t      chunk_size_;
+    size_t      max_pending_chunks_;
+    std::string buf_;
+#if (defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+#else
+    std::vector<std::string> pending_;
+    bool                     quit_;
+    std::mutex               mtx_;
+    std::condition_variable  cv_;
+    std::thread              thread_;
+#endif
+};
+
+// Read-only memory mapping of a complete file. The operating system pages in content on demand, so large
+// files, e.g. recordings, can be accessed randomly and from multiple threads without reading them into buffers.
+class SE_MappedFile
+{
+public:
+    SE_MappedFile();
+    ~SE_MappedFile();
+
+    /**
+        Map file into memory. Any already mapped file will first be unmapped.
+        @param filename Path to file
+        @return 0 on success, -1 if the file could not be opened or mapped
+    */
+    int Open(const std::string& filename);
+
+    /**
+        Unmap file. Any pointers retrieved from Data() become invalid.
+    */
+    void Close();
+
+    const char* Data()
+    {
+        return data_;
+    }
+
+    size_t Size()
+    {
+        return size_;
+    }
+
+private:
+    const char* data_;
+    size_t      size_;
+#ifdef _WIN32
+    void* file_;
+    void* mapping_;
+#else
+    int fd_;
+#endif
+};
+
+// Image writer encoding and storing images on a background thread, so that the calling (render) thread
+// never waits for encoding or disk I/O. Image data is copied, so the caller can reuse its buffer right away.
+// File format is given by the filename extension, see SE_WriteImage(). On platforms lacking std::thread
+// support images are written directly instead.
+class SE_AsyncImageWriter
+{
+public:
+    SE_AsyncImageWriter(size_t max_pending_images = 8);
+    ~SE_AsyncImageWriter();
+
+    /**
+        Queue image for writing. Returns immediately unless the writer thread has fallen far behind.
+        See SE_WriteTGA() for argument details.
+    */
+    void Write(const std::string& filename, int width, int height, const unsigned char* data, int pixelSize, int pixelFormat, bool upsidedown);
+
+    /**
+        Wait until all queued images have been written
+    */
+    void Flush();
+
+private:
+    typedef struct
+    {
+        std::string                filename;
+        int                        width;
+        int                        height;
+        int                        pixelSize;
+        int                        pixelFormat;
+        bool                       upsidedown;
+        std::vector<unsigned char> data;
+    } Image;
+
+    void WriterLoop();
+
+    size_t max_pending_images_;
+#if (defined WINVER && WINVER == _WIN32_WINNT_WIN7 || __MINGW32__)
+#else
+    std::vector<Image>      pending_;
+    std::vector<Image>      spare_;  // written images kept for reuse of their buffers
+    bool                    busy_;
+    bool                    quit_;
+    std::mutex              mtx_;
+    std::condition_variable cv_;
+    std::thread             thread_;
+#endif
+};
+
 std::vector<std::string> SplitString(const std::string& s, char separator);
 std::string              DirNameOf(const std::string& fname);
 std::string              FileNameOf(const std::string& fname);
@@ -719,6 +876,20 @@ FILE*                    FileOpen(const char* filename, const char* mode);
 int    strtoi(std::string s);
 double strtod(std::string s);
 
+/**
+        Append number in fixed-point notation to string, without locale dependency or temporary allocations.
+        Result is the same as printf("%.<decimals>f"), but considerably faster when converting large amounts of data.
+        @param str String to append to
+        @param value Number to convert
+        @param decimals Number of decimals
+*/
+void StrAppendFixed(std::string& str, double value, int decimals);
+
+/**
+        Append integer to string, see StrAppendFixed()
+*/
+void StrAppendInt(std::string& str, long long value);
+
 /**
         Copy string
         @param dest Destination buffer (resulting copy)
@@ -805,7 +976,13 @@ public:
                         ...);
 
     void SetCallback(FuncPtr callback);
-    void Open(std::string scenario_filename, int numvehicles, std::string csv_filename);
+
+    /**
+        Open CSV file and write header
+        @param buffered If true data rows are handed over to a background writer instead of flushed line by line
+    */
+    void Open(std::string scenario_filename, int numvehicles, std::string csv_filename, bool buffered = false);
+    void Close();
 
 private:
     // Constructor to be called by instantiator
@@ -820,6 +997,9 @@ private:
     // File output stream
     std::ofstream file_;
 
+    // Used instead of file_ for data rows in buffered mode
+    SE_AsyncFileWriter async_file_;
+
     // Callback function pointer for error logging
     FuncPtr callback_;
 };
@@ -1009,6 +1189,217 @@ public:
     }
 };
 
+// Container of simulation state. Filled and read back, in identical order, by the SyncState() functions of
+// storyboard elements, entities, controllers and so on. Plain data is stored as raw bytes and other types as
+// shared immutable copies, so a snapshot can be copied cheaply and restored any number of times. In-memory only.
+// References between objects, e.g. entities and controllers, are stored as indices, see Reference().
+class SE_StateSnapshot
+{
+public:
+    SE_StateSnapshot() : saving_(true), failed_(false), read_pos_(0), read_obj_(0)
+    {
+    }
+
+    /**
+        Discard any content and prepare for saving
+    */
+    void BeginSave()
+    {
+        data_.clear();
+        objects_.clear();
+        saving_ = true;
+        failed_ = false;
+    }
+
+    /**
+        Prepare for restoring content from the beginning
+    */
+    void BeginRestore()
+    {
+        read_pos_ = 0;
+        read_obj_ = 0;
+        saving_   = false;
+        failed_   = false;
+    }
+
+    bool IsSaving() const
+    {
+        return saving_;
+    }
+
+    // Returns true if restore ran out of data or found a value of other type than expected, i.e. the snapshot does not match
+    bool Failed() const
+    {
+        return failed_;
+    }
+
+    // Mark snapshot as not matching, e.g. when a SyncState() function finds inconsistent content
+    void SetFailed()
+    {
+        failed_ = true;
+    }
+
+    size_t GetDataSize() const
+    {
+        return data_.size();
+    }
+
+    /**
+        Save value into, or restore value from, the snapshot depending on mode
+        @param value Variable to save or restore. Non trivially copyable types must be copy constructible and assignable.
+    */
+    template <class T>
+    void Value(T& value)
+    {
+        Value(value, std::integral_constant<bool, std::is_trivially_copyable<T>::value>());
+    }
+
+    /**
+        Register the instances that references of given type may point to, e.g. all entities of the scenario.
+        The same instances, in the same order, must be registered when restoring.
+        @param targets List of instances, must outlive the save or restore operation
+    */
+    template <class T>
+    void SetReferenceTargets(const std::vector<T*>& targets)
+    {
+        targets_[std::type_index(typeid(T))] = &targets;
+    }
+
+    /**
+        Save or restore a reference, stored as index among the registered targets of its type instead of the address
+        @param ptr Pointer to save or restore, may be nullptr
+    */
+    template <class T>
+    void Reference(T*& ptr)
+    {
+        auto                   it      = targets_.find(std::type_index(typeid(T)));
+        const std::vector<T*>* targets = it != targets_.end() ? static_cast<const std::vector<T*>*>(it->second) : nullptr;
+        int                    index   = -1;
+
+        if (saving_ && ptr != nullptr)
+        {
+            if (targets != nullptr)
+            {
+                auto target = std::find(targets->begin(), targets->end(), ptr);
+                if (target != targets->end())
+                {
+                    index = static_cast<int>(target - targets->begin());
+                }
+            }
+
+            if (index == -1)
+            {
+                failed_ = true;  // unknown instance, can't be restored
+            }
+        }
+
+        Value(index);
+
+        if (!saving_ && !failed_)
+        {
+            if (index == -1)
+            {
+                ptr = nullptr;
+            }
+            else if (targets != nullptr && index >= 0 && index < static_cast<int>(targets->size()))
+            {
+                ptr = (*targets)[static_cast<size_t>(index)];
+            }
+            else
+            {
+                failed_ = true;
+            }
+        }
+    }
+
+    /**
+        Save or restore a list of references, see Reference()
+        @param ptrs List of pointers to save or restore
+    */
+    template <class T>
+    void References(std::vector<T*>& ptrs)
+    {
+        size_t n = ptrs.size();
+        Value(n);
+        if (!saving_ && !failed_)
+        {
+            ptrs.resize(n);
+        }
+        for (size_t i = 0; i < n && !failed_; i++)
+        {
+            Reference(ptrs[i]);
+        }
+    }
+
+private:
+    struct HolderBase
+    {
+        virtual ~HolderBase() = default;
+    };
+
+    template <class T>
+    struct Holder : public HolderBase
+    {
+        Holder(const T& value) : value_(value)
+        {
+        }
+        T value_;
+    };
+
+    template <class T>
+    void Value(T& value, std::true_type)
+    {
+        if (saving_)
+        {
+            const char* p = reinterpret_cast<const char*>(&value);
+            data_.insert(data_.end(), p, p + sizeof(T));
+        }
+        else if (failed_ || read_pos_ + sizeof(T) > data_.size())
+        {
+            failed_ = true;
+        }
+        else
+        {
+            memcpy(&value, &data_[read_pos_], sizeof(T));
+            read_pos_ += sizeof(T);
+        }
+    }
+
+    template <class T>
+    void Value(T& value, std::false_type)
+    {
+        if (saving_)
+        {
+            objects_.push_back(std::make_shared<Holder<T>>(value));
+            return;
+        }
+
+        const Holder<T>* holder = nullptr;
+        if (!failed_ && read_obj_ < objects_.size())
+        {
+            holder = dynamic_cast<const Holder<T>*>(objects_[read_obj_].get());
+        }
+
+        if (holder == nullptr)
+        {
+            failed_ = true;
+        }
+        else
+        {
+            value = holder->value_;
+            read_obj_++;
+        }
+    }
+
+    std::vector<char>                              data_;
+    std::vector<std::shared_ptr<const HolderBase>> objects_;
+    std::map<std::type_index, const void*>         targets_;  // registered reference targets per type
+    bool                                           saving_;
+    bool                                           failed_;
+    size_t                                         read_pos_;  // read cursor in data_
+    size_t                                         read_obj_;  // read cursor in objects_
+};
+
 class DampedSpring
 {
 public:
@@ -1158,7 +1549,14 @@ public:
           osiFilePath_(""),
           osiFileEnabled_(false),
           collisionDetection_(false),
+          kpiFilePath_(""),
+          kpiEntityFilePath_(""),
+          stopOnCollision_(false),
+          stopAtTTC_(-1.0),
+          scenarioTemplateMode_(false),
           saveImagesToRAM_(false),
+          imageCaptureBuffers_(1),
+          imageFileFormat_("tga"),
           ghost_mode_(GhostMode::NORMAL),
           ghost_headstart_(0.0)
     {
@@ -1190,6 +1588,69 @@ public:
     {
         return collisionDetection_;
     }
+
+    /**
+            Specify CSV file to which key performance indicators (KPI) of each run are appended, one row per run
+            Set "" to disable
+            Note: Needs to be called prior to calling SE_Init()
+            @param path KPI file path
+    */
+    void SetKPIFilePath(std::string kpiFilePath)
+    {
+        kpiFilePath_ = kpiFilePath;
+    }
+    std::string GetKPIFilePath()
+    {
+        return kpiFilePath_;
+    }
+
+    /**
+            Specify CSV file to which KPIs of each entity are appended, one row per entity and run
+            Set "" to disable
+            Note: Needs to be called prior to calling SE_Init()
+            @param path KPI entity file path
+    */
+    void SetKPIEntityFilePath(std::string kpiEntityFilePath)
+    {
+        kpiEntityFilePath_ = kpiEntityFilePath;
+    }
+    std::string GetKPIEntityFilePath()
+    {
+        return kpiEntityFilePath_;
+    }
+
+    /**
+            Specify criteria for terminating the scenario early, e.g. when the outcome of interest is already known
+            @param stopOnCollision Stop at first collision between any entities
+            @param stopAtTTC Stop when time-to-collision of any entity falls below this value, set < 0 to disable
+    */
+    void SetStopCriteria(bool stopOnCollision, double stopAtTTC)
+    {
+        stopOnCollision_ = stopOnCollision;
+        stopAtTTC_       = stopAtTTC;
+    }
+    bool GetStopOnCollision()
+    {
+        return stopOnCollision_;
+    }
+    double GetStopAtTTC()
+    {
+        return stopAtTTC_;
+    }
+
+    /**
+            Scenario template mode: Keep parsed scenario, catalog files and road network in memory between runs
+            of the same scenario, e.g. parameter permutations, and only re-instantiate entities and storyboard
+            @param mode true=enable, false=disable (and release any kept data at next scenario load)
+    */
+    void SetScenarioTemplateMode(bool mode)
+    {
+        scenarioTemplateMode_ = mode;
+    }
+    bool GetScenarioTemplateMode()
+    {
+        return scenarioTemplateMode_;
+    }
     std::vector<std::string>& GetPaths()
     {
         return paths_;
@@ -1260,6 +1721,25 @@ public:
         return saveImagesToRAM_;
     }
 
+    /**
+            Specify how rendered images are captured
+            @param nrOfBuffers Number of frames in flight for asynchronous read back, 1 = synchronous (image of current frame)
+            @param fileFormat File format of saved images, "tga", "png", "ppm" or "raw"
+    */
+    void SetImageCaptureMode(int nrOfBuffers, std::string fileFormat)
+    {
+        imageCaptureBuffers_ = MAX(1, nrOfBuffers);
+        imageFileFormat_     = fileFormat;
+    }
+    int GetImageCaptureBuffers()
+    {
+        return imageCaptureBuffers_;
+    }
+    std::string GetImageFileFormat()
+    {
+        return imageFileFormat_;
+    }
+
     void        EnableOSIFile(std::string osiFilePath);
     void        DisableOSIFile();
     std::string GetOSIFilePath()
@@ -1318,7 +1798,14 @@ private:
     SE_SystemTime              systemTime_;
     SE_Rand                    rand_;
     bool                       collisionDetection_;
+    std::string                kpiFilePath_;
+    std::string                kpiEntityFilePath_;
+    bool                       stopOnCollision_;
+    double                     stopAtTTC_;
+    bool                       scenarioTemplateMode_;
     bool                       saveImagesToRAM_;
+    int                        imageCaptureBuffers_;
+    std::string                imageFileFormat_;
     std::map<int, std::string> entity_model_map_;
     GhostMode                  ghost_mode_;
     double                     ghost_headstart_;
@@ -1354,6 +1841,34 @@ int SE_WritePPM(const char* filename, int width, int height, const unsigned char
 */
 int SE_WriteTGA(const char* filename, int width, int height, const unsigned char* data, int pixelSize, int pixelFormat, bool upsidedown);
 
+/**
+        Store RGB or BGR (3*8 bits color values) image data as an uncompressed PNG image file
+        Favors speed over size, since no compression is applied. PNG spec: https://www.w3.org/TR/png/
+        @param filename File name including extension which should be ".png", e.g. "img0.png"
+        @param width Width
+        @param height Height
+        @param rgbData Array of color values
+        @param pixelSize 3 (RGB or BGR)
+        @param pixelFormat 0=Unspecified, 0x1907=RGB (GL_RGB), 0x80E0=BGR (GL_BGR)
+        @param upsidedown false=lines stored from top to bottom, true=lines stored from bottom to top
+        @return 0 if OK, -1 if failed to open file, -2 if unexpected pixelSize
+*/
+int SE_WritePNG(const char* filename, int width, int height, const unsigned char* data, int pixelSize, int pixelFormat, bool upsidedown);
+
+/**
+        Store image data as is, without any header or conversion, e.g. for piping frames into a video encoder
+        @param filename File name including extension which should be ".raw", e.g. "img0.raw"
+        @return 0 if OK, -1 if failed to open file
+*/
+int SE_WriteRAW(const char* filename, int width, int height, const unsigned char* data, int pixelSize);
+
+/**
+        Store image data in a file format given by the filename extension: ".tga", ".png", ".ppm" or ".raw"
+        See SE_WriteTGA() for argument details
+        @return 0 if OK, -1 if failed to open file, -2 if unexpected pixelSize, -4 if unsupported file format
+*/
+int SE_WriteImage(const char* filename, int width, int height, const unsigned char* data, int pixelSize, int pixelFormat, bool upsidedown);
+
 /**
         Read a CSV file (comma separated values)
         @param filename File name including extension
@@ -0,0 +1,318 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#ifdef _USE_PROFILER
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "Profiler.hpp"
+#include "CommonMini.hpp"
+
+Profiler& Profiler::Inst()
+{
+    static Profiler instance;
+    return instance;
+}
+
+Profiler::Profiler() : enabled_(false), trace_(false), start_time_(0), n_zones_(0), n_frames_(0), n_events_(0)
+{
+    for (int i = 0; i < PROFILER_MAX_ZONES; i++)
+    {
+        frame_time_[i]     = 0;
+        n_calls_[i]        = 0;
+        total_time_[i]     = 0;
+        max_frame_time_[i] = 0;
+    }
+}
+
+long long Profiler::TimeSinceStart(Clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count() - start_time_.load(std::memory_order_relaxed);
+}
+
+void Profiler::Enable(const std::string& filename)
+{
+    mutex_.Lock();
+
+    // zones are kept, since call sites store their index
+    for (int i = 0; i < PROFILER_MAX_ZONES; i++)
+    {
+        frame_time_[i]     = 0;
+        n_calls_[i]        = 0;
+        total_time_[i]     = 0;
+        max_frame_time_[i] = 0;
+    }
+    for (size_t i = 0; i < threads_.size(); i++)
+    {
+        threads_[i]->mutex.Lock();
+        threads_[i]->events.clear();
+        threads_[i]->mutex.Unlock();
+    }
+    frames_.clear();
+    n_frames_ = 0;
+    n_events_ = 0;
+    filename_ = filename;
+    trace_.store(!filename.empty(), std::memory_order_relaxed);
+    start_time_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count(), std::memory_order_relaxed);
+    enabled_.store(true, std::memory_order_release);
+
+    mutex_.Unlock();
+}
+
+void Profiler::Disable()
+{
+    Trace trace;
+
+    mutex_.Lock();
+
+    if (!enabled_.exchange(false, std::memory_order_acq_rel))
+    {
+        mutex_.Unlock();
+        return;
+    }
+
+    // take the trace, so that it is written without blocking the measured threads
+    if (trace_)
+    {
+        trace.filename = filename_;
+        trace.n_events = n_events_;
+        trace.zone_names.assign(zone_name_, zone_name_ + n_zones_);
+        trace.frames.swap(frames_);
+        for (size_t i = 0; i < threads_.size(); i++)
+        {
+            trace.thread_events.push_back(std::make_pair(threads_[i]->thread_id, std::vector<Event>()));
+            threads_[i]->mutex.Lock();
+            trace.thread_events.back().second.swap(threads_[i]->events);
+            threads_[i]->mutex.Unlock();
+        }
+    }
+
+    mutex_.Unlock();
+
+    LogSummary();
+
+    if (!trace.filename.empty())
+    {
+        WriteTrace(trace);
+    }
+}
+
+int Profiler::RegisterZone(const char* name)
+{
+    int zone = -1;
+
+    mutex_.Lock();
+
+    for (int i = 0; i < n_zones_ && zone < 0; i++)
+    {
+        if (zone_name_[i] == name)
+        {
+            zone = i;
+        }
+    }
+
+    if (zone < 0)
+    {
+        if (n_zones_ < PROFILER_MAX_ZONES)
+        {
+            zone_name_[n_zones_] = name;
+            zone                 = n_zones_++;
+        }
+        else
+        {
+            LOG("Profiler: Max number of zones (%d) reached, skipping %s", PROFILER_MAX_ZONES, name);
+        }
+    }
+
+    mutex_.Unlock();
+
+    return zone;
+}
+
+Profiler::ThreadEvents* Profiler::GetThreadEvents()
+{
+    thread_local ThreadEvents* thread_events = nullptr;
+
+    if (thread_events == nullptr)
+    {
+        mutex_.Lock();
+        threads_.push_back(std::unique_ptr<ThreadEvents>(new ThreadEvents));
+        thread_events            = threads_.back().get();
+        thread_events->thread_id = static_cast<int>(threads_.size());
+        mutex_.Unlock();
+    }
+
+    return thread_events;
+}
+
+void Profiler::Record(int zone, Clock::time_point start, Clock::time_point end)
+{
+    if (zone < 0 || !enabled_.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    long long duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+    frame_time_[zone].fetch_add(duration, std::memory_order_relaxed);
+    n_calls_[zone].fetch_add(1, std::memory_order_relaxed);
+
+    if (trace_.load(std::memory_order_relaxed) && n_events_.fetch_add(1, std::memory_order_relaxed) < PROFILER_MAX_EVENTS)
+    {
+        Event         event;
+        ThreadEvents* thread_events = GetThreadEvents();
+
+        event.zone     = zone;
+        event.start    = TimeSinceStart(start);
+        event.duration = duration;
+
+        // only contended while Enable() or Disable() takes the events
+        thread_events->mutex.Lock();
+        thread_events->events.push_back(event);
+        thread_events->mutex.Unlock();
+    }
+}
+
+void Profiler::EndFrame()
+{
+    if (!enabled_.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    FrameSample sample;
+
+    mutex_.Lock();
+
+    int n_zones = n_zones_;
+
+    sample.time = TimeSinceStart(Clock::now());
+    sample.zone_time.resize(static_cast<size_t>(n_zones));
+
+    for (int i = 0; i < n_zones; i++)
+    {
+        long long time = frame_time_[i].exchange(0, std::memory_order_relaxed);
+
+        total_time_[i] += time;
+        max_frame_time_[i] = MAX(max_frame_time_[i], time);
+        sample.zone_time[static_cast<size_t>(i)] = time;
+    }
+
+    if (trace_ && enabled_)
+    {
+        frames_.push_back(sample);
+    }
+    n_frames_++;
+
+    mutex_.Unlock();
+}
+
+std::vector<ProfileZoneStats> Profiler::GetStats()
+{
+    std::vector<ProfileZoneStats> stats;
+
+    mutex_.Lock();
+
+    for (int i = 0; i < n_zones_; i++)
+    {
+        ProfileZoneStats zone_stats;
+        zone_stats.name           = zone_name_[i];
+        zone_stats.n_calls        = n_calls_[i];
+        zone_stats.total_time     = 1e-9 * static_cast<double>(total_time_[i]);
+        zone_stats.max_frame_time = 1e-9 * static_cast<double>(max_frame_time_[i]);
+        stats.push_back(zone_stats);
+    }
+
+    mutex_.Unlock();
+
+    return stats;
+}
+
+void Profiler::LogSummary()
+{
+    std::vector<ProfileZoneStats> stats    = GetStats();
+    int                           n_frames = n_frames_;
+
+    LOG("Profile: %d frames, time per frame (ms):", n_frames);
+    LOG("Profile: %-40s %10s %10s %10s", "zone", "calls", "avg", "max");
+    for (size_t i = 0; i < stats.size(); i++)
+    {
+        if (stats[i].n_calls == 0)
+        {
+            continue;
+        }
+        LOG("Profile: %-40s %10lld %10.4f %10.4f",
+            stats[i].name.c_str(),
+            stats[i].n_calls,
+            n_frames > 0 ? 1e3 * stats[i].total_time / n_frames : 0.0,
+            1e3 * stats[i].max_frame_time);
+    }
+}
+
+int Profiler::WriteTrace(const Trace& trace)
+{
+    FILE* file = FileOpen(trace.filename.c_str(), "w");
+
+    if (file == nullptr)
+    {
+        LOG("Profiler: Failed to open %s for writing", trace.filename.c_str());
+        return -1;
+    }
+
+    if (trace.n_events > PROFILER_MAX_EVENTS)
+    {
+        LOG("Profiler: Trace limited to first %d of %lld events", PROFILER_MAX_EVENTS, trace.n_events);
+    }
+
+    // Chrome trace event format, timestamps in microseconds
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"esmini\"}}");
+
+    for (size_t i = 0; i < trace.thread_events.size(); i++)
+    {
+        const std::vector<Event>& events = trace.thread_events[i].second;
+
+        for (size_t j = 0; j < events.size(); j++)
+        {
+            fprintf(file,
+                    ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    trace.zone_names[static_cast<size_t>(events[j].zone)].c_str(),
+                    trace.thread_events[i].first,
+                    1e-3 * static_cast<double>(events[j].start),
+                    1e-3 * static_cast<double>(events[j].duration));
+        }
+    }
+
+    // Time per zone and frame as counter, values in ms
+    for (size_t i = 0; i < trace.frames.size(); i++)
+    {
+        const FrameSample& frame = trace.frames[i];
+
+        fprintf(file, ",\n{\"name\":\"frame time (ms)\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{", 1e-3 * static_cast<double>(frame.time));
+        for (size_t j = 0; j < frame.zone_time.size(); j++)
+        {
+            fprintf(file, "%s\"%s\":%.4f", j > 0 ? "," : "", trace.zone_names[j].c_str(), 1e-6 * static_cast<double>(frame.zone_time[j]));
+        }
+        fprintf(file, "}}");
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    LOG("Profiler: Trace written to %s", trace.filename.c_str());
+
+    return 0;
+}
+
+#endif  // _USE_PROFILER
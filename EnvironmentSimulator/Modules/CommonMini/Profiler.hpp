@@ -0,0 +1,186 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+/*
+ * Lightweight scoped timers showing where the time of a frame goes. Put SE_PROFILE_SCOPE("name") first in a block
+ * to measure it. Timers only measure while the profiler is enabled (see --profile option), else the cost is a flag
+ * check. Build with USE_PROFILER=OFF to remove the timers completely.
+ *
+ * Time per zone (name) is summed per frame. The timeline, including per frame sums as counters, can be saved in
+ * Chrome trace event format for viewing in https://ui.perfetto.dev or chrome://tracing.
+ */
+
+#pragma once
+
+#define SE_PROFILE_CONCAT_(a, b) a##b
+#define SE_PROFILE_CONCAT(a, b)  SE_PROFILE_CONCAT_(a, b)
+
+#ifdef _USE_PROFILER
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CommonMini.hpp"
+
+#define PROFILER_MAX_ZONES  64
+#define PROFILER_MAX_EVENTS 10000000  // timeline events, beyond this only frame statistics are collected
+
+struct ProfileZoneStats
+{
+    std::string name;
+    long long   n_calls;
+    double      total_time;      // (s)
+    double      max_frame_time;  // max time spent in the zone during a single frame (s)
+};
+
+class Profiler
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    static Profiler& Inst();
+
+    /**
+        Reset statistics and start measuring
+        @param filename Trace file written by Disable(), empty for statistics only
+    */
+    void Enable(const std::string& filename);
+
+    /**
+        Stop measuring, log summary and write any trace file. Timers ending after this call are dropped.
+    */
+    void Disable();
+
+    bool IsEnabled()
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+        Find zone by name, or add it. Called once per call site, see SE_PROFILE_SCOPE.
+        @return Zone index, -1 if too many zones
+    */
+    int RegisterZone(const char* name);
+
+    void Record(int zone, Clock::time_point start, Clock::time_point end);
+
+    /**
+        Add the time spent in each zone since last call to the frame statistics and the trace
+    */
+    void EndFrame();
+
+    int GetNumberOfFrames()
+    {
+        return n_frames_.load(std::memory_order_relaxed);
+    }
+    std::vector<ProfileZoneStats> GetStats();
+    void                          LogSummary();
+
+private:
+    struct Event
+    {
+        int       zone;
+        long long start;  // (ns) since Enable()
+        long long duration;
+    };
+
+    struct ThreadEvents
+    {
+        int                thread_id;
+        SE_Mutex           mutex;  // owning thread appends, Enable() and Disable() take the events
+        std::vector<Event> events;
+    };
+
+    struct FrameSample
+    {
+        long long              time;
+        std::vector<long long> zone_time;
+    };
+
+    // Copy of the trace, taken under the locks by Disable() and written to file after releasing them
+    struct Trace
+    {
+        std::string                                     filename;
+        std::vector<std::string>                        zone_names;
+        std::vector<std::pair<int, std::vector<Event>>> thread_events;  // thread id and events
+        std::vector<FrameSample>                        frames;
+        long long                                       n_events;
+    };
+
+    Profiler();
+    long long     TimeSinceStart(Clock::time_point time);
+    ThreadEvents* GetThreadEvents();
+    int           WriteTrace(const Trace& trace);
+
+    std::atomic<bool>                          enabled_;
+    std::atomic<bool>                          trace_;       // collect timeline events, i.e. trace file given
+    std::atomic<long long>                     start_time_;  // (ns) since clock epoch
+    std::string                                filename_;
+    SE_Mutex                                   mutex_;  // protects zone registration, the thread list and frame data
+    std::string                                zone_name_[PROFILER_MAX_ZONES];
+    std::atomic<int>                           n_zones_;
+    std::atomic<long long>                     frame_time_[PROFILER_MAX_ZONES];  // time (ns) per zone in current frame
+    std::atomic<long long>                     n_calls_[PROFILER_MAX_ZONES];
+    long long                                  total_time_[PROFILER_MAX_ZONES];
+    long long                                  max_frame_time_[PROFILER_MAX_ZONES];
+    std::atomic<int>                           n_frames_;
+    std::atomic<long long>                     n_events_;
+    std::vector<std::unique_ptr<ThreadEvents>> threads_;  // kept when threads exit, for the trace
+    std::vector<FrameSample>                   frames_;
+};
+
+class ProfileScope
+{
+public:
+    ProfileScope(int zone, bool end_frame = false) : zone_(zone), end_frame_(end_frame), enabled_(Profiler::Inst().IsEnabled())
+    {
+        if (enabled_)
+        {
+            start_ = Profiler::Clock::now();
+        }
+    }
+
+    ~ProfileScope()
+    {
+        if (enabled_)
+        {
+            Profiler::Inst().Record(zone_, start_, Profiler::Clock::now());
+            if (end_frame_)
+            {
+                Profiler::Inst().EndFrame();
+            }
+        }
+    }
+
+private:
+    int                         zone_;
+    bool                        end_frame_;
+    bool                        enabled_;
+    Profiler::Clock::time_point start_;
+};
+
+// Measure time until end of the enclosing block
+#define SE_PROFILE_SCOPE(name)                                                                              \
+    static const int SE_PROFILE_CONCAT(profile_zone_, __LINE__) = Profiler::Inst().RegisterZone(name); \
+    ProfileScope     SE_PROFILE_CONCAT(profile_scope_, __LINE__)(SE_PROFILE_CONCAT(profile_zone_, __LINE__))
+
+// Same as SE_PROFILE_SCOPE, in addition closing the frame at end of the block, see Profiler::EndFrame()
+#define SE_PROFILE_FRAME(name)                                                                              \
+    static const int SE_PROFILE_CONCAT(profile_zone_, __LINE__) = Profiler::Inst().RegisterZone(name); \
+    ProfileScope     SE_PROFILE_CONCAT(profile_scope_, __LINE__)(SE_PROFILE_CONCAT(profile_zone_, __LINE__), true)
+#else
+#define SE_PROFILE_SCOPE(name)
+#define SE_PROFILE_FRAME(name)
+#endif
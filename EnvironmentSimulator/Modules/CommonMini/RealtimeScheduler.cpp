@@ -0,0 +1,158 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
+#include "RealtimeScheduler.hpp"
+#include "CommonMini.hpp"
+#include "Profiler.hpp"
+
+RealtimeScheduler::RealtimeScheduler(double period, int cpu) : period_(period), cpu_(cpu), started_(false), exec_time_sum_(0.0)
+{
+    period_duration_ = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(period));
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+int RealtimeScheduler::Start()
+{
+    int retval = 0;
+
+#ifdef _WIN32
+    if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+    {
+        LOG("Realtime scheduler: Failed to raise thread priority, continuing with normal priority");
+        retval = -1;
+    }
+    if (cpu_ >= 0 && SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu_) == 0)
+    {
+        LOG("Realtime scheduler: Failed to pin thread to CPU %d", cpu_);
+        retval = -1;
+    }
+#else
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = RT_SCHED_PRIORITY;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0)
+    {
+        LOG("Realtime scheduler: SCHED_FIFO not permitted (needs CAP_SYS_NICE or rtprio limit), continuing with normal priority");
+        retval = -1;
+    }
+#ifdef __linux__
+    if (cpu_ >= 0)
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(static_cast<size_t>(cpu_), &cpu_set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0)
+        {
+            LOG("Realtime scheduler: Failed to pin thread to CPU %d", cpu_);
+            retval = -1;
+        }
+    }
+#else
+    if (cpu_ >= 0)
+    {
+        LOG("Realtime scheduler: CPU pinning not supported on this platform");
+        retval = -1;
+    }
+#endif
+#endif
+
+    frame_start_ = Clock::now();
+    deadline_    = frame_start_ + period_duration_;
+    started_     = true;
+
+    LOG("Realtime scheduler started, period %.3f ms%s", 1e3 * period_, retval == 0 ? "" : " (limited, see above)");
+
+    return retval;
+}
+
+void RealtimeScheduler::WaitForNextFrame()
+{
+    SE_PROFILE_SCOPE("RealtimeScheduler::WaitForNextFrame");
+
+    if (!started_)
+    {
+        Start();
+        return;
+    }
+
+    Clock::time_point now       = Clock::now();
+    double            exec_time = std::chrono::duration<double>(now - frame_start_).count();
+
+    stats_.exec_time_min = stats_.n_frames == 0 ? exec_time : MIN(stats_.exec_time_min, exec_time);
+    stats_.exec_time_max = MAX(stats_.exec_time_max, exec_time);
+    exec_time_sum_ += exec_time;
+    stats_.n_frames++;
+    stats_.exec_time_avg = exec_time_sum_ / stats_.n_frames;
+    stats_.exec_time_histogram[MIN(static_cast<int>(10 * exec_time / period_), RT_HISTOGRAM_BINS - 1)]++;
+
+    if (now > deadline_)
+    {
+        // Overrun, skip to first deadline still ahead
+        stats_.n_deadline_misses++;
+        deadline_ += period_duration_ * ((now - deadline_) / period_duration_ + 1);
+    }
+
+#ifdef __linux__
+    // Absolute deadline, steady_clock is CLOCK_MONOTONIC
+    long long       ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline_.time_since_epoch()).count();
+    struct timespec ts;
+    ts.tv_sec  = static_cast<time_t>(ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+    {
+        // interrupted by signal, continue sleeping
+    }
+#else
+    std::this_thread::sleep_until(deadline_);
+#endif
+
+    frame_start_              = Clock::now();
+    stats_.wakeup_latency_max = MAX(stats_.wakeup_latency_max, std::chrono::duration<double>(frame_start_ - deadline_).count());
+    deadline_ += period_duration_;
+}
+
+RealtimeStats RealtimeScheduler::GetStats()
+{
+    return stats_;
+}
+
+void RealtimeScheduler::LogSummary()
+{
+    std::string histogram;
+
+    for (int i = 0; i < RT_HISTOGRAM_BINS; i++)
+    {
+        histogram += (i > 0 ? " " : "") + std::to_string(stats_.exec_time_histogram[i]);
+    }
+
+    LOG("Realtime: %d frames, period %.3f ms, %d deadline misses, execution time min/avg/max %.3f/%.3f/%.3f ms, max wake up latency %.3f ms",
+        stats_.n_frames,
+        1e3 * period_,
+        stats_.n_deadline_misses,
+        1e3 * stats_.exec_time_min,
+        1e3 * stats_.exec_time_avg,
+        1e3 * stats_.exec_time_max,
+        1e3 * stats_.wakeup_latency_max);
+    LOG("Realtime: execution time histogram, frames per 10%% of period (last bin > 100%%): %s", histogram.c_str());
+}
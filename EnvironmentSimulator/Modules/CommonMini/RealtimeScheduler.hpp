@@ -0,0 +1,85 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+/*
+ * Paces a loop to a fixed period using absolute deadlines, so that timing errors don't accumulate, and collects
+ * statistics on execution time and missed deadlines. The thread running the loop is given realtime priority
+ * (SCHED_FIFO on Linux/POSIX, time critical on Windows) and optionally pinned to a CPU core, when permitted.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#define RT_HISTOGRAM_BINS 11  // execution time per 10% of period, last bin for overruns
+#define RT_SCHED_PRIORITY 80  // SCHED_FIFO priority, 1 (low) - 99 (high)
+
+struct RealtimeStats
+{
+    int    n_frames;
+    int    n_deadline_misses;  // frames not finished within their period
+    double exec_time_min;      // execution time (s), from wake up until start of next wait
+    double exec_time_avg;
+    double exec_time_max;
+    double wakeup_latency_max;  // max delay from deadline until the thread actually woke up (s)
+    int    exec_time_histogram[RT_HISTOGRAM_BINS];
+};
+
+class RealtimeScheduler
+{
+public:
+    /**
+        @param period Frame period (s)
+        @param cpu Core to pin the thread to, -1 for no pinning
+    */
+    RealtimeScheduler(double period, int cpu = -1);
+
+    /**
+        Apply priority and CPU affinity to the calling thread and set first deadline one period from now.
+        Failing to get realtime priority, e.g. due to missing privileges, is logged and the scheduler continues with
+        normal priority.
+        @return 0 if realtime priority and any pinning was applied, else -1
+    */
+    int Start();
+
+    bool Started()
+    {
+        return started_;
+    }
+
+    /**
+        End current frame: record its execution time and sleep until its deadline. After a missed deadline the next
+        deadline is moved forward to the first one still ahead, i.e. frames are skipped rather than squeezed together.
+    */
+    void WaitForNextFrame();
+
+    double GetPeriod()
+    {
+        return period_;
+    }
+
+    RealtimeStats GetStats();
+    void          LogSummary();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    double            period_;
+    int               cpu_;
+    bool              started_;
+    Clock::duration   period_duration_;
+    Clock::time_point deadline_;
+    Clock::time_point frame_start_;
+    RealtimeStats     stats_;
+    double            exec_time_sum_;
+};
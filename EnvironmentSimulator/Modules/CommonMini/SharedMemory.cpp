@@ -0,0 +1,250 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#endif
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "SharedMemory.hpp"
+#include "CommonMini.hpp"
+
+#define SHM_RING_MAGIC   0x45534D52  // "ESMR"
+#define SHM_RING_VERSION 1
+
+// Layout of the shared memory. Zero initialized by the server, ready for clients once magic is set.
+// Counters are free running and wrap around, slot index is counter modulo number of slots.
+struct ShmRing
+{
+    std::atomic<uint32_t> magic;
+    uint32_t              version;
+    std::atomic<uint32_t> closed;                   // set by the server when shutting down
+    alignas(64) std::atomic<uint32_t> write_count;  // number of messages written, also futex word
+    std::atomic<uint32_t> waiting;                  // receiver is about to wait, or waiting, for write_count to change
+    alignas(64) std::atomic<uint32_t> read_count;   // number of messages read
+    struct
+    {
+        alignas(64) uint32_t size;
+        char data[SHM_RING_SLOT_SIZE];
+    } slot[SHM_RING_SLOTS];
+};
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "atomic counter must be usable as futex word");
+
+#ifdef __linux__
+static void FutexWait(std::atomic<uint32_t>* addr, uint32_t value, long long timeout_ns)
+{
+    struct timespec ts;
+    ts.tv_sec  = static_cast<time_t>(timeout_ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(timeout_ns % 1000000000);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT, value, &ts, nullptr, 0);
+}
+
+static void FutexWake(std::atomic<uint32_t>* addr)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+#endif
+
+int SharedMemoryBase::Map(bool create)
+{
+#ifdef _WIN32
+    (void)create;
+    LOG("Shared memory transport not supported on Windows");
+    return -1;
+#else
+    int fd = -1;
+
+    if (create)
+    {
+        shm_unlink(name_.c_str());  // remove any stale instance, e.g. after a crash
+        fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0 || ftruncate(fd, static_cast<off_t>(sizeof(ShmRing))) != 0)
+        {
+            LOG("Failed to create shared memory %s", name_.c_str());
+            if (fd >= 0)
+            {
+                close(fd);
+                shm_unlink(name_.c_str());
+            }
+            return -1;
+        }
+    }
+    else
+    {
+        struct stat file_stat;
+        fd = shm_open(name_.c_str(), O_RDWR, 0);
+        if (fd < 0)
+        {
+            return -1;  // not created yet, quietly try again later
+        }
+        if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(ShmRing))
+        {
+            close(fd);
+            return -1;
+        }
+    }
+
+    void* addr = mmap(nullptr, sizeof(ShmRing), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);  // mapping stays valid
+
+    if (addr == MAP_FAILED)
+    {
+        LOG("Failed to map shared memory %s", name_.c_str());
+        return -1;
+    }
+
+    ring_ = static_cast<ShmRing*>(addr);
+
+    if (create)
+    {
+        ring_->version = SHM_RING_VERSION;
+        ring_->magic.store(SHM_RING_MAGIC);
+    }
+    else if (ring_->magic.load() != SHM_RING_MAGIC || ring_->version != SHM_RING_VERSION)
+    {
+        Unmap();
+        return -1;
+    }
+
+    return 0;
+#endif
+}
+
+void SharedMemoryBase::Unmap()
+{
+#ifndef _WIN32
+    if (ring_ != nullptr)
+    {
+        munmap(ring_, sizeof(ShmRing));
+        ring_ = nullptr;
+    }
+#endif
+}
+
+SharedMemoryServer::SharedMemoryServer(std::string name, unsigned int timeoutMs) : SharedMemoryBase(name), timeoutMs_(timeoutMs)
+{
+    Map(true);
+}
+
+SharedMemoryServer::~SharedMemoryServer()
+{
+#ifndef _WIN32
+    if (ring_ != nullptr)
+    {
+        ring_->closed.store(1);  // make clients re-attach, in case a new server is started
+        Unmap();
+        shm_unlink(name_.c_str());
+    }
+#endif
+}
+
+int SharedMemoryServer::Receive(char* buf, unsigned int size)
+{
+    if (ring_ == nullptr)
+    {
+        return -1;
+    }
+
+    uint32_t read_count  = ring_->read_count.load(std::memory_order_relaxed);
+    uint32_t write_count = ring_->write_count.load(std::memory_order_acquire);
+
+    if (write_count == read_count && timeoutMs_ > 0)
+    {
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs_);
+
+        // Announce waiting before checking counter a last time, so that the sender can't miss to wake us up
+        ring_->waiting.store(1);
+        while ((write_count = ring_->write_count.load()) == read_count)
+        {
+            long long remaining_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (remaining_ns <= 0)
+            {
+                break;
+            }
+#ifdef __linux__
+            FutexWait(&ring_->write_count, write_count, remaining_ns);
+#else
+            usleep(50);
+#endif
+        }
+        ring_->waiting.store(0);
+    }
+
+    if (write_count == read_count)
+    {
+        return -1;
+    }
+
+    unsigned int slot_size = ring_->slot[read_count % SHM_RING_SLOTS].size;
+    unsigned int n         = MIN(slot_size, size);
+    memcpy(buf, ring_->slot[read_count % SHM_RING_SLOTS].data, n);
+    ring_->read_count.store(read_count + 1, std::memory_order_release);
+
+    return static_cast<int>(n);
+}
+
+SharedMemoryClient::SharedMemoryClient(std::string name) : SharedMemoryBase(name)
+{
+    Map(false);
+}
+
+int SharedMemoryClient::Send(char* buf, unsigned int size)
+{
+    if (size > SHM_RING_SLOT_SIZE)
+    {
+        LOG_ONCE("Shared memory message too large: %d bytes (max %d)", size, SHM_RING_SLOT_SIZE);
+        return -1;
+    }
+
+    if (ring_ != nullptr && ring_->closed.load())
+    {
+        Unmap();  // server gone, attach to any new one
+    }
+
+    if (ring_ == nullptr && Map(false) != 0)
+    {
+        return -1;
+    }
+
+    uint32_t write_count = ring_->write_count.load(std::memory_order_relaxed);
+    if (write_count - ring_->read_count.load(std::memory_order_acquire) >= SHM_RING_SLOTS)
+    {
+        return -1;  // full
+    }
+
+    ring_->slot[write_count % SHM_RING_SLOTS].size = size;
+    memcpy(ring_->slot[write_count % SHM_RING_SLOTS].data, buf, size);
+    ring_->write_count.store(write_count + 1);
+
+#ifdef __linux__
+    if (ring_->waiting.load())
+    {
+        FutexWake(&ring_->write_count);
+    }
+#endif
+
+    return static_cast<int>(size);
+}
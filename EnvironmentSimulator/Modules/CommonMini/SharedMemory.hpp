@@ -0,0 +1,104 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+/*
+ * Local alternative to UDP for sending messages between processes on the same host. Messages are passed through a
+ * single producer, single consumer ring buffer in named POSIX shared memory, avoiding kernel round trips for each
+ * message. A waiting receiver is woken by futex (Linux), on other POSIX platforms the receiver polls.
+ * Same interface as UDPServer and UDPClient. Not supported on Windows.
+ */
+
+#pragma once
+
+#include <string>
+
+#define ESMINI_DEFAULT_SHM_NAME "/esmini_server"
+#define SHM_RING_SLOTS          64   // max number of queued messages
+#define SHM_RING_SLOT_SIZE      512  // max message size (bytes)
+
+struct ShmRing;
+
+class SharedMemoryBase
+{
+public:
+    int GetStatus()
+    {
+        return ring_ == nullptr ? -1 : 0;
+    }  // -1 = NOK, 0 = OK
+
+    std::string GetName()
+    {
+        return name_;
+    }
+
+protected:
+    SharedMemoryBase(std::string name) : name_(name), ring_(nullptr)
+    {
+    }
+    ~SharedMemoryBase()
+    {
+        Unmap();
+    }
+    int  Map(bool create);
+    void Unmap();
+
+    std::string name_;
+    ShmRing*    ring_;
+};
+
+class SharedMemoryServer : public SharedMemoryBase
+{
+public:
+    /**
+        Create shared memory ring buffer. Any existing one with same name is replaced.
+        @param name Name of the shared memory object, e.g. "/esmini_server"
+        @param timeoutMs Max time to wait for a message in Receive(), 0 = don't wait
+    */
+    SharedMemoryServer(std::string name, unsigned int timeoutMs = 500);
+    ~SharedMemoryServer();
+
+    /**
+        Fetch oldest message, waiting for it up to the timeout if none is queued
+        @param buf Destination buffer
+        @param size Size of buf, longer messages are truncated
+        @return Size of received message, -1 if no message
+    */
+    int          Receive(char* buf, unsigned int size);
+    unsigned int GetTimeout()
+    {
+        return timeoutMs_;
+    }
+
+private:
+    unsigned int timeoutMs_;
+};
+
+class SharedMemoryClient : public SharedMemoryBase
+{
+public:
+    /**
+        Attach to shared memory ring buffer. If not yet created by the server, attaching is retried at each Send().
+        @param name Name of the shared memory object, e.g. "/esmini_server"
+    */
+    SharedMemoryClient(std::string name);
+    ~SharedMemoryClient()
+    {
+    }
+
+    /**
+        Queue message and wake up any waiting receiver
+        @param buf Message
+        @param size Size of message, max SHM_RING_SLOT_SIZE
+        @return Size of sent message, -1 if not sent, e.g. server not available or ring buffer full
+    */
+    int Send(char* buf, unsigned int size);
+};
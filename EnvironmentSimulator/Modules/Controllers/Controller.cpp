@@ -92,6 +92,12 @@ void Controller::Step(double timeStep)
     }
 }
 
+void Controller::SyncState(SE_StateSnapshot& state)
+{
+    state.Value(active_domains_);
+    state.Value(mode_);
+}
+
 void Controller::LinkObject(Object* object)
 {
     object_ = object;
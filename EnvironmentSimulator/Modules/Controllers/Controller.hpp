@@ -117,6 +117,9 @@ namespace scenarioengine
         // Base class Step function should be called from derived classes
         virtual void Step(double timeStep);
 
+        // Save or restore dynamic state. Derived classes with internal state should extend and call base class function
+        virtual void SyncState(SE_StateSnapshot& state);
+
         bool Active()
         {
             return (active_domains_ != static_cast<unsigned int>(ControlDomains::DOMAIN_NONE));
@@ -209,6 +209,16 @@ void ControllerACC::Step(double timeStep)
     Controller::Step(timeStep);
 }
 
+void ControllerACC::SyncState(SE_StateSnapshot& state)
+{
+    Controller::SyncState(state);
+    state.Value(vehicle_);
+    state.Value(active_);
+    state.Value(setSpeed_);
+    state.Value(currentSpeed_);
+    state.Value(setSpeedSet_);
+}
+
 int ControllerACC::Activate(ControlActivationMode lat_activation_mode,
                             ControlActivationMode long_activation_mode,
                             ControlActivationMode light_activation_mode,
@@ -46,6 +46,7 @@ namespace scenarioengine
         void Init();
         void InitPostPlayer();
         void Step(double timeStep);
+        void SyncState(SE_StateSnapshot& state) override;
         int  Activate(ControlActivationMode lat_activation_mode,
                       ControlActivationMode long_activation_mode,
                       ControlActivationMode light_activation_mode,
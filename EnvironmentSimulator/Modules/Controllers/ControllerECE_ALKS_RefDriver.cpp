@@ -475,6 +475,21 @@ void ControllerECE_ALKS_REF_DRIVER::Step(double timeStep)
     Controller::Step(timeStep);
 }
 
+void ControllerECE_ALKS_REF_DRIVER::SyncState(SE_StateSnapshot& state)
+{
+    Controller::SyncState(state);
+    state.Value(vehicle_);
+    state.Value(active_);
+    state.Value(setSpeed_);
+    state.Value(currentSpeed_);
+    state.Value(dtFreeCutOut_);
+    state.Value(cutInDetected_);
+    state.Value(waitTime_);
+    state.Value(driverBraking_);
+    state.Value(aebBraking_);
+    state.Value(timeSinceBraking_);
+}
+
 int ControllerECE_ALKS_REF_DRIVER::Activate(ControlActivationMode lat_activation_mode,
                                             ControlActivationMode long_activation_mode,
                                             ControlActivationMode light_activation_mode,
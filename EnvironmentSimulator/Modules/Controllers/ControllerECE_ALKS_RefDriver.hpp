@@ -48,6 +48,7 @@ namespace scenarioengine
 
         void Init();
         void Step(double timeStep);
+        void SyncState(SE_StateSnapshot& state) override;
         int  Activate(ControlActivationMode lat_activation_mode,
                       ControlActivationMode long_activation_mode,
                       ControlActivationMode light_activation_mode,
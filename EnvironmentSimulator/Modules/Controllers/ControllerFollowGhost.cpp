@@ -238,6 +238,12 @@ void ControllerFollowGhost::Step(double timeStep)
     Controller::Step(timeStep);
 }
 
+void ControllerFollowGhost::SyncState(SE_StateSnapshot& state)
+{
+    Controller::SyncState(state);
+    state.Value(vehicle_);
+}
+
 int ControllerFollowGhost::Activate(ControlActivationMode lat_activation_mode,
                                     ControlActivationMode long_activation_mode,
                                     ControlActivationMode light_activation_mode,
@@ -123,6 +123,39 @@ void ControllerFollowRoute::Step(double timeStep)
     Controller::Step(timeStep);
 }
 
+void ControllerFollowRoute::SyncState(SE_StateSnapshot &state)
+{
+    Controller::SyncState(state);
+    state.Value(vehicle_);
+    state.Value(waypoints_);
+    state.Value(currentWaypointIndex_);
+    state.Value(scenarioWaypointIndex_);
+    state.Value(changingLane_);
+    state.Value(pathCalculated_);
+    state.Value(allWaypoints_);
+
+    // Any ongoing lane change is owned by the controller, recreate it if needed before restoring its state
+    bool changing = laneChangeAction_ != nullptr;
+    int  lane     = changing ? static_cast<LatLaneChangeAction *>(laneChangeAction_)->target_->value_ : 0;
+    state.Value(changing);
+    state.Value(lane);
+
+    if (!state.IsSaving())
+    {
+        delete laneChangeAction_;
+        laneChangeAction_ = nullptr;
+        if (changing)
+        {
+            CreateLaneChange(lane);
+        }
+    }
+
+    if (laneChangeAction_ != nullptr)
+    {
+        laneChangeAction_->SyncState(state);
+    }
+}
+
 int ControllerFollowRoute::Activate(ControlActivationMode lat_activation_mode,
                                     ControlActivationMode long_activation_mode,
                                     ControlActivationMode light_activation_mode,
@@ -195,7 +228,10 @@ void ControllerFollowRoute::UpdateWaypoints(roadmanager::Position vehiclePos, ro
 
 void ControllerFollowRoute::CalculateWaypoints()
 {
-    roadmanager::LaneIndependentRouter router(odr_);
+    if (router_ == nullptr)
+    {
+        router_ = std::make_shared<roadmanager::LaneIndependentRouter>(odr_);
+    }
 
     roadmanager::Position startPos  = object_->pos_;
     roadmanager::Position targetPos = object_->pos_.GetRoute()->scenario_waypoints_[static_cast<unsigned int>(scenarioWaypointIndex_)];
@@ -213,7 +249,7 @@ void ControllerFollowRoute::CalculateWaypoints()
         targetPos = object_->pos_.GetRoute()->scenario_waypoints_[static_cast<unsigned int>(scenarioWaypointIndex_)];
     }
 
-    std::vector<roadmanager::Node> pathToGoal = router.CalculatePath(startPos, targetPos);
+    std::vector<roadmanager::Node> pathToGoal = router_->CalculatePath(startPos, targetPos);
     if (pathToGoal.empty())
     {
         LOG("Error: Path not found, deactivating controller");
@@ -221,7 +257,7 @@ void ControllerFollowRoute::CalculateWaypoints()
     }
     else
     {
-        waypoints_ = router.GetWaypoints(pathToGoal, startPos, targetPos);
+        waypoints_ = router_->GetWaypoints(pathToGoal, startPos, targetPos);
 
         object_->pos_.GetRoute()->minimal_waypoints_.clear();
         object_->pos_.GetRoute()->minimal_waypoints_ = {waypoints_[0], waypoints_[1]};
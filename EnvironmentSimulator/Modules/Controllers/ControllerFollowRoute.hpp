@@ -19,12 +19,18 @@
 #include "Entities.hpp"
 #include "vehicle.hpp"
 #include <queue>
+#include <memory>
 
 // Enable test mode, which stops the vehicle when reaching a target
 // or in case of path not found
 
 #define CONTROLLER_FOLLOW_ROUTE_TYPE_NAME "FollowRouteController"
 
+namespace roadmanager
+{
+    class LaneIndependentRouter;
+}
+
 namespace scenarioengine
 {
     typedef enum
@@ -59,6 +65,7 @@ namespace scenarioengine
 
         void Init();
         void Step(double timeStep);
+        void SyncState(SE_StateSnapshot &state) override;
         int  Activate(ControlActivationMode lat_activation_mode,
                       ControlActivationMode long_activation_mode,
                       ControlActivationMode light_activation_mode,
@@ -159,6 +166,8 @@ namespace scenarioengine
         double                             minDistForCollision_ = 10;
         double                             minLaneWidth_        = 0.5;
         bool                               testMode_;
+
+        std::shared_ptr<roadmanager::LaneIndependentRouter> router_;  // kept between path calculations, reusing search buffers
     };
 
     Controller *InstantiateControllerFollowRoute(void *args);
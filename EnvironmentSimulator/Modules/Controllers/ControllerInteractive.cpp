@@ -110,6 +110,12 @@ void ControllerInteractive::Step(double timeStep)
     Controller::Step(timeStep);
 }
 
+void ControllerInteractive::SyncState(SE_StateSnapshot& state)
+{
+    Controller::SyncState(state);
+    state.Value(vehicle_);
+}
+
 int ControllerInteractive::Activate(ControlActivationMode lat_activation_mode,
                                     ControlActivationMode long_activation_mode,
                                     ControlActivationMode light_activation_mode,
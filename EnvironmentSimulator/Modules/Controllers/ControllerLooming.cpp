@@ -419,6 +419,21 @@ void ControllerLooming::Step(double timeStep)
     Controller::Step(timeStep);
 }
 
+void ControllerLooming::SyncState(SE_StateSnapshot& state)
+{
+    Controller::SyncState(state);
+    state.Value(vehicle_);
+    state.Value(active_);
+    state.Value(setSpeed_);
+    state.Value(currentSpeed_);
+    state.Value(setSpeedSet_);
+    state.Value(prevNearAngle);
+    state.Value(prevFarAngle);
+    state.Value(steering);
+    state.Value(acc);
+    state.Value(angleDiff);
+}
+
 void ControllerLooming::Init()
 {
     Controller::Init();
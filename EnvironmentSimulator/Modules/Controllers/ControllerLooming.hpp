@@ -67,6 +67,7 @@ namespace scenarioengine
             setSpeed_ = setSpeed;
         }
         void Step(double timeStep);
+        void SyncState(SE_StateSnapshot& state) override;
         bool hasFarTan;
         bool getHasFarTan()
         {
@@ -111,6 +111,12 @@ void ControllerOffroadFollower::Step(double timeStep)
     Controller::Step(timeStep);
 }
 
+void ControllerOffroadFollower::SyncState(SE_StateSnapshot& state)
+{
+    Controller::SyncState(state);
+    state.Value(vehicle_);
+}
+
 int ControllerOffroadFollower::Activate(ControlActivationMode lat_activation_mode,
                                         ControlActivationMode long_activation_mode,
                                         ControlActivationMode light_activation_mode,
@@ -173,6 +173,24 @@ void ControllerSloppyDriver::Step(double timeStep)
     Controller::Step(timeStep);
 }
 
+void ControllerSloppyDriver::SyncState(SE_StateSnapshot& state)
+{
+    Controller::SyncState(state);
+    state.Value(time_);
+    state.Value(speedTimer_);
+    state.Value(speedTimerAverage_);
+    state.Value(referenceSpeed_);
+    state.Value(initSpeed_);
+    state.Value(currentSpeed_);
+    state.Value(targetFactor_);
+    state.Value(lateralTimer_);
+    state.Value(lateralTimerAverage_);
+    state.Value(currentT_);
+    state.Value(currentH_);
+    state.Value(tFuzz0);
+    state.Value(tFuzzTarget);
+}
+
 int ControllerSloppyDriver::Activate(ControlActivationMode lat_activation_mode,
                                      ControlActivationMode long_activation_mode,
                                      ControlActivationMode light_activation_mode,
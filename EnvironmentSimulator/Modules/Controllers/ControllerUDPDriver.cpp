@@ -38,8 +38,10 @@ ControllerUDPDriver::ControllerUDPDriver(InitArgs* args)
     : Controller(args),
       inputMode_(InputMode::DRIVER_INPUT),
       udpServer_(nullptr),
+      shmServer_(nullptr),
       port_(0),
-      execMode_(ExecMode::EXEC_MODE_ASYNCHRONOUS)
+      execMode_(ExecMode::EXEC_MODE_ASYNCHRONOUS),
+      transport_(Transport::TRANSPORT_UDP)
 {
     if (args && args->properties && args->properties->ValueExists("inputMode"))
     {
@@ -104,6 +106,22 @@ ControllerUDPDriver::ControllerUDPDriver(InitArgs* args)
         }
     }
 
+    if (args && args->properties && args->properties->ValueExists("transport"))
+    {
+        if (args->properties->GetValueStr("transport") == "udp")
+        {
+            transport_ = Transport::TRANSPORT_UDP;
+        }
+        else if (args->properties->GetValueStr("transport") == "sharedMemory")
+        {
+            transport_ = Transport::TRANSPORT_SHARED_MEMORY;
+        }
+        else
+        {
+            LOG_AND_QUIT("ControllerExternalDriverModel unexpected arg transport %s", args->properties->GetValueStr("transport").c_str());
+        }
+    }
+
     // currently only supporting override mode
     if (args && args->properties && args->properties->ValueExists("mode"))
     {
@@ -124,6 +142,11 @@ ControllerUDPDriver::~ControllerUDPDriver()
     {
         delete udpServer_;
     }
+
+    if (shmServer_ != nullptr)
+    {
+        delete shmServer_;
+    }
 }
 
 std::string ControllerUDPDriver::InputMode2Str(InputMode inputMode)
@@ -162,6 +185,32 @@ std::string ControllerUDPDriver::ExecMode2Str(ExecMode execMode)
     }
 }
 
+std::string ControllerUDPDriver::Transport2Str(Transport transport)
+{
+    if (transport == Transport::TRANSPORT_UDP)
+    {
+        return "UDP";
+    }
+    else if (transport == Transport::TRANSPORT_SHARED_MEMORY)
+    {
+        return "SharedMemory";
+    }
+    else
+    {
+        return "Unknown";
+    }
+}
+
+int ControllerUDPDriver::Receive(char* buf, unsigned int size)
+{
+    if (transport_ == Transport::TRANSPORT_SHARED_MEMORY)
+    {
+        return shmServer_->Receive(buf, size);
+    }
+
+    return udpServer_->Receive(buf, size);
+}
+
 void ControllerUDPDriver::Init()
 {
     if (basePort_ == -1)
@@ -182,7 +231,7 @@ void ControllerUDPDriver::Step(double timeStep)
         // Pick all queued messages - store only the last/latest
         while (retval >= 0)
         {
-            retval = udpServer_->Receive(reinterpret_cast<char*>(&msg), sizeof(msg));
+            retval = Receive(reinterpret_cast<char*>(&msg), sizeof(msg));
             if (retval > 0)
             {
                 receivedNrOfBytes = retval;
@@ -191,7 +240,7 @@ void ControllerUDPDriver::Step(double timeStep)
     }
     else
     {
-        retval = udpServer_->Receive(reinterpret_cast<char*>(&msg), sizeof(msg));
+        retval = Receive(reinterpret_cast<char*>(&msg), sizeof(msg));
         if (retval >= 0)
         {
             receivedNrOfBytes = retval;
@@ -346,6 +395,13 @@ void ControllerUDPDriver::Step(double timeStep)
     Controller::Step(timeStep);
 }
 
+void ControllerUDPDriver::SyncState(SE_StateSnapshot& state)
+{
+    Controller::SyncState(state);
+    state.Value(vehicle_);
+    state.Value(lastMsg);
+}
+
 int ControllerUDPDriver::Activate(ControlActivationMode lat_activation_mode,
                                   ControlActivationMode long_activation_mode,
                                   ControlActivationMode light_activation_mode,
@@ -358,8 +414,29 @@ int ControllerUDPDriver::Activate(ControlActivationMode lat_activation_mode,
             port_ = basePort_ + object_->GetId();
         }
 
-        if (udpServer_ == nullptr ||                                    // not created yet
-            (udpServer_ != nullptr && udpServer_->GetPort() != port_))  // port nr changed. Need to recreate the socket.
+        if (transport_ == Transport::TRANSPORT_SHARED_MEMORY)
+        {
+            std::string shmName = UDP_DRIVER_SHM_NAME_PREFIX + std::to_string(port_);
+
+            if (shmServer_ == nullptr ||                                      // not created yet
+                (shmServer_ != nullptr && shmServer_->GetName() != shmName))  // port nr changed. Need to recreate the buffer.
+            {
+                if (shmServer_ != nullptr)
+                {
+                    delete shmServer_;
+                }
+                // Asynchronous mode picks only already queued messages, no need to wait
+                shmServer_ =
+                    new SharedMemoryServer(shmName, execMode_ == ExecMode::EXEC_MODE_ASYNCHRONOUS ? 0 : UDP_SYNCHRONOUS_MODE_TIMEOUT_MS);
+                if (shmServer_->GetStatus() != 0)
+                {
+                    LOG_AND_QUIT("ExternalDriverModel failed to create shared memory %s", shmName.c_str());
+                }
+                LOG("ExternalDriverModel server listening on shared memory %s execMode: %s", shmName.c_str(), ExecMode2Str(execMode_).c_str());
+            }
+        }
+        else if (udpServer_ == nullptr ||                                    // not created yet
+                 (udpServer_ != nullptr && udpServer_->GetPort() != port_))  // port nr changed. Need to recreate the socket.
         {
             // Close socket in case the controller is assigned again with different port
             if (udpServer_ != nullptr)
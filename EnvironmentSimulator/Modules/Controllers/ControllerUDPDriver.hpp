@@ -17,12 +17,14 @@
 #include "Parameters.hpp"
 #include "vehicle.hpp"
 #include "UDP.hpp"
+#include "SharedMemory.hpp"
 
 #define CONTROLLER_UDP_DRIVER_TYPE_NAME "UDPDriverController"
 
 #define UDP_DRIVER_MESSAGE_VERSION      1
 #define DEFAULT_UDP_DRIVER_PORT         49950
 #define UDP_SYNCHRONOUS_MODE_TIMEOUT_MS 500
+#define UDP_DRIVER_SHM_NAME_PREFIX      "/esmini_udp_driver_"  // followed by port number
 
 namespace scenarioengine
 {
@@ -45,6 +47,12 @@ namespace scenarioengine
             EXEC_MODE_SYNCHRONOUS  = 1,
         };
 
+        enum class Transport
+        {
+            TRANSPORT_UDP           = 0,
+            TRANSPORT_SHARED_MEMORY = 1,  // local ring buffer, see SharedMemory.hpp
+        };
+
         typedef struct
         {
             unsigned int version;
@@ -107,9 +115,11 @@ namespace scenarioengine
         ~ControllerUDPDriver();
         std::string InputMode2Str(InputMode inputMode);
         std::string ExecMode2Str(ExecMode execMode);
+        std::string Transport2Str(Transport transport);
 
         void Init();
         void Step(double timeStep);
+        void SyncState(SE_StateSnapshot& state) override;
         int  Activate(ControlActivationMode lat_activation_mode,
                       ControlActivationMode long_activation_mode,
                       ControlActivationMode light_activation_mode,
@@ -134,16 +144,20 @@ namespace scenarioengine
         }
 
     private:
-        vehicle::Vehicle  vehicle_;
-        vehicle::THROTTLE accelerate = vehicle::THROTTLE_NONE;
-        vehicle::STEERING steer      = vehicle::STEERING_NONE;
-        InputMode         inputMode_;
-        UDPServer*        udpServer_;
-        int               port_;
-        static int        basePort_;
-        ExecMode          execMode_;
-        DMMessage         msg;
-        DMMessage         lastMsg;
+        vehicle::Vehicle    vehicle_;
+        vehicle::THROTTLE   accelerate = vehicle::THROTTLE_NONE;
+        vehicle::STEERING   steer      = vehicle::STEERING_NONE;
+        InputMode           inputMode_;
+        UDPServer*          udpServer_;
+        SharedMemoryServer* shmServer_;
+        int                 port_;
+        static int          basePort_;
+        ExecMode            execMode_;
+        Transport           transport_;
+        DMMessage           msg;
+        DMMessage           lastMsg;
+
+        int Receive(char* buf, unsigned int size);
     };
 
     Controller* InstantiateControllerUDPDriver(void* args);
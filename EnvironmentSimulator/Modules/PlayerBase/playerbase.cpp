@@ -13,6 +13,7 @@
 #include <iostream>
 #include <string>
 #include <random>
+#include <thread>
 
 #include "PlayerServer.hpp"
 #include "ScenarioEngine.hpp"
@@ -20,6 +21,7 @@
 #include "CommonMini.hpp"
 #include "Server.hpp"
 #include "playerbase.hpp"
+#include "Profiler.hpp"
 #include "helpText.hpp"
 #include "OSCParameterDistribution.hpp"
 
@@ -29,8 +31,9 @@
 
 using namespace scenarioengine;
 
-#define GHOST_HEADSTART 2.5
-#define TRAIL_Z_OFFSET  0.02
+#define GHOST_HEADSTART             2.5
+#define TRAIL_Z_OFFSET              0.02
+#define THROUGHPUT_DEFAULT_TIMESTEP 0.05
 
 #ifdef _USE_OSG
 
@@ -59,6 +62,8 @@ ScenarioPlayer::ScenarioPlayer(int argc, char* argv[])
     threads              = false;
     launch_server        = false;
     fixed_timestep_      = -1.0;
+    throughput_          = false;
+    wall_start_time_     = 0;
     osi_receiver_addr    = "";
     osi_freq_            = 0;
     osi_updated_         = false;
@@ -108,6 +113,28 @@ ScenarioPlayer::~ScenarioPlayer()
     }
 #endif  // _USE_OSG
     Logger::Inst().SetTimePtr(0);
+
+    if (rt_scheduler_)
+    {
+        rt_scheduler_->LogSummary();
+    }
+
+#ifdef _USE_PROFILER
+    Profiler::Inst().Disable();
+#endif
+
+    if (throughput_ && scenarioEngine)
+    {
+        double wall_time = 1e-3 * static_cast<double>(SE_getSystemTime() - wall_start_time_);
+        double sim_time  = scenarioEngine->getSimulationTime();
+        LOG("Throughput: %.2f s simulated in %.3f s wall time (%.1f x realtime)", sim_time, wall_time, sim_time / MAX(wall_time, 1e-3));
+    }
+
+    if (CSV_Log)
+    {
+        CSV_Log->Close();
+    }
+
     if (scenarioEngine)
     {
         delete scenarioEngine;
@@ -155,6 +182,8 @@ void ScenarioPlayer::SetOSIFileStatus(bool is_on, const char* filename)
 
 void ScenarioPlayer::Draw()
 {
+    SE_PROFILE_SCOPE("ScenarioPlayer::Draw");
+
     if (viewer_)
     {
 #ifdef _USE_OSG
@@ -177,10 +206,17 @@ void ScenarioPlayer::Draw()
 
 int ScenarioPlayer::Frame(double timestep_s, bool server_mode)
 {
+    SE_PROFILE_FRAME("ScenarioPlayer::Frame");
+
     static bool messageShown  = false;
     int         retval        = 0;
     double      ghost_solo_dt = 0.05;
 
+    if (rt_scheduler_ && !rt_scheduler_->Started())
+    {
+        rt_scheduler_->Start();  // from the thread running the frames
+    }
+
     if (!IsPaused() || server_mode)
     {
 #ifdef _USE_OSI
@@ -193,7 +229,10 @@ int ScenarioPlayer::Frame(double timestep_s, bool server_mode)
         {
             while (retval == 0 && SE_Env::Inst().GetGhostMode() != GhostMode::NORMAL && !IsQuitRequested())
             {
-                Draw();
+                if (!throughput_)
+                {
+                    Draw();
+                }
                 if (!IsPaused() && !IsQuitRequested())
                 {
                     retval = ScenarioFrame(ghost_solo_dt, false);
@@ -215,12 +254,15 @@ int ScenarioPlayer::Frame(double timestep_s, bool server_mode)
 
     if (!server_mode)
     {
-        Draw();
-
-        if (scenarioEngine->getSimulationTime() > 3600 && !messageShown)
+        if (!throughput_)
         {
-            LOG("Info: Simulation time > 1 hour. Put a stopTrigger for automatic ending");
-            messageShown = true;
+            Draw();
+
+            if (scenarioEngine->getSimulationTime() > 3600 && !messageShown)
+            {
+                LOG("Info: Simulation time > 1 hour. Put a stopTrigger for automatic ending");
+                messageShown = true;
+            }
         }
 
         if (player_server_)
@@ -229,6 +271,11 @@ int ScenarioPlayer::Frame(double timestep_s, bool server_mode)
         }
     }
 
+    if (rt_scheduler_)
+    {
+        rt_scheduler_->WaitForNextFrame();
+    }
+
     return retval;
 }
 
@@ -249,6 +296,8 @@ int ScenarioPlayer::Frame(bool server_mode)
 
 int ScenarioPlayer::ScenarioFrame(double timestep_s, bool keyframe)
 {
+    SE_PROFILE_SCOPE("ScenarioPlayer::ScenarioFrame");
+
     int retval = 0;
     mutex.Lock();
 
@@ -298,6 +347,8 @@ int ScenarioPlayer::ScenarioFrame(double timestep_s, bool keyframe)
 
 void ScenarioPlayer::ScenarioPostFrame()
 {
+    SE_PROFILE_SCOPE("ScenarioPlayer::ScenarioPostFrame");
+
     mutex.Lock();
 
     for (size_t i = 0; i < sensor.size(); i++)
@@ -559,7 +610,11 @@ OffScreenImage* ScenarioPlayer::FetchCapturedImagePtr()
 
     if (viewer_ && viewer_->IsOffScreenRequested())
     {
-        viewer_->renderSemaphore.Wait();  // Wait until rendering is done
+        if (SE_Env::Inst().GetImageCaptureBuffers() < 2)
+        {
+            viewer_->renderSemaphore.Wait();  // Wait until rendering is done
+        }
+        // else asynchronous capture, no need to wait since the most recently completed frame is returned
 
         if (viewer_->capturedImage_.data == nullptr)
         {
@@ -654,6 +709,7 @@ void ScenarioPlayer::CloseViewer()
 {
     if (viewer_ != nullptr)
     {
+        viewer_->FlushImageCapture();
         delete viewer_;
         viewer_ = nullptr;
     }
@@ -1276,7 +1332,9 @@ int ScenarioPlayer::Init()
     opt.AddOption("osc", "OpenSCENARIO filename (required) - if path includes spaces, enclose with \"\"", "filename");
     opt.AddOption("aa_mode", "Anti-alias mode=number of multisamples (subsamples, 0=off, 4=default)", "mode");
     opt.AddOption("bounding_boxes", "Show entities as bounding boxes (toggle modes on key ',') ");
-    opt.AddOption("capture_screen", "Continuous screen capture. Warning: Many jpeg files will be created");
+    opt.AddOption("capture_buffers", "Number of frames in flight for asynchronous screen capture (1 = synchronous)", "number", "1");
+    opt.AddOption("capture_format", "Screen capture file format (\"tga\" (default), \"png\", \"ppm\", \"raw\")", "format");
+    opt.AddOption("capture_screen", "Continuous screen capture. Warning: Many image files will be created");
     opt.AddOption(
         "camera_mode",
         "Initial camera mode (\"orbit\" (default), \"fixed\", \"flex\", \"flex-orbit\", \"top\", \"driver\", \"custom\") (swith with key 'k') ",
@@ -1304,6 +1362,8 @@ int ScenarioPlayer::Init()
     opt.AddOption("hide_route_waypoints", "Disable route waypoint visualization (toggle with key 'R')");
     opt.AddOption("hide_trajectories", "Hide trajectories from start (toggle with key 'n')");
     opt.AddOption("info_text", "Show on-screen info text (toggle key 'i') mode 0=None 1=current (default) 2=per_object 3=both", "mode");
+    opt.AddOption("kpi_entity_file", "Append key performance indicators of each entity to a CSV file, one row per entity and run", "filename");
+    opt.AddOption("kpi_file", "Append key performance indicators (min TTC, gap, collision...) of each run to a CSV file, one row per run", "filename");
     opt.AddOption("logfile_path", "logfile path/filename, e.g. \"../esmini.log\" (default: log.txt)", "path");
     opt.AddOption("osc_str", "OpenSCENARIO XML string", "string");
     opt.AddOption("osg_screenshot_event_handler", "Revert to OSG default jpg images ('c'/'C' keys handler)");
@@ -1315,6 +1375,7 @@ int ScenarioPlayer::Init()
     opt.AddOption("osi_receiver_ip", "IP address where to send OSI UDP packages", "IP address");
 #endif
     opt.AddOption("param_dist", "Run variations of the scenario according to specified parameter distribution file", "filename");
+    opt.AddOption("param_dist_sampling", "Sampling method for stochastic parameter distributions", "method (random|lhs|sobol)", "random");
     opt.AddOption("param_permutation", "Run specific permutation of parameter distribution", "index (0 .. NumberOfPermutations-1)");
     opt.AddOption("pause", "Pause simulation after initialization");
     opt.AddOption("path", "Search path prefix for assets, e.g. OpenDRIVE files (multiple occurrences supported)", "path");
@@ -1322,15 +1383,32 @@ int ScenarioPlayer::Init()
 #ifdef _USE_IMPLOT
     opt.AddOption("plot", "Show window with line-plots of interesting data", "mode (asynchronous|synchronous)", "asynchronous");
 #endif
+#ifdef _USE_PROFILER
+    opt.AddOption("profile", "Measure time per frame spent in main subsystems, log summary and save trace (Chrome/Perfetto JSON)", "filename", "profile.json");
+#endif
+    opt.AddOption("realtime",
+                  "Run at fixed timestep paced to absolute deadlines, with realtime priority when permitted. Logs frame timing statistics",
+                  "timestep");
+    opt.AddOption("realtime_cpu", "Pin the simulation thread to given CPU core in realtime mode", "core");
     opt.AddOption("record", "Record position data into a file for later replay", "filename");
     opt.AddOption("road_features", "Show OpenDRIVE road features (\"on\", \"off\"  (default)) (toggle during simulation by press 'o') ", "mode");
+    opt.AddOption("road_tile_cache", "Directory for caching generated road tiles, reused while the OpenDRIVE file and tile size are unchanged", "path");
+    opt.AddOption("road_tile_size", "Generate road 3D model in square tiles of given size (m), built on demand around the camera", "size");
     opt.AddOption("return_nr_permutations", "Return number of permutations without executing the scenario (-1 = error)");
     opt.AddOption("save_generated_model", "Save generated 3D model (n/a when a scenegraph is loaded)");
     opt.AddOption("save_xosc", "Save OpenSCENARIO file with any populated parameter values (from distribution)");
+    opt.AddOption("scenario_template", "Keep parsed scenario, catalogs and road network in memory between runs, e.g. permutations");
     opt.AddOption("seed", "Specify seed number for random generator", "number");
     opt.AddOption("sensors", "Show sensor frustums (toggle during simulation by press 'r') ");
     opt.AddOption("server", "Launch server to receive state of external Ego simulator");
+    opt.AddOption("server_shm", "Launch server to receive state of external Ego simulator via local shared memory instead of UDP");
+    opt.AddOption("stop_at_ttc", "Terminate the scenario when time-to-collision of any entity falls below given value", "seconds");
+    opt.AddOption("stop_on_collision", "Terminate the scenario at first collision between any entities");
     opt.AddOption("threads", "Run viewer in a separate thread, parallel to scenario engine");
+    opt.AddOption("throughput",
+                  "Run headless as fast as possible with buffered file output and report achieved speed (implies fixed_timestep)",
+                  "timestep",
+                  "0.05");
     opt.AddOption("trail_mode", "Show trail lines and/or dots (toggle key 'j') mode 0=None 1=lines 2=dots 3=both", "mode");
     opt.AddOption("use_signs_in_external_model", "When external scenegraph 3D model is loaded, skip creating signs from OpenDRIVE");
     opt.AddOption("version", "Show version and quit");
@@ -1374,6 +1452,11 @@ int ScenarioPlayer::Init()
     }
     else if (opt.IsOptionArgumentSet("param_dist"))
     {
+        if (opt.GetOptionSet("param_dist_sampling") && dist.SetSamplingMethod(opt.GetOptionArg("param_dist_sampling")) != 0)
+        {
+            return -1;
+        }
+
         if (dist.GetNumPermutations() == 0)
         {
             if (LoadParameterDistribution(opt.GetOptionArg("param_dist")) != 0)
@@ -1486,7 +1569,7 @@ int ScenarioPlayer::Init()
 #endif
     }
 
-    if (opt.GetOptionSet("server"))
+    if (opt.GetOptionSet("server") || opt.GetOptionSet("server_shm"))
     {
         launch_server = true;
         LOG("Launch server to receive state of external Ego simulator");
@@ -1506,11 +1589,63 @@ int ScenarioPlayer::Init()
             LOG("Zero timestep ignored, running in realtime speed");
         }
     }
-    if (index == 0)
+    if (opt.GetOptionSet("throughput"))
+    {
+        throughput_ = true;
+        if (GetFixedTimestep() < SMALL_NUMBER)
+        {
+            double timestep = strtod(opt.GetOptionArg("throughput"));
+            if (timestep < SMALL_NUMBER)
+            {
+                LOG("Throughput mode: Invalid timestep \"%s\" ignored, using %.2f",
+                    opt.GetOptionArg("throughput").c_str(),
+                    THROUGHPUT_DEFAULT_TIMESTEP);
+                timestep = THROUGHPUT_DEFAULT_TIMESTEP;
+            }
+            SetFixedTimestep(timestep);
+        }
+        LOG("Throughput mode, no visualization and fixed timestep: %.3f", GetFixedTimestep());
+    }
+    else if (opt.GetOptionSet("realtime"))
+    {
+        double timestep = strtod(opt.GetOptionArg("realtime"));
+        if (timestep < SMALL_NUMBER)
+        {
+            LOG("Realtime mode: Invalid timestep \"%s\", needs to be > 0. Realtime option ignored", opt.GetOptionArg("realtime").c_str());
+        }
+        else
+        {
+            int cpu = -1;
+            if (opt.GetOptionSet("realtime_cpu"))
+            {
+                int n_cpu = static_cast<int>(std::thread::hardware_concurrency());
+                cpu       = strtoi(opt.GetOptionArg("realtime_cpu"));
+                if (cpu < 0 || (n_cpu > 0 && cpu >= n_cpu))
+                {
+                    LOG("Realtime mode: Invalid CPU core \"%s\" (available 0-%d), thread not pinned",
+                        opt.GetOptionArg("realtime_cpu").c_str(),
+                        n_cpu - 1);
+                    cpu = -1;
+                }
+            }
+            SetFixedTimestep(timestep);
+            rt_scheduler_ = std::make_unique<RealtimeScheduler>(GetFixedTimestep(), cpu);
+            LOG("Realtime mode, fixed timestep: %.3f", GetFixedTimestep());
+        }
+    }
+    else if (index == 0)
     {
         LOG("No fixed timestep specified - running in realtime speed");
     }
 
+#ifdef _USE_PROFILER
+    if (opt.GetOptionSet("profile"))
+    {
+        Profiler::Inst().Enable(opt.GetOptionArg("profile"));
+        LOG("Profiling frames, trace file: %s", opt.GetOptionArg("profile").c_str());
+    }
+#endif
+
     if (opt.GetOptionArg("path") != "")
     {
         int counter = 0;
@@ -1540,11 +1675,47 @@ int ScenarioPlayer::Init()
         LOG("Generated seed %u", SE_Env::Inst().GetRand().GetSeed());
     }
 
+    if (opt.GetOptionSet("capture_buffers") || opt.GetOptionSet("capture_format"))
+    {
+        std::string format = opt.GetOptionSet("capture_format") ? ToLower(opt.GetOptionArg("capture_format")) : SE_Env::Inst().GetImageFileFormat();
+        if (format != "tga" && format != "png" && format != "ppm" && format != "raw")
+        {
+            LOG("Unsupported capture format %s, applying %s", format.c_str(), SE_Env::Inst().GetImageFileFormat().c_str());
+            format = SE_Env::Inst().GetImageFileFormat();
+        }
+        SE_Env::Inst().SetImageCaptureMode(
+            opt.GetOptionSet("capture_buffers") ? strtoi(opt.GetOptionArg("capture_buffers")) : SE_Env::Inst().GetImageCaptureBuffers(),
+            format);
+    }
+
     if (opt.GetOptionSet("collision"))
     {
         SE_Env::Inst().SetCollisionDetection(true);
     }
 
+    if ((arg_str = opt.GetOptionArg("kpi_file")) != "")
+    {
+        SE_Env::Inst().SetKPIFilePath(arg_str);
+        LOG("Appending KPIs to %s", arg_str.c_str());
+    }
+
+    if ((arg_str = opt.GetOptionArg("kpi_entity_file")) != "")
+    {
+        SE_Env::Inst().SetKPIEntityFilePath(arg_str);
+        LOG("Appending entity KPIs to %s", arg_str.c_str());
+    }
+
+    if (opt.GetOptionSet("scenario_template"))
+    {
+        SE_Env::Inst().SetScenarioTemplateMode(true);
+    }
+
+    if (opt.GetOptionSet("stop_on_collision") || opt.IsOptionArgumentSet("stop_at_ttc"))
+    {
+        SE_Env::Inst().SetStopCriteria(opt.GetOptionSet("stop_on_collision"),
+                                       opt.IsOptionArgumentSet("stop_at_ttc") ? strtod(opt.GetOptionArg("stop_at_ttc")) : -1.0);
+    }
+
     if (opt.GetOptionSet("plot"))
     {
         if (opt.GetOptionArg("plot") != "synchronous")
@@ -1685,7 +1856,7 @@ int ScenarioPlayer::Init()
                 filename = dist.AddInfoToFilepath(filename);
             }
 
-            CSV_Log->Open(scenarioEngine->getScenarioFilename(), static_cast<int>(scenarioEngine->entities_.object_.size()), filename);
+            CSV_Log->Open(scenarioEngine->getScenarioFilename(), static_cast<int>(scenarioEngine->entities_.object_.size()), filename, throughput_ || rt_scheduler_);
             LOG("Log all vehicle data in csv file");
         }
         else
@@ -1721,13 +1892,16 @@ int ScenarioPlayer::Init()
         }
 
         LOG("Recording data to file %s", filename.c_str());
-        scenarioGateway->RecordToFile(filename, scenarioEngine->getOdrFilename(), scenarioEngine->getSceneGraphFilename());
+        scenarioGateway->RecordToFile(filename,
+                                      scenarioEngine->getOdrFilename(),
+                                      scenarioEngine->getSceneGraphFilename(),
+                                      throughput_ || rt_scheduler_);
     }
 
     if (launch_server)
     {
-        // Launch UDP server to receive external Ego state
-        StartServer(scenarioEngine);
+        // Launch UDP or shared memory server to receive external Ego state
+        StartServer(scenarioEngine, opt.GetOptionSet("server_shm"));
     }
 
     if (opt.GetOptionSet("player_server"))
@@ -1740,7 +1914,11 @@ int ScenarioPlayer::Init()
 
     player_init_semaphore.Set();
 
-    if (opt.IsInOriginalArgs("--window") || opt.IsInOriginalArgs("--borderless-window"))
+    if (throughput_ && (opt.IsInOriginalArgs("--window") || opt.IsInOriginalArgs("--borderless-window")))
+    {
+        LOG("Throughput mode, ignoring window request");
+    }
+    else if (opt.IsInOriginalArgs("--window") || opt.IsInOriginalArgs("--borderless-window"))
     {
 #ifdef _USE_OSG
 
@@ -1797,6 +1975,8 @@ int ScenarioPlayer::Init()
 
     Frame(0.0);
 
+    wall_start_time_ = SE_getSystemTime();
+
     if (opt.GetOptionSet("pause"))
     {
         SetState(PlayerState::PLAYER_STATE_PAUSE);
@@ -1818,6 +1998,8 @@ void ScenarioPlayer::RegisterObjCallback(int id, ObjCallbackFunc func, void* dat
 
 void ScenarioPlayer::UpdateCSV_Log()
 {
+    SE_PROFILE_SCOPE("ScenarioPlayer::UpdateCSV_Log");
+
     // Flag for signalling end of data line, all vehicles reported
     bool isendline = false;
 
@@ -18,6 +18,7 @@
 #include "PlayerServer.hpp"
 #include "RoadManager.hpp"
 #include "CommonMini.hpp"
+#include "RealtimeScheduler.hpp"
 #include "Server.hpp"
 #include "IdealSensor.hpp"
 
@@ -142,6 +143,15 @@ namespace scenarioengine
         {
             return osi_freq_;
         }
+
+        /**
+        Realtime scheduler pacing the frames, see --realtime option
+        @return Pointer to the scheduler, nullptr if not running in realtime mode
+        */
+        RealtimeScheduler *GetRealtimeScheduler()
+        {
+            return rt_scheduler_.get();
+        }
         void        RegisterObjCallback(int id, ObjCallbackFunc func, void *data);
         void        UpdateCSV_Log();
         int         GetNumberOfParameters();
@@ -253,6 +263,8 @@ namespace scenarioengine
         bool        launch_server;
         bool        disable_controllers_;
         double      fixed_timestep_;
+        bool        throughput_;       // run as fast as possible, no visualization and buffered file output
+        __int64     wall_start_time_;  // system time (ms) when the scenario started, for speed report
         int         osi_freq_;
         int         frame_counter_;
         std::string osi_receiver_addr;
@@ -261,6 +273,8 @@ namespace scenarioengine
         char      **argv_;
         std::string titleString;
         PlayerState state_;
+
+        std::unique_ptr<RealtimeScheduler> rt_scheduler_;  // paces frames in realtime mode, else nullptr
     };
 
 }  // namespace scenarioengine
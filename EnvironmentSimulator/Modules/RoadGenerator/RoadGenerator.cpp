@@ -0,0 +1,662 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "RoadGenerator.hpp"
+#include "CommonMini.hpp"
+
+#define JUNCTION_MARGIN   6.0  // junction radius in addition to road width (m)
+#define INTEGRATION_STEPS 1000
+
+using namespace roadgenerator;
+
+double Network::GetTotalLength() const
+{
+    double length = 0.0;
+
+    for (size_t i = 0; i < roads.size(); i++)
+    {
+        length += roads[i].length;
+    }
+
+    return length;
+}
+
+static Geometry Line(double length)
+{
+    return {GeometryType::LINE, length, 0.0, 0.0, 0.0, 0.0};
+}
+
+static Geometry Arc(double length, double curvature)
+{
+    return {GeometryType::ARC, length, curvature, curvature, 0.0, 0.0};
+}
+
+static Geometry Spiral(double length, double curv_start, double curv_end)
+{
+    return {GeometryType::SPIRAL, length, curv_start, curv_end, 0.0, 0.0};
+}
+
+// Cubic lateral shift u = u_length * p, v = v_offset * (3p^2 - 2p^3), p in [0, 1]
+static Geometry Poly3(double u_length, double v_offset)
+{
+    double length = 0.0;
+    double dp     = 1.0 / INTEGRATION_STEPS;
+
+    for (int i = 0; i < INTEGRATION_STEPS; i++)
+    {
+        double p  = (i + 0.5) * dp;
+        double dv = 6 * v_offset * (p - p * p);
+        length += sqrt(u_length * u_length + dv * dv) * dp;
+    }
+
+    return {GeometryType::POLY3, length, 0.0, 0.0, u_length, v_offset};
+}
+
+// End pose of a geometry element. Spirals are integrated numerically, accurate well below mm level.
+static Pose EndPose(const Pose& start, const Geometry& geom)
+{
+    Pose end = start;
+
+    if (geom.type == GeometryType::POLY3)
+    {
+        end.x += geom.u_length * cos(start.h) - geom.v_offset * sin(start.h);
+        end.y += geom.u_length * sin(start.h) + geom.v_offset * cos(start.h);
+    }
+    else if (geom.type == GeometryType::LINE)
+    {
+        end.x += geom.length * cos(start.h);
+        end.y += geom.length * sin(start.h);
+    }
+    else
+    {
+        double dcurv = (geom.curv_end - geom.curv_start) / geom.length;
+        double ds    = geom.length / INTEGRATION_STEPS;
+
+        for (int i = 0; i < INTEGRATION_STEPS; i++)
+        {
+            double s = (i + 0.5) * ds;
+            double h = start.h + geom.curv_start * s + 0.5 * dcurv * s * s;
+            end.x += cos(h) * ds;
+            end.y += sin(h) * ds;
+        }
+        end.h = start.h + 0.5 * (geom.curv_start + geom.curv_end) * geom.length;
+    }
+
+    return end;
+}
+
+static Pose EndPose(const Pose& start, const std::vector<Geometry>& geometry)
+{
+    Pose pose = start;
+
+    for (size_t i = 0; i < geometry.size(); i++)
+    {
+        pose = EndPose(pose, geometry[i]);
+    }
+
+    return pose;
+}
+
+// Clothoid - arc - clothoid, changing heading by curvature * (spiral_length + arc_length)
+static void AddCurve(std::vector<Geometry>& geometry, double curvature, double spiral_length, double arc_length)
+{
+    geometry.push_back(Spiral(spiral_length, 0.0, curvature));
+    geometry.push_back(Arc(arc_length, curvature));
+    geometry.push_back(Spiral(spiral_length, curvature, 0.0));
+}
+
+/*
+ * Geometry from start to a point at given distance straight ahead with same heading. With mixed geometry the road
+ * is an S-curve, its lateral displacement taken back by a paramPoly3, padded with lines. Roads too short for the
+ * mix are straight lines.
+ */
+static std::vector<Geometry> StraightAheadGeometry(double distance, bool mix)
+{
+    std::vector<Geometry> geometry;
+    double                scale = MIN(1.0, distance / 400.0);
+
+    if (mix && distance > 100.0)
+    {
+        AddCurve(geometry, 0.01 / scale, 15.0 * scale, 10.0 * scale);
+        AddCurve(geometry, -0.01 / scale, 15.0 * scale, 10.0 * scale);
+
+        Pose   end       = EndPose({0.0, 0.0, 0.0}, geometry);
+        double poly_u    = 30.0 * scale;
+        double remaining = distance - end.x - poly_u;
+
+        if (remaining > 0.0)
+        {
+            geometry.insert(geometry.begin(), Line(0.5 * remaining));
+            geometry.push_back(Poly3(poly_u, -end.y));
+            geometry.push_back(Line(0.5 * remaining));
+            return geometry;
+        }
+        geometry.clear();
+    }
+
+    geometry.push_back(Line(distance));
+
+    return geometry;
+}
+
+static Road& AddRoad(Network& network, int junction, const Pose& start, const std::vector<Geometry>& geometry)
+{
+    Road road;
+
+    road.id          = network.id_counter++;
+    road.junction    = junction;
+    road.start       = start;
+    road.geometry    = geometry;
+    road.length      = 0.0;
+    road.predecessor = {"", -1, false};
+    road.successor   = {"", -1, false};
+    road.lane_links  = false;
+    for (size_t i = 0; i < geometry.size(); i++)
+    {
+        road.length += geometry[i].length;
+    }
+    network.roads.push_back(road);
+
+    return network.roads.back();
+}
+
+/*
+ * Grid of size x size junctions, spaced road_length. Arms are numbered counter clockwise from east (0 = east,
+ * 1 = north, 2 = west, 3 = south). Each junction has connecting roads from each arm to every other arm.
+ */
+int roadgenerator::CreateGrid(Network& network, int size, double road_length, bool mix)
+{
+    struct Arm
+    {
+        int  road_id;  // -1 if no road
+        bool road_starts_here;
+    };
+
+    double radius = network.n_lanes * network.lane_width + JUNCTION_MARGIN;
+
+    if (network.n_lanes < 1 || network.lane_width < SMALL_NUMBER || size < 2 || road_length < 2 * radius + 1.0)
+    {
+        LOG("Grid needs lanes of width > 0, size >= 2 and roads longer than the junctions");
+        return -1;
+    }
+
+    std::vector<Arm>      arms(static_cast<size_t>(4 * size * size), {-1, false});
+    std::vector<Geometry> geometry = StraightAheadGeometry(road_length - 2 * radius, mix);
+
+    network.id_counter = size * size;  // junction ids first
+
+    for (int r = 0; r < size; r++)
+    {
+        for (int c = 0; c < size; c++)
+        {
+            int junction = r * size + c;
+
+            if (c < size - 1)
+            {
+                Road& road       = AddRoad(network, -1, {c * road_length + radius, r * road_length, 0.0}, geometry);
+                road.predecessor = {"junction", junction, false};
+                road.successor   = {"junction", junction + 1, false};
+                arms[static_cast<size_t>(4 * junction + 0)]       = {road.id, true};
+                arms[static_cast<size_t>(4 * (junction + 1) + 2)] = {road.id, false};
+            }
+            if (r < size - 1)
+            {
+                Road& road       = AddRoad(network, -1, {c * road_length, r * road_length + radius, M_PI_2}, geometry);
+                road.predecessor = {"junction", junction, false};
+                road.successor   = {"junction", junction + size, false};
+                arms[static_cast<size_t>(4 * junction + 1)]          = {road.id, true};
+                arms[static_cast<size_t>(4 * (junction + size) + 3)] = {road.id, false};
+            }
+        }
+    }
+
+    for (int j = 0; j < size * size; j++)
+    {
+        Junction junction;
+        double   cx = (j % size) * road_length;
+        double   cy = (j / size) * road_length;
+
+        junction.id = j;
+
+        for (int a = 0; a < 4; a++)
+        {
+            Arm& in = arms[static_cast<size_t>(4 * j + a)];
+            if (in.road_id < 0)
+            {
+                continue;
+            }
+
+            for (int b = 0; b < 4; b++)
+            {
+                Arm& out = arms[static_cast<size_t>(4 * j + b)];
+                if (b == a || out.road_id < 0)
+                {
+                    continue;
+                }
+
+                // enter at arm a heading towards the center, leave at arm b heading away from it
+                Pose                  start = {cx + radius * cos(a * M_PI_2), cy + radius * sin(a * M_PI_2), GetAngleInInterval2PI(a * M_PI_2 + M_PI)};
+                std::vector<Geometry> turn;
+                int                   direction = (b - a + 2) % 4;  // 0 = straight, 1 = left, 3 = right
+
+                if (direction == 0)
+                {
+                    turn.push_back(Line(2 * radius));
+                }
+                else
+                {
+                    turn.push_back(Arc(radius * M_PI_2, (direction == 1 ? 1.0 : -1.0) / radius));
+                }
+
+                Road& road       = AddRoad(network, j, start, turn);
+                road.predecessor = {"road", in.road_id, in.road_starts_here};
+                road.successor   = {"road", out.road_id, out.road_starts_here};
+                junction.connections.push_back({in.road_id, road.id, !in.road_starts_here});
+            }
+        }
+        network.junctions.push_back(junction);
+    }
+
+    return 0;
+}
+
+/*
+ * Highway of n_roads segments, each a curve to alternating sides followed by a paramPoly3 lane shift when mixed
+ */
+int roadgenerator::CreateHighway(Network& network, int n_roads, double road_length, bool mix)
+{
+    Pose pose = {0.0, 0.0, 0.0};
+
+    if (network.n_lanes < 1 || network.lane_width < SMALL_NUMBER || n_roads < 1 || road_length < SMALL_NUMBER)
+    {
+        LOG("Highway needs lanes of width > 0 and at least one road of length > 0");
+        return -1;
+    }
+
+    for (int i = 0; i < n_roads; i++)
+    {
+        std::vector<Geometry> geometry;
+        double                sign = i % 2 == 0 ? 1.0 : -1.0;
+
+        if (mix && road_length > 700.0)
+        {
+            geometry.push_back(Line(0.5 * (road_length - 600.0)));
+            AddCurve(geometry, sign / 1000.0, 150.0, 150.0);
+            geometry.push_back(Poly3(150.0, sign * network.lane_width));
+            geometry.push_back(Line(road_length - geometry[0].length - 450.0 - geometry[4].length));
+        }
+        else
+        {
+            geometry.push_back(Line(road_length));
+        }
+
+        Road& road = AddRoad(network, -1, pose, geometry);
+        if (i > 0)
+        {
+            road.predecessor = {"road", road.id - 1, false};
+        }
+        if (i < n_roads - 1)
+        {
+            road.successor = {"road", road.id + 1, true};
+        }
+        road.lane_links = true;
+        pose            = EndPose(pose, geometry);
+    }
+
+    return 0;
+}
+
+int roadgenerator::CreateRing(Network& network, int n_roads, double road_length)
+{
+    if (network.n_lanes < 1 || network.lane_width < SMALL_NUMBER || n_roads < 2 || road_length < SMALL_NUMBER)
+    {
+        LOG("Ring needs lanes of width > 0 and at least two roads of length > 0");
+        return -1;
+    }
+
+    double radius = n_roads * road_length / (2 * M_PI);
+
+    for (int i = 0; i < n_roads; i++)
+    {
+        // start poses on the circle, instead of chaining end poses, to close the ring exactly
+        double angle = 2 * M_PI * i / n_roads;
+        Road&  road  = AddRoad(network, -1, {radius * sin(angle), radius * (1 - cos(angle)), angle}, {Arc(road_length, 1.0 / radius)});
+
+        road.predecessor = {"road", network.roads[0].id + (i + n_roads - 1) % n_roads, false};
+        road.successor   = {"road", network.roads[0].id + (i + 1) % n_roads, true};
+        road.lane_links  = true;
+    }
+
+    return 0;
+}
+
+static void WriteLane(FILE* file, const Network& network, const Road& road, int id)
+{
+    // in junctions, lanes link to the lane driving the same direction, i.e. opposite sign when the road runs the other way
+    int pred_id = road.predecessor.contact_start ? -id : id;
+    int succ_id = road.successor.contact_start ? id : -id;
+
+    fprintf(file, "                    <lane id=\"%d\" type=\"driving\" level=\"false\">\n", id);
+    if (road.junction >= 0 || road.lane_links)
+    {
+        fprintf(file, "                        <link>\n");
+        if (!road.predecessor.element_type.empty())
+        {
+            fprintf(file, "                            <predecessor id=\"%d\"/>\n", pred_id);
+        }
+        if (!road.successor.element_type.empty())
+        {
+            fprintf(file, "                            <successor id=\"%d\"/>\n", succ_id);
+        }
+        fprintf(file, "                        </link>\n");
+    }
+    fprintf(file, "                        <width sOffset=\"0.0\" a=\"%.3f\" b=\"0.0\" c=\"0.0\" d=\"0.0\"/>\n", network.lane_width);
+    if (road.junction < 0)
+    {
+        fprintf(file,
+                "                        <roadMark sOffset=\"0.0\" type=\"%s\" weight=\"standard\" color=\"standard\" width=\"0.12\"/>\n",
+                abs(id) == network.n_lanes ? "solid" : "broken");
+    }
+    fprintf(file, "                    </lane>\n");
+}
+
+static void WriteLink(FILE* file, const char* tag, const RoadLink& link)
+{
+    if (link.element_type == "road")
+    {
+        fprintf(file,
+                "            <%s elementType=\"road\" elementId=\"%d\" contactPoint=\"%s\"/>\n",
+                tag,
+                link.id,
+                link.contact_start ? "start" : "end");
+    }
+    else if (link.element_type == "junction")
+    {
+        fprintf(file, "            <%s elementType=\"junction\" elementId=\"%d\"/>\n", tag, link.id);
+    }
+}
+
+int roadgenerator::WriteOpenDRIVE(const std::string& filename, const Network& network)
+{
+    FILE* file = FileOpen(filename.c_str(), "w");
+
+    if (file == nullptr)
+    {
+        LOG("Failed to open %s for writing", filename.c_str());
+        return -1;
+    }
+
+    fprintf(file, "<?xml version=\"1.0\" standalone=\"yes\"?>\n<OpenDRIVE>\n");
+    fprintf(file, "    <header revMajor=\"1\" revMinor=\"5\" name=\"%s\" version=\"1.00\"/>\n", FileNameWithoutExtOf(filename).c_str());
+
+    for (size_t i = 0; i < network.roads.size(); i++)
+    {
+        const Road& road = network.roads[i];
+        Pose        pose = road.start;
+        double      s    = 0.0;
+
+        fprintf(file, "    <road name=\"\" length=\"%.6f\" id=\"%d\" junction=\"%d\">\n", road.length, road.id, road.junction);
+        fprintf(file, "        <link>\n");
+        WriteLink(file, "predecessor", road.predecessor);
+        WriteLink(file, "successor", road.successor);
+        fprintf(file, "        </link>\n");
+        fprintf(file, "        <planView>\n");
+        for (size_t j = 0; j < road.geometry.size(); j++)
+        {
+            const Geometry& geom = road.geometry[j];
+
+            fprintf(file,
+                    "            <geometry s=\"%.6f\" x=\"%.6f\" y=\"%.6f\" hdg=\"%.9f\" length=\"%.6f\">\n",
+                    s,
+                    pose.x,
+                    pose.y,
+                    pose.h,
+                    geom.length);
+            if (geom.type == GeometryType::LINE)
+            {
+                fprintf(file, "                <line/>\n");
+            }
+            else if (geom.type == GeometryType::ARC)
+            {
+                fprintf(file, "                <arc curvature=\"%.12f\"/>\n", geom.curv_start);
+            }
+            else if (geom.type == GeometryType::SPIRAL)
+            {
+                fprintf(file, "                <spiral curvStart=\"%.12f\" curvEnd=\"%.12f\"/>\n", geom.curv_start, geom.curv_end);
+            }
+            else
+            {
+                fprintf(file,
+                        "                <paramPoly3 aU=\"0.0\" bU=\"%.9f\" cU=\"0.0\" dU=\"0.0\" aV=\"0.0\" bV=\"0.0\" cV=\"%.9f\" dV=\"%.9f\" "
+                        "pRange=\"normalized\"/>\n",
+                        geom.u_length,
+                        3 * geom.v_offset,
+                        -2 * geom.v_offset);
+            }
+            fprintf(file, "            </geometry>\n");
+            pose = EndPose(pose, geom);
+            s += geom.length;
+        }
+        fprintf(file, "        </planView>\n");
+        fprintf(file, "        <lanes>\n");
+        fprintf(file, "            <laneSection s=\"0.0\">\n");
+        if (road.junction < 0)
+        {
+            fprintf(file, "                <left>\n");
+            for (int k = network.n_lanes; k > 0; k--)
+            {
+                WriteLane(file, network, road, k);
+            }
+            fprintf(file, "                </left>\n");
+        }
+        fprintf(file, "                <center>\n");
+        fprintf(file, "                    <lane id=\"0\" type=\"none\" level=\"false\">\n");
+        if (road.junction < 0)
+        {
+            fprintf(file, "                        <roadMark sOffset=\"0.0\" type=\"solid\" weight=\"standard\" color=\"standard\" width=\"0.12\"/>\n");
+        }
+        fprintf(file, "                    </lane>\n");
+        fprintf(file, "                </center>\n");
+        fprintf(file, "                <right>\n");
+        for (int k = 1; k <= network.n_lanes; k++)
+        {
+            WriteLane(file, network, road, -k);
+        }
+        fprintf(file, "                </right>\n");
+        fprintf(file, "            </laneSection>\n");
+        fprintf(file, "        </lanes>\n");
+        fprintf(file, "    </road>\n");
+    }
+
+    for (size_t i = 0; i < network.junctions.size(); i++)
+    {
+        const Junction& junction = network.junctions[i];
+
+        fprintf(file, "    <junction id=\"%d\" name=\"\">\n", junction.id);
+        for (size_t j = 0; j < junction.connections.size(); j++)
+        {
+            const Connection& connection = junction.connections[j];
+
+            fprintf(file,
+                    "        <connection id=\"%d\" incomingRoad=\"%d\" connectingRoad=\"%d\" contactPoint=\"start\">\n",
+                    static_cast<int>(j),
+                    connection.incoming_road,
+                    connection.connecting_road);
+            for (int k = 1; k <= network.n_lanes; k++)
+            {
+                fprintf(file, "            <laneLink from=\"%d\" to=\"%d\"/>\n", connection.incoming_ends_here ? -k : k, -k);
+            }
+            fprintf(file, "        </connection>\n");
+        }
+        fprintf(file, "    </junction>\n");
+    }
+
+    fprintf(file, "</OpenDRIVE>\n");
+    fclose(file);
+
+    return 0;
+}
+
+int roadgenerator::WriteOpenSCENARIO(const std::string& filename,
+                                     const std::string& odr_filename,
+                                     const Network&     network,
+                                     int                n_vehicles,
+                                     double             spacing,
+                                     double             speed,
+                                     double             duration,
+                                     const std::string& controller,
+                                     unsigned int       seed)
+{
+    struct Slot
+    {
+        int    road_id;
+        int    lane_id;
+        double s;
+    };
+
+    std::vector<Slot> slots;
+
+    for (size_t i = 0; i < network.roads.size(); i++)
+    {
+        const Road& road = network.roads[i];
+
+        if (road.junction >= 0)
+        {
+            continue;
+        }
+        for (int k = 1; k <= network.n_lanes; k++)
+        {
+            for (double s = 0.5 * spacing; s < road.length - 0.5 * spacing; s += spacing)
+            {
+                slots.push_back({road.id, -k, s});
+                slots.push_back({road.id, k, road.length - s});
+            }
+        }
+    }
+
+    if (n_vehicles > static_cast<int>(slots.size()))
+    {
+        LOG("Network has room for %d vehicles at spacing %.1f m, reducing from %d", static_cast<int>(slots.size()), spacing, n_vehicles);
+        n_vehicles = static_cast<int>(slots.size());
+    }
+
+    FILE* file = FileOpen(filename.c_str(), "w");
+
+    if (file == nullptr)
+    {
+        LOG("Failed to open %s for writing", filename.c_str());
+        return -1;
+    }
+
+    // refer to the road network relative to the scenario file when in the same folder
+    std::string logic_file = DirNameOf(filename) == DirNameOf(odr_filename) ? FileNameOf(odr_filename) : odr_filename;
+
+    std::mt19937                           generator(seed);
+    std::uniform_real_distribution<double> speed_factor(0.9, 1.1);
+
+    fprintf(file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<OpenSCENARIO>\n");
+    fprintf(file,
+            "   <FileHeader revMajor=\"1\" revMinor=\"1\" date=\"2024-01-01T00:00:00\" description=\"%d vehicles, generated by odrgen\" "
+            "author=\"esmini\"/>\n",
+            n_vehicles);
+    fprintf(file, "   <ParameterDeclarations/>\n");
+    fprintf(file, "   <CatalogLocations/>\n");
+    fprintf(file, "   <RoadNetwork>\n      <LogicFile filepath=\"%s\"/>\n   </RoadNetwork>\n", logic_file.c_str());
+    fprintf(file, "   <Entities>\n");
+    for (int i = 0; i < n_vehicles; i++)
+    {
+        fprintf(file, "      <ScenarioObject name=\"Car%d\">\n", i);
+        fprintf(file, "         <Vehicle name=\"car\" vehicleCategory=\"car\">\n");
+        fprintf(file, "            <ParameterDeclarations/>\n");
+        fprintf(file, "            <BoundingBox>\n");
+        fprintf(file, "               <Center x=\"1.4\" y=\"0.0\" z=\"0.9\"/>\n");
+        fprintf(file, "               <Dimensions width=\"2.0\" length=\"5.0\" height=\"1.8\"/>\n");
+        fprintf(file, "            </BoundingBox>\n");
+        fprintf(file, "            <Performance maxSpeed=\"69\" maxAcceleration=\"10\" maxDeceleration=\"10\"/>\n");
+        fprintf(file, "            <Axles>\n");
+        fprintf(file,
+                "               <FrontAxle maxSteering=\"0.5\" wheelDiameter=\"0.8\" trackWidth=\"1.68\" positionX=\"2.98\" positionZ=\"0.4\"/>\n");
+        fprintf(file, "               <RearAxle maxSteering=\"0.0\" wheelDiameter=\"0.8\" trackWidth=\"1.68\" positionX=\"0\" positionZ=\"0.4\"/>\n");
+        fprintf(file, "            </Axles>\n");
+        fprintf(file, "            <Properties/>\n");
+        fprintf(file, "         </Vehicle>\n");
+        if (!controller.empty())
+        {
+            fprintf(file, "         <ObjectController>\n");
+            fprintf(file, "            <Controller name=\"%s\">\n", controller.c_str());
+            fprintf(file, "               <Properties>\n");
+            fprintf(file, "                  <Property name=\"esminiController\" value=\"%s\"/>\n", controller.c_str());
+            fprintf(file, "               </Properties>\n");
+            fprintf(file, "            </Controller>\n");
+            fprintf(file, "         </ObjectController>\n");
+        }
+        fprintf(file, "      </ScenarioObject>\n");
+    }
+    fprintf(file, "   </Entities>\n");
+    fprintf(file, "   <Storyboard>\n      <Init>\n         <Actions>\n");
+    for (int i = 0; i < n_vehicles; i++)
+    {
+        // spread vehicles over all slots, i.e. all roads and lanes
+        const Slot& slot = slots[static_cast<size_t>(static_cast<long long>(i) * static_cast<long long>(slots.size()) / n_vehicles)];
+
+        fprintf(file, "            <Private entityRef=\"Car%d\">\n", i);
+        fprintf(file, "               <PrivateAction>\n");
+        fprintf(file, "                  <TeleportAction>\n");
+        fprintf(file,
+                "                     <Position><LanePosition roadId=\"%d\" laneId=\"%d\" offset=\"0\" s=\"%.2f\"/></Position>\n",
+                slot.road_id,
+                slot.lane_id,
+                slot.s);
+        fprintf(file, "                  </TeleportAction>\n");
+        fprintf(file, "               </PrivateAction>\n");
+        fprintf(file, "               <PrivateAction>\n");
+        fprintf(file, "                  <LongitudinalAction>\n");
+        fprintf(file, "                     <SpeedAction>\n");
+        fprintf(file, "                        <SpeedActionDynamics dynamicsShape=\"step\" dynamicsDimension=\"time\" value=\"0.0\"/>\n");
+        fprintf(file, "                        <SpeedActionTarget><AbsoluteTargetSpeed value=\"%.2f\"/></SpeedActionTarget>\n", speed * speed_factor(generator));
+        fprintf(file, "                     </SpeedAction>\n");
+        fprintf(file, "                  </LongitudinalAction>\n");
+        fprintf(file, "               </PrivateAction>\n");
+        if (!controller.empty())
+        {
+            fprintf(file, "               <PrivateAction>\n");
+            fprintf(file, "                  <ActivateControllerAction/>\n");
+            fprintf(file, "               </PrivateAction>\n");
+        }
+        fprintf(file, "            </Private>\n");
+    }
+    fprintf(file, "         </Actions>\n      </Init>\n");
+    if (duration > SMALL_NUMBER)
+    {
+        fprintf(file, "      <StopTrigger>\n");
+        fprintf(file, "         <ConditionGroup>\n");
+        fprintf(file, "            <Condition name=\"StopTime\" delay=\"0\" conditionEdge=\"none\">\n");
+        fprintf(file, "               <ByValueCondition>\n");
+        fprintf(file, "                  <SimulationTimeCondition value=\"%.2f\" rule=\"greaterThan\"/>\n", duration);
+        fprintf(file, "               </ByValueCondition>\n");
+        fprintf(file, "            </Condition>\n");
+        fprintf(file, "         </ConditionGroup>\n");
+        fprintf(file, "      </StopTrigger>\n");
+    }
+    else
+    {
+        fprintf(file, "      <StopTrigger/>\n");
+    }
+    fprintf(file, "   </Storyboard>\n</OpenSCENARIO>\n");
+    fclose(file);
+
+    return n_vehicles;
+}
@@ -0,0 +1,154 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+/*
+ * Generator of synthetic road networks of any size, for scale testing of RoadManager and ScenarioEngine.
+ *
+ * Three network types are supported:
+ *   grid    - N x N junctions connected by two-way roads, all turns available in each junction
+ *   highway - N road segments connected end to start
+ *   ring    - N arcs connected end to start forming a circle, i.e. a road without end
+ * Road geometries optionally mix line, spiral, arc and paramPoly3 elements. A network is first built in memory, then
+ * written as OpenDRIVE. In addition an OpenSCENARIO file can be written, populating the network with given number of
+ * vehicles, optionally assigned a controller.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace roadgenerator
+{
+    enum class GeometryType
+    {
+        LINE,
+        ARC,
+        SPIRAL,
+        POLY3
+    };
+
+    struct Geometry
+    {
+        GeometryType type;
+        double       length;
+        double       curv_start;  // arc and spiral
+        double       curv_end;    // spiral
+        double       u_length;    // poly3, length along start heading
+        double       v_offset;    // poly3, lateral offset at end, heading at start and end equal
+    };
+
+    struct Pose
+    {
+        double x;
+        double y;
+        double h;
+    };
+
+    struct RoadLink
+    {
+        std::string element_type;  // "road", "junction" or empty for no link
+        int         id;
+        bool        contact_start;
+    };
+
+    struct Road
+    {
+        int                   id;
+        int                   junction;
+        Pose                  start;
+        std::vector<Geometry> geometry;
+        double                length;
+        RoadLink              predecessor;
+        RoadLink              successor;
+        bool                  lane_links;  // link lanes of neighbor roads (direct road to road connections)
+    };
+
+    struct Connection
+    {
+        int  incoming_road;
+        int  connecting_road;
+        bool incoming_ends_here;  // incoming road ends in the junction, i.e. its right lanes drive into it
+    };
+
+    struct Junction
+    {
+        int                     id;
+        std::vector<Connection> connections;
+    };
+
+    struct Network
+    {
+        std::vector<Road>     roads;
+        std::vector<Junction> junctions;
+        int                   n_lanes;
+        double                lane_width;
+        int                   id_counter = 0;
+
+        double GetTotalLength() const;
+    };
+
+    /**
+        Add a grid of size x size junctions, spaced road_length, to an empty network
+        @param network Network with n_lanes and lane_width set
+        @param size Number of junctions per row and column, at least 2
+        @param road_length Distance between junction centers, must leave room for the junctions
+        @param mix Mix line, spiral, arc and paramPoly3 geometries, else lines only
+        @return 0 if successful, -1 on invalid arguments
+    */
+    int CreateGrid(Network& network, int size, double road_length, bool mix);
+
+    /**
+        Add a highway of n_roads segments connected end to start to an empty network
+        @param network Network with n_lanes and lane_width set
+        @param n_roads Number of road segments, at least 1
+        @param road_length Length of each segment
+        @param mix Curves and a paramPoly3 lane shift per segment, else straight lines only
+        @return 0 if successful, -1 on invalid arguments
+    */
+    int CreateHighway(Network& network, int n_roads, double road_length, bool mix);
+
+    /**
+        Add a ring of n_roads arcs to an empty network, last road connected to the first one
+        @param network Network with n_lanes and lane_width set
+        @param n_roads Number of roads, at least 2
+        @param road_length Length of each road, the ring radius given by total length
+        @return 0 if successful, -1 on invalid arguments
+    */
+    int CreateRing(Network& network, int n_roads, double road_length);
+
+    /**
+        Write network to OpenDRIVE file
+        @return 0 if successful, -1 if the file could not be written
+    */
+    int WriteOpenDRIVE(const std::string& filename, const Network& network);
+
+    /**
+        Write OpenSCENARIO file populating the network. Vehicles are spread evenly over all driving lanes outside
+        junctions, at least spacing apart, each driving at speed +/-10%.
+        @param odr_filename Road network, referred to relative to the scenario file when in the same folder
+        @param duration Simulation time when the scenario stops, 0 for no stop trigger
+        @param controller Controller assigned to and activated for all vehicles, empty for default controller
+        @param seed Random seed for vehicle speeds
+        @return Number of vehicles, fewer than requested if they do not fit in the network, -1 on failure
+    */
+    int WriteOpenSCENARIO(const std::string& filename,
+                          const std::string& odr_filename,
+                          const Network&     network,
+                          int                n_vehicles,
+                          double             spacing,
+                          double             speed,
+                          double             duration,
+                          const std::string& controller,
+                          unsigned int       seed);
+
+}  // namespace roadgenerator
@@ -5,63 +5,253 @@
 
 using namespace roadmanager;
 
-LaneIndependentRouter::LaneIndependentRouter(OpenDrive *odr) : odr_(odr), roadCalculations_(RoadCalculations())
+#define TARGET_STATE 0xFFFFFFFF  // open list entry is the target
+
+// Position of road reference line at given s value
+static void GetRoadReferencePoint(Road *road, double s, double &x, double &y)
 {
+    x = 0.0;
+    y = 0.0;
+    for (int i = road->GetNumberOfGeometries() - 1; i >= 0; i--)
+    {
+        Geometry *geom = road->GetGeometry(i);
+        if (s >= geom->GetS() || i == 0)
+        {
+            double h;
+            geom->EvaluateDS(CLAMP(s - geom->GetS(), 0.0, geom->GetLength()), &x, &y, &h);
+            return;
+        }
+    }
 }
 
-LaneIndependentRouter::~LaneIndependentRouter()
+size_t RouteCache::KeyHash::operator()(const Key &key) const
+{
+    size_t h = std::hash<int>()(key.startRoadId);
+    for (size_t v : {std::hash<int>()(key.startLaneId),
+                     std::hash<bool>()(key.forward),
+                     std::hash<int>()(key.targetRoadId),
+                     std::hash<int>()(key.targetLaneId),
+                     std::hash<double>()(key.targetS),
+                     std::hash<int>()(static_cast<int>(key.strategy))})
+    {
+        h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+bool RouteCache::KeyEqual::operator()(const Key &a, const Key &b) const
 {
-    clearQueue(unvisited_);
-    clearVector(visited_);
+    return a.startRoadId == b.startRoadId && a.startLaneId == b.startLaneId && a.forward == b.forward && a.targetRoadId == b.targetRoadId &&
+           a.targetLaneId == b.targetLaneId && a.targetS == b.targetS && a.strategy == b.strategy;
 }
 
-// Gets the next pathnode for the nextroad based on current srcnode
-std::vector<Node *> LaneIndependentRouter::GetNextNodes(Road *nextRoad, Road *targetRoad, Node *currentNode)
+bool RouteCache::Get(const Key &key, std::vector<Node> &path)
 {
-    std::vector<std::pair<int, int>> connectingLaneIds = GetConnectingLanes(currentNode, nextRoad);
-    if (connectingLaneIds.empty())
+    mutex_.Lock();
+
+    auto it = index_.find(key);
+    if (it == index_.end())
     {
-        return {};
+        misses_++;
+        mutex_.Unlock();
+        return false;
+    }
+
+    // Move entry first in list, marking it most recently used
+    entries_.splice(entries_.begin(), entries_, it->second);
+    path = it->second->second;
+    hits_++;
+
+    mutex_.Unlock();
+
+    return true;
+}
+
+void RouteCache::Put(const Key &key, const std::vector<Node> &path)
+{
+    mutex_.Lock();
+
+    if (capacity_ == 0)
+    {
+        mutex_.Unlock();
+        return;
+    }
+
+    auto it = index_.find(key);
+    if (it != index_.end())
+    {
+        entries_.erase(it->second);
+        index_.erase(it);
+    }
+
+    entries_.emplace_front(key, path);
+    index_[key] = entries_.begin();
+
+    while (entries_.size() > capacity_)
+    {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+
+    mutex_.Unlock();
+}
+
+void RouteCache::SetCapacity(size_t capacity)
+{
+    mutex_.Lock();
+
+    capacity_ = capacity;
+    while (entries_.size() > capacity_)
+    {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
     }
 
-    std::vector<Node *> nextNodes;
-    int                 targetLaneId = targetWaypoint_.GetLaneId();
-    ;
-    for (std::pair<int, int> lanePair : connectingLaneIds)
+    mutex_.Unlock();
+}
+
+size_t RouteCache::GetCapacity()
+{
+    mutex_.Lock();
+    size_t capacity = capacity_;
+    mutex_.Unlock();
+
+    return capacity;
+}
+
+size_t RouteCache::GetSize()
+{
+    mutex_.Lock();
+    size_t size = entries_.size();
+    mutex_.Unlock();
+
+    return size;
+}
+
+void RouteCache::Clear()
+{
+    mutex_.Lock();
+
+    entries_.clear();
+    index_.clear();
+    hits_   = 0;
+    misses_ = 0;
+
+    mutex_.Unlock();
+}
+
+void RouteCache::ResetCounters()
+{
+    hits_   = 0;
+    misses_ = 0;
+}
+
+LaneGraph::LaneGraph(OpenDrive *odr) : odr_(odr), max_speed_(0.0)
+{
+    RoadCalculations    roadCalculations;
+    int                 nRoads        = odr_->GetNumOfRoads();
+    int                 nWithoutTypes = 0;
+    std::vector<double> speed(static_cast<size_t>(nRoads));
+
+    groups_.resize(static_cast<size_t>(nRoads) * 6);
+
+    for (int i = 0; i < nRoads; i++)
     {
-        Node *pNode = nullptr;
-        if (nextRoad == targetRoad && lanePair.second == targetLaneId)
+        Road *road              = odr_->GetRoadByIdx(i);
+        roadIdx_[road->GetId()] = i;
+
+        if (road->GetNumberOfRoadTypes() == 0)
         {
-            // Target road found and driving in same direction, create a target node.
-            pNode = CreateTargetNode(currentNode, nextRoad, lanePair);
+            // Assume road is rural, warn once for all roads further down
+            speed[static_cast<size_t>(i)] = roadCalculations.GetRoadTypeSpeed(Road::RoadType::ROADTYPE_RURAL);
+            nWithoutTypes++;
         }
         else
         {
-            RoadLink *nextLink = GetNextLink(currentNode, nextRoad);
-            if (!nextLink)
+            speed[static_cast<size_t>(i)] = roadCalculations.CalcAverageSpeed(road);
+        }
+        max_speed_ = MAX(max_speed_, speed[static_cast<size_t>(i)]);
+
+        for (int exit = EXIT_SUCCESSOR; exit <= EXIT_NONE; exit++)
+        {
+            double x = 0.0;
+            double y = 0.0;
+            if (exit != EXIT_NONE)
             {
-                // Dont add node if it does not have a link. (end of road)
-                continue;
+                GetRoadReferencePoint(road, exit == EXIT_SUCCESSOR ? road->GetLength() : 0.0, x, y);
             }
-            // create next non target node
-            pNode                = new Node;
-            pNode->link          = nextLink;
-            pNode->road          = nextRoad;
-            pNode->currentLaneId = lanePair.second;
-            pNode->fromLaneId    = lanePair.first;
-            pNode->previous      = currentNode;
-            double nextWeight    = roadCalculations_.CalcWeight(currentNode, routeStrategy_, nextRoad->GetLength(), nextRoad);
-            pNode->weight        = currentNode->weight + nextWeight;
+            for (int side = 0; side < 2; side++)
+            {
+                ExitGroup &group = groups_[static_cast<size_t>(i) * 6 + static_cast<size_t>(exit) * 2 + static_cast<size_t>(side)];
+                group.road       = road;
+                group.link =
+                    exit == EXIT_NONE ? nullptr : road->GetLink(exit == EXIT_SUCCESSOR ? LinkType::SUCCESSOR : LinkType::PREDECESSOR);
+                group.x          = x;
+                group.y          = y;
+                group.first_edge = 0;
+                group.n_edges    = 0;
+            }
+        }
+    }
+
+    if (nWithoutTypes > 0)
+    {
+        LOG("Warning: %d roads have no road types (and speed limit), assumed rural in route calculations", nWithoutTypes);
+    }
+
+    // Then find all connections
+    for (size_t g = 0; g < groups_.size(); g++)
+    {
+        ExitGroup &group = groups_[g];
+        group.first_edge = static_cast<unsigned int>(edges_.size());
+
+        if (group.link == nullptr)
+        {
+            continue;
         }
-        if (pNode)
+
+        int side = (g % 2) ? 1 : -1;
+        for (Road *nextRoad : GetNextRoads(group.link, group.road))
         {
-            nextNodes.push_back(pNode);
+            std::vector<std::pair<int, int>> connectingLaneIds = GetConnectingLanes(group.road, group.link, side, nextRoad);
+            if (connectingLaneIds.empty())
+            {
+                continue;
+            }
+
+            RoadLink *nextLink  = GetNextLink(group.road, group.link, nextRoad);
+            double    nextSpeed = speed[static_cast<size_t>(roadIdx_[nextRoad->GetId()])];
+            Edge      edge;
+
+            // If average speed is 0, road can't be traveled on
+            edge.weight[Position::RouteStrategy::SHORTEST]          = nextRoad->GetLength();
+            edge.weight[Position::RouteStrategy::FASTEST]           = nextSpeed < SMALL_NUMBER ? LARGE_NUMBER : nextRoad->GetLength() / nextSpeed;
+            edge.weight[Position::RouteStrategy::MIN_INTERSECTIONS] = group.link->GetElementType() == RoadLink::ELEMENT_TYPE_JUNCTION ? 1 : 0;
+
+            for (std::pair<int, int> lanePair : connectingLaneIds)
+            {
+                edge.to           = GetExitGroupIndex(nextRoad, nextLink, lanePair.second);
+                edge.from_lane_id = lanePair.first;
+                edge.lane_id      = lanePair.second;
+                edges_.push_back(edge);
+            }
         }
+        group.n_edges = static_cast<unsigned int>(edges_.size()) - group.first_edge;
     }
-    return nextNodes;
 }
 
-std::vector<Road *> LaneIndependentRouter::GetNextRoads(RoadLink *link, Road *currentRoad)
+unsigned int LaneGraph::GetExitGroupIndex(Road *road, RoadLink *link, int laneId) const
+{
+    unsigned int exit = EXIT_NONE;
+    if (link != nullptr)
+    {
+        exit = link->GetType() == LinkType::SUCCESSOR ? EXIT_SUCCESSOR : EXIT_PREDECESSOR;
+    }
+
+    return static_cast<unsigned int>(roadIdx_.at(road->GetId())) * 6 + exit * 2 + (laneId > 0 ? 1 : 0);
+}
+
+std::vector<Road *> LaneGraph::GetNextRoads(RoadLink *link, Road *currentRoad) const
 {
     std::vector<Road *> nextRoads;
     Road               *nextRoad;
@@ -77,6 +267,10 @@ std::vector<Road *> LaneIndependentRouter::GetNextRoads(RoadLink *link, Road *cu
     {
         // check all junction links (connecting roads) that has pivot road as incoming road
         Junction *junction = odr_->GetJunctionById(link->GetElementId());
+        if (junction == nullptr)
+        {
+            return nextRoads;
+        }
         for (size_t j = 0; j < junction->GetNoConnectionsFromRoadId(currentRoad->GetId()); j++)
         {
             int roadId = junction->GetConnectingRoadIdFromIncomingRoadId(currentRoad->GetId(), (int)j);
@@ -90,12 +284,12 @@ std::vector<Road *> LaneIndependentRouter::GetNextRoads(RoadLink *link, Road *cu
     return nextRoads;
 }
 
-RoadLink *LaneIndependentRouter::GetNextLink(Node *currentNode, Road *nextRoad)
+RoadLink *LaneGraph::GetNextLink(Road *road, RoadLink *link, Road *nextRoad) const
 {
-    if (currentNode->link->GetElementType() == RoadLink::ELEMENT_TYPE_ROAD)
+    if (link->GetElementType() == RoadLink::ELEMENT_TYPE_ROAD)
     {
         // node link is a road, find link in the other end of it
-        if (currentNode->link->GetContactPointType() == ContactPointType::CONTACT_POINT_END)
+        if (link->GetContactPointType() == ContactPointType::CONTACT_POINT_END)
         {
             return nextRoad->GetLink(LinkType::PREDECESSOR);
         }
@@ -104,9 +298,9 @@ RoadLink *LaneIndependentRouter::GetNextLink(Node *currentNode, Road *nextRoad)
             return nextRoad->GetLink(LinkType::SUCCESSOR);
         }
     }
-    else if (currentNode->link->GetElementType() == RoadLink::ElementType::ELEMENT_TYPE_JUNCTION)
+    else if (link->GetElementType() == RoadLink::ElementType::ELEMENT_TYPE_JUNCTION)
     {
-        Junction *junction = Position::GetOpenDrive()->GetJunctionById(currentNode->link->GetElementId());
+        Junction *junction = odr_->GetJunctionById(link->GetElementId());
         int       elementId;
         if (junction && junction->GetType() == Junction::JunctionType::DIRECT)
         {
@@ -115,7 +309,7 @@ RoadLink *LaneIndependentRouter::GetNextLink(Node *currentNode, Road *nextRoad)
         else
         {
             // Default junction
-            elementId = currentNode->road->GetId();
+            elementId = road->GetId();
         }
 
         if (nextRoad->GetLink(LinkType::SUCCESSOR) && nextRoad->GetLink(LinkType::SUCCESSOR)->GetElementId() == elementId)
@@ -131,28 +325,28 @@ RoadLink *LaneIndependentRouter::GetNextLink(Node *currentNode, Road *nextRoad)
     return nullptr;
 }
 
-std::vector<std::pair<int, int>> LaneIndependentRouter::GetConnectingLanes(Node *currentNode, Road *nextRoad)
+std::vector<std::pair<int, int>> LaneGraph::GetConnectingLanes(Road *road, RoadLink *link, int side, Road *nextRoad) const
 {
     LaneSection *lanesection = nullptr;
-    if (currentNode->link->GetType() == LinkType::SUCCESSOR)
+    if (link->GetType() == LinkType::SUCCESSOR)
     {
-        int nrOfLanesection = currentNode->road->GetNumberOfLaneSections();
-        lanesection         = currentNode->road->GetLaneSectionByIdx(nrOfLanesection - 1);
+        int nrOfLanesection = road->GetNumberOfLaneSections();
+        lanesection         = road->GetLaneSectionByIdx(nrOfLanesection - 1);
     }
     else
     {
-        lanesection = currentNode->road->GetLaneSectionByIdx(0);
+        lanesection = road->GetLaneSectionByIdx(0);
     }
 
     std::vector<std::pair<int, int>> connectingLaneIds;
     int                              nrOfLanes = lanesection->GetNumberOfLanes();
-    for (size_t i = 0; i < nrOfLanes; i++)
+    for (int i = 0; i < nrOfLanes; i++)
     {
-        Lane *lane          = lanesection->GetLaneByIdx((int)i);
+        Lane *lane          = lanesection->GetLaneByIdx(i);
         int   currentlaneId = lane->GetId();
-        if (lane->IsDriving() && SIGN(currentlaneId) == SIGN(currentNode->currentLaneId) && lane->GetId() != 0)
+        if (lane->IsDriving() && SIGN(currentlaneId) == side && lane->GetId() != 0)
         {
-            int nextLaneId = currentNode->road->GetConnectingLaneId(currentNode->link, currentlaneId, nextRoad->GetId());
+            int nextLaneId = road->GetConnectingLaneId(link, currentlaneId, nextRoad->GetId());
             if (nextLaneId != 0)
             {
                 connectingLaneIds.push_back({currentlaneId, nextLaneId});
@@ -163,54 +357,26 @@ std::vector<std::pair<int, int>> LaneIndependentRouter::GetConnectingLanes(Node
     return connectingLaneIds;
 }
 
-Node *LaneIndependentRouter::CreateTargetNode(Node *currentNode, Road *nextRoad, std::pair<int, int> laneIds)
+LaneIndependentRouter::LaneIndependentRouter(OpenDrive *odr)
+    : graph_(odr->GetLaneGraph()),
+      odr_(odr),
+      roadCalculations_(RoadCalculations()),
+      routeStrategy_(Position::RouteStrategy::SHORTEST),
+      targetX_(0.0),
+      targetY_(0.0),
+      targetRoadLength_(0.0),
+      startGroup_(0),
+      startState_(0),
+      seq_(0)
 {
-    // Create last node (targetnode)
-    Node *targetNode          = new Node;
-    targetNode->previous      = currentNode;
-    targetNode->road          = nextRoad;
-    targetNode->currentLaneId = laneIds.second;
-    targetNode->fromLaneId    = laneIds.first;
-    targetNode->link          = nullptr;
-    double nextWeight         = roadCalculations_.CalcWeightWithPos(currentNode, targetWaypoint_, nextRoad, routeStrategy_);
-    targetNode->weight        = currentNode->weight + nextWeight;
-    return targetNode;
+    // one search state per edge, plus start
+    bestG_.resize(graph_->GetNumberOfEdges() + 1, LARGE_NUMBER);
+    closed_.resize(graph_->GetNumberOfEdges() + 1, false);
+    pred_.resize(graph_->GetNumberOfEdges() + 1, TARGET_STATE);
 }
 
-bool LaneIndependentRouter::FindGoal()
+LaneIndependentRouter::~LaneIndependentRouter()
 {
-    while (!unvisited_.empty())
-    {
-        Node *currentNode = unvisited_.top();
-        unvisited_.pop();
-        bool nodeIsVisited = std::find_if(visited_.begin(), visited_.end(), [currentNode](Node *n) { return *n == *currentNode; }) != visited_.end();
-        if (nodeIsVisited)
-        {
-            delete currentNode;
-            continue;
-        }
-        visited_.push_back(currentNode);
-        Road *targetRoad   = odr_->GetRoadById(targetWaypoint_.GetTrackId());
-        int   targetLaneId = targetWaypoint_.GetLaneId();
-        if (currentNode->road == targetRoad && currentNode->currentLaneId == targetLaneId)
-        {
-            return true;
-        }
-        if (!currentNode->link)
-        {
-            continue;
-        }
-        std::vector<Road *> nextRoads = GetNextRoads(currentNode->link, currentNode->road);
-        for (Road *nextRoad : nextRoads)
-        {
-            std::vector<Node *> nextNodes = GetNextNodes(nextRoad, targetRoad, currentNode);
-            for (Node *n : nextNodes)
-            {
-                unvisited_.push(n);
-            }
-        }
-    }
-    return false;
 }
 
 bool LaneIndependentRouter::IsPositionValid(Position pos)
@@ -233,48 +399,64 @@ bool LaneIndependentRouter::IsPositionValid(Position pos)
     return lane->IsDriving();  // true if lane is defined as drivable
 }
 
-Node *LaneIndependentRouter::CreateStartNode(RoadLink *link, Road *road, int laneId, ContactPointType contactPoint, Position pos)
+double LaneIndependentRouter::Heuristic(unsigned int group)
 {
-    Node *startNode          = new Node;
-    startNode->link          = link;
-    startNode->road          = road;
-    startNode->currentLaneId = laneId;
-    startNode->fromLaneId    = 0;
-    startNode->previous      = 0;
-
-    double roadLength = 0;
-
-    if (contactPoint == ContactPointType::CONTACT_POINT_START)
+    if (routeStrategy_ == Position::RouteStrategy::MIN_INTERSECTIONS)
     {
-        roadLength = pos.GetS();
-    }
-    else if (contactPoint == ContactPointType::CONTACT_POINT_END)
-    {
-        roadLength = road->GetLength() - pos.GetS();
+        return 0.0;
     }
 
-    double nextWeight = 0;
-    if (routeStrategy_ == Position::RouteStrategy::SHORTEST)
-    {
-        nextWeight = roadLength;
-    }
-    else if (routeStrategy_ == Position::RouteStrategy::FASTEST)
+    // Straight line distance to target. The target road might be entered from any end, at zero cost if entered
+    // via a junction link, so its length is subtracted to never overestimate the remaining cost.
+    const LaneGraph::ExitGroup &g    = graph_->GetExitGroup(group);
+    double                      dist = MAX(0.0, sqrt(pow(g.x - targetX_, 2) + pow(g.y - targetY_, 2)) - targetRoadLength_);
+
+    if (routeStrategy_ == Position::RouteStrategy::FASTEST)
     {
-        double averageSpeed = roadCalculations_.CalcAverageSpeed(road);
-        nextWeight          = roadLength / averageSpeed;
+        return graph_->GetMaxSpeed() > SMALL_NUMBER ? dist / graph_->GetMaxSpeed() : 0.0;
     }
-    else if (routeStrategy_ == Position::RouteStrategy::MIN_INTERSECTIONS)
+
+    return dist;
+}
+
+unsigned int LaneIndependentRouter::GetStateGroup(unsigned int state)
+{
+    return state == startState_ ? startGroup_ : graph_->GetEdge(state).to;
+}
+
+void LaneIndependentRouter::Push(double g, int laneChange, unsigned int state, unsigned int edge, unsigned int from)
+{
+    OpenEntry entry;
+    entry.f          = state == TARGET_STATE ? g : g + Heuristic(GetStateGroup(state));
+    entry.g          = g;
+    entry.laneChange = laneChange;
+    entry.seq        = seq_++;
+    entry.state      = state;
+    entry.edge       = edge;
+    entry.from       = from;
+
+    open_.push_back(entry);
+    std::push_heap(open_.begin(), open_.end(), OpenEntryCompare());
+
+    if (state != TARGET_STATE)
     {
-        nextWeight = 0;
+        touched_.push_back(state);
+        bestG_[state] = g;
     }
-    startNode->weight = nextWeight;
-    return startNode;
 }
 
 std::vector<Node> LaneIndependentRouter::CalculatePath(Position start, Position target)
 {
-    clearQueue(unvisited_);
-    clearVector(visited_);
+    // Reset search state of previous query
+    for (unsigned int state : touched_)
+    {
+        bestG_[state]  = LARGE_NUMBER;
+        closed_[state] = false;
+        pred_[state]   = TARGET_STATE;
+    }
+    touched_.clear();
+    open_.clear();
+    seq_ = 0;
 
     if (!IsPositionValid(start))
     {
@@ -293,6 +475,8 @@ std::vector<Node> LaneIndependentRouter::CalculatePath(Position start, Position
     targetWaypoint_    = target;
     Road *targetRoad   = odr_->GetRoadById(targetWaypoint_.GetTrackId());
     int   targetLaneId = targetWaypoint_.GetLaneId();
+    targetRoadLength_  = targetRoad->GetLength();
+    GetRoadReferencePoint(targetRoad, targetWaypoint_.GetS(), targetX_, targetY_);
 
     // Get routestrategy from traget position
     routeStrategy_ = target.GetRouteStrategy();
@@ -329,25 +513,125 @@ std::vector<Node> LaneIndependentRouter::CalculatePath(Position start, Position
         return {};
     }
 
-    Node *startNode = CreateStartNode(nextElement, startRoad, startLaneId, contactPoint, start);
-    unvisited_.push(startNode);
+    // Weight of remaining part of start road
+    double startWeight = 0;
+    double roadLength  = contactPoint == ContactPointType::CONTACT_POINT_START ? start.GetS() : startRoad->GetLength() - start.GetS();
+    if (routeStrategy_ == Position::RouteStrategy::SHORTEST)
+    {
+        startWeight = roadLength;
+    }
+    else if (routeStrategy_ == Position::RouteStrategy::FASTEST)
+    {
+        startWeight = roadLength / roadCalculations_.CalcAverageSpeed(startRoad);
+    }
 
-    bool              found = FindGoal();
+    // Paths are shared between routers, e.g. by vehicles having the same origin and destination
+    RouteCache::Key key =
+        {startRoad->GetId(), startLaneId, isInForwardDirection, targetRoad->GetId(), targetLaneId, targetWaypoint_.GetS(), routeStrategy_};
     std::vector<Node> pathToGoal;
-    if (found)
+    if (graph_->GetRouteCache().Get(key, pathToGoal))
     {
-        Node *nodeIterator = visited_.back();
-        while (nodeIterator != 0)
+        // Only the cost of the start road differs from the cached path
+        double startWeightDiff = startWeight - pathToGoal[0].weight;
+        for (Node &node : pathToGoal)
         {
-            pathToGoal.push_back(*nodeIterator);
-            nodeIterator = nodeIterator->previous;
+            node.weight += startWeightDiff;
         }
+        return pathToGoal;
     }
-    else
+
+    startGroup_ = graph_->GetExitGroupIndex(startRoad, nextElement, startLaneId);
+    startState_ = graph_->GetNumberOfEdges();
+    Push(startWeight, 0, startState_, startState_, TARGET_STATE);
+
+    OpenEntry goal;
+    bool      found = false;
+    while (!open_.empty())
+    {
+        std::pop_heap(open_.begin(), open_.end(), OpenEntryCompare());
+        OpenEntry current = open_.back();
+        open_.pop_back();
+
+        if (current.state == TARGET_STATE)
+        {
+            goal  = current;
+            found = true;
+            break;
+        }
+
+        if (closed_[current.state])
+        {
+            continue;
+        }
+        closed_[current.state] = true;
+        pred_[current.state]   = current.from;
+
+        const LaneGraph::ExitGroup &group         = graph_->GetExitGroup(GetStateGroup(current.state));
+        int                         currentLaneId = current.state == startState_ ? startLaneId : graph_->GetEdge(current.state).lane_id;
+
+        for (unsigned int i = group.first_edge; i < group.first_edge + group.n_edges; i++)
+        {
+            const LaneGraph::Edge &edge       = graph_->GetEdge(i);
+            Road                  *nextRoad   = graph_->GetExitGroup(edge.to).road;
+            int                    laneChange = abs(edge.lane_id - currentLaneId);
+
+            if (nextRoad == targetRoad && edge.lane_id == targetLaneId)
+            {
+                // Target road found and driving in same direction, weight of the part up to target position
+                Node previousNode;
+                previousNode.link = group.link;
+                double weight     = roadCalculations_.CalcWeightWithPos(&previousNode, targetWaypoint_, targetRoad, routeStrategy_);
+                Push(current.g + weight, laneChange, TARGET_STATE, i, current.state);
+            }
+            else if (graph_->GetExitGroup(edge.to).link != nullptr && !closed_[i])  // skip end of road
+            {
+                double g = current.g + edge.weight[routeStrategy_];
+                if (g <= bestG_[i])
+                {
+                    Push(g, laneChange, i, i, current.state);
+                }
+            }
+        }
+    }
+
+    if (!found)
     {
         LOG("(LaneIndependentRouter::CalculatePath) Warning: Path to target not found");
+        return {};
+    }
+
+    // Trace back from target to start
+    Node node;
+    node.road          = targetRoad;
+    node.currentLaneId = targetLaneId;
+    node.fromLaneId    = graph_->GetEdge(goal.edge).from_lane_id;
+    node.weight        = goal.g;
+    node.link          = nullptr;
+    node.previous      = nullptr;
+    pathToGoal.push_back(node);
+
+    for (unsigned int state = goal.from; state != TARGET_STATE; state = pred_[state])
+    {
+        const LaneGraph::ExitGroup &group = graph_->GetExitGroup(GetStateGroup(state));
+        node.road                         = group.road;
+        node.link                         = group.link;
+        node.weight                       = bestG_[state];
+        if (state == startState_)
+        {
+            node.currentLaneId = startLaneId;
+            node.fromLaneId    = 0;
+        }
+        else
+        {
+            node.currentLaneId = graph_->GetEdge(state).lane_id;
+            node.fromLaneId    = graph_->GetEdge(state).from_lane_id;
+        }
+        pathToGoal.push_back(node);
     }
     std::reverse(pathToGoal.begin(), pathToGoal.end());
+
+    graph_->GetRouteCache().Put(key, pathToGoal);
+
     return pathToGoal;
 }
 
@@ -416,7 +700,7 @@ double RoadCalculations::CalcAverageSpeed(Road *road)
     if (roadTypeCount == 0)
     {
         // Assume road is rural
-        LOG("Warning: Road %d has no road types (and speed limit)", road->GetId());
+        LOG_ONCE("Warning: Road %d has no road types (and speed limit), assumed rural (further roads not reported)", road->GetId());
         return roadTypeToSpeed[Road::RoadType::ROADTYPE_RURAL];
     }
 
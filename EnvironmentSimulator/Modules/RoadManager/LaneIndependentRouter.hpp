@@ -6,6 +6,9 @@
 #include "CommonMini.hpp"
 #include "RoadManager.hpp"
 #include <unordered_map>
+#include <memory>
+#include <list>
+#include <atomic>
 
 namespace roadmanager
 {
@@ -35,31 +38,6 @@ namespace roadmanager
         }
     } Node;
 
-    /**
-     * @brief operator for comparing weights of nodes in the priority queue
-     *
-     */
-    struct WeightCompare
-    {
-    public:
-        bool operator()(Node *a, Node *b)  // overloading both operators
-        {
-            if (a->weight == b->weight)  // sort after lanes if weight is same.
-            {
-                // Changes lane as soon as possible:
-                int aAbs = abs(a->currentLaneId - a->previous->currentLaneId);
-                int bAbs = abs(b->currentLaneId - b->previous->currentLaneId);
-                // Changes lane as late as possible:
-                // int aAbs = abs(a->currentLaneId);
-                // int bAbs = abs(b->currentLaneId);
-                return aAbs > bAbs;
-            }
-            else
-            {
-                return a->weight > b->weight;
-            }
-        }
-    };
     /**
      * @brief Contains the functionality for calculating weights for the lane independent pathfinder
      *
@@ -95,6 +73,16 @@ namespace roadmanager
          * @return double ((m) or (s) or (nr of intersection) depending on routestrategy)
          */
         double CalcWeightWithPos(Node *previousNode, Position pos, Road *road, Position::RouteStrategy routeStrategy);
+        /**
+         * @brief Get the assumed speed of a road type, used when no speed limit is given
+         *
+         * @param roadType
+         * @return double (m/s)
+         */
+        double GetRoadTypeSpeed(Road::RoadType roadType)
+        {
+            return roadTypeToSpeed[roadType];
+        }
 
     private:
         /**
@@ -112,48 +100,201 @@ namespace roadmanager
         };
     };
     /**
-     * @brief The lane independent pathfinder
+     * @brief Bounded cache of calculated paths, least recently used entry is dropped when full. Thread safe.
+     *  Paths only depend on start road, lane and direction, not on the start s value, so vehicles starting
+     *  anywhere on the same road and lane share entries.
      *
      */
-    class LaneIndependentRouter
+    class RouteCache
     {
     public:
+        typedef struct
+        {
+            int                     startRoadId;
+            int                     startLaneId;
+            bool                    forward;  // start direction along road
+            int                     targetRoadId;
+            int                     targetLaneId;
+            double                  targetS;  // affects cost of last road, hence choice of entry to target road
+            Position::RouteStrategy strategy;
+        } Key;
+
+        RouteCache(size_t capacity = 1000) : capacity_(capacity)
+        {
+        }
+
         /**
-         * @brief Construct a new Lane Independent Router object
+         * @brief Look up path
+         *
+         * @param key
+         * @param path will receive a copy of the path, if found
+         * @return true if found, else false
+         */
+        bool Get(const Key &key, std::vector<Node> &path);
+
+        /**
+         * @brief Add path, replacing any existing one of same key
+         *
+         * @param key
+         * @param path
+         */
+        void Put(const Key &key, const std::vector<Node> &path);
+
+        /**
+         * @brief Set max number of paths, 0 disables the cache
+         *
+         * @param capacity
+         */
+        void SetCapacity(size_t capacity);
+
+        size_t GetCapacity();
+        size_t GetSize();
+
+        /**
+         * @brief Remove all paths and reset counters
+         *
+         */
+        void Clear();
+
+        /**
+         * @brief Reset hit and miss counters, keeping the paths
+         *
+         */
+        void ResetCounters();
+
+        unsigned long long GetHits()
+        {
+            return hits_;
+        }
+
+        unsigned long long GetMisses()
+        {
+            return misses_;
+        }
+
+    private:
+        struct KeyHash
+        {
+            size_t operator()(const Key &key) const;
+        };
+
+        struct KeyEqual
+        {
+            bool operator()(const Key &a, const Key &b) const;
+        };
+
+        typedef std::list<std::pair<Key, std::vector<Node>>> EntryList;
+
+        SE_Mutex                                                        mutex_;
+        size_t                                                          capacity_;
+        EntryList                                                       entries_;  // most recently used first
+        std::unordered_map<Key, EntryList::iterator, KeyHash, KeyEqual> index_;
+        std::atomic<unsigned long long>                                 hits_   = {0};
+        std::atomic<unsigned long long>                                 misses_ = {0};
+    };
+
+    /**
+     * @brief Lane level routing graph of a road network, built once and shared by all routers of the network.
+     *  Lanes on the same side of a road and leaving through the same link have identical connections, so
+     *  they are grouped into one graph node ("exit group"). Edges, with precomputed weights per route strategy,
+     *  are stored in a compact array indexed by exit group.
+     *
+     */
+    class LaneGraph
+    {
+    public:
+        typedef enum
+        {
+            EXIT_SUCCESSOR   = 0,
+            EXIT_PREDECESSOR = 1,
+            EXIT_NONE        = 2  // no link to continue on (dead end)
+        } ExitType;
+
+        typedef struct
+        {
+            unsigned int to;            // index of exit group on next road
+            int          from_lane_id;  // lane on current road
+            int          lane_id;       // connected lane on next road
+            double       weight[3];     // cost of traveling the next road, per Position::RouteStrategy
+        } Edge;
+
+        typedef struct
+        {
+            Road        *road;
+            RoadLink    *link;        // link to leave the road by, nullptr if dead end
+            double       x;           // road reference line position at the exit end, for search heuristics
+            double       y;
+            unsigned int first_edge;  // index of first outgoing edge
+            unsigned int n_edges;
+        } ExitGroup;
+
+        /**
+         * @brief Build the graph of given road network
          *
          * @param odr the opendrive road network
          */
-        LaneIndependentRouter(OpenDrive *odr);
+        LaneGraph(OpenDrive *odr);
 
-        ~LaneIndependentRouter();
+        /**
+         * @brief Get index of exit group
+         *
+         * @param road
+         * @param link link to leave the road by (successor or predecessor of road), nullptr for dead end
+         * @param laneId any lane on the side of interest
+         * @return unsigned int, index of exit group
+         */
+        unsigned int GetExitGroupIndex(Road *road, RoadLink *link, int laneId) const;
+
+        const ExitGroup &GetExitGroup(unsigned int index) const
+        {
+            return groups_[index];
+        }
+
+        const Edge &GetEdge(unsigned int index) const
+        {
+            return edges_[index];
+        }
+
+        unsigned int GetNumberOfExitGroups() const
+        {
+            return static_cast<unsigned int>(groups_.size());
+        }
+
+        unsigned int GetNumberOfEdges() const
+        {
+            return static_cast<unsigned int>(edges_.size());
+        }
 
         /**
-         * @brief Calculates the path between two positions.
+         * @brief Highest average speed of any road, used for lower bound of travel time
          *
-         * @param start
-         * @param target
-         * @return std::vector<Node *>, empty list if path not found
+         * @return double (m/s)
          */
-        std::vector<Node> CalculatePath(Position start, Position target);
+        double GetMaxSpeed() const
+        {
+            return max_speed_;
+        }
+
         /**
-         * @brief Translate a list of nodes (path) in to waypoints
+         * @brief Cache of paths calculated on this graph, shared by all routers of the road network
          *
-         * @param path list of nodes
-         * @param start starting waypoint
-         * @param target target waypoint
-         * @return std::vector<Position>
+         * @return RouteCache&
          */
-        std::vector<Position> GetWaypoints(std::vector<Node> path, Position start, Position target);
+        RouteCache &GetRouteCache()
+        {
+            return route_cache_;
+        }
 
     private:
         /**
          * @brief Get the Next Link between two roads
          *
-         * @param currentNode
+         * @param road current road
+         * @param link link leaving current road
          * @param nextRoad
          * @return RoadLink*, if no link exist returns nullptr
          */
-        RoadLink *GetNextLink(Node *currentNode, Road *nextRoad);
+        RoadLink *GetNextLink(Road *road, RoadLink *link, Road *nextRoad) const;
         /**
          * @brief Get the nextroads from a link
          *
@@ -161,50 +302,89 @@ namespace roadmanager
          * @param currentRoad
          * @return std::vector<Road *>, empty if no roads exists
          */
-        std::vector<Road *> GetNextRoads(RoadLink *link, Road *currentRoad);
+        std::vector<Road *> GetNextRoads(RoadLink *link, Road *currentRoad) const;
         /**
-         * @brief Creates a Target Node
+         * @brief Get the Connecting Lanes between the lanes on one side of a road and the next road
          *
-         * @param currentNode
+         * @param road current road
+         * @param link link leaving current road
+         * @param side lane side of current road, -1 right or 1 left
          * @param nextRoad
-         * @param laneIds a pair containing the current and from lane id.
-         * @return Node*
-         */
-        Node *CreateTargetNode(Node *currentNode, Road *nextRoad, std::pair<int, int> laneIds);
-        /**
-         * @brief Creates a Start Node
-         *
-         * @param link
-         * @param road
-         * @param laneId
-         * @param contactPoint
-         * @param pos
-         * @return Node*
+         * @return std::vector<std::pair<int, int>>  <fromlaneId,currentLaneId>
          */
-        Node *CreateStartNode(RoadLink *link, Road *road, int laneId, ContactPointType contactPoint, Position pos);
+        std::vector<std::pair<int, int>> GetConnectingLanes(Road *road, RoadLink *link, int side, Road *nextRoad) const;
+
+        OpenDrive                   *odr_;
+        std::unordered_map<int, int> roadIdx_;  // road id to index
+        std::vector<ExitGroup>       groups_;   // six per road, see GetExitGroupIndex()
+        std::vector<Edge>            edges_;
+        double                       max_speed_;
+        RouteCache                   route_cache_;
+    };
+
+    /**
+     * @brief The lane independent pathfinder. A* search on the lane graph of the road network, with euclidean
+     *  distance (or travel time at highest road speed) as heuristic. Search buffers are kept between queries.
+     *
+     */
+    class LaneIndependentRouter
+    {
+    public:
         /**
-         * @brief Get the next nodes (one for each lane) for the next road
+         * @brief Construct a new Lane Independent Router object
          *
-         * @param nextRoad
-         * @param targetRoad
-         * @param currentNode currentNode
-         * @return std::vector<Node *>
+         * @param odr the opendrive road network
          */
-        std::vector<Node *> GetNextNodes(Road *nextRoad, Road *targetRoad, Node *currentNode);
+        LaneIndependentRouter(OpenDrive *odr);
+
+        ~LaneIndependentRouter();
+
         /**
-         * @brief Get the Connecting Lanes between a node (road,lane) and the next road
+         * @brief Calculates the path between two positions.
          *
-         * @param currentNode
-         * @param nextRoad
-         * @return std::vector<std::pair<int, int>>  <fromlaneId,currentLaneId>
+         * @param start
+         * @param target
+         * @return std::vector<Node *>, empty list if path not found
          */
-        std::vector<std::pair<int, int>> GetConnectingLanes(Node *currentNode, Road *nextRoad);
+        std::vector<Node> CalculatePath(Position start, Position target);
         /**
-         * @brief The main loop of the lane independent pathfinder
+         * @brief Translate a list of nodes (path) in to waypoints
          *
-         * @return true if path is found
+         * @param path list of nodes
+         * @param start starting waypoint
+         * @param target target waypoint
+         * @return std::vector<Position>
          */
-        bool FindGoal();
+        std::vector<Position> GetWaypoints(std::vector<Node> path, Position start, Position target);
+
+    private:
+        typedef struct
+        {
+            double       f;           // cost so far plus estimated remaining cost
+            double       g;           // cost so far
+            int          laneChange;  // lane id difference from previous road, less is preferred at equal cost
+            unsigned int seq;         // insertion order, for deterministic ordering of equal entries
+            unsigned int state;       // search state, or target
+            unsigned int edge;        // edge leading here
+            unsigned int from;        // search state on previous road
+        } OpenEntry;
+
+        struct OpenEntryCompare
+        {
+            bool operator()(const OpenEntry &a, const OpenEntry &b) const
+            {
+                if (a.f != b.f)
+                {
+                    return a.f > b.f;
+                }
+                else if (a.laneChange != b.laneChange)
+                {
+                    return a.laneChange > b.laneChange;  // change lane as soon as possible
+                }
+                return a.seq > b.seq;
+            }
+        };
+
         /**
          * @brief Checks if a position is valid on the OpenDRIVE network.
          *
@@ -213,45 +393,32 @@ namespace roadmanager
          * @return false
          */
         bool IsPositionValid(Position pos);
-        template <class Q>
-        void clearQueue(Q &q)
-        {
-            while (!q.empty())
-            {
-                auto p = q.top();
-                q.pop();
-                delete p;
-            }
-            q = Q();
-        }
-        template <class V>
-        void clearVector(V &v)
-        {
-            for (auto p : v)
-            {
-                delete p;
-            }
-            v.clear();
-        }
-
-        struct InspectionPriorityQueue : public std::priority_queue<Node *, std::vector<Node *>, WeightCompare>
-        {
-            using BaseClass = std::priority_queue<Node *, std::vector<Node *>, WeightCompare>;
-            using BaseClass::BaseClass;
+        /**
+         * @brief Estimate of remaining cost from exit of a group to the target, never overestimating
+         */
+        double       Heuristic(unsigned int group);
+        unsigned int GetStateGroup(unsigned int state);
+        void         Push(double g, int laneChange, unsigned int state, unsigned int edge, unsigned int from);
 
-        public:
-            std::vector<Node *> &GetUnderlyingContainer()
-            {
-                return c;
-            }
-        };
+        std::shared_ptr<LaneGraph> graph_;
+        OpenDrive                 *odr_;
+        RoadCalculations           roadCalculations_;
+        Position::RouteStrategy    routeStrategy_;
+        Position                   targetWaypoint_;
+        double                     targetX_;
+        double                     targetY_;
+        double                     targetRoadLength_;
+        unsigned int               startGroup_;
+        unsigned int               startState_;
 
-        InspectionPriorityQueue unvisited_;
-        std::vector<Node *>     visited_;
-        Position                targetWaypoint_;
-        OpenDrive              *odr_;
-        RoadCalculations        roadCalculations_;
-        Position::RouteStrategy routeStrategy_;
+        // Search buffers, reused between queries. A search state is the edge by which a lane on a road is entered,
+        // so that lane changes can be preferred as in a lane by lane search, or the start.
+        std::vector<OpenEntry>    open_;
+        std::vector<double>       bestG_;
+        std::vector<bool>         closed_;
+        std::vector<unsigned int> pred_;
+        std::vector<unsigned int> touched_;
+        unsigned int              seq_;
     };
 
 }  // namespace roadmanager
\ No newline at end of file
@@ -55,6 +55,7 @@
 #include <string>
 
 #include "RoadManager.hpp"
+#include "LaneIndependentRouter.hpp"
 #include "odrSpiral.h"
 #include "pugixml.hpp"
 #include "CommonMini.hpp"
@@ -67,6 +68,7 @@ using namespace roadmanager;
 #define OSI_POINT_CALC_STEPSIZE    1     // [m]
 #define OSI_TANGENT_LINE_TOLERANCE 0.01  // [m]
 #define OSI_POINT_DIST_SCALE       0.025
+#define OSI_POINT_BATCH_SIZE       8  // number of fixed-step candidate points evaluated ahead in one batch
 #define ROADMARK_WIDTH_STANDARD    0.15
 #define ROADMARK_WIDTH_BOLD        0.20
 #define NURBS_STEPLENGTH           1.0
@@ -74,6 +76,35 @@ using namespace roadmanager;
 static int g_Lane_id;
 static int g_Laneb_id;
 
+// Branch-free binary search in sorted arrays of s-values, e.g. start of each lane section along a road.
+// Return number of elements in s_values[0 .. n-1] being less than (LowerBoundS) or not greater than (UpperBoundS) s,
+// i.e. same as std::lower_bound and std::upper_bound but with the conditional steps compiling into cmov instructions.
+static inline int LowerBoundS(const double* s_values, int n, double s)
+{
+    const double* base = s_values;
+    while (n > 0)
+    {
+        int  half = n / 2;
+        bool less = base[half] < s;
+        base      = less ? base + half + 1 : base;
+        n         = less ? n - half - 1 : half;
+    }
+    return static_cast<int>(base - s_values);
+}
+
+static inline int UpperBoundS(const double* s_values, int n, double s)
+{
+    const double* base = s_values;
+    while (n > 0)
+    {
+        int  half     = n / 2;
+        bool not_more = base[half] <= s;
+        base          = not_more ? base + half + 1 : base;
+        n             = not_more ? n - half - 1 : half;
+    }
+    return static_cast<int>(base - s_values);
+}
+
 const char* object_type_str[] = {"barrier",   "bike",     "building",     "bus",          "car",           "crosswalk",  "gantry",
                                  "motorbike", "none",     "obstacle",     "parkingSpace", "patch",         "pedestrian", "pole",
                                  "railing",   "roadmark", "soundbarrier", "streetlamp",   "trafficisland", "trailer",    "train",
@@ -605,6 +636,14 @@ void Geometry::EvaluateDS(double ds, double* x, double* y, double* h) const
     LOG("Geometry virtual Evaluate");
 }
 
+void Geometry::EvaluateDSBatch(const double* ds, size_t n, double* x, double* y, double* h) const
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        EvaluateDS(ds[i], &x[i], &y[i], &h[i]);
+    }
+}
+
 void Line::Print() const
 {
     LOG("Line x: %.2f, y: %.2f, h: %.2f length: %.2f", GetX(), GetY(), GetHdg(), GetLength());
@@ -617,6 +656,23 @@ void Line::EvaluateDS(double ds, double* x, double* y, double* h) const
     *y = GetY() + ds * sin(*h);
 }
 
+void Line::EvaluateDSBatch(const double* ds, size_t n, double* x, double* y, double* h) const
+{
+    const double hdg   = GetHdg();
+    const double x0    = GetX();
+    const double y0    = GetY();
+    const double cos_h = cos(hdg);
+    const double sin_h = sin(hdg);
+
+    // no dependencies between iterations, let the compiler vectorize
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = x0 + ds[i] * cos_h;
+        y[i] = y0 + ds[i] * sin_h;
+        h[i] = hdg;
+    }
+}
+
 double Arc::GetRadius() const
 {
     if (abs(curvature_) < SMALL_NUMBER)
@@ -671,6 +727,34 @@ void Arc::EvaluateDS(double ds, double* x, double* y, double* h) const
     }
 }
 
+void Arc::EvaluateDSBatch(const double* ds, size_t n, double* x, double* y, double* h) const
+{
+    if (abs(curvature_) < SMALL_NUMBER)  // line
+    {
+        Line(GetS(), GetX(), GetY(), GetHdg(), GetLength()).EvaluateDSBatch(ds, n, x, y, h);
+        return;
+    }
+
+    const double hdg   = GetHdg();
+    const double x0    = GetX();
+    const double y0    = GetY();
+    const double cos_h = cos(hdg);
+    const double sin_h = sin(hdg);
+    const double r     = 1.0 / curvature_;  // signed radius
+
+    for (size_t i = 0; i < n; i++)
+    {
+        // local coordinates, start point in origo and heading along x axis
+        double angle = ds[i] * curvature_;
+        double u     = r * sin(angle);
+        double v     = r * (1.0 - cos(angle));
+
+        x[i] = x0 + u * cos_h - v * sin_h;
+        y[i] = y0 + u * sin_h + v * cos_h;
+        h[i] = hdg + angle;
+    }
+}
+
 Spiral::Spiral(double s, double x, double y, double hdg, double length, double curv_start, double curv_end)
     : Geometry(s, x, y, hdg, length, GEOMETRY_TYPE_SPIRAL),
       curv_start_(curv_start),
@@ -765,6 +849,56 @@ void Spiral::EvaluateDS(double ds, double* x, double* y, double* h) const
     }
 }
 
+void Spiral::EvaluateDSBatch(const double* ds, size_t n, double* x, double* y, double* h) const
+{
+    if (clothoid_type_ == LINE || clothoid_type_ == ARC)
+    {
+        // distance is clamped to the geometry, only make a copy when needed
+        std::vector<double> ds_clamped;
+        for (size_t i = 0; i < n; i++)
+        {
+            if (ds[i] < 0.0 || ds[i] > length_)
+            {
+                ds_clamped.assign(ds, ds + n);
+                for (size_t j = i; j < n; j++)
+                {
+                    ds_clamped[j] = MAX(MIN(ds_clamped[j], length_), 0.0);
+                }
+                ds = ds_clamped.data();
+                break;
+            }
+        }
+
+        if (clothoid_type_ == LINE)
+        {
+            line_.EvaluateDSBatch(ds, n, x, y, h);
+        }
+        else
+        {
+            arc_.EvaluateDSBatch(ds, n, x, y, h);
+        }
+        return;
+    }
+
+    // combine the two rotations, first to spiral segment start then to geometry heading, into one
+    const double rot   = GetHdg() - GetH0();
+    const double cos_r = cos(rot);
+    const double sin_r = sin(rot);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double xTmp, yTmp, t;
+        odrSpiral(s0_ + MAX(MIN(ds[i], length_), 0.0), c_dot_, &xTmp, &yTmp, &t);
+
+        double x1 = xTmp - GetX0();
+        double y1 = yTmp - GetY0();
+
+        x[i] = GetX() + x1 * cos_r - y1 * sin_r;
+        y[i] = GetY() + x1 * sin_r + y1 * cos_r;
+        h[i] = t + rot;
+    }
+}
+
 double Spiral::EvaluateCurvatureDS(double ds) const
 {
     if (clothoid_type_ == LINE)
@@ -901,6 +1035,25 @@ void Poly3::EvaluateDS(double ds, double* x, double* y, double* h) const
     *h = GetHdg() + atan(poly3_.EvaluatePrim(u_local));
 }
 
+void Poly3::EvaluateDSBatch(const double* ds, size_t n, double* x, double* y, double* h) const
+{
+    const double hdg   = GetHdg();
+    const double cos_h = cos(hdg);
+    const double sin_h = sin(hdg);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double u_local = 0;
+        double v_local = 0;
+
+        EvaluateDSLocal(ds[i], u_local, v_local);
+
+        x[i] = GetX() + u_local * cos_h - v_local * sin_h;
+        y[i] = GetY() + u_local * sin_h + v_local * cos_h;
+        h[i] = hdg + atan(poly3_.EvaluatePrim(u_local));
+    }
+}
+
 double Poly3::EvaluateCurvatureDS(double ds) const
 {
     return poly3_.EvaluatePrimPrim(ds);
@@ -936,6 +1089,38 @@ void ParamPoly3::EvaluateDS(double ds, double* x, double* y, double* h) const
     *h = hdg + atan2(poly3V_.EvaluatePrim(p), poly3U_.EvaluatePrim(p));
 }
 
+void ParamPoly3::EvaluateDSBatch(const double* ds, size_t n, double* x, double* y, double* h) const
+{
+    const double hdg   = GetHdg();
+    const double cos_h = cos(hdg);
+    const double sin_h = sin(hdg);
+    size_t       idx   = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (i > 0 && ds[i] >= ds[i - 1])
+        {
+            // increasing distance, just continue walking the table from previous entry
+            while (idx < PARAMPOLY3_STEPS + 1 && !(s2p_map_[idx][0] > ds[i]))
+            {
+                idx++;
+            }
+        }
+        else
+        {
+            idx = S2PIdx(ds[i]);
+        }
+
+        double p       = S2PByIdx(ds[i], idx);
+        double u_local = poly3U_.Evaluate(p);
+        double v_local = poly3V_.Evaluate(p);
+
+        x[i] = GetX() + u_local * cos_h - v_local * sin_h;
+        y[i] = GetY() + u_local * sin_h + v_local * cos_h;
+        h[i] = hdg + atan2(poly3V_.EvaluatePrim(p), poly3U_.EvaluatePrim(p));
+    }
+}
+
 double ParamPoly3::EvaluateCurvatureDS(double ds) const
 {
     double up          = poly3U_.EvaluatePrim(ds);
@@ -991,17 +1176,46 @@ void ParamPoly3::calcS2PMap(PRangeType p_range)
     }
 }
 
-double ParamPoly3::S2P(double s) const
+size_t ParamPoly3::S2PIdx(double s) const
 {
-    for (size_t i = 0; i < PARAMPOLY3_STEPS; i++)
+    // binary search, first entry is always 0 so start looking from the second one
+    size_t lo = 1;
+    size_t hi = PARAMPOLY3_STEPS + 1;
+
+    while (lo < hi)
     {
-        if (s2p_map_[i + 1][0] > s)
+        size_t mid = lo + (hi - lo) / 2;
+        if (s2p_map_[mid][0] > s)
         {
-            double w = (s - s2p_map_[i][0]) / (s2p_map_[i + 1][0] - s2p_map_[i][0]);
-            return s2p_map_[i][1] + w * (s2p_map_[i + 1][1] - s2p_map_[i][1]);
+            hi = mid;
         }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+
+    return lo;
+}
+
+double ParamPoly3::S2PByIdx(double s, size_t idx) const
+{
+    if (idx < 1)
+    {
+        idx = 1;
+    }
+    else if (idx > PARAMPOLY3_STEPS)
+    {
+        return s2p_map_[PARAMPOLY3_STEPS][1];
     }
-    return s2p_map_[PARAMPOLY3_STEPS][1];
+
+    double w = (s - s2p_map_[idx - 1][0]) / (s2p_map_[idx][0] - s2p_map_[idx - 1][0]);
+    return s2p_map_[idx - 1][1] + w * (s2p_map_[idx][1] - s2p_map_[idx - 1][1]);
+}
+
+double ParamPoly3::S2P(double s) const
+{
+    return S2PByIdx(s, S2PIdx(s));
 }
 
 void Elevation::Print() const
@@ -1481,35 +1695,16 @@ int Road::GetLaneSectionIdxByS(double s, int start_at) const
         return -1;
     }
 
-    LaneSection* lane_section = lane_section_[start_at];
-    size_t       i            = start_at;
-
-    if (s < lane_section->GetS() && start_at > 0)
+    if (s < lane_section_s_[start_at] && start_at > 0)
     {
-        // Look backwards
-        for (i = start_at - 1; i > 0; i--)  // No need to check the first one
-        {
-            lane_section = GetLaneSectionByIdx((int)i);
-            if (s > lane_section->GetS())
-            {
-                break;
-            }
-        }
+        // Look backwards, for last lane section starting before s
+        return MAX(0, LowerBoundS(lane_section_s_.data(), start_at, s) - 1);
     }
     else
     {
-        // look forward
-        for (i = start_at; i < GetNumberOfLaneSections() - 1; i++)  // No need to check the last one
-        {
-            lane_section = GetLaneSectionByIdx((int)i);
-            if (s < lane_section->GetS() + lane_section->GetLength())
-            {
-                break;
-            }
-        }
+        // look forward, for last lane section starting at or before s
+        return MAX(0, UpperBoundS(lane_section_s_.data(), GetNumberOfLaneSections(), s) - 1);
     }
-
-    return (int)i;
 }
 
 int Road::GetLaneInfoByS(double s, int start_lane_section_idx, int start_lane_id, LaneInfo& lane_info, int laneTypeMask) const
@@ -1742,6 +1937,33 @@ Geometry* Road::GetGeometry(int idx) const
     return geometry_[idx];
 }
 
+int Road::GetGeometryIdxByS(double s, int start_at) const
+{
+    if (start_at < 0 || start_at > GetNumberOfGeometries() - 1)
+    {
+        return -1;
+    }
+
+    if (s > geometry_s_end_[start_at])
+    {
+        // Look forward, for first geometry ending at or after s (last one as fallback)
+        return start_at + LowerBoundS(&geometry_s_end_[start_at], GetNumberOfGeometries() - 1 - start_at, s);
+    }
+    else if (s < geometry_s_[start_at])
+    {
+        // Look backwards, for last geometry starting at or before s (first one as fallback)
+        return MAX(0, UpperBoundS(geometry_s_.data(), start_at, s) - 1);
+    }
+
+    return start_at;
+}
+
+void Road::AddGeometryS(Geometry* geometry)
+{
+    geometry_s_.push_back(geometry->GetS());
+    geometry_s_end_.push_back(geometry->GetS() + geometry->GetLength());
+}
+
 void LaneSection::Print() const
 {
     LOG("LaneSection: %.2f, %d lanes:", s_, (int)lane_.size());
@@ -2333,26 +2555,31 @@ void Road::Print() const
 void Road::AddLine(Line* line)
 {
     geometry_.push_back((Geometry*)line);
+    AddGeometryS(geometry_.back());
 }
 
 void Road::AddArc(Arc* arc)
 {
     geometry_.push_back((Geometry*)arc);
+    AddGeometryS(geometry_.back());
 }
 
 void Road::AddSpiral(Spiral* spiral)
 {
     geometry_.push_back((Geometry*)spiral);
+    AddGeometryS(geometry_.back());
 }
 
 void Road::AddPoly3(Poly3* poly3)
 {
     geometry_.push_back((Geometry*)poly3);
+    AddGeometryS(geometry_.back());
 }
 
 void Road::AddParamPoly3(ParamPoly3* param_poly3)
 {
     geometry_.push_back((Geometry*)param_poly3);
+    AddGeometryS(geometry_.back());
 }
 
 void Road::AddElevation(Elevation* elevation)
@@ -2366,6 +2593,7 @@ void Road::AddElevation(Elevation* elevation)
     elevation->SetLength(length_ - elevation->GetS());
 
     elevation_profile_.push_back((Elevation*)elevation);
+    elevation_s_.push_back(elevation->GetS());
 }
 
 void Road::AddSuperElevation(Elevation* super_elevation)
@@ -2379,6 +2607,7 @@ void Road::AddSuperElevation(Elevation* super_elevation)
     super_elevation->SetLength(length_ - super_elevation->GetS());
 
     super_elevation_profile_.push_back((Elevation*)super_elevation);
+    super_elevation_s_.push_back(super_elevation->GetS());
 }
 
 Elevation* Road::GetElevation(int idx) const
@@ -2558,39 +2787,25 @@ RMObject::ObjectType RMObject::Str2Type(std::string type)
 
 double Road::GetLaneOffset(double s) const
 {
-    int i = 0;
-
     if (lane_offset_.size() == 0)
     {
         return 0;
     }
 
-    for (; i + 1 < (int)lane_offset_.size(); i++)
-    {
-        if (s < lane_offset_[i + 1]->GetS())
-        {
-            break;
-        }
-    }
+    int i = MAX(0, UpperBoundS(lane_offset_s_.data(), static_cast<int>(lane_offset_s_.size()), s) - 1);
+
     return (lane_offset_[i]->GetLaneOffset(s));
 }
 
 double Road::GetLaneOffsetPrim(double s) const
 {
-    int i = 0;
-
     if (lane_offset_.size() == 0)
     {
         return 0;
     }
 
-    for (; i + 1 < (int)lane_offset_.size(); i++)
-    {
-        if (s < lane_offset_[i + 1]->GetS())
-        {
-            break;
-        }
-    }
+    int i = MAX(0, UpperBoundS(lane_offset_s_.data(), static_cast<int>(lane_offset_s_.size()), s) - 1);
+
     return (lane_offset_[i]->GetLaneOffsetPrim(s));
 }
 
@@ -2922,10 +3137,12 @@ void Road::AddLaneOffset(LaneOffset* lane_offset)
                                               lane_offset->GetPolynomial().GetB(),
                                               lane_offset->GetPolynomial().GetC(),
                                               lane_offset->GetPolynomial().GetD()));
+        lane_offset_s_.push_back(0.0);
     }
     lane_offset->SetLength(length_ - lane_offset->GetS());
 
     lane_offset_.push_back((LaneOffset*)lane_offset);
+    lane_offset_s_.push_back(lane_offset->GetS());
 }
 
 double Road::GetCenterOffset(double s, int lane_id) const
@@ -2975,6 +3192,7 @@ void Road::AddLaneSection(LaneSection* lane_section)
     lane_section->SetLength(length_ - lane_section->GetS());
 
     lane_section_.push_back((LaneSection*)lane_section);
+    lane_section_s_.push_back(lane_section->GetS());
 }
 
 bool Road::GetZAndPitchByS(double s, double* z, double* z_prim, double* z_primPrim, double* pitch, int* index) const
@@ -2994,19 +3212,15 @@ bool Road::GetZAndPitchByS(double s, double* z, double* z_prim, double* z_primPr
 
         if (elevation && s > elevation->GetS() + elevation->GetLength() - SMALL_NUMBER)
         {
-            while (s > elevation->GetS() + elevation->GetLength() - SMALL_NUMBER && *index < GetNumberOfElevations() - 1)
-            {
-                // Move to next elevation section
-                elevation = GetElevation(++*index);
-            }
+            // Move to next elevation section containing s
+            *index    = LowerBoundS(elevation_s_.data(), GetNumberOfElevations(), s + SMALL_NUMBER) - 1;
+            elevation = GetElevation(*index);
         }
         else if (elevation && s < elevation->GetS())
         {
-            while (s < elevation->GetS() && *index > 0)
-            {
-                // Move to previous elevation section
-                elevation = GetElevation(--*index);
-            }
+            // Move to previous elevation section containing s
+            *index    = MAX(0, UpperBoundS(elevation_s_.data(), *index, s) - 1);
+            elevation = GetElevation(*index);
         }
 
         if (elevation)
@@ -3043,19 +3257,15 @@ bool Road::UpdateZAndRollBySAndT(double s, double t, double* z, double* roadSupe
 
         if (super_elevation && s > super_elevation->GetS() + super_elevation->GetLength())
         {
-            while (s > super_elevation->GetS() + super_elevation->GetLength() && *index < GetNumberOfSuperElevations() - 1)
-            {
-                // Move to next elevation section
-                super_elevation = GetSuperElevation(++*index);
-            }
+            // Move to next elevation section containing s
+            *index          = LowerBoundS(super_elevation_s_.data(), GetNumberOfSuperElevations(), s) - 1;
+            super_elevation = GetSuperElevation(*index);
         }
         else if (super_elevation && s < super_elevation->GetS())
         {
-            while (s < super_elevation->GetS() && *index > 0)
-            {
-                // Move to previous elevation section
-                super_elevation = GetSuperElevation(--*index);
-            }
+            // Move to previous elevation section containing s
+            *index          = MAX(0, UpperBoundS(super_elevation_s_.data(), *index, s) - 1);
+            super_elevation = GetSuperElevation(*index);
         }
 
         if (super_elevation)
@@ -3215,6 +3425,35 @@ void OpenDrive::Clear()
 
     SetSpeedUnit(SpeedUnit::UNDEFINED);
     friction_.Reset();
+    lane_graph_.mutex_.Lock();
+    lane_graph_.graph_.reset();
+    lane_graph_.mutex_.Unlock();
+}
+
+std::shared_ptr<LaneGraph> OpenDrive::GetLaneGraph()
+{
+    lane_graph_.mutex_.Lock();
+
+    if (lane_graph_.graph_ == nullptr)
+    {
+        lane_graph_.graph_ = std::make_shared<LaneGraph>(this);
+    }
+    std::shared_ptr<LaneGraph> graph = lane_graph_.graph_;
+
+    lane_graph_.mutex_.Unlock();
+
+    return graph;
+}
+
+void OpenDrive::ResetState()
+{
+    lane_graph_.mutex_.Lock();
+    if (lane_graph_.graph_ != nullptr)
+    {
+        // graph and cached routes only depend on the road network, keep them for the next run
+        lane_graph_.graph_->GetRouteCache().ResetCounters();
+    }
+    lane_graph_.mutex_.Unlock();
 }
 
 bool OpenDrive::LoadOpenDriveFile(const char* filename, bool replace)
@@ -3223,6 +3462,9 @@ bool OpenDrive::LoadOpenDriveFile(const char* filename, bool replace)
     {
         Clear();
     }
+    lane_graph_.mutex_.Lock();
+    lane_graph_.graph_.reset();  // road network changes, graph needs to be rebuilt
+    lane_graph_.mutex_.Unlock();
 
     odr_filename_ = filename;
 
@@ -6227,7 +6469,10 @@ OpenDrive* Position::GetOpenDrive()
     return &od;
 }
 
-bool OpenDrive::CheckLaneOSIRequirement(std::vector<double> x0, std::vector<double> y0, std::vector<double> x1, std::vector<double> y1) const
+bool OpenDrive::CheckLaneOSIRequirement(const std::vector<double>& x0,
+                                        const std::vector<double>& y0,
+                                        const std::vector<double>& x1,
+                                        const std::vector<double>& y1) const
 {
     double x0_tan_diff, y0_tan_diff, x1_tan_diff, y1_tan_diff;
     x0_tan_diff = x0[2] - x0[0];
@@ -6328,10 +6573,134 @@ GetMaxSegmentLen(Position* pivot, Position* pos, double min, double max, double
     return max_segment_length;
 }
 
+// Evaluates x, y of points along a lane line, i.e. lane center, outer lane border or road mark line, without the overhead
+// of a complete Position update, e.g. for the tangent points needed by CheckLaneOSIRequirement(). Consecutive points on the
+// same geometry are evaluated in one batch through Geometry::EvaluateDSBatch(). Given same s, result equals x, y of
+// Position::SetLanePos(), SetLaneBoundaryPos() or SetRoadMarkPos() respectively.
+class LaneLineSampler
+{
+public:
+    /**
+            @param center true for lane center, false for outer border of the lane
+            @param t_offset Additional lateral offset, e.g. of a road mark line
+            @param s_max Max s value of tangent points
+    */
+    LaneLineSampler(Road* road, LaneSection* lsec, int lane_id, bool center, double t_offset, double s_max)
+        : road_(road),
+          lsec_(lsec),
+          lane_id_(lane_id),
+          center_(center),
+          t_offset_(t_offset),
+          s_max_(s_max)
+    {
+    }
+
+    void Evaluate(const double* s, int n, double* x, double* y)
+    {
+        double ds[OSI_POINT_BATCH_SIZE * 2];
+        double h[OSI_POINT_BATCH_SIZE * 2];
+        int    i = 0;
+
+        while (i < n)
+        {
+            // collect a run of points on the same geometry
+            geometry_idx_  = road_->GetGeometryIdxByS(CLAMP(s[i], 0.0, road_->GetLength()), geometry_idx_);
+            Geometry* geom = road_->GetGeometry(geometry_idx_);
+            int       m    = 0;
+
+            if (geom == nullptr)
+            {
+                geometry_idx_ = 0;
+                for (; i < n; i++)
+                {
+                    x[i] = y[i] = 0.0;
+                }
+                return;
+            }
+
+            do
+            {
+                ds[m] = CLAMP(s[i + m], 0.0, road_->GetLength()) - geom->GetS();
+                m++;
+            } while (i + m < n && m < OSI_POINT_BATCH_SIZE * 2 &&
+                     road_->GetGeometryIdxByS(CLAMP(s[i + m], 0.0, road_->GetLength()), geometry_idx_) == geometry_idx_);
+
+            geom->EvaluateDSBatch(ds, static_cast<size_t>(m), &x[i], &y[i], h);
+
+            // lateral offset perpendicular to reference line heading, see Position::Track2XYZ()
+            for (int k = 0; k < m; k++)
+            {
+                double s_k = CLAMP(s[i + k], 0.0, road_->GetLength());
+                double t   = t_offset_ + road_->GetLaneOffset(s_k);
+
+                if (lane_id_ != 0)
+                {
+                    t += (center_ ? lsec_->GetCenterOffset(s_k, lane_id_) : lsec_->GetOuterOffset(s_k, lane_id_)) * (lane_id_ < 0 ? -1 : 1);
+                }
+                x[i + k] += t * cos(h[k] + M_PI_2);
+                y[i + k] += t * sin(h[k] + M_PI_2);
+            }
+            i += m;
+        }
+    }
+
+    /**
+            Get tangent points, i.e. points at OSI_TANGENT_LINE_TOLERANCE before and after given candidate point.
+            When a step is given, the tangent points of following candidates s + step, s + 2 * step... up to s_end are
+            evaluated in the same batch and returned by subsequent calls with the same s values.
+            @param step Distance to next candidate, 0 for no look-ahead, e.g. while refining candidate position
+            @param x x-coordinates of the points before and after the candidate point
+            @param y y-coordinates of the points before and after the candidate point
+    */
+    void GetTangentPoints(double s, double step, double s_end, double x[2], double y[2])
+    {
+        if (batch_idx_ >= batch_size_ || batch_s_[batch_idx_] != s)
+        {
+            // evaluate next batch of candidates, accumulating s values the same way as the caller stepping one by one
+            batch_s_[0] = s;
+            batch_size_ = 1;
+            while (step > SMALL_NUMBER && batch_size_ < OSI_POINT_BATCH_SIZE && batch_s_[batch_size_ - 1] < s_end)
+            {
+                batch_s_[batch_size_] = MIN(batch_s_[batch_size_ - 1] + step, s_end);
+                batch_size_++;
+            }
+
+            double tangent_s[OSI_POINT_BATCH_SIZE * 2];
+            for (int i = 0; i < batch_size_; i++)
+            {
+                tangent_s[2 * i]     = MAX(batch_s_[i] - OSI_TANGENT_LINE_TOLERANCE, 0);
+                tangent_s[2 * i + 1] = MIN(batch_s_[i] + OSI_TANGENT_LINE_TOLERANCE, s_max_);
+            }
+            Evaluate(tangent_s, 2 * batch_size_, batch_x_, batch_y_);
+            batch_idx_ = 0;
+        }
+
+        x[0] = batch_x_[2 * batch_idx_];
+        y[0] = batch_y_[2 * batch_idx_];
+        x[1] = batch_x_[2 * batch_idx_ + 1];
+        y[1] = batch_y_[2 * batch_idx_ + 1];
+        batch_idx_++;
+    }
+
+private:
+    Road*        road_;
+    LaneSection* lsec_;
+    int          lane_id_;
+    bool         center_;
+    double       t_offset_;
+    double       s_max_;
+    int          geometry_idx_ = 0;
+    double       batch_s_[OSI_POINT_BATCH_SIZE];
+    double       batch_x_[OSI_POINT_BATCH_SIZE * 2];
+    double       batch_y_[OSI_POINT_BATCH_SIZE * 2];
+    int          batch_size_ = 0;
+    int          batch_idx_  = 0;
+};
+
 void OpenDrive::SetLaneOSIPoints()
 {
     // Initialization
-    Position                 pos_pivot, pos_tmp, pos_candidate;
+    Position                 pos_pivot, pos_candidate;
     Road*                    road;
     LaneSection*             lsec;
     Lane*                    lane;
@@ -6345,7 +6714,6 @@ void OpenDrive::SetLaneOSIPoints()
     int                      osiintersection;
 
     pos_pivot.SetMode(Position::PosModeType::SET, Position::PosMode::H_REL);
-    pos_tmp.SetMode(Position::PosModeType::SET, Position::PosMode::H_REL);
     pos_candidate.SetMode(Position::PosModeType::SET, Position::PosMode::H_REL);
 
     // Looping through each road
@@ -6402,19 +6770,21 @@ void OpenDrive::SetLaneOSIPoints()
                 PointStruct p = {lsec->GetS(), pos_pivot.GetX(), pos_pivot.GetY(), pos_pivot.GetZ(), pos_pivot.GetHRoad()};
                 osi_point.push_back(p);
 
-                // [XO, YO] = closest position with given (-) tolerance
-                pos_tmp.SetLanePos(road->GetId(), lane->GetId(), MAX(0, lsec->GetS() - OSI_TANGENT_LINE_TOLERANCE), 0, j);
-                x0.push_back(pos_tmp.GetX());
-                y0.push_back(pos_tmp.GetY());
+                // [XO, YO] = closest positions with given (-) and (+) tolerance
+                LaneLineSampler sampler(road, lsec, lane->GetId(), true, 0.0, lsec_end);
+                double          tangent_s[2] = {MAX(0, lsec->GetS() - OSI_TANGENT_LINE_TOLERANCE),
+                                                MIN(lsec->GetS() + OSI_TANGENT_LINE_TOLERANCE, lsec_end)};
+                double          tangent_x[2], tangent_y[2];
+                sampler.Evaluate(tangent_s, 2, tangent_x, tangent_y);
+                x0.push_back(tangent_x[0]);
+                y0.push_back(tangent_y[0]);
 
                 // Push real position between the +/- tolerance points
                 x0.push_back(pos_pivot.GetX());
                 y0.push_back(pos_pivot.GetY());
 
-                // [XO, YO] = closest position with given (+) tolerance
-                pos_tmp.SetLanePos(road->GetId(), lane->GetId(), MIN(lsec->GetS() + OSI_TANGENT_LINE_TOLERANCE, lsec_end), 0, j);
-                x0.push_back(pos_tmp.GetX());
-                y0.push_back(pos_tmp.GetY());
+                x0.push_back(tangent_x[1]);
+                y0.push_back(tangent_y[1]);
 
                 bool   insert = false;
                 double step   = OSI_POINT_CALC_STEPSIZE;
@@ -6430,18 +6800,16 @@ void OpenDrive::SetLaneOSIPoints()
                     // [X1, Y1] = Real position with no tolerance
                     pos_candidate.SetLanePos(road->GetId(), lane->GetId(), s, 0, j);
 
-                    // [X1, Y1] = closest position with given (-) tolerance
-                    pos_tmp.SetLanePos(road->GetId(), lane->GetId(), MAX(s - OSI_TANGENT_LINE_TOLERANCE, 0), 0, j);
-                    x1.push_back(pos_tmp.GetX());
-                    y1.push_back(pos_tmp.GetY());
+                    // [X1, Y1] = closest positions with given (-) and (+) tolerance, fixed-step candidates evaluated ahead
+                    sampler.GetTangentPoints(s, insert ? 0.0 : step, lsec_end - SMALL_NUMBER / 2, tangent_x, tangent_y);
+                    x1.push_back(tangent_x[0]);
+                    y1.push_back(tangent_y[0]);
 
                     x1.push_back(pos_candidate.GetX());
                     y1.push_back(pos_candidate.GetY());
 
-                    // [X1, Y1] = closest position with given (+) tolerance
-                    pos_tmp.SetLanePos(road->GetId(), lane->GetId(), MIN(s + OSI_TANGENT_LINE_TOLERANCE, lsec_end), 0, j);
-                    x1.push_back(pos_tmp.GetX());
-                    y1.push_back(pos_tmp.GetY());
+                    x1.push_back(tangent_x[1]);
+                    y1.push_back(tangent_y[1]);
 
                     // Check OSI Requirement between current given points
                     if (NEAR_NUMBERS(pos_pivot.GetH(), pos_candidate.GetH()))
@@ -6584,6 +6952,8 @@ void OpenDrive::SetLaneBoundaryPoints()
 
                 if (n_roadmarks == 0)
                 {
+                    LaneLineSampler sampler(road, lsec, lane->GetId(), false, 0.0, road->GetLength());
+
                     // Looping through sequential points along the track determined by "OSI_POINT_CALC_STEPSIZE"
                     while (true)
                     {
@@ -6592,43 +6962,29 @@ void OpenDrive::SetLaneBoundaryPoints()
                         // Make sure we stay within lane section length
                         s1 = MIN(s1, lsec_end - OSI_TANGENT_LINE_TOLERANCE);
 
-                        // [XO, YO] = closest position with given (-) tolerance
-                        pos.SetLaneBoundaryPos(road->GetId(), lane->GetId(), MAX(0, s0 - OSI_TANGENT_LINE_TOLERANCE), 0, j);
-                        x0.push_back(pos.GetX());
-                        y0.push_back(pos.GetY());
-
-                        // [XO, YO] = Real position with no tolerance
-                        pos.SetLaneBoundaryPos(road->GetId(), lane->GetId(), s0, 0, j);
-                        x0.push_back(pos.GetX());
-                        y0.push_back(pos.GetY());
+                        // [XO, YO] and [X1, Y1] = closest position with given (-) tolerance, real position with no tolerance and
+                        // closest position with given (+) tolerance, all evaluated in one batch
+                        double s_batch[6] = {MAX(0, s0 - OSI_TANGENT_LINE_TOLERANCE),
+                                             s0,
+                                             s0 + OSI_TANGENT_LINE_TOLERANCE,
+                                             s1 - OSI_TANGENT_LINE_TOLERANCE,
+                                             s1,
+                                             s1 + OSI_TANGENT_LINE_TOLERANCE};
+                        double x_batch[6], y_batch[6];
+                        sampler.Evaluate(s_batch, 6, x_batch, y_batch);
+                        x0.assign(&x_batch[0], &x_batch[3]);
+                        y0.assign(&y_batch[0], &y_batch[3]);
+                        x1.assign(&x_batch[3], &x_batch[6]);
+                        y1.assign(&y_batch[3], &y_batch[6]);
 
                         // Add the starting point of each lane as osi point
                         if (counter == 1)
                         {
+                            pos.SetLaneBoundaryPos(road->GetId(), lane->GetId(), s0, 0, j);
                             PointStruct p = {s0, pos.GetX(), pos.GetY(), pos.GetZ(), pos.GetHRoad()};
                             osi_point.push_back(p);
                         }
 
-                        // [XO, YO] = closest position with given (+) tolerance
-                        pos.SetLaneBoundaryPos(road->GetId(), lane->GetId(), s0 + OSI_TANGENT_LINE_TOLERANCE, 0, j);
-                        x0.push_back(pos.GetX());
-                        y0.push_back(pos.GetY());
-
-                        // [X1, Y1] = closest position with given (-) tolerance
-                        pos.SetLaneBoundaryPos(road->GetId(), lane->GetId(), s1 - OSI_TANGENT_LINE_TOLERANCE, 0, j);
-                        x1.push_back(pos.GetX());
-                        y1.push_back(pos.GetY());
-
-                        // [X1, Y1] = Real position with no tolerance
-                        pos.SetLaneBoundaryPos(road->GetId(), lane->GetId(), s1, 0, j);
-                        x1.push_back(pos.GetX());
-                        y1.push_back(pos.GetY());
-
-                        // [X1, Y1] = closest position with given (+) tolerance
-                        pos.SetLaneBoundaryPos(road->GetId(), lane->GetId(), s1 + OSI_TANGENT_LINE_TOLERANCE, 0, j);
-                        x1.push_back(pos.GetX());
-                        y1.push_back(pos.GetY());
-
                         // Check OSI Requirement between current given points
                         if (x1[1] - x0[1] != 0 && y1[1] - y0[1] != 0)
                         {
@@ -6642,6 +6998,7 @@ void OpenDrive::SetLaneBoundaryPoints()
                         // Make sure max segment length is longer than stepsize
                         if (osi_requirement)
                         {
+                            pos.SetLaneBoundaryPos(road->GetId(), lane->GetId(), s1 + OSI_TANGENT_LINE_TOLERANCE, 0, j);
                             max_segment_length = GetMaxSegmentLen(0,
                                                                   &pos,
                                                                   1.1 * OSI_POINT_CALC_STEPSIZE,
@@ -6906,33 +7263,21 @@ void OpenDrive::SetRoadMarkOSIPoints()
                                         PointStruct p = {s_roadmarkline, pos_pivot.GetX(), pos_pivot.GetY(), pos_pivot.GetZ(), pos_pivot.GetHRoad()};
                                         osi_point.push_back(p);
 
-                                        // [XO, YO] = closest position with given (-) tolerance
-                                        pos_tmp.SetRoadMarkPos(road->GetId(),
-                                                               lane->GetId(),
-                                                               m,
-                                                               0,
-                                                               n,
-                                                               MAX(0, s_roadmarkline - OSI_TANGENT_LINE_TOLERANCE),
-                                                               0,
-                                                               j);
-                                        x0.push_back(pos_tmp.GetX());
-                                        y0.push_back(pos_tmp.GetY());
+                                        // [XO, YO] = closest positions with given (-) and (+) tolerance
+                                        LaneLineSampler sampler(road, lsec, lane->GetId(), false, lane_roadMarkTypeLine->GetTOffset(), lsec_end);
+                                        double          tangent_s[2] = {MAX(0, s_roadmarkline - OSI_TANGENT_LINE_TOLERANCE),
+                                                                        MIN(s_roadmarkline + OSI_TANGENT_LINE_TOLERANCE, road->GetLength())};
+                                        double          tangent_x[2], tangent_y[2];
+                                        sampler.Evaluate(tangent_s, 2, tangent_x, tangent_y);
+                                        x0.push_back(tangent_x[0]);
+                                        y0.push_back(tangent_y[0]);
 
                                         // Push real position between the +/- tolerance points
                                         x0.push_back(pos_pivot.GetX());
                                         y0.push_back(pos_pivot.GetY());
 
-                                        // [XO, YO] = closest position with given (+) tolerance
-                                        pos_tmp.SetRoadMarkPos(road->GetId(),
-                                                               lane->GetId(),
-                                                               m,
-                                                               0,
-                                                               n,
-                                                               MIN(s_roadmarkline + OSI_TANGENT_LINE_TOLERANCE, road->GetLength()),
-                                                               0,
-                                                               j);
-                                        x0.push_back(pos_tmp.GetX());
-                                        y0.push_back(pos_tmp.GetY());
+                                        x0.push_back(tangent_x[1]);
+                                        y0.push_back(tangent_y[1]);
 
                                         bool   insert = false;
                                         double step   = OSI_POINT_CALC_STEPSIZE;
@@ -6947,26 +7292,16 @@ void OpenDrive::SetRoadMarkOSIPoints()
                                             // [X1, Y1] = Real position with no tolerance
                                             pos_candidate.SetRoadMarkPos(road->GetId(), lane->GetId(), m, 0, n, s, 0, j);
 
-                                            // [X1, Y1] = closest position with given (-) tolerance
-                                            pos_tmp
-                                                .SetRoadMarkPos(road->GetId(), lane->GetId(), m, 0, n, MAX(s - OSI_TANGENT_LINE_TOLERANCE, 0), 0, j);
-                                            x1.push_back(pos_tmp.GetX());
-                                            y1.push_back(pos_tmp.GetY());
+                                            // [X1, Y1] = closest positions with given (-) and (+) tolerance, fixed-step candidates evaluated ahead
+                                            sampler.GetTangentPoints(s, insert ? 0.0 : step, s_end_roadmark - SMALL_NUMBER / 2, tangent_x, tangent_y);
+                                            x1.push_back(tangent_x[0]);
+                                            y1.push_back(tangent_y[0]);
 
                                             x1.push_back(pos_candidate.GetX());
                                             y1.push_back(pos_candidate.GetY());
 
-                                            // [X1, Y1] = closest position with given (+) tolerance
-                                            pos_tmp.SetRoadMarkPos(road->GetId(),
-                                                                   lane->GetId(),
-                                                                   m,
-                                                                   0,
-                                                                   n,
-                                                                   MIN(s + OSI_TANGENT_LINE_TOLERANCE, lsec_end),
-                                                                   0,
-                                                                   j);
-                                            x1.push_back(pos_tmp.GetX());
-                                            y1.push_back(pos_tmp.GetY());
+                                            x1.push_back(tangent_x[1]);
+                                            y1.push_back(tangent_y[1]);
 
                                             // Check OSI Requirement between current given points
                                             if (NEAR_NUMBERS(pos_pivot.GetH(), pos_candidate.GetH()))
@@ -8249,29 +8584,13 @@ Position::ReturnCode Position::SetLongitudinalTrackPos(int track_id, double s)
         osi_point_idx_       = 0;
     }
 
-    Geometry* geometry = road->GetGeometry(geometry_idx_);
-    if (geometry == nullptr)
+    if (road->GetGeometry(geometry_idx_) == nullptr)
     {
         return ReturnCode::ERROR_GENERIC;
     }
 
-    // check if still on same geometry
-    if (s > geometry->GetS() + geometry->GetLength())
-    {
-        while (s > geometry->GetS() + geometry->GetLength() && geometry_idx_ < road->GetNumberOfGeometries() - 1)
-        {
-            // Move to next geometry
-            geometry = road->GetGeometry(++geometry_idx_);
-        }
-    }
-    else if (s < geometry->GetS())
-    {
-        while (s < geometry->GetS() && geometry_idx_ > 0)
-        {
-            // Move to previous geometry
-            geometry = road->GetGeometry(--geometry_idx_);
-        }
-    }
+    // check if still on same geometry, else find the one containing s
+    geometry_idx_ = road->GetGeometryIdxByS(s, geometry_idx_);
 
     if (s > road->GetLength())
     {
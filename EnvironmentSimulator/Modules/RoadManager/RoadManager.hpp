@@ -18,6 +18,7 @@
 #include <map>
 #include <vector>
 #include <list>
+#include <memory>
 #include "pugixml.hpp"
 #include "CommonMini.hpp"
 
@@ -214,6 +215,18 @@ namespace roadmanager
         virtual void   Print() const;
         virtual void   EvaluateDS(double ds, double *x, double *y, double *h) const;
 
+        /**
+         * Evaluate position and heading for a number of distances along the geometry in one call.
+         * Equivalent to calling EvaluateDS() for each entry, but lets the geometry types hoist any per-geometry
+         * computations out of the loop. Monotonic increasing ds values gives best performance.
+         * @param ds Array of distances along the geometry, relative start of geometry
+         * @param n Number of entries in ds and output arrays
+         * @param x Output array of x coordinates, size n
+         * @param y Output array of y coordinates, size n
+         * @param h Output array of headings, size n
+         */
+        virtual void EvaluateDSBatch(const double *ds, size_t n, double *x, double *y, double *h) const;
+
     protected:
         double       s_;
         double       x_;
@@ -236,6 +249,7 @@ namespace roadmanager
 
         void   Print() const;
         void   EvaluateDS(double ds, double *x, double *y, double *h) const;
+        void   EvaluateDSBatch(const double *ds, size_t n, double *x, double *y, double *h) const;
         double EvaluateCurvatureDS(double ds) const
         {
             (void)ds;
@@ -270,6 +284,7 @@ namespace roadmanager
         }
         void Print() const;
         void EvaluateDS(double ds, double *x, double *y, double *h) const;
+        void EvaluateDSBatch(const double *ds, size_t n, double *x, double *y, double *h) const;
 
     private:
         double curvature_;
@@ -340,6 +355,7 @@ namespace roadmanager
         }
         void   Print() const;
         void   EvaluateDS(double ds, double *x, double *y, double *h) const;
+        void   EvaluateDSBatch(const double *ds, size_t n, double *x, double *y, double *h) const;
         double EvaluateCurvatureDS(double ds) const;
         void   SetX(double x);
         void   SetY(double y);
@@ -382,6 +398,7 @@ namespace roadmanager
             return poly3_;
         }
         void   EvaluateDS(double ds, double *x, double *y, double *h) const;
+        void   EvaluateDSBatch(const double *ds, size_t n, double *x, double *y, double *h) const;
         double EvaluateCurvatureDS(double ds) const;
 
         Polynomial poly3_;
@@ -436,6 +453,7 @@ namespace roadmanager
             return poly3V_;
         }
         void   EvaluateDS(double ds, double *x, double *y, double *h) const;
+        void   EvaluateDSBatch(const double *ds, size_t n, double *x, double *y, double *h) const;
         double EvaluateCurvatureDS(double ds) const;
         void   calcS2PMap(PRangeType p_range);
         double s2p_map_[PARAMPOLY3_STEPS + 1][2];
@@ -443,6 +461,10 @@ namespace roadmanager
 
         Polynomial poly3U_;
         Polynomial poly3V_;
+
+    private:
+        size_t S2PIdx(double s) const;  // index of first map entry with s greater than given s
+        double S2PByIdx(double s, size_t idx) const;
     };
 
     class Elevation
@@ -2216,6 +2238,14 @@ namespace roadmanager
             return (int)geometry_.size();
         }
 
+        /**
+        Retrieve the geometry index at specified s-value
+        @param s distance along the road segment
+        @param start_at index of geometry to start search from, typically the one found previous time
+        @return geometry index, -1 if start_at is out of range
+        */
+        int GetGeometryIdxByS(double s, int start_at = 0) const;
+
         /**
         Retrieve the lanesection specified by vector element index (idx)
         useful for iterating over all available lane sections, e.g:
@@ -2409,6 +2439,17 @@ namespace roadmanager
         std::vector<LaneOffset *>    lane_offset_;
         std::vector<Signal *>        signal_;
         std::vector<RMObject *>      object_;
+
+        // Start (and for geometries also end) s-value of each entry of the vectors above, for fast lookup by s
+        std::vector<double> geometry_s_;
+        std::vector<double> geometry_s_end_;
+        std::vector<double> elevation_s_;
+        std::vector<double> super_elevation_s_;
+        std::vector<double> lane_section_s_;
+        std::vector<double> lane_offset_s_;
+
+    private:
+        void AddGeometryS(Geometry *geometry);
     };
 
     class LaneRoadLaneConnection
@@ -2670,6 +2711,8 @@ namespace roadmanager
         int         towgs84_;
     } GeoReference;
 
+    class LaneGraph;
+
     class OpenDrive
     {
     public:
@@ -2706,7 +2749,10 @@ namespace roadmanager
                 Setting information based on the OSI standards for OpenDrive elements
         */
         bool SetRoadOSI();
-        bool CheckLaneOSIRequirement(std::vector<double> x0, std::vector<double> y0, std::vector<double> x1, std::vector<double> y1) const;
+        bool CheckLaneOSIRequirement(const std::vector<double> &x0,
+                                     const std::vector<double> &y0,
+                                     const std::vector<double> &x1,
+                                     const std::vector<double> &y1) const;
         void SetLaneOSIPoints();
         void SetRoadMarkOSIPoints();
 
@@ -2747,6 +2793,18 @@ namespace roadmanager
             return (int)junction_.size();
         }
 
+        /**
+                Get the lane level routing graph of the road network. Built on first request, then shared by all routers.
+        */
+        std::shared_ptr<LaneGraph> GetLaneGraph();
+
+        /**
+                Reset state collected while running a scenario, e.g. route cache statistics, keeping the loaded road
+                network and anything derived from it only, like the lane graph and cached routes.
+                Use when the same road network is reused for another scenario run.
+        */
+        void ResetState();
+
         bool IsIndirectlyConnected(int road1_id, int road2_id, int *&connecting_road_id, int *&connecting_lane_id, int lane1_id = 0, int lane2_id = 0)
             const;
 
@@ -2827,6 +2885,24 @@ namespace roadmanager
         };
 
     private:
+        // Lane graph, built on first request from any thread. A copied road network gets its own graph, since it refers to its owner.
+        class LaneGraphInstance
+        {
+        public:
+            LaneGraphInstance() = default;
+            LaneGraphInstance(const LaneGraphInstance &)
+            {
+            }
+            LaneGraphInstance &operator=(const LaneGraphInstance &)
+            {
+                graph_.reset();
+                return *this;
+            }
+
+            std::shared_ptr<LaneGraph> graph_;
+            SE_Mutex                   mutex_;
+        };
+
         pugi::xml_node                     root_node_;
         std::vector<Road *>                road_;
         std::vector<Junction *>            junction_;
@@ -2838,6 +2914,7 @@ namespace roadmanager
         int                                versionMajor_;
         int                                versionMinor_;
         GlobalFriction                     friction_;
+        LaneGraphInstance                  lane_graph_;
     };
 
     typedef struct
@@ -28,6 +28,8 @@ using std::min;
 using triangle2D::overlap2d;
 using namespace STGeometry;
 
+#define CURVE_BATCH_SIZE 32  // number of uniformly spaced curve points evaluated per batch
+
 /******************************************
  *  _____     _                   _       *
  * |_   _| __(_) __ _ _ __   __ _| | ___  *
@@ -369,22 +371,45 @@ void aabbTree::curve2triangles(Geometry *geometry, double segmSize, double maxAn
     double s0     = 0;
     double length = geometry->GetLength();
     double ds     = min(segmSize, length);
+    double x0, y0, t0;
+
+    // Segment end points are evaluated in batches of uniform steps. A refined step breaks the
+    // uniform sequence, so then the batch is restarted from the refined point.
+    double bs[CURVE_BATCH_SIZE], bx[CURVE_BATCH_SIZE], by[CURVE_BATCH_SIZE], bt[CURVE_BATCH_SIZE];
+    size_t n_batch = 0;
+    size_t idx     = 0;
+
+    geometry->EvaluateDS(s0, &x0, &y0, &t0);
     while (s0 < length)
     {
-        double x0, y0, t0, x1, y1, t1, x2, y2;
+        double x1, y1, t1, x2, y2;
         int    count = 0;
-        geometry->EvaluateDS(s0, &x0, &y0, &t0);
 
-        double s1 = min(s0 + ds, length);
+        if (idx >= n_batch)
+        {
+            double s = s0;
+            for (n_batch = 0; n_batch < CURVE_BATCH_SIZE && s < length; n_batch++)
+            {
+                s           = min(s + ds, length);
+                bs[n_batch] = s;
+            }
+            geometry->EvaluateDSBatch(bs, n_batch, bx, by, bt);
+            idx = 0;
+        }
+
+        double s1 = bs[idx];
+        x1        = bx[idx];
+        y1        = by[idx];
+        t1        = bt[idx];
+        idx++;
 
-    s_1:
-        geometry->EvaluateDS(s1, &x1, &y1, &t1);
-        if (abs(t1 - t0) > maxAngle && count < 4)
+        while (abs(t1 - t0) > maxAngle && count < 4)
         {
             double dt = abs(t1 - t0) / (s1 - s0);
             s1        = s0 + maxAngle / dt;
+            geometry->EvaluateDS(s1, &x1, &y1, &t1);
+            n_batch = 0;  // continue uniform steps from the refined point
             count++;
-            goto s_1;
         }
 
         tangentIntersection(x0, y0, s0, t0, x1, y1, s1, t1, x2, y2);
@@ -392,5 +417,8 @@ void aabbTree::curve2triangles(Geometry *geometry, double segmSize, double maxAn
         ptBBox bbx = makeTriangleAndBbx(x0, y0, x1, y1, x2, y2, geometry, s0, s1);
         vec.push_back(bbx);
         s0 = s1;
+        x0 = x1;
+        y0 = y1;
+        t0 = t1;
     }
 }
@@ -264,6 +264,21 @@ void OSCCondition::Reset()
     timer_.Reset();
 }
 
+void OSCCondition::SyncState(SE_StateSnapshot& state)
+{
+    state.Value(last_result_);
+    state.Value(timer_);
+    state.Value(state_);
+}
+
+void ConditionGroup::SyncState(SE_StateSnapshot& state)
+{
+    for (auto c : condition_)
+    {
+        c->SyncState(state);
+    }
+}
+
 bool OSCCondition::Evaluate(double sim_time)
 {
     (void)sim_time;
@@ -398,6 +413,20 @@ void Trigger::Reset()
     }
 }
 
+void Trigger::SyncState(SE_StateSnapshot& state)
+{
+    for (auto cg : conditionGroup_)
+    {
+        cg->SyncState(state);
+    }
+}
+
+void TrigByEntity::SyncState(SE_StateSnapshot& state)
+{
+    OSCCondition::SyncState(state);
+    state.References(triggered_by_entities_);
+}
+
 bool TrigByState::CheckCondition(double sim_time)
 {
     (void)sim_time;
@@ -544,6 +573,13 @@ void TrigByState::Reset()
     OSCCondition::Reset();
 }
 
+void TrigByState::SyncState(SE_StateSnapshot& state)
+{
+    OSCCondition::SyncState(state);
+    state.Value(state_change_);
+    state.Value(latest_state_change_);
+}
+
 bool TrigBySimulationTime::CheckCondition(double sim_time)
 {
     sim_time_   = sim_time;
@@ -724,7 +760,7 @@ bool TrigByTimeToCollision::CheckCondition(double sim_time)
 
     triggered_by_entities_.clear();
     bool   result = false;
-    double rel_dist, rel_speed;
+    double rel_dist;
 
     ttc_ = -1;
 
@@ -757,35 +793,10 @@ bool TrigByTimeToCollision::CheckCondition(double sim_time)
             rel_dist = LARGE_NUMBER;
         }
 
-        if (object_)
-        {
-            // Calculate relative speed along triggering object's velocity direction
-            double rel_vel[2] = {0.0, 0.0};
-            ProjectPointOnVector2D(object_->pos_.GetVelX(),
-                                   object_->pos_.GetVelY(),
-                                   trigObj->pos_.GetVelX(),
-                                   trigObj->pos_.GetVelY(),
-                                   rel_vel[0],
-                                   rel_vel[1]);
-            rel_speed = GetLengthOfVector2D(trigObj->pos_.GetVelX() - rel_vel[0], trigObj->pos_.GetVelY() - rel_vel[1]);
-        }
-        else
-        {
-            rel_speed = trigObj->speed_;
-        }
+        ttc_ = trigObj->TimeToCollision(object_, rel_dist, false);
 
-        // TimeToCollision (TTC) not defined for cases:
-        //  - when target object is behind
-        //  - when triggering entity speed is <=0 (still or going reverse)
-        //  - when distance is constant or increasing
-        if (rel_dist < 0 || trigObj->speed_ < SMALL_NUMBER || rel_speed <= SMALL_NUMBER)
+        if (ttc_ >= 0.0)
         {
-            ttc_ = -1;
-        }
-        else
-        {
-            ttc_ = fabs(rel_dist / rel_speed);
-
             result = EvaluateRule(ttc_, value_, rule_);
 
             if (result == true)
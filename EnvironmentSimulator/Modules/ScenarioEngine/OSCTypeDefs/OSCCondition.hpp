@@ -77,6 +77,12 @@ namespace scenarioengine
         bool         CheckEdge(bool new_value, bool old_value, OSCCondition::ConditionEdge edge);
         std::string  Edge2Str();
         virtual void Reset();
+
+        /**
+            Save or restore dynamic state of the condition, e.g. last result and delay timer
+            @param state Snapshot to save into or restore from, depending on its mode
+        */
+        virtual void SyncState(SE_StateSnapshot& state);
     };
 
     class ConditionGroup
@@ -93,6 +99,7 @@ namespace scenarioengine
         }
 
         bool Evaluate(double sim_time);
+        void SyncState(SE_StateSnapshot& state);
     };
 
     class Trigger
@@ -113,6 +120,7 @@ namespace scenarioengine
 
         bool         Evaluate(double sim_time);
         virtual void Reset();
+        void         SyncState(SE_StateSnapshot& state);
 
     private:
         bool defaultValue_;  // applied on empty conditions
@@ -168,6 +176,8 @@ namespace scenarioengine
         void print()
         {
         }
+
+        void SyncState(SE_StateSnapshot& state) override;
     };
 
     class TrigByTimeHeadway : public TrigByEntity
@@ -493,6 +503,7 @@ namespace scenarioengine
         std::string CondElementState2Str(CondElementState state);
         void        Log();
         void        Reset();
+        void        SyncState(SE_StateSnapshot& state) override;
     };
 
     class TrigByValue : public OSCCondition
@@ -327,6 +327,8 @@ void SwarmTrafficAction::Step(double simTime, double dt)
 
 void SwarmTrafficAction::createRoadSegments(BBoxVec& vec)
 {
+    std::vector<double> samples, sx, sy, sh;
+
     for (int i = 0; i < odrManager_->GetNumOfRoads(); i++)
     {
         roadmanager::Road* road = odrManager_->GetRoadByIdx(i);
@@ -343,15 +345,26 @@ void SwarmTrafficAction::createRoadSegments(BBoxVec& vec)
                 }
                 case roadmanager::Geometry::GeometryType::GEOMETRY_TYPE_LINE:
                 {
+                    // Segment end points are known up front, evaluate all of them in one go
                     auto const length = gm->GetLength();
-                    for (double dist = gm->GetS(); dist < length;)
+                    samples.clear();
+                    for (double dist = gm->GetS(); dist < length; dist = MIN(dist + minSize_, length))
+                    {
+                        samples.push_back(dist);
+                    }
+                    if (samples.empty())
+                    {
+                        break;
+                    }
+                    samples.push_back(length);
+                    sx.resize(samples.size());
+                    sy.resize(samples.size());
+                    sh.resize(samples.size());
+                    gm->EvaluateDSBatch(samples.data(), samples.size(), sx.data(), sy.data(), sh.data());
+
+                    for (size_t k = 0; k < samples.size() - 1; k++)
                     {
-                        double ds = dist + minSize_;
-                        if (ds > length)
-                            ds = length;
-                        double x0, y0, x1, y1, x2, y2, dummy, l;
-                        gm->EvaluateDS(dist, &x0, &y0, &dummy);
-                        gm->EvaluateDS(ds, &x1, &y1, &dummy);
+                        double x0 = sx[k], y0 = sy[k], x1 = sx[k + 1], y1 = sy[k + 1], x2, y2, l;
                         l  = sqrt(pow(x1 - x0, 2) + pow(y1 - y0, 2));
                         x2 = (x1 + x0) / 2 + l / 4.0;
                         y2 = (y1 + y0) / 2 + l / 4.0;
@@ -360,11 +373,10 @@ void SwarmTrafficAction::createRoadSegments(BBoxVec& vec)
                         triangle->a         = a;
                         triangle->b         = b;
                         triangle->c         = c;
-                        triangle->sI        = dist;
-                        triangle->sF        = ds;
+                        triangle->sI        = samples[k];
+                        triangle->sF        = samples[k + 1];
                         ptBBox bbox         = make_shared<BBox>(triangle);
                         vec.push_back(bbox);
-                        dist = ds;
                     }
                     break;
                 }
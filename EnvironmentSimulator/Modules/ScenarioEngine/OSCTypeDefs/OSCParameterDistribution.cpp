@@ -14,9 +14,200 @@
 #include "OSCParameterDistribution.hpp"
 #include <iomanip>
 #include <sstream>
+#include <cmath>
+#include <cstdint>
 
 using namespace scenarioengine;
 
+#define SOBOL_MAX_DIMENSION 16
+#define SOBOL_BITS          32
+
+// Sobol direction number initialization (Joe & Kuo, new-joe-kuo-6.21201), dimension 2 and up.
+// Dimension 1 uses the van der Corput sequence and needs no table entry.
+static const struct
+{
+    unsigned int s;
+    unsigned int a;
+    unsigned int m[6];
+} sobol_init[SOBOL_MAX_DIMENSION - 1] = {
+    {1, 0, {1}},
+    {2, 1, {1, 3}},
+    {3, 1, {1, 3, 1}},
+    {3, 2, {1, 1, 1}},
+    {4, 1, {1, 1, 3, 3}},
+    {4, 4, {1, 3, 5, 13}},
+    {5, 2, {1, 1, 5, 5, 17}},
+    {5, 4, {1, 1, 5, 5, 5}},
+    {5, 7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6, 1, {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}},
+};
+
+static uint64_t SplitMix64(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Stateless hash of (seed, a, b) into the open interval (0, 1)
+static double HashToUnit(uint64_t seed, uint64_t a, uint64_t b)
+{
+    uint64_t h = SplitMix64(SplitMix64(SplitMix64(seed) ^ a) ^ b);
+    return (static_cast<double>(h >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+static double SobolSample(unsigned int index, unsigned int dim, uint32_t shift)
+{
+    uint32_t v[SOBOL_BITS];
+
+    if (dim == 0)
+    {
+        for (unsigned int k = 0; k < SOBOL_BITS; k++)
+        {
+            v[k] = 1u << (SOBOL_BITS - 1 - k);
+        }
+    }
+    else
+    {
+        unsigned int s = sobol_init[dim - 1].s;
+        unsigned int a = sobol_init[dim - 1].a;
+
+        for (unsigned int k = 0; k < SOBOL_BITS; k++)
+        {
+            if (k < s)
+            {
+                v[k] = sobol_init[dim - 1].m[k] << (SOBOL_BITS - 1 - k);
+            }
+            else
+            {
+                v[k] = v[k - s] ^ (v[k - s] >> s);
+                for (unsigned int l = 1; l < s; l++)
+                {
+                    if ((a >> (s - 1 - l)) & 1)
+                    {
+                        v[k] ^= v[k - l];
+                    }
+                }
+            }
+        }
+    }
+
+    // Gray code order allows direct access of any point, skip the first (all zero) point
+    uint32_t gray = (index + 1) ^ ((index + 1) >> 1);
+    uint32_t x    = 0;
+    for (unsigned int k = 0; gray != 0; k++, gray >>= 1)
+    {
+        if (gray & 1)
+        {
+            x ^= v[k];
+        }
+    }
+
+    // random digital shift keeps the low discrepancy property while making the sequence depend on the seed
+    return (static_cast<double>(x ^ shift) + 0.5) / 4294967296.0;
+}
+
+static double NormalCDF(double x)
+{
+    return 0.5 * std::erfc(-x / sqrt(2.0));
+}
+
+// Inverse of standard normal cumulative distribution function, P. J. Acklam's rational approximation
+static double InverseNormalCDF(double p)
+{
+    static const double a[] =
+        {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] =
+        {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00};
+
+    const double p_low = 0.02425;
+
+    p = CLAMP(p, 1e-300, 1.0 - 1e-16);
+
+    if (p < p_low)
+    {
+        double q = sqrt(-2 * log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+    else if (p > 1 - p_low)
+    {
+        double q = sqrt(-2 * log(1 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+}
+
+static double PoissonCDF(int k, double lambda)
+{
+    if (k < 0)
+    {
+        return 0.0;
+    }
+
+    double pk  = exp(-lambda);
+    double cum = pk;
+    for (int i = 1; i <= k && cum < 1.0; i++)
+    {
+        pk *= lambda / i;
+        cum += pk;
+    }
+
+    return MIN(cum, 1.0);
+}
+
+static int InversePoissonCDF(double p, double lambda)
+{
+    if (lambda > 500.0)
+    {
+        // exp(-lambda) underflows, use normal approximation
+        return MAX(0, static_cast<int>(std::lround(lambda + sqrt(lambda) * InverseNormalCDF(p))));
+    }
+
+    int    k   = 0;
+    double pk  = exp(-lambda);
+    double cum = pk;
+    while (cum < p && pk > 0.0)
+    {
+        k++;
+        pk *= lambda / k;
+        cum += pk;
+    }
+
+    return k;
+}
+
+static int ParseRange(pugi::xml_node node, double& lower, double& upper)
+{
+    pugi::xml_node range = node.child("Range");
+    if (range.empty())
+    {
+        return -1;
+    }
+
+    lower = std::atof(range.attribute("lowerLimit").value());
+    upper = std::atof(range.attribute("upperLimit").value());
+
+    if (upper < lower)
+    {
+        LOG("Distribution range invalid range %.2f..%.2f", lower, upper);
+        return -2;
+    }
+
+    return 0;
+}
+
 OSCParameterDistribution& OSCParameterDistribution::Inst()
 {
     static OSCParameterDistribution instance_;
@@ -50,6 +241,7 @@ int OSCParameterDistribution::Load(std::string filename)
             if (!result)
             {
                 LOG("%s: %s at offset (character position): %d", file_name_candidates[i].c_str(), result.description(), result.offset);
+                Reset();
                 return -1;
             }
             else
@@ -120,6 +312,7 @@ int OSCParameterDistribution::Load(std::string filename)
                 if (value_set_dist.empty())
                 {
                     LOG("ValueSetDistribution missing");
+                    Reset();
                     return -1;
                 }
 
@@ -144,6 +337,7 @@ int OSCParameterDistribution::Load(std::string filename)
                 if (param_name.empty() || param_name == "")
                 {
                     LOG("Missing single distribution parameter name");
+                    Reset();
                     return -1;
                 }
 
@@ -151,6 +345,7 @@ int OSCParameterDistribution::Load(std::string filename)
                 if (dist.empty())
                 {
                     LOG("Missing single distribution definition");
+                    Reset();
                     return -1;
                 }
 
@@ -180,6 +375,7 @@ int OSCParameterDistribution::Load(std::string filename)
                     if (range.empty())
                     {
                         LOG("Distribution range missing");
+                        Reset();
                         return -1;
                     }
 
@@ -189,6 +385,7 @@ int OSCParameterDistribution::Load(std::string filename)
                     if (upper_limit < lower_limit)
                     {
                         LOG("Distribution range invalid range %.2f..%.2f", lower_limit, upper_limit);
+                        Reset();
                         return -1;
                     }
                     for (double v = lower_limit; v < upper_limit + SMALL_NUMBER; v += step_width)
@@ -202,11 +399,13 @@ int OSCParameterDistribution::Load(std::string filename)
                 else if (!strcmp(dist.name(), "UserDefinedDistribution"))
                 {
                     LOG("UserDefinedDistribution not yet supported");
+                    Reset();
                     return -1;
                 }
                 else
                 {
                     LOG("Unexpected distribution definition");
+                    Reset();
                     return -1;
                 }
             }
@@ -224,9 +423,10 @@ int OSCParameterDistribution::Load(std::string filename)
         {
             LOG("Found BOTH Deterministic and Stochastic distribution elements. Only one expected. Using Deterministic.");
         }
-        else
+        else if (LoadStochastic(stochastic) != 0)
         {
-            LOG("Stochastic distributions not supported yet");
+            Reset();
+            return -1;
         }
     }
     else if (deterministic.empty())
@@ -237,10 +437,331 @@ int OSCParameterDistribution::Load(std::string filename)
     return 0;
 }
 
+int OSCParameterDistribution::LoadStochastic(pugi::xml_node stochastic)
+{
+    int n_runs = std::atoi(stochastic.attribute("numberOfTestRuns").value());
+    if (n_runs < 1)
+    {
+        LOG("Stochastic distribution: Invalid or missing numberOfTestRuns: %s", stochastic.attribute("numberOfTestRuns").value());
+        return -1;
+    }
+    num_test_runs_ = static_cast<unsigned int>(n_runs);
+
+    if (stochastic.attribute("randomSeed"))
+    {
+        random_seed_ = static_cast<unsigned int>(std::strtoul(stochastic.attribute("randomSeed").value(), nullptr, 10));
+    }
+    else
+    {
+        random_seed_ = 0;
+        LOG("Stochastic distribution: No randomSeed specified, using %u", random_seed_);
+    }
+
+    for (pugi::xml_node dist_node = stochastic.child("StochasticDistribution"); dist_node;
+         dist_node                = dist_node.next_sibling("StochasticDistribution"))
+    {
+        StochasticParameter param;
+        param.name = dist_node.attribute("parameterName").value();
+        if (param.name.empty())
+        {
+            LOG("Missing stochastic distribution parameter name");
+            return -1;
+        }
+
+        pugi::xml_node dist = dist_node.first_child();
+        if (dist.empty())
+        {
+            LOG("Missing stochastic distribution definition for parameter %s", param.name.c_str());
+            return -1;
+        }
+
+        param.mean         = 0.0;
+        param.std_dev      = 0.0;
+        param.lower        = 0.0;
+        param.upper        = 0.0;
+        param.total_weight = 0.0;
+        param.has_range    = ParseRange(dist, param.lower, param.upper) == 0;
+
+        std::string dist_name = dist.name();
+        if (dist_name == "NormalDistribution" || dist_name == "LogNormalDistribution")
+        {
+            double expected_value = std::atof(dist.attribute("expectedValue").value());
+            double variance       = std::atof(dist.attribute("variance").value());
+
+            if (variance < 0.0)
+            {
+                LOG("%s: Negative variance %.2f for parameter %s", dist_name.c_str(), variance, param.name.c_str());
+                return -1;
+            }
+
+            if (dist_name == "NormalDistribution")
+            {
+                param.type    = StochasticType::NORMAL;
+                param.mean    = expected_value;
+                param.std_dev = sqrt(variance);
+            }
+            else
+            {
+                if (expected_value < SMALL_NUMBER)
+                {
+                    LOG("LogNormalDistribution: expectedValue must be positive, parameter %s", param.name.c_str());
+                    return -1;
+                }
+                // expected value and variance refers to the log-normal variable, find parameters of underlying normal distribution
+                double sigma2 = log(1.0 + variance / (expected_value * expected_value));
+                param.type    = StochasticType::LOG_NORMAL;
+                param.mean    = log(expected_value) - 0.5 * sigma2;
+                param.std_dev = sqrt(sigma2);
+            }
+        }
+        else if (dist_name == "UniformDistribution")
+        {
+            if (!param.has_range)
+            {
+                LOG("UniformDistribution: Missing or invalid Range for parameter %s", param.name.c_str());
+                return -1;
+            }
+            param.type = StochasticType::UNIFORM;
+        }
+        else if (dist_name == "PoissonDistribution")
+        {
+            param.type = StochasticType::POISSON;
+            param.mean = std::atof(dist.attribute("expectedValue").value());
+            if (param.mean < SMALL_NUMBER)
+            {
+                LOG("PoissonDistribution: expectedValue must be positive, parameter %s", param.name.c_str());
+                return -1;
+            }
+        }
+        else if (dist_name == "Histogram")
+        {
+            param.type = StochasticType::HISTOGRAM;
+            for (pugi::xml_node bin = dist.child("Bin"); bin; bin = bin.next_sibling("Bin"))
+            {
+                WeightedBin b;
+                b.weight = std::atof(bin.attribute("weight").value());
+                if (ParseRange(bin, b.lower, b.upper) != 0 || b.weight < 0.0)
+                {
+                    LOG("Histogram: Invalid bin for parameter %s", param.name.c_str());
+                    return -1;
+                }
+                param.total_weight += b.weight;
+                param.bins.push_back(b);
+            }
+        }
+        else if (dist_name == "ProbabilityDistributionSet")
+        {
+            param.type = StochasticType::PROBABILITY_SET;
+            for (pugi::xml_node elem = dist.child("Element"); elem; elem = elem.next_sibling("Element"))
+            {
+                WeightedBin b = {std::atof(elem.attribute("weight").value()), 0.0, 0.0, elem.attribute("value").value()};
+                if (b.weight < 0.0)
+                {
+                    LOG("ProbabilityDistributionSet: Negative weight for parameter %s", param.name.c_str());
+                    return -1;
+                }
+                param.total_weight += b.weight;
+                param.bins.push_back(b);
+            }
+        }
+        else if (dist_name == "UserDefinedDistribution")
+        {
+            LOG("UserDefinedDistribution not yet supported");
+            return -1;
+        }
+        else
+        {
+            LOG("Unexpected stochastic distribution definition %s", dist_name.c_str());
+            return -1;
+        }
+
+        if ((param.type == StochasticType::HISTOGRAM || param.type == StochasticType::PROBABILITY_SET) && param.total_weight < SMALL_NUMBER)
+        {
+            LOG("%s: Missing entries or zero total weight for parameter %s", dist_name.c_str(), param.name.c_str());
+            return -1;
+        }
+
+        stochastic_list_.push_back(param);
+    }
+
+    if (stochastic_list_.empty())
+    {
+        LOG("Stochastic distribution: No StochasticDistribution elements found");
+        return -1;
+    }
+
+    if (sampling_method_ == SamplingMethod::SOBOL && stochastic_list_.size() > SOBOL_MAX_DIMENSION)
+    {
+        LOG("Sobol sampling supports %d parameters, Latin hypercube sampling used for the remaining %d",
+            SOBOL_MAX_DIMENSION,
+            static_cast<int>(stochastic_list_.size()) - SOBOL_MAX_DIMENSION);
+    }
+
+    return 0;
+}
+
+double OSCParameterDistribution::GetUniformSample(unsigned int run, unsigned int param_index)
+{
+    if (sampling_method_ == SamplingMethod::SOBOL && param_index < SOBOL_MAX_DIMENSION)
+    {
+        return SobolSample(run, param_index, static_cast<uint32_t>(SplitMix64(random_seed_ ^ (static_cast<uint64_t>(param_index) << 32))));
+    }
+    else if (sampling_method_ == SamplingMethod::LATIN_HYPERCUBE || sampling_method_ == SamplingMethod::SOBOL)
+    {
+        if (lhs_strata_.size() < stochastic_list_.size())
+        {
+            lhs_strata_.resize(stochastic_list_.size());
+        }
+
+        std::vector<unsigned int>& strata = lhs_strata_[param_index];
+        if (strata.empty())
+        {
+            // Fisher-Yates shuffle of the strata, seeded per parameter
+            strata.resize(num_test_runs_);
+            for (unsigned int i = 0; i < num_test_runs_; i++)
+            {
+                strata[i] = i;
+            }
+            for (unsigned int i = num_test_runs_ - 1; i > 0; i--)
+            {
+                unsigned int j = static_cast<unsigned int>(HashToUnit(~static_cast<uint64_t>(random_seed_), param_index, i) * (i + 1));
+                std::swap(strata[i], strata[MIN(j, i)]);
+            }
+        }
+
+        return (strata[run] + HashToUnit(random_seed_, run, param_index)) / num_test_runs_;
+    }
+
+    return HashToUnit(random_seed_, run, param_index);
+}
+
+std::string OSCParameterDistribution::GetStochasticValue(unsigned int run, unsigned int param_index)
+{
+    StochasticParameter& param = stochastic_list_[param_index];
+    double               u     = GetUniformSample(run, param_index);
+
+    switch (param.type)
+    {
+        case StochasticType::UNIFORM:
+            return std::to_string(param.lower + u * (param.upper - param.lower));
+
+        case StochasticType::NORMAL:
+        case StochasticType::LOG_NORMAL:
+        {
+            double lower = param.lower;
+            double upper = param.upper;
+
+            if (param.type == StochasticType::LOG_NORMAL && param.has_range)
+            {
+                lower = lower > 0.0 ? log(lower) : -LARGE_NUMBER;
+                upper = upper > 0.0 ? log(upper) : -LARGE_NUMBER;
+            }
+
+            if (param.std_dev < SMALL_NUMBER)
+            {
+                double v = param.mean;
+                if (param.has_range)
+                {
+                    v = CLAMP(v, lower, upper);
+                }
+                return std::to_string(param.type == StochasticType::LOG_NORMAL ? exp(v) : v);
+            }
+
+            if (param.has_range)
+            {
+                // truncated distribution, map sample into the probability range of the limits
+                double p_lower = NormalCDF((lower - param.mean) / param.std_dev);
+                double p_upper = NormalCDF((upper - param.mean) / param.std_dev);
+                u              = p_lower + u * (p_upper - p_lower);
+            }
+
+            double v = param.mean + param.std_dev * InverseNormalCDF(u);
+            if (param.has_range)
+            {
+                v = CLAMP(v, lower, upper);
+            }
+
+            return std::to_string(param.type == StochasticType::LOG_NORMAL ? exp(v) : v);
+        }
+
+        case StochasticType::POISSON:
+        {
+            if (param.has_range)
+            {
+                int    k_lower = static_cast<int>(ceil(param.lower));
+                int    k_upper = static_cast<int>(floor(param.upper));
+                double p_lower = PoissonCDF(k_lower - 1, param.mean);
+                double p_upper = PoissonCDF(k_upper, param.mean);
+                u              = p_lower + u * (p_upper - p_lower);
+                return std::to_string(CLAMP(InversePoissonCDF(u, param.mean), k_lower, k_upper));
+            }
+
+            return std::to_string(InversePoissonCDF(u, param.mean));
+        }
+
+        case StochasticType::HISTOGRAM:
+        case StochasticType::PROBABILITY_SET:
+        {
+            // pick bin according to weights, then reuse the remaining fraction of the sample within the bin
+            double target = u * param.total_weight;
+            size_t i      = 0;
+            for (; i < param.bins.size() - 1 && target > param.bins[i].weight; i++)
+            {
+                target -= param.bins[i].weight;
+            }
+
+            WeightedBin& bin = param.bins[i];
+            if (param.type == StochasticType::PROBABILITY_SET)
+            {
+                return bin.value;
+            }
+
+            double fraction = bin.weight > SMALL_NUMBER ? CLAMP(target / bin.weight, 0.0, 1.0) : 0.5;
+            return std::to_string(bin.lower + fraction * (bin.upper - bin.lower));
+        }
+    }
+
+    return "";
+}
+
+void OSCParameterDistribution::SetSamplingMethod(SamplingMethod method)
+{
+    sampling_method_ = method;
+    lhs_strata_.clear();
+}
+
+int OSCParameterDistribution::SetSamplingMethod(std::string method)
+{
+    if (method == "random")
+    {
+        SetSamplingMethod(SamplingMethod::RANDOM);
+    }
+    else if (method == "lhs")
+    {
+        SetSamplingMethod(SamplingMethod::LATIN_HYPERCUBE);
+    }
+    else if (method == "sobol")
+    {
+        SetSamplingMethod(SamplingMethod::SOBOL);
+    }
+    else
+    {
+        LOG("Unsupported sampling method %s, expected random, lhs or sobol", method.c_str());
+        return -1;
+    }
+
+    return 0;
+}
+
 unsigned int OSCParameterDistribution::GetNumPermutations()
 {
     unsigned int n = 1;
 
+    if (!stochastic_list_.empty())
+    {
+        return num_test_runs_;
+    }
+
     if (param_list_.size() == 0)
     {
         return 0;
@@ -261,6 +782,11 @@ unsigned int OSCParameterDistribution::GetNumParameters()
         return 0;
     }
 
+    if (!stochastic_list_.empty())
+    {
+        return static_cast<unsigned int>(stochastic_list_.size());
+    }
+
     // Calculate number of parameters in current permutation
     unsigned int num_parameters = 0;
 
@@ -297,6 +823,11 @@ OSCParameterDistribution::ParameterValueEntry OSCParameterDistribution::GetParam
         return {"", ""};
     }
 
+    if (!stochastic_list_.empty())
+    {
+        return {stochastic_list_[param_index].name, GetStochasticValue(static_cast<unsigned int>(index_), param_index)};
+    }
+
     // mirror internal index starting from end, since permutations are traversed that way
     // varying the latest variable first
     unsigned int p_idx         = n_parameters - param_index - 1;
@@ -387,6 +918,11 @@ void OSCParameterDistribution::Reset()
         param_list_[i].clear();
     }
     param_list_.clear();
+    stochastic_list_.clear();
+    lhs_strata_.clear();
+    num_test_runs_   = 0;
+    random_seed_     = 0;
+    sampling_method_ = SamplingMethod::RANDOM;
     filename_.clear();
     scenario_filename_.clear();
     index_           = -1;
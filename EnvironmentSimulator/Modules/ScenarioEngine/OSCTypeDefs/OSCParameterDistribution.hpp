@@ -21,19 +21,70 @@ namespace scenarioengine
 {
     class OSCParameterDistribution
     {
+    public:
+        enum class SamplingMethod
+        {
+            RANDOM          = 0,  // independent pseudo random samples
+            LATIN_HYPERCUBE = 1,  // one sample per equal-probability stratum of each parameter
+            SOBOL           = 2,  // low-discrepancy quasi random sequence
+        };
+
+    private:
         struct ParameterValueEntry
         {
             std::string name;
             std::string value;
         };
 
+        enum class StochasticType
+        {
+            NORMAL,
+            LOG_NORMAL,
+            UNIFORM,
+            POISSON,
+            HISTOGRAM,
+            PROBABILITY_SET,
+        };
+
+        struct WeightedBin
+        {
+            double      weight;
+            double      lower;
+            double      upper;
+            std::string value;  // used by ProbabilityDistributionSet elements only
+        };
+
+        // Stochastic parameters are not expanded into value lists. Instead each sample is generated on demand
+        // from (seed, run index, parameter index), making any permutation directly accessible and reproducible.
+        struct StochasticParameter
+        {
+            std::string              name;
+            StochasticType           type;
+            double                   mean;
+            double                   std_dev;
+            double                   lower;
+            double                   upper;
+            bool                     has_range;
+            std::vector<WeightedBin> bins;
+            double                   total_weight;
+        };
+
         std::vector<std::vector<std::vector<ParameterValueEntry>>> param_list_;
+        std::vector<StochasticParameter>                           stochastic_list_;
+        unsigned int                                               num_test_runs_;
+        unsigned int                                               random_seed_;
+        SamplingMethod                                             sampling_method_;
+        std::vector<std::vector<unsigned int>>                     lhs_strata_;  // lazily created stratum permutation per parameter
         std::string                                                filename_;
         std::string                                                scenario_filename_;
         int                                                        index_;
         int                                                        requested_index_;
         pugi::xml_document                                         doc_;
 
+        int         LoadStochastic(pugi::xml_node stochastic);
+        double      GetUniformSample(unsigned int run, unsigned int param_index);
+        std::string GetStochasticValue(unsigned int run, unsigned int param_index);
+
     public:
         OSCParameterDistribution()
         {
@@ -68,5 +119,22 @@ namespace scenarioengine
         std::string         GetParamValue(unsigned int param_index);
         std::string         AddInfoToFilename(std::string filename);
         std::string         AddInfoToFilepath(std::string filepath);
+
+        /**
+         * Specify how stochastic distributions are sampled. Can be changed at any time, samples are generated on demand.
+         * @param method RANDOM, LATIN_HYPERCUBE or SOBOL
+         */
+        void SetSamplingMethod(SamplingMethod method);
+        int  SetSamplingMethod(std::string method);
+
+        SamplingMethod GetSamplingMethod()
+        {
+            return sampling_method_;
+        }
+
+        bool IsStochastic()
+        {
+            return !stochastic_list_.empty();
+        }
     };
 }  // namespace scenarioengine
@@ -449,6 +449,13 @@ void FollowTrajectoryAction::Step(double simTime, double dt)
     }
 }
 
+void FollowTrajectoryAction::SyncState(SE_StateSnapshot& state)
+{
+    OSCPrivateAction::SyncState(state);
+    state.Value(time_);
+    state.Value(initialDistanceOffset_);
+}
+
 void FollowTrajectoryAction::ReplaceObjectRefs(Object* obj1, Object* obj2)
 {
     if (object_ == obj1)
@@ -500,6 +507,12 @@ void AcquirePositionAction::Step(double simTime, double dt)
     OSCAction::End();
 }
 
+void AcquirePositionAction::SyncState(SE_StateSnapshot& state)
+{
+    OSCPrivateAction::SyncState(state);
+    state.Value(route_);
+}
+
 void AcquirePositionAction::ReplaceObjectRefs(Object* obj1, Object* obj2)
 {
     if (object_ == obj1)
@@ -781,6 +794,16 @@ void LatLaneChangeAction::Step(double simTime, double dt)
     object_->SetDirtyBits(Object::DirtyBit::LATERAL | Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::SPEED);
 }
 
+void LatLaneChangeAction::SyncState(SE_StateSnapshot& state)
+{
+    OSCPrivateAction::SyncState(state);
+    state.Value(transition_);
+    state.Value(target_lane_offset_);
+    state.Value(start_offset_);
+    state.Value(internal_pos_);
+    state.Value(heading_agnostic_);
+}
+
 void LatLaneChangeAction::ReplaceObjectRefs(Object* obj1, Object* obj2)
 {
     if (object_ == obj1)
@@ -878,6 +901,12 @@ void LatLaneOffsetAction::Step(double simTime, double dt)
     transition_.Step(dt);
 }
 
+void LatLaneOffsetAction::SyncState(SE_StateSnapshot& state)
+{
+    OSCPrivateAction::SyncState(state);
+    state.Value(transition_);
+}
+
 void LatLaneOffsetAction::ReplaceObjectRefs(Object* obj1, Object* obj2)
 {
     if (object_ == obj1)
@@ -1048,6 +1077,17 @@ void LongSpeedAction::Step(double simTime, double dt)
     }
 }
 
+void LongSpeedAction::SyncState(SE_StateSnapshot& state)
+{
+    OSCPrivateAction::SyncState(state);
+    state.Value(transition_);
+    state.Value(target_speed_reached_);
+    if (target_ && target_->type_ == Target::TargetType::RELATIVE_SPEED)
+    {
+        static_cast<TargetRelative*>(target_.get())->SyncState(state);
+    }
+}
+
 void LongSpeedProfileAction::Start(double simTime)
 {
     OSCAction::Start(simTime);
@@ -1428,6 +1468,18 @@ void LongSpeedProfileAction::Step(double simTime, double dt)
     object_->SetSpeed(speed_);
 }
 
+void LongSpeedProfileAction::SyncState(SE_StateSnapshot& state)
+{
+    OSCPrivateAction::SyncState(state);
+    state.Value(segment_);
+    state.Value(cur_index_);
+    state.Value(start_time_);
+    state.Value(elapsed_);
+    state.Value(speed_);
+    state.Value(acc_);
+    state.Value(init_acc_);
+}
+
 void LongSpeedProfileAction::CheckAcceleration(double acc)
 {
     if (following_mode_ == FollowingMode::POSITION)
@@ -1678,6 +1730,13 @@ void LongDistanceAction::Step(double simTime, double)
     }
 }
 
+void LongDistanceAction::SyncState(SE_StateSnapshot& state)
+{
+    OSCPrivateAction::SyncState(state);
+    state.Value(sim_time_);
+    state.Value(acceleration_);
+}
+
 void LongDistanceAction::ReplaceObjectRefs(Object* obj1, Object* obj2)
 {
     if (object_ == obj1)
@@ -2311,6 +2370,16 @@ void SynchronizeAction::Step(double simTime, double dt)
     }
 }
 
+void SynchronizeAction::SyncState(SE_StateSnapshot& state)
+{
+    OSCPrivateAction::SyncState(state);
+    state.Value(mode_);
+    state.Value(submode_);
+    state.Value(steadyState_);
+    state.Value(lastDist_);
+    state.Value(lastMasterDist_);
+}
+
 void VisibilityAction::Start(double simTime)
 {
     OSCAction::Start(simTime);
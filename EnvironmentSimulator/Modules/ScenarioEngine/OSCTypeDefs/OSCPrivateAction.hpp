@@ -255,6 +255,12 @@ namespace scenarioengine
 
             double GetValue();
 
+            void SyncState(SE_StateSnapshot& state)
+            {
+                state.Value(consumed_);
+                state.Value(object_speed_);
+            }
+
         private:
             bool   consumed_;
             double object_speed_;
@@ -292,6 +298,7 @@ namespace scenarioengine
 
         void Start(double simTime);
         void Step(double simTime, double dt);
+        void SyncState(SE_StateSnapshot& state) override;
 
         void print()
         {
@@ -399,6 +406,7 @@ namespace scenarioengine
 
         void Start(double simTime);
         void Step(double simTime, double dt = 0.0);
+        void SyncState(SE_StateSnapshot& state) override;
 
         void print()
         {
@@ -501,6 +509,7 @@ namespace scenarioengine
 
         void Start(double simTime);
         void Step(double simTime, double dt);
+        void SyncState(SE_StateSnapshot& state) override;
 
         void print()
         {
@@ -588,6 +597,7 @@ namespace scenarioengine
         };
 
         void Step(double simTime, double dt);
+        void SyncState(SE_StateSnapshot& state) override;
         void Start(double simTime);
 
         void ReplaceObjectRefs(Object* obj1, Object* obj2);
@@ -670,6 +680,7 @@ namespace scenarioengine
 
         void Start(double simTime);
         void Step(double simTime, double dt);
+        void SyncState(SE_StateSnapshot& state) override;
 
         void ReplaceObjectRefs(Object* obj1, Object* obj2);
     };
@@ -782,6 +793,7 @@ namespace scenarioengine
         };
 
         void Step(double simTime, double dt);
+        void SyncState(SE_StateSnapshot& state) override;
         void Start(double simTime);
 
         const char* Mode2Str(SynchMode mode);
@@ -1032,6 +1044,7 @@ namespace scenarioengine
         };
 
         void Step(double simTime, double dt);
+        void SyncState(SE_StateSnapshot& state) override;
         void Start(double simTime);
         void End();
 
@@ -1074,6 +1087,7 @@ namespace scenarioengine
 
         void Start(double simTime);
         void Step(double simTime, double dt);
+        void SyncState(SE_StateSnapshot& state) override;
 
         void ReplaceObjectRefs(Object* obj1, Object* obj2);
     };
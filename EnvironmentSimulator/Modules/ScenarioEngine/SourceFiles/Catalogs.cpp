@@ -53,13 +53,68 @@ CatalogType Entry::GetTypeByNodeName(pugi::xml_node node)
     return CatalogType::CATALOG_UNDEFINED;
 }
 
-Entry::Entry(std::string name, pugi::xml_document root)
+Entry::Entry(std::string name, std::shared_ptr<const pugi::xml_document> root, pugi::xml_node node)
 {
     name_ = name;
-    root_ = std::move(root);
+    root_ = root;
+    node_ = node;
     type_ = GetTypeByNodeName(GetNode());
 }
 
+CatalogCache& CatalogCache::Inst()
+{
+    static CatalogCache instance;
+    return instance;
+}
+
+std::shared_ptr<const pugi::xml_document> CatalogCache::Load(const std::string& filename, pugi::xml_parse_result& result)
+{
+    long long mod_time = -1;
+    long long size     = -1;
+    GetFileStatus(filename.c_str(), mod_time, size);
+
+    mutex_.Lock();
+
+    auto it = files_.find(filename);
+    if (it != files_.end() && it->second.mod_time == mod_time && it->second.size == size)
+    {
+        std::shared_ptr<const pugi::xml_document> doc = it->second.doc;
+        mutex_.Unlock();
+        result.status = pugi::status_ok;
+        result.offset = 0;
+        return doc;
+    }
+
+    std::shared_ptr<pugi::xml_document> doc = std::make_shared<pugi::xml_document>();
+    result                                  = doc->load_file(filename.c_str());
+    if (!result)
+    {
+        mutex_.Unlock();
+        return nullptr;
+    }
+
+    files_[filename] = {mod_time, size, doc};
+    mutex_.Unlock();
+
+    return doc;
+}
+
+void CatalogCache::Clear()
+{
+    mutex_.Lock();
+    files_.clear();
+    mutex_.Unlock();
+}
+
+size_t CatalogCache::GetNumberOfFiles()
+{
+    mutex_.Lock();
+    size_t n = files_.size();
+    mutex_.Unlock();
+
+    return n;
+}
+
 int Catalogs::RegisterCatalogDirectory(std::string type, std::string directory)
 {
     CatalogDirEntry entry;
@@ -13,6 +13,8 @@
 #pragma once
 
 #include <iostream>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -40,14 +42,15 @@ namespace scenarioengine
     class Entry
     {
     public:
-        std::string        name_;
-        pugi::xml_document root_;
-        CatalogType        type_;
+        std::string                               name_;
+        std::shared_ptr<const pugi::xml_document> root_;  // parsed catalog file, shared between scenario instances
+        pugi::xml_node                            node_;
+        CatalogType                               type_;
 
-        Entry(std::string name, pugi::xml_document root);
+        Entry(std::string name, std::shared_ptr<const pugi::xml_document> root, pugi::xml_node node);
         pugi::xml_node GetNode()
         {
-            return root_.first_child();
+            return node_;
         }
 
         static std::string GetTypeAsStr_(CatalogType type);
@@ -101,6 +104,40 @@ namespace scenarioengine
         }
     };
 
+    /**
+     * Process wide cache of parsed catalog files, shared by all scenario instances, e.g. repeated SE_Init calls.
+     * Files are identified by path, modification time and size, so a changed file is parsed again. The cached documents
+     * are never modified. Any parameter references are resolved when an entry is instantiated.
+     */
+    class CatalogCache
+    {
+    public:
+        static CatalogCache& Inst();
+
+        /**
+         * Get parsed catalog file, loading it unless already cached
+         * @param filename Catalog file path
+         * @param result Parse result, check for any error
+         * @return Shared document, nullptr on failure
+         */
+        std::shared_ptr<const pugi::xml_document> Load(const std::string& filename, pugi::xml_parse_result& result);
+
+        void Clear();
+
+        size_t GetNumberOfFiles();
+
+    private:
+        typedef struct
+        {
+            long long                                 mod_time;  // ns, but resolution depends on file system
+            long long                                 size;      // catches edits within timestamp resolution
+            std::shared_ptr<const pugi::xml_document> doc;
+        } CachedFile;
+
+        SE_Mutex                          mutex_;
+        std::map<std::string, CachedFile> files_;
+    };
+
     class Catalogs
     {
     public:
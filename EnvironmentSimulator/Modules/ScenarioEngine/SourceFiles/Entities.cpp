@@ -1154,6 +1154,35 @@ int Object::Distance(double                            x,
     return 0;
 }
 
+double Object::TimeToCollision(Object* target, double dist, bool closingOnly)
+{
+    double rel_speed = speed_;
+
+    if (target != nullptr)
+    {
+        // Calculate relative speed along the object's velocity direction
+        double rel_vel[2] = {0.0, 0.0};
+        ProjectPointOnVector2D(target->pos_.GetVelX(), target->pos_.GetVelY(), pos_.GetVelX(), pos_.GetVelY(), rel_vel[0], rel_vel[1]);
+        rel_speed = GetLengthOfVector2D(pos_.GetVelX() - rel_vel[0], pos_.GetVelY() - rel_vel[1]);
+
+        if (closingOnly && GetDotProduct2D(pos_.GetVelX() - rel_vel[0], pos_.GetVelY() - rel_vel[1], pos_.GetVelX(), pos_.GetVelY()) < 0.0)
+        {
+            rel_speed = -rel_speed;  // target moving away faster than the object
+        }
+    }
+
+    // TimeToCollision (TTC) not defined for cases:
+    //  - when target object is behind
+    //  - when object speed is <=0 (still or going reverse)
+    //  - when distance is constant or increasing
+    if (dist < 0 || speed_ < SMALL_NUMBER || rel_speed <= SMALL_NUMBER)
+    {
+        return -1.0;
+    }
+
+    return fabs(dist / rel_speed);
+}
+
 Object::OverlapType Object::OverlappingFront(Object* target, double tolerance)
 {
     // Strategy:
@@ -1765,6 +1794,63 @@ Object* Object::TrailerVehicle()
     return trailer_vehicle;
 }
 
+void Object::SyncState(SE_StateSnapshot& state)
+{
+    state.Value(speed_);
+    state.Value(wheel_angle_);
+    state.Value(wheel_rot_);
+    state.Value(ghost_trail_s_);
+    state.Value(trail_follow_index_);
+    state.Value(odometer_);
+    state.Value(end_of_road_timestamp_);
+    state.Value(off_road_timestamp_);
+    state.Value(stand_still_timestamp_);
+    state.Value(reset_);
+    state.References(controllers_);
+    state.Value(headstart_time_);
+    state.Value(visibilityMask_);
+    state.Value(junctionSelectorStrategy_);
+    state.Value(nextJunctionSelectorAngle_);
+    state.Value(overrideActionList);
+    state.Value(trail_closest_pos_);
+    state.Value(sensor_pos_);
+    state.Value(trail_);
+    state.Value(state_old);
+    state.References(collisions_);
+    state.Value(dirty_);
+    state.Value(is_active_);
+    state.Value(pos_);
+
+    // The route is shared by reference between positions, while its current position along the path is updated in place
+    bool has_route = pos_.GetRoute() != nullptr;
+    state.Value(has_route);
+    if (has_route)
+    {
+        state.Value(*pos_.GetRoute());
+    }
+}
+
+void Vehicle::SyncState(SE_StateSnapshot& state)
+{
+    Object::SyncState(state);
+
+    Object* trailer = trailer_hitch_ ? trailer_hitch_->trailer_vehicle_ : nullptr;
+    Object* tow     = trailer_coupler_ ? trailer_coupler_->tow_vehicle_ : nullptr;
+    state.Reference(trailer);
+    state.Reference(tow);
+    if (!state.IsSaving() && !state.Failed())
+    {
+        if (trailer_hitch_)
+        {
+            trailer_hitch_->trailer_vehicle_ = trailer;
+        }
+        if (trailer_coupler_)
+        {
+            trailer_coupler_->tow_vehicle_ = tow;
+        }
+    }
+}
+
 std::string Object::Type2String(int type)
 {
     switch (type)
@@ -324,6 +324,15 @@ namespace scenarioengine
                      double&                           dist,
                      double                            maxDist = LARGE_NUMBER);
 
+        /**
+        Calculate time to collision with target, given distance along the object's velocity direction
+        @param target The object to check, or nullptr for a stationary target point
+        @param dist Distance to target, negative if target is behind
+        @param closingOnly If true the TTC is defined only when the distance is decreasing, else the absolute relative speed is used
+        @return Time to collision, or -1 if not defined
+        */
+        double TimeToCollision(Object* target, double dist, bool closingOnly);
+
         enum class OverlapType
         {
             NONE            = 0,             // object is not overlapping Ego front projection
@@ -539,6 +548,12 @@ namespace scenarioengine
         Object*            TrailerVehicle();
         static std::string Type2String(int type);
 
+        /**
+            Save or restore dynamic state of the object, e.g. position, speed and odometer
+            @param state Snapshot to save into or restore from, depending on its mode
+        */
+        virtual void SyncState(SE_StateSnapshot& state);
+
     private:
         int  dirty_;
         bool is_active_;
@@ -693,6 +708,7 @@ namespace scenarioengine
         void                            AlignTrailers();
         static std::string              Category2String(int category);
         static std::string              Role2String(int role);
+        void                            SyncState(SE_StateSnapshot& state) override;
         std::shared_ptr<TrailerCoupler> trailer_coupler_;  // mounting point to any tow vehicle
         std::shared_ptr<TrailerHitch>   trailer_hitch_;    // mounting point to any tow vehicle
     };
@@ -0,0 +1,253 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#include <fstream>
+#include "KPICollector.hpp"
+#include "CommonMini.hpp"
+
+#define KPI_MAX_RANGE 250.0  // entities further away than this are not considered (m)
+#define KPI_MAX_JUMP  1.0    // movement beyond speed * dt plus this margin is considered discontinuous (m)
+
+using namespace scenarioengine;
+
+KPICollector::KPICollector(bool stop_on_collision, double stop_at_ttc)
+    : stop_on_collision_(stop_on_collision),
+      stop_at_ttc_(stop_at_ttc),
+      stop_reason_(StopReason::NONE)
+{
+}
+
+KPICollector::EntityKPI* KPICollector::GetEntityKPI(Object* obj)
+{
+    auto it = kpi_index_.find(obj->GetId());
+
+    if (it != kpi_index_.end())
+    {
+        return &kpi_[it->second];
+    }
+
+    kpi_index_[obj->GetId()] = kpi_.size();
+    kpi_.push_back({obj->GetId(), obj->GetName(), -1.0, -1.0, 0.0, -1.0, obj->GetSpeed(), obj->pos_.GetX(), obj->pos_.GetY()});
+
+    return &kpi_.back();
+}
+
+bool KPICollector::Update(double sim_time, double dt, std::vector<Object*>& objects)
+{
+    // Make sure all entities are registered, and update single entity indicators
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        Object*    obj = objects[i];
+        EntityKPI* kpi = GetEntityKPI(obj);
+
+        // Skip deceleration over discrete movements, e.g. teleport, where the speed change is not physical
+        bool discontinuous = obj->reset_ || obj->CheckDirtyBits(Object::DirtyBit::TELEPORT) ||
+                             PointDistance2D(kpi->prev_x, kpi->prev_y, obj->pos_.GetX(), obj->pos_.GetY()) >
+                                 MAX(fabs(kpi->prev_speed), fabs(obj->GetSpeed())) * dt + KPI_MAX_JUMP;
+
+        if (dt > SMALL_NUMBER && !discontinuous)
+        {
+            double decel   = (kpi->prev_speed - obj->GetSpeed()) / dt;
+            kpi->max_decel = MAX(kpi->max_decel, decel);
+        }
+        kpi->prev_speed = obj->GetSpeed();
+        kpi->prev_x     = obj->pos_.GetX();
+        kpi->prev_y     = obj->pos_.GetY();
+    }
+
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        Object* obj0 = objects[i];
+
+        if (!obj0->IsActive())
+        {
+            continue;
+        }
+
+        for (size_t j = i + 1; j < objects.size(); j++)
+        {
+            Object* obj1 = objects[j];
+
+            if (!obj1->IsActive() || PointDistance2D(obj0->pos_.GetX(), obj0->pos_.GetY(), obj1->pos_.GetX(), obj1->pos_.GetY()) > KPI_MAX_RANGE)
+            {
+                continue;
+            }
+
+            EntityKPI* kpi0 = GetEntityKPI(obj0);
+            EntityKPI* kpi1 = GetEntityKPI(obj1);
+
+            double lat_dist0 = 0.0, long_dist0 = 0.0, lat_dist1 = 0.0, long_dist1 = 0.0;
+            double gap = obj0->FreeSpaceDistance(obj1, &lat_dist0, &long_dist0);
+            obj1->CollisionAndRelativeDistLatLong(obj0, &lat_dist1, &long_dist1);
+
+            kpi0->min_gap = kpi0->min_gap < 0.0 ? gap : MIN(kpi0->min_gap, gap);
+            kpi1->min_gap = kpi1->min_gap < 0.0 ? gap : MIN(kpi1->min_gap, gap);
+
+            if (gap < SMALL_NUMBER)
+            {
+                if (kpi0->collision_time < 0.0)
+                {
+                    kpi0->collision_time = sim_time;
+                }
+                if (kpi1->collision_time < 0.0)
+                {
+                    kpi1->collision_time = sim_time;
+                }
+
+                if (stop_on_collision_ && stop_reason_ == StopReason::NONE)
+                {
+                    LOG("KPI stop criteria: Collision between %s and %s at %.2f", obj0->GetName().c_str(), obj1->GetName().c_str(), sim_time);
+                    stop_reason_ = StopReason::COLLISION;
+                }
+                continue;
+            }
+
+            // TTC only defined for targets ahead and within lateral extension of the object, i.e. on collision course
+            double ttc[2] = {fabs(lat_dist0) > SMALL_NUMBER ? -1.0 : obj0->TimeToCollision(obj1, long_dist0, true),
+                             fabs(lat_dist1) > SMALL_NUMBER ? -1.0 : obj1->TimeToCollision(obj0, long_dist1, true)};
+            for (int k = 0; k < 2; k++)
+            {
+                EntityKPI* kpi = k == 0 ? kpi0 : kpi1;
+                if (ttc[k] >= 0.0)
+                {
+                    kpi->min_ttc = kpi->min_ttc < 0.0 ? ttc[k] : MIN(kpi->min_ttc, ttc[k]);
+
+                    if (stop_at_ttc_ > 0.0 && ttc[k] < stop_at_ttc_ && stop_reason_ == StopReason::NONE)
+                    {
+                        LOG("KPI stop criteria: TTC %.2f < %.2f for %s at %.2f", ttc[k], stop_at_ttc_, kpi->name.c_str(), sim_time);
+                        stop_reason_ = StopReason::TTC;
+                    }
+                }
+            }
+        }
+    }
+
+    return stop_reason_ != StopReason::NONE;
+}
+
+std::string KPICollector::StopReason2Str(StopReason reason)
+{
+    switch (reason)
+    {
+        case StopReason::NONE:
+            return "none";
+        case StopReason::COLLISION:
+            return "collision";
+        case StopReason::TTC:
+            return "ttc";
+    }
+    return "unknown";
+}
+
+FILE* KPICollector::OpenCSV(std::string filename, std::string header)
+{
+    bool write_header = true;
+    {
+        std::ifstream check(filename, std::ios::binary | std::ios::ate);
+        if (check.good() && check.tellg() > 0)
+        {
+            write_header = false;
+        }
+    }
+
+    FILE* file = fopen(filename.c_str(), "a");
+    if (file == nullptr)
+    {
+        LOG("Failed to open KPI file %s", filename.c_str());
+        return nullptr;
+    }
+
+    if (write_header)
+    {
+        fprintf(file, "%s\n", header.c_str());
+    }
+
+    return file;
+}
+
+int KPICollector::WriteRow(std::string filename, std::string scenario, int permutation, double end_time)
+{
+    if (filename.empty())
+    {
+        return 0;
+    }
+
+    FILE* file = OpenCSV(filename, "scenario, permutation, end_time, stop_reason, collision, collision_time, min_ttc, min_gap, max_decel");
+    if (file == nullptr)
+    {
+        return -1;
+    }
+
+    // Aggregate over all entities
+    double min_ttc = -1.0, min_gap = -1.0, max_decel = 0.0, collision_time = -1.0;
+    for (size_t i = 0; i < kpi_.size(); i++)
+    {
+        if (kpi_[i].min_ttc >= 0.0)
+        {
+            min_ttc = min_ttc < 0.0 ? kpi_[i].min_ttc : MIN(min_ttc, kpi_[i].min_ttc);
+        }
+        if (kpi_[i].min_gap >= 0.0)
+        {
+            min_gap = min_gap < 0.0 ? kpi_[i].min_gap : MIN(min_gap, kpi_[i].min_gap);
+        }
+        if (kpi_[i].collision_time >= 0.0)
+        {
+            collision_time = collision_time < 0.0 ? kpi_[i].collision_time : MIN(collision_time, kpi_[i].collision_time);
+        }
+        max_decel = MAX(max_decel, kpi_[i].max_decel);
+    }
+
+    fprintf(file,
+            "%s, %d, %.3f, %s, %d, %.3f, %.3f, %.3f, %.3f\n",
+            scenario.c_str(),
+            permutation,
+            end_time,
+            StopReason2Str(stop_reason_).c_str(),
+            collision_time < 0.0 ? 0 : 1,
+            collision_time,
+            min_ttc,
+            min_gap,
+            max_decel);
+    fclose(file);
+
+    return 0;
+}
+
+int KPICollector::WriteEntityRows(std::string filename, std::string scenario, int permutation)
+{
+    if (filename.empty())
+    {
+        return 0;
+    }
+
+    FILE* file = OpenCSV(filename, "scenario, permutation, entity, collision_time, min_ttc, min_gap, max_decel");
+    if (file == nullptr)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < kpi_.size(); i++)
+    {
+        fprintf(file,
+                "%s, %d, %s, %.3f, %.3f, %.3f, %.3f\n",
+                scenario.c_str(),
+                permutation,
+                kpi_[i].name.c_str(),
+                kpi_[i].collision_time,
+                kpi_[i].min_ttc,
+                kpi_[i].min_gap,
+                kpi_[i].max_decel);
+    }
+    fclose(file);
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * esmini - Environment Simulator Minimalistic
+ * https://github.com/esmini/esmini
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) partners of Simulation Scenarios
+ * https://sites.google.com/view/simulationscenarios
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Entities.hpp"
+
+namespace scenarioengine
+{
+    /**
+     * Collects a few key performance indicators (KPIs) per entity while the scenario runs, e.g. minimum
+     * time-to-collision and gap, and optionally requests the scenario to stop early. Aggregated results are appended
+     * to a CSV file, one row per run with fixed columns, optionally along with a second file holding one row per
+     * entity. Useful for large parameter sweeps where the full recordings are not needed.
+     */
+    class KPICollector
+    {
+    public:
+        enum class StopReason
+        {
+            NONE      = 0,
+            COLLISION = 1,
+            TTC       = 2,
+        };
+
+        typedef struct
+        {
+            int         id;
+            std::string name;
+            double      min_ttc;         // -1 = not defined, i.e. never on collision course
+            double      min_gap;         // -1 = no other entity within range
+            double      max_decel;       // maximum deceleration (m/s2)
+            double      collision_time;  // time of first collision, -1 = no collision
+            double      prev_speed;
+            double      prev_x;
+            double      prev_y;
+        } EntityKPI;
+
+        KPICollector(bool stop_on_collision, double stop_at_ttc);
+
+        /**
+         * Update indicators given current state of all entities. Call once per frame after entities have moved.
+         * @param sim_time Current simulation time
+         * @param dt Timestep of last frame
+         * @param objects Entities to evaluate
+         * @return true if any stop criteria has been met
+         */
+        bool Update(double sim_time, double dt, std::vector<Object*>& objects);
+
+        /**
+         * Append one result row, aggregated over all entities, to specified CSV file. A header is added if the file is
+         * missing or empty. Columns: scenario, permutation, end_time, stop_reason, collision, collision_time, min_ttc,
+         * min_gap, max_decel. Undefined values are written as -1.
+         * @return 0 on success else -1
+         */
+        int WriteRow(std::string filename, std::string scenario, int permutation, double end_time);
+
+        /**
+         * Append one row per entity to specified CSV file. A header is added if the file is missing or empty.
+         * Columns: scenario, permutation, entity, collision_time, min_ttc, min_gap, max_decel
+         * @return 0 on success else -1
+         */
+        int WriteEntityRows(std::string filename, std::string scenario, int permutation);
+
+        StopReason GetStopReason()
+        {
+            return stop_reason_;
+        }
+        std::string StopReason2Str(StopReason reason);
+
+        std::vector<EntityKPI>& GetEntityKPIs()
+        {
+            return kpi_;
+        }
+
+    private:
+        std::vector<EntityKPI>          kpi_;
+        std::unordered_map<int, size_t> kpi_index_;  // entity id -> index in kpi_
+        bool                            stop_on_collision_;
+        double                          stop_at_ttc_;
+        StopReason                      stop_reason_;
+
+        EntityKPI* GetEntityKPI(Object* obj);
+        FILE*      OpenCSV(std::string filename, std::string header);
+    };
+
+}  // namespace scenarioengine
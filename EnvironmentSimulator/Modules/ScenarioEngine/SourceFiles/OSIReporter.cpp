@@ -12,6 +12,7 @@
 
 #include "CommonMini.hpp"
 #include "OSIReporter.hpp"
+#include "Profiler.hpp"
 #include "OSITrafficCommand.hpp"
 #include <cmath>
 #include <string>
@@ -181,6 +182,8 @@ SE_SOCKET OSIReporter::OpenSocket(std::string ipaddr)
 
 void OSIReporter::ReportSensors(std::vector<ObjectSensor *> sensor)
 {
+    SE_PROFILE_SCOPE("OSIReporter::ReportSensors");
+
     if (sensor.size() == 0)
     {
         return;
@@ -291,6 +294,8 @@ int OSIReporter::ClearOSIGroundTruth()
 
 int OSIReporter::UpdateOSIGroundTruth(const std::vector<std::unique_ptr<ObjectState>> &objectState)
 {
+    SE_PROFILE_SCOPE("OSIReporter::UpdateOSIGroundTruth");
+
     if (GetUpdated() == true)
     {
         // already updated within this scenario frame, skip
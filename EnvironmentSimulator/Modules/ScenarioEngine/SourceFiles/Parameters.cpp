@@ -10,11 +10,16 @@
  * https://sites.google.com/view/simulationscenarios
  */
 
+#include <algorithm>
 #include "Parameters.hpp"
 #include "simple_expr.h"
 
 using namespace scenarioengine;
 
+#define PARAM_HANDLE_INDEX_BITS 20  // lower bits of a handle hold the declaration index, upper bits the generation
+#define PARAM_HANDLE_INDEX_MASK ((1 << PARAM_HANDLE_INDEX_BITS) - 1)
+#define PARAM_HANDLE_GEN_MASK   0x7FF
+
 void Parameters::addParameterDeclarations(pugi::xml_node xml_node)
 {
     paramDeclarationsSize_.push(static_cast<int>(parameterDeclarations_.Parameter.size()));
@@ -40,9 +45,25 @@ void Parameters::RestoreParameterDeclarations()
 {
     if (!paramDeclarationsSize_.empty())
     {
-        parameterDeclarations_.Parameter.erase(
-            parameterDeclarations_.Parameter.begin(),
-            parameterDeclarations_.Parameter.begin() + static_cast<int>(parameterDeclarations_.Parameter.size()) - paramDeclarationsSize_.top());
+        UpdateSymbolTable();
+
+        // Most recent declarations are last, remove them from the symbol table as well
+        for (int i = static_cast<int>(parameterDeclarations_.Parameter.size()) - 1; i >= paramDeclarationsSize_.top(); i--)
+        {
+            auto it = symbol_table_.find(parameterDeclarations_.Parameter[static_cast<unsigned int>(i)].name);
+            if (it != symbol_table_.end())
+            {
+                it->second.pop_back();
+                if (it->second.empty())
+                {
+                    symbol_table_.erase(it);
+                }
+            }
+        }
+        parameterDeclarations_.Parameter.resize(static_cast<unsigned int>(paramDeclarationsSize_.top()));
+        n_indexed_ = parameterDeclarations_.Parameter.size();
+        decl_generation_.resize(n_indexed_);
+        generation_++;  // any declarations added later get a new generation, rejecting handles to the removed ones
         paramDeclarationsSize_.pop();
         catalog_param_assignments.clear();
     }
@@ -52,31 +73,91 @@ void Parameters::RestoreParameterDeclarations()
     }
 }
 
+void Parameters::UpdateSymbolTable()
+{
+    if (parameterDeclarations_.Parameter.size() < n_indexed_)
+    {
+        // declarations removed from outside, start over
+        symbol_table_.clear();
+        decl_generation_.clear();
+        n_indexed_ = 0;
+        generation_++;
+    }
+
+    if (n_indexed_ < parameterDeclarations_.Parameter.size())
+    {
+        generation_++;  // new declarations may shadow previous ones, trigger re-resolving of compiled expressions
+    }
+
+    for (; n_indexed_ < parameterDeclarations_.Parameter.size(); n_indexed_++)
+    {
+        symbol_table_[parameterDeclarations_.Parameter[n_indexed_].name].push_back(static_cast<int>(n_indexed_));
+        decl_generation_.push_back(generation_);
+    }
+}
+
+int Parameters::LookupIndex(const std::string& name)
+{
+    if (name.empty())
+    {
+        return -1;
+    }
+
+    UpdateSymbolTable();
+
+    // parameter names should not include prefix, but support also parameter name including prefix
+    auto it = symbol_table_.end();
+    if (name[0] == PARAMETER_PREFIX)
+    {
+        it = symbol_table_.find(name.substr(1));
+    }
+    if (it == symbol_table_.end())
+    {
+        it = symbol_table_.find(name);
+    }
+
+    if (it == symbol_table_.end())
+    {
+        return -1;
+    }
+
+    return it->second.back();
+}
+
 int Parameters::setParameter(std::string name, std::string value)
 {
-    // If string already present in parameterDeclaration
-    for (size_t i = 0; i < parameterDeclarations_.Parameter.size(); i++)
+    OSCParameterDeclarations::ParameterStruct* ps = getParameterEntry(name);
+
+    if (!ps)
     {
-        if (PARAMETER_PREFIX + parameterDeclarations_.Parameter[i].name == name ||  // parameter names should not include prefix
-            parameterDeclarations_.Parameter[i].name == name)                       // But support also parameter name including prefix
-        {
-            parameterDeclarations_.Parameter[i].value._string = value;
-            return 0;
-        }
+        return -1;
     }
 
-    return -1;
+    ps->value._string = value;
+
+    return 0;
 }
 
 std::string Parameters::getParameter(OSCParameterDeclarations& parameterDeclaration, std::string name)
 {
-    // If string already present in parameterDeclaration
-    for (size_t i = 0; i < parameterDeclaration.Parameter.size(); i++)
+    if (&parameterDeclaration == &parameterDeclarations_)
+    {
+        OSCParameterDeclarations::ParameterStruct* ps = getParameterEntry(name);
+        if (ps)
+        {
+            return ps->value._string;
+        }
+    }
+    else
     {
-        if (PARAMETER_PREFIX + parameterDeclaration.Parameter[i].name == name ||  // parameter names should not include prefix
-            parameterDeclaration.Parameter[i].name == name)                       // But support also parameter name including prefix
+        // Most recent declaration last
+        for (int i = static_cast<int>(parameterDeclaration.Parameter.size()) - 1; i >= 0; i--)
         {
-            return parameterDeclaration.Parameter[i].value._string;
+            if (PARAMETER_PREFIX + parameterDeclaration.Parameter[static_cast<unsigned int>(i)].name == name ||  // parameter names should not include prefix
+                parameterDeclaration.Parameter[static_cast<unsigned int>(i)].name == name)  // But support also parameter name including prefix
+            {
+                return parameterDeclaration.Parameter[static_cast<unsigned int>(i)].value._string;
+            }
         }
     }
     LOG("Failed to resolve parameter %s", name.c_str());
@@ -85,17 +166,55 @@ std::string Parameters::getParameter(OSCParameterDeclarations& parameterDeclarat
 
 OSCParameterDeclarations::ParameterStruct* Parameters::getParameterEntry(std::string name)
 {
-    // If string already present in parameterDeclaration
-    for (size_t i = 0; i < parameterDeclarations_.Parameter.size(); i++)
+    return getParameterEntryByIndex(LookupIndex(name));
+}
+
+OSCParameterDeclarations::ParameterStruct* Parameters::getParameterEntryByIndex(int index)
+{
+    if (index < 0 || static_cast<unsigned int>(index) >= parameterDeclarations_.Parameter.size())
     {
-        if (PARAMETER_PREFIX + parameterDeclarations_.Parameter[i].name == name ||  // parameter names should not include prefix
-            parameterDeclarations_.Parameter[i].name == name)                       // But support also parameter name including prefix
-        {
-            return &parameterDeclarations_.Parameter[i];
-        }
+        return 0;
     }
 
-    return 0;
+    return &parameterDeclarations_.Parameter[static_cast<unsigned int>(index)];
+}
+
+int Parameters::GetParameterHandle(std::string name)
+{
+    int index = LookupIndex(name);
+
+    if (index < 0 || index > PARAM_HANDLE_INDEX_MASK)
+    {
+        return -1;
+    }
+
+    return ((decl_generation_[static_cast<unsigned int>(index)] & PARAM_HANDLE_GEN_MASK) << PARAM_HANDLE_INDEX_BITS) | index;
+}
+
+OSCParameterDeclarations::ParameterStruct* Parameters::getParameterEntryByHandle(int handle)
+{
+    if (handle < 0)
+    {
+        return 0;
+    }
+
+    UpdateSymbolTable();  // register any declarations added or removed from outside
+
+    unsigned int index = static_cast<unsigned int>(handle & PARAM_HANDLE_INDEX_MASK);
+    if (index >= decl_generation_.size() || ((handle >> PARAM_HANDLE_INDEX_BITS) & PARAM_HANDLE_GEN_MASK) != (decl_generation_[index] & PARAM_HANDLE_GEN_MASK))
+    {
+        LOG("Parameter handle %d is not valid, e.g. declaration removed or scenario reloaded", handle);
+        return 0;
+    }
+
+    return getParameterEntryByIndex(static_cast<int>(index));
+}
+
+void Parameters::InvalidateHandles()
+{
+    UpdateSymbolTable();
+    generation_++;
+    std::fill(decl_generation_.begin(), decl_generation_.end(), generation_);
 }
 
 int Parameters::GetNumberOfParameters()
@@ -111,15 +230,16 @@ const char* Parameters::GetParameterName(int index, OSCParameterDeclarations::Pa
         return 0;
     }
 
-    *type = parameterDeclarations_.Parameter[static_cast<unsigned int>(index)].type;
+    // Index 0 refers to the most recent declaration, which is stored last
+    unsigned int i = static_cast<unsigned int>(static_cast<int>(parameterDeclarations_.Parameter.size()) - 1 - index);
+
+    *type = parameterDeclarations_.Parameter[i].type;
 
-    return parameterDeclarations_.Parameter[static_cast<unsigned int>(index)].name.c_str();
+    return parameterDeclarations_.Parameter[i].name.c_str();
 }
 
-int Parameters::setParameterValue(std::string name, const void* value)
+static int SetParameterStructValue(OSCParameterDeclarations::ParameterStruct* ps, const void* value)
 {
-    OSCParameterDeclarations::ParameterStruct* ps = getParameterEntry(name);
-
     if (!ps)
     {
         return -1;
@@ -153,10 +273,8 @@ int Parameters::setParameterValue(std::string name, const void* value)
     return 0;
 }
 
-int Parameters::getParameterValue(std::string name, void* value)
+static int GetParameterStructValue(OSCParameterDeclarations::ParameterStruct* ps, void* value)
 {
-    OSCParameterDeclarations::ParameterStruct* ps = getParameterEntry(name);
-
     if (!ps)
     {
         return -1;
@@ -187,6 +305,26 @@ int Parameters::getParameterValue(std::string name, void* value)
     return 0;
 }
 
+int Parameters::setParameterValue(std::string name, const void* value)
+{
+    return SetParameterStructValue(getParameterEntry(name), value);
+}
+
+int Parameters::getParameterValue(std::string name, void* value)
+{
+    return GetParameterStructValue(getParameterEntry(name), value);
+}
+
+int Parameters::setParameterValueByHandle(int handle, const void* value)
+{
+    return SetParameterStructValue(getParameterEntryByHandle(handle), value);
+}
+
+int Parameters::getParameterValueByHandle(int handle, void* value)
+{
+    return GetParameterStructValue(getParameterEntryByHandle(handle), value);
+}
+
 int Parameters::getParameterValueInt(std::string name, int& value)
 {
     OSCParameterDeclarations::ParameterStruct* ps = getParameterEntry(name);
@@ -395,6 +533,139 @@ static void ReplaceStringInPlace(std::string& subject, const std::string& search
     }
 }
 
+static void ConvertOperatorNames(std::string& expr)
+{
+    // Convert from OpenSCENARIO 1.1 operator names to expr op names
+    ReplaceStringInPlace(expr, "not ", "!");
+    ReplaceStringInPlace(expr, "not(", "!(");
+    ReplaceStringInPlace(expr, "and ", "&& ");
+    ReplaceStringInPlace(expr, "or ", "|| ");
+    ReplaceStringInPlace(expr, "true ", "1 ");
+    ReplaceStringInPlace(expr, "false ", "0 ");
+}
+
+#define EXPR_SLOT_KEY_BASE  987654321000LL  // numeric placeholder for parameter references while compiling expressions
+#define EXPR_CACHE_MAX_SIZE 4096            // compiled expressions kept, cache is flushed when full
+
+Parameters::CompiledExpression::~CompiledExpression()
+{
+    if (compiled != nullptr)
+    {
+        destroy_compiled_expr(compiled);
+    }
+}
+
+Parameters::CompiledExpression* Parameters::GetCompiledExpression(const std::string& expr)
+{
+    auto it = expr_cache_.find(expr);
+    if (it != expr_cache_.end())
+    {
+        return it->second.get();
+    }
+
+    if (expr_cache_.size() >= EXPR_CACHE_MAX_SIZE)
+    {
+        expr_cache_.clear();  // e.g. expressions built dynamically, start over rather than growing forever
+    }
+
+    CompiledExpression* ce = new CompiledExpression;
+    expr_cache_.emplace(expr, std::unique_ptr<CompiledExpression>(ce));
+
+    // Replace each parameter reference by a unique numeric placeholder, later bound to a slot
+    std::string         text;
+    std::vector<double> keys;
+    size_t              pos = 0;
+    size_t              found;
+    while ((found = expr.find(PARAMETER_PREFIX, pos)) != std::string::npos)
+    {
+        size_t end = expr.find_first_of(" ({)}-+*/%^!|&<>=,", found);
+        if (end == found + 1 || (end == std::string::npos && found + 1 == expr.length()))
+        {
+            return ce;  // missing parameter name, leave to the string based evaluation to report
+        }
+
+        text.append(expr, pos, found - pos);
+        ce->names.push_back(expr.substr(found + 1, end == std::string::npos ? std::string::npos : end - found - 1));
+        ce->bool_ok.push_back(end != std::string::npos && expr[end] == ' ');
+        keys.push_back(static_cast<double>(EXPR_SLOT_KEY_BASE + static_cast<long long>(keys.size())));
+        text.append(std::to_string(EXPR_SLOT_KEY_BASE + static_cast<long long>(keys.size() - 1)));
+
+        if (end == std::string::npos)
+        {
+            pos = expr.length();
+            break;
+        }
+        pos = end;
+    }
+    text.append(expr, pos, std::string::npos);
+    ConvertOperatorNames(text);
+
+    ce->slots.resize(keys.size());
+    ce->compiled = compile_expr(text.c_str(), keys.data(), ce->slots.data(), static_cast<int>(keys.size()));
+
+    return ce;
+}
+
+int Parameters::EvaluateCompiledExpression(const std::string& expr, double& value)
+{
+    CompiledExpression* ce = GetCompiledExpression(expr);
+
+    if (ce->compiled == nullptr)
+    {
+        return -1;
+    }
+
+    // Resolve parameter references, only needed when declarations have changed since last evaluation
+    UpdateSymbolTable();
+    if (ce->generation != generation_)
+    {
+        ce->index.resize(ce->names.size());
+        for (size_t i = 0; i < ce->names.size(); i++)
+        {
+            ce->index[i] = LookupIndex(ce->names[i]);
+        }
+        ce->generation = generation_;
+    }
+
+    // Bind current parameter values
+    for (size_t i = 0; i < ce->index.size(); i++)
+    {
+        OSCParameterDeclarations::ParameterStruct* ps = getParameterEntryByIndex(ce->index[i]);
+        if (ps == nullptr)
+        {
+            return -1;
+        }
+
+        const std::string& str = ps->value._string;
+        double             v   = 0.0;
+        if (!str.empty() && str[0] == '-' && parse_expr_number(str.c_str() + 1, &v) == 0)
+        {
+            v = -v;
+        }
+        else if (parse_expr_number(str.c_str(), &v) != 0)
+        {
+            if (ce->bool_ok[i] && (str == "true" || str == "false"))
+            {
+                v = str == "true" ? 1.0 : 0.0;
+            }
+            else
+            {
+                return -1;  // not a plain number, e.g. a string parameter
+            }
+        }
+        ce->slots[i] = v;
+    }
+
+    ExprReturnStruct rs = eval_compiled_expr(ce->compiled);
+    if (rs.type != EXPR_RETURN_DOUBLE)
+    {
+        return -1;
+    }
+    value = rs._double;
+
+    return 0;
+}
+
 std::string Parameters::ReadAttribute(pugi::xml_node node, std::string attribute_name, bool required)
 {
     std::string return_value;
@@ -421,16 +692,17 @@ std::string Parameters::ReadAttribute(pugi::xml_node node, std::string attribute
                 std::size_t found = expr.find('}', 2);
                 if (found != std::string::npos)
                 {
-                    expr = expr.substr(2, found - 2);        // trim to bare expression, exclude '{' and '}'
-                    expr = ResolveParametersInString(expr);  // replace parameters by their values
+                    expr = expr.substr(2, found - 2);  // trim to bare expression, exclude '{' and '}'
 
-                    // Convert from OpenSCENARIO 1.1 operator names to expr op names
-                    ReplaceStringInPlace(expr, "not ", "!");
-                    ReplaceStringInPlace(expr, "not(", "!(");
-                    ReplaceStringInPlace(expr, "and ", "&& ");
-                    ReplaceStringInPlace(expr, "or ", "|| ");
-                    ReplaceStringInPlace(expr, "true ", "1 ");
-                    ReplaceStringInPlace(expr, "false ", "0 ");
+                    // First try the compiled version, falling back to string substitution for non numeric expressions
+                    double value = 0.0;
+                    if (EvaluateCompiledExpression(expr, value) == 0)
+                    {
+                        return std::to_string(value);
+                    }
+
+                    expr = ResolveParametersInString(expr);  // replace parameters by their values
+                    ConvertOperatorNames(expr);
 
                     ExprReturnStruct rs = eval_expr(expr.c_str());
                     if (rs.type == EXPR_RETURN_UNDEFINED && isnan(rs._double))
@@ -485,6 +757,13 @@ void Parameters::parseParameterDeclarations(pugi::xml_node declarationsNode, OSC
         is_variable = true;
     }
 
+    // Catalog parameter assignments by name, in case of duplicates we want the most recent
+    std::unordered_map<std::string, const std::string*> assignments;
+    for (size_t i = 0; i < catalog_param_assignments.size(); i++)
+    {
+        assignments[catalog_param_assignments[i].name] = &catalog_param_assignments[i].value._string;
+    }
+
     for (pugi::xml_node pdChild = declarationsNode.first_child(); pdChild; pdChild = pdChild.next_sibling())
     {
         OSCParameterDeclarations::ParameterStruct param = {"", OSCParameterDeclarations::ParameterType::PARAM_TYPE_STRING, {0, 0, "", false}};
@@ -493,15 +772,11 @@ void Parameters::parseParameterDeclarations(pugi::xml_node declarationsNode, OSC
         param.variable = is_variable;
 
         // Check for catalog parameter assignements, overriding default value
-        // Start from end of parameter list, in case of duplicates we want the most recent
         param.value._string = ReadAttribute(pdChild, "value");
-        for (int i = static_cast<int>(catalog_param_assignments.size()) - 1; i >= 0; i--)
+        auto assignment     = assignments.find(param.name);
+        if (assignment != assignments.end())
         {
-            if (param.name == catalog_param_assignments[static_cast<unsigned int>(i)].name)
-            {
-                param.value._string = catalog_param_assignments[static_cast<unsigned int>(i)].value._string;
-                break;
-            }
+            param.value._string = *assignment->second;
         }
 
         std::string type_str;
@@ -554,13 +829,17 @@ void Parameters::parseParameterDeclarations(pugi::xml_node declarationsNode, OSC
         {
             LOG_TRACE_AND_QUIT("Unexpected Type: %s", type_str.c_str());
         }
-        pd->Parameter.insert(pd->Parameter.begin(), param);
+        pd->Parameter.push_back(param);  // most recent declaration last
     }
 }
 
 void Parameters::Clear()
 {
     parameterDeclarations_.Parameter.clear();
+    symbol_table_.clear();
+    decl_generation_.clear();
+    n_indexed_ = 0;
+    generation_++;
     while (!paramDeclarationsSize_.empty())
     {
         paramDeclarationsSize_.pop();
@@ -572,9 +851,28 @@ void Parameters::Print(std::string typestr)
 {
     LOG("%d %s%s", parameterDeclarations_.Parameter.size(), typestr.c_str(), parameterDeclarations_.Parameter.size() > 0 ? ":" : "");
 
-    for (size_t i = 0; i < parameterDeclarations_.Parameter.size(); i++)
+    for (int i = static_cast<int>(parameterDeclarations_.Parameter.size()) - 1; i >= 0; i--)
+    {
+        LOG("   %s = %s",
+            parameterDeclarations_.Parameter[static_cast<unsigned int>(i)].name.c_str(),
+            parameterDeclarations_.Parameter[static_cast<unsigned int>(i)].value._string.c_str());
+    }
+}
+
+void Parameters::SyncState(SE_StateSnapshot& state)
+{
+    // Values are restored in place, so that the symbol table, compiled expressions and handles stay valid
+    size_t n = parameterDeclarations_.Parameter.size();
+    state.Value(n);
+    if (!state.IsSaving() && n != parameterDeclarations_.Parameter.size())
+    {
+        state.SetFailed();
+        return;
+    }
+
+    for (auto& p : parameterDeclarations_.Parameter)
     {
-        LOG("   %s = %s", parameterDeclarations_.Parameter[i].name.c_str(), parameterDeclarations_.Parameter[i].value._string.c_str());
+        state.Value(p.value);
     }
 }
 
@@ -17,6 +17,8 @@
 #include "OSCParameterDeclarations.hpp"
 #include <vector>
 #include <stack>
+#include <unordered_map>
+#include <memory>
 
 namespace scenarioengine
 {
@@ -42,6 +44,17 @@ namespace scenarioengine
         }
         OSCParameterDeclarations::ParameterStruct* getParameterEntry(std::string name);
         int                                        setParameter(std::string name, std::string value);
+
+        // Handle based access, avoiding name lookup for parameters accessed frequently, e.g. every step.
+        // A handle is valid until the parameter declaration it refers to goes out of scope or is cleared, e.g. on
+        // scenario reload. A handle includes a generation count, so that stale handles are rejected instead of
+        // referring to another parameter.
+        int                                        GetParameterHandle(std::string name);  // -1 if not found
+        OSCParameterDeclarations::ParameterStruct* getParameterEntryByHandle(int handle);
+        int                                        getParameterValueByHandle(int handle, void* value);
+        int                                        setParameterValueByHandle(int handle, const void* value);
+        void                                       InvalidateHandles();  // e.g. when the scenario is unloaded
+
         void                                       addParameterDeclarations(pugi::xml_node xml_node);
         void                                       CreateRestorePoint();
         void                                       RestoreParameterDeclarations();  // To what it was before addParameterDeclarations
@@ -73,5 +86,38 @@ namespace scenarioengine
 
         // Log current set of parameter names and values
         void Print(std::string type);
+
+        // Save or restore parameter values. Declarations must be the same when restoring.
+        void SyncState(SE_StateSnapshot& state);
+
+    private:
+        // Expression compiled once, parameter references bound to slots updated on each evaluation
+        struct CompiledExpression
+        {
+            void*                    compiled = nullptr;  // 0 if the expression can't be compiled, always use the string based evaluation
+            std::vector<std::string> names;               // referred parameter name per slot, excluding prefix
+            std::vector<int>         index;               // declaration index per slot, resolved from names
+            int                      generation = -1;     // declarations generation the indices were resolved for
+            std::vector<bool>        bool_ok;             // true/false values accepted as 1/0 for the slot
+            std::vector<double>      slots;
+
+            ~CompiledExpression();
+        };
+
+        // Compiled expressions by source text, kept over scenario reloads (e.g. permutations) but limited in size
+        std::unordered_map<std::string, std::unique_ptr<CompiledExpression>> expr_cache_;
+
+        CompiledExpression* GetCompiledExpression(const std::string& expr);
+        int                 EvaluateCompiledExpression(const std::string& expr, double& value);
+
+        // Symbol table, parameter name (excluding prefix) -> indices in parameterDeclarations_, most recent declaration last
+        std::unordered_map<std::string, std::vector<int>> symbol_table_;
+        size_t                                            n_indexed_  = 0;  // number of declarations registered in the symbol table
+        int                                               generation_ = 0;  // incremented when declarations are added or removed
+        std::vector<int>                                  decl_generation_;  // generation when each declaration was added, part of handles
+
+        void                                       UpdateSymbolTable();
+        int                                        LookupIndex(const std::string& name);
+        OSCParameterDeclarations::ParameterStruct* getParameterEntryByIndex(int index);
     };
 }  // namespace scenarioengine
\ No newline at end of file
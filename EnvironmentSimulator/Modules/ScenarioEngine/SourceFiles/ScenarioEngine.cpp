@@ -12,11 +12,13 @@
 
 #include "ScenarioEngine.hpp"
 #include "CommonMini.hpp"
+#include "Profiler.hpp"
 #include "ControllerFollowGhost.hpp"
 #include "ControllerExternal.hpp"
 #include "ControllerRel2Abs.hpp"
 #include "ControllerFollowRoute.hpp"
 #include "OSCParameterDistribution.hpp"
+#include <atomic>
 
 #define WHEEL_RADIUS          0.35
 #define STAND_STILL_THRESHOLD 1e-3  // meter per second
@@ -46,7 +48,10 @@ ScenarioEngine::ScenarioEngine(const pugi::xml_document& xml_doc, bool disable_c
 
 void ScenarioEngine::InitScenarioCommon(bool disable_controllers)
 {
+    static std::atomic<int> instance_counter(0);
+
     init_status_         = 0;
+    instance_id_         = ++instance_counter;
     disable_controllers_ = disable_controllers;
     simulationTime_      = 0;
     trueTime_            = 0;
@@ -54,6 +59,13 @@ void ScenarioEngine::InitScenarioCommon(bool disable_controllers)
     scenarioReader       = new ScenarioReader(&entities_, &catalogs, disable_controllers);
     injected_actions_    = nullptr;
     ghost_               = nullptr;
+    kpi_                 = nullptr;
+
+    if (!SE_Env::Inst().GetKPIFilePath().empty() || !SE_Env::Inst().GetKPIEntityFilePath().empty() || SE_Env::Inst().GetStopOnCollision() ||
+        SE_Env::Inst().GetStopAtTTC() > 0.0)
+    {
+        kpi_ = new KPICollector(SE_Env::Inst().GetStopOnCollision(), SE_Env::Inst().GetStopAtTTC());
+    }
     SE_Env::Inst().SetGhostMode(GhostMode::NORMAL);
     SE_Env::Inst().SetGhostHeadstart(0.0);
 }
@@ -118,6 +130,19 @@ int ScenarioEngine::InitScenario(const pugi::xml_document& xml_doc, bool disable
 
 ScenarioEngine::~ScenarioEngine()
 {
+    if (kpi_)
+    {
+        kpi_->WriteRow(SE_Env::Inst().GetKPIFilePath(),
+                       FileNameOf(getScenarioFilename()),
+                       OSCParameterDistribution::Inst().GetIndex(),
+                       simulationTime_);
+        kpi_->WriteEntityRows(SE_Env::Inst().GetKPIEntityFilePath(),
+                              FileNameOf(getScenarioFilename()),
+                              OSCParameterDistribution::Inst().GetIndex());
+        delete kpi_;
+        kpi_ = nullptr;
+    }
+
     scenarioReader->UnloadControllers();
     delete scenarioReader;
     scenarioReader = 0;
@@ -142,6 +167,11 @@ void ScenarioEngine::UpdateGhostMode()
 
 int ScenarioEngine::step(double deltaSimTime)
 {
+    SE_PROFILE_SCOPE("ScenarioEngine::step");
+
+    // Take in states posted by other threads, e.g. server or external driver models
+    scenarioGateway.applyPostedStates();
+
     UpdateGhostMode();
 
     if (frame_nr_ == 0)
@@ -420,6 +450,7 @@ int ScenarioEngine::step(double deltaSimTime)
         {
             if (SE_Env::Inst().GetGhostMode() != GhostMode::RESTARTING)
             {
+                SE_PROFILE_SCOPE("Controller::Step");
                 scenarioReader->controller_[i]->Step(deltaSimTime);
             }
         }
@@ -497,6 +528,12 @@ int ScenarioEngine::step(double deltaSimTime)
         DetectCollisions();
     }
 
+    if (kpi_ && kpi_->Update(simulationTime_, deltaSimTime, entities_.object_))
+    {
+        // stop criteria met, terminate the scenario
+        storyBoard.Stop();
+    }
+
     frame_nr_++;
 
     return 0;
@@ -569,7 +606,15 @@ int ScenarioEngine::parseScenario()
             if (FileExists(file_name_candidates[i].c_str()))
             {
                 located = true;
-                if (roadmanager::Position::LoadOpenDrive(file_name_candidates[i].c_str()) == true)
+                if (SE_Env::Inst().GetScenarioTemplateMode() && roadmanager::Position::GetOpenDrive()->GetNumOfRoads() > 0 &&
+                    roadmanager::Position::GetOpenDrive()->GetOpenDriveFilename() == file_name_candidates[i])
+                {
+                    // Road network already loaded by previous run, no need to read it again. Just reset per run state.
+                    LOG("Reusing OpenDRIVE: %s", file_name_candidates[i].c_str());
+                    roadmanager::Position::GetOpenDrive()->ResetState();
+                    break;
+                }
+                else if (roadmanager::Position::LoadOpenDrive(file_name_candidates[i].c_str()) == true)
                 {
                     LOG("Loaded OpenDRIVE: %s", file_name_candidates[i].c_str());
                     break;
@@ -658,6 +703,8 @@ int ScenarioEngine::parseScenario()
 
 int ScenarioEngine::defaultController(Object* obj, double dt)
 {
+    SE_PROFILE_SCOPE("ScenarioEngine::defaultController");
+
     int    retval  = 0;
     double steplen = obj->speed_ * dt;
 
@@ -686,6 +733,8 @@ int ScenarioEngine::defaultController(Object* obj, double dt)
 
 void ScenarioEngine::prepareGroundTruth(double dt)
 {
+    SE_PROFILE_SCOPE("ScenarioEngine::prepareGroundTruth");
+
     for (size_t i = 0; i < entities_.object_.size(); i++)
     {
         // Fetch external states from gateway
@@ -1188,6 +1237,8 @@ void ScenarioEngine::ResetEvents()
 
 int ScenarioEngine::DetectCollisions()
 {
+    SE_PROFILE_SCOPE("ScenarioEngine::DetectCollisions");
+
     collision_pair_.clear();
     for (size_t i = 0; i < entities_.object_.size(); i++)
     {
@@ -1237,3 +1288,122 @@ int ScenarioEngine::DetectCollisions()
 
     return 0;
 }
+
+static int CountStoryBoardElements(StoryBoardElement* element)
+{
+    int n = 1;
+    for (auto child : *element->GetChildren())
+    {
+        n += CountStoryBoardElements(child);
+    }
+    return n;
+}
+
+std::vector<int> ScenarioEngine::GetStateLayout()
+{
+    // Anything affecting the sequence of values in a snapshot. The instance id makes sure that a snapshot is not
+    // restored into another scenario instance, e.g. after reinitialization, since parts of the state refer to it.
+    std::vector<int> layout;
+
+    layout.push_back(instance_id_);
+    layout.push_back(static_cast<int>(entities_.object_.size()));
+    for (auto obj : entities_.object_)
+    {
+        layout.push_back(obj->GetId());
+        layout.push_back(obj->type_);
+    }
+    layout.push_back(static_cast<int>(scenarioReader->controller_.size()));
+    layout.push_back(scenarioGateway.getNumberOfObjects());
+    layout.push_back(static_cast<int>(storyBoard.init_.private_action_.size()));
+    layout.push_back(static_cast<int>(storyBoard.init_.global_action_.size()));
+    layout.push_back(CountStoryBoardElements(&storyBoard));
+    layout.push_back(static_cast<int>(ScenarioReader::parameters.parameterDeclarations_.Parameter.size()));
+    layout.push_back(static_cast<int>(ScenarioReader::variables.parameterDeclarations_.Parameter.size()));
+
+    return layout;
+}
+
+void ScenarioEngine::SyncState(SE_StateSnapshot& state)
+{
+    state.Value(simulationTime_);
+    state.Value(trueTime_);
+    state.Value(frame_nr_);
+    state.Value(doOnce);
+
+    size_t n_collisions = collision_pair_.size();
+    state.Value(n_collisions);
+    if (!state.IsSaving() && !state.Failed())
+    {
+        collision_pair_.resize(n_collisions);
+    }
+    for (size_t i = 0; i < n_collisions && !state.Failed(); i++)
+    {
+        state.Reference(collision_pair_[i].object0);
+        state.Reference(collision_pair_[i].object1);
+    }
+    state.Value(SE_Env::Inst().GetRand().GetGenerator());
+
+    for (auto obj : entities_.object_)
+    {
+        obj->SyncState(state);
+    }
+
+    for (auto controller : scenarioReader->controller_)
+    {
+        controller->SyncState(state);
+    }
+
+    storyBoard.SyncState(state);
+    ScenarioReader::parameters.SyncState(state);
+    ScenarioReader::variables.SyncState(state);
+
+    for (auto& obj_state : scenarioGateway.objectState_)
+    {
+        state.Value(*obj_state);
+    }
+}
+
+int ScenarioEngine::SaveState(SE_StateSnapshot& state)
+{
+    std::vector<int> layout = GetStateLayout();
+
+    state.BeginSave();
+    state.SetReferenceTargets(entities_.object_);
+    state.SetReferenceTargets(scenarioReader->controller_);
+    state.Value(layout);
+    SyncState(state);
+
+    if (state.Failed())
+    {
+        LOG("Failed to save state: Reference to an entity or controller not part of the scenario");
+        return -1;
+    }
+
+    return 0;
+}
+
+int ScenarioEngine::RestoreState(SE_StateSnapshot& state)
+{
+    std::vector<int> layout;
+
+    state.BeginRestore();
+    state.SetReferenceTargets(entities_.object_);
+    state.SetReferenceTargets(scenarioReader->controller_);
+    state.Value(layout);
+
+    if (state.Failed() || layout != GetStateLayout())
+    {
+        LOG("Failed to restore state: Snapshot does not match scenario instance, or entities or controllers added or removed since saved");
+        return -1;
+    }
+
+    SyncState(state);
+
+    if (state.Failed())
+    {
+        LOG("Failed to restore state: Snapshot corrupt, simulation state undefined");
+        return -1;
+    }
+
+    return 0;
+}
@@ -23,6 +23,7 @@
 #include "ScenarioGateway.hpp"
 #include "ScenarioReader.hpp"
 #include "RoadNetwork.hpp"
+#include "KPICollector.hpp"
 
 namespace scenarioengine
 {
@@ -75,6 +76,10 @@ namespace scenarioengine
         void SetupGhost(Object *object);
         void ResetEvents();
         int  DetectCollisions();
+        KPICollector *GetKPICollector()
+        {
+            return kpi_;
+        }
         bool GetDisableControllersFlag()
         {
             return disable_controllers_;
@@ -133,6 +138,21 @@ namespace scenarioengine
         }
         void CreateGhostTeleport(Object *obj1, Object *obj2, Event *event);
 
+        /**
+        Save complete dynamic state of the simulation, e.g. to later explore alternative continuations from this point
+        @param state Snapshot to fill, any previous content is discarded
+        @return 0 on success
+        */
+        int SaveState(SE_StateSnapshot &state);
+
+        /**
+        Restore simulation to a state saved by SaveState() of the same scenario instance. Entities and controllers
+        must not have been added or removed in between. The snapshot is not modified, so it can be restored again.
+        @param state Snapshot to restore
+        @return 0 on success, -1 if the snapshot does not match current scenario
+        */
+        int RestoreState(SE_StateSnapshot &state);
+
         void UpdateGhostMode();
         int  GetInitStatus()
         {
@@ -164,12 +184,16 @@ namespace scenarioengine
         Vehicle         sumotemplate;
         ScenarioGateway scenarioGateway;
         Object         *ghost_;
+        KPICollector   *kpi_;
 
         // execution control flags
         unsigned int frame_nr_;
         int          init_status_;
+        int          instance_id_;  // unique per scenario initialization, part of state snapshot layout
 
-        int parseScenario();
+        int              parseScenario();
+        std::vector<int> GetStateLayout();
+        void             SyncState(SE_StateSnapshot &state);
     };
 
 }  // namespace scenarioengine
@@ -10,8 +10,10 @@
  * https://sites.google.com/view/simulationscenarios
  */
 
+#include <thread>
 #include "ScenarioGateway.hpp"
 #include "CommonMini.hpp"
+#include "Profiler.hpp"
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -233,7 +235,63 @@ void ObjectState::Print()
 
 // ScenarioGateway
 
-ScenarioGateway::ScenarioGateway()
+// Values that can be posted from other threads, grouped by the update function applying them
+enum
+{
+    POSTED_X = 0,
+    POSTED_Y,
+    POSTED_Z,
+    POSTED_H,
+    POSTED_P,
+    POSTED_R,
+    POSTED_TIMESTAMP,
+    POSTED_SPEED,
+    POSTED_WHEEL_ANGLE,
+    POSTED_WHEEL_ROT,
+    POSTED_N_VALUES
+};
+
+enum
+{
+    POSTED_GROUP_POS = 0,
+    POSTED_GROUP_SPEED,
+    POSTED_GROUP_WHEEL_ANGLE,
+    POSTED_GROUP_WHEEL_ROT,
+    POSTED_GROUP_CREATE,  // create object, if not existing, before applying other values
+    POSTED_N_GROUPS
+};
+
+#define POSTED_FRESH       4   // flag set in PostedObjectState::middle when it holds values not yet seen by the consumer
+#define POSTED_INDEX_MASK  3
+#define POSTED_SPINS_YIELD 64  // producers waiting for their turn start yielding after this number of attempts
+
+namespace scenarioengine
+{
+    struct PostedValues
+    {
+        double       value[POSTED_N_VALUES];
+        unsigned int stamp[POSTED_N_GROUPS];  // post counter at latest write of each group, 0 = never written
+        char         name[NAME_LEN];          // name of object to create, see POSTED_GROUP_CREATE
+    };
+
+    // Slot for values posted to one object, triple buffered. The producer writes into its back buffer and swaps it
+    // with the middle one, the consumer swaps its front buffer with the middle one when that is fresh. Hence neither
+    // side ever waits for the other, and the consumer always gets the complete set of values from one post.
+    struct PostedObjectState
+    {
+        alignas(64) std::atomic<int> id{-1};  // -1 = free slot, a claimed slot is never released
+        std::atomic<bool>            writing{false};  // producers posting to the same object take turns
+        std::atomic<unsigned int>    middle{1};       // buffer index, possibly combined with POSTED_FRESH
+        unsigned int                 back  = 0;       // producer side, protected by writing
+        unsigned int                 count = 0;
+        PostedValues                 latest = {};
+        unsigned int                 front  = 2;  // consumer side
+        unsigned int                 applied_stamp[POSTED_N_GROUPS] = {};
+        PostedValues                 buffer[3]                      = {};
+    };
+}  // namespace scenarioengine
+
+ScenarioGateway::ScenarioGateway() : posted_(new PostedObjectState[GATEWAY_POSTED_STATE_SLOTS])
 {
 }
 
@@ -243,15 +301,23 @@ ScenarioGateway::~ScenarioGateway()
 
     data_file_.flush();
     data_file_.close();
+    async_data_file_.Close();
 }
 
 ObjectState* ScenarioGateway::getObjectStatePtrById(int id)
 {
-    for (size_t i = 0; i < objectState_.size(); i++)
+    // Start looking right after the previously found object, so that objects accessed in order,
+    // e.g. one call per object each frame, are found immediately. The start index is only a hint,
+    // so relaxed atomic access is enough when called from several threads.
+    size_t n     = objectState_.size();
+    size_t start = last_lookup_idx_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < n; i++)
     {
-        if (objectState_[i]->state_.info.id == id)
+        size_t idx = (start + 1 + i) % n;
+        if (objectState_[idx]->state_.info.id == id)
         {
-            return objectState_[i].get();
+            last_lookup_idx_.store(idx, std::memory_order_relaxed);
+            return objectState_[idx].get();
         }
     }
 
@@ -260,17 +326,17 @@ ObjectState* ScenarioGateway::getObjectStatePtrById(int id)
 
 int ScenarioGateway::getObjectStateById(int id, ObjectState& objectState)
 {
-    for (size_t i = 0; i < objectState_.size(); i++)
+    ObjectState* obj_state = getObjectStatePtrById(id);
+
+    if (obj_state == nullptr)
     {
-        if (objectState_[i]->state_.info.id == id)
-        {
-            objectState = *objectState_[i];
-            return 0;
-        }
+        // Indicate not found by returning non zero
+        return -1;
     }
 
-    // Indicate not found by returning non zero
-    return -1;
+    objectState = *obj_state;
+
+    return 0;
 }
 
 int ScenarioGateway::updateObjectInfo(ObjectState* obj_state,
@@ -725,15 +791,19 @@ int ScenarioGateway::updateObjectWorldPos(int id, double timestamp, double x, do
     {
         // Create state and set permanent information
         LOG("Object id: %d must be reported before updated", id);
-    }
-    else
-    {
-        // Update status
-        obj_state->state_.pos.SetInertiaPos(x, y, z, h, p, r);
-        obj_state->state_.info.timeStamp = timestamp;
-        obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
+        return 0;
     }
 
+    return updateObjectWorldPos(obj_state, timestamp, x, y, z, h, p, r);
+}
+
+int ScenarioGateway::updateObjectWorldPos(ObjectState* obj_state, double timestamp, double x, double y, double z, double h, double p, double r)
+{
+    // Update status of already looked up object
+    obj_state->state_.pos.SetInertiaPos(x, y, z, h, p, r);
+    obj_state->state_.info.timeStamp = timestamp;
+    obj_state->dirty_ |= Object::DirtyBit::LONGITUDINAL | Object::DirtyBit::LATERAL;
+
     return 0;
 }
 
@@ -911,6 +981,201 @@ int ScenarioGateway::updateObjectFrictionCoefficients(int id, double friction[4]
     return 0;
 }
 
+int ScenarioGateway::postValues(int id, unsigned int groups, int first, int n, const double* values, const char* create_name)
+{
+    if (id < 0)
+    {
+        return -1;
+    }
+
+    // Find slot of the object, or claim a free one
+    PostedObjectState* slot  = nullptr;
+    unsigned int       start = static_cast<unsigned int>(id) % GATEWAY_POSTED_STATE_SLOTS;
+    for (unsigned int i = 0; i < GATEWAY_POSTED_STATE_SLOTS && slot == nullptr; i++)
+    {
+        PostedObjectState& candidate = posted_[(start + i) % GATEWAY_POSTED_STATE_SLOTS];
+        int                slot_id   = candidate.id.load(std::memory_order_acquire);
+
+        // on failed exchange slot_id is updated to the id of the other producer, which might be the same object
+        if ((slot_id == -1 && candidate.id.compare_exchange_strong(slot_id, id)) || slot_id == id)
+        {
+            slot = &candidate;
+        }
+    }
+
+    if (slot == nullptr)
+    {
+        LOG_ONCE("Failed to post state of object %d, max %d objects supported", id, GATEWAY_POSTED_STATE_SLOTS);
+        return -1;
+    }
+
+    // Take turn with any other producer of the same object. Turns are short, but the other producer might have been
+    // preempted in the middle of one, so don't keep spinning.
+    bool expected = false;
+    for (int spins = 0; !slot->writing.compare_exchange_weak(expected, true, std::memory_order_acquire); spins++)
+    {
+        expected = false;
+        if (spins >= POSTED_SPINS_YIELD)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    slot->count++;
+    for (int i = 0; i < n; i++)
+    {
+        slot->latest.value[first + i] = values[i];
+    }
+    if (create_name != nullptr)
+    {
+        StrCopy(slot->latest.name, create_name, NAME_LEN);
+        groups |= 1u << POSTED_GROUP_CREATE;
+    }
+    for (int i = 0; i < POSTED_N_GROUPS; i++)
+    {
+        if (groups & (1u << i))
+        {
+            slot->latest.stamp[i] = slot->count;
+        }
+    }
+
+    // Publish all values, including ones of earlier posts, so that the consumer finds the latest of each group
+    slot->buffer[slot->back] = slot->latest;
+    slot->back               = slot->middle.exchange(slot->back | POSTED_FRESH, std::memory_order_acq_rel) & POSTED_INDEX_MASK;
+
+    slot->writing.store(false, std::memory_order_release);
+
+    if (!any_posted_.load(std::memory_order_relaxed))
+    {
+        any_posted_.store(true, std::memory_order_release);
+    }
+
+    return 0;
+}
+
+int ScenarioGateway::postObjectWorldPos(int id, double timestamp, double x, double y, double z, double h, double p, double r)
+{
+    double values[] = {x, y, z, h, p, r, timestamp};
+    return postValues(id, 1u << POSTED_GROUP_POS, POSTED_X, POSTED_TIMESTAMP - POSTED_X + 1, values);
+}
+
+int ScenarioGateway::postObjectSpeed(int id, double speed)
+{
+    return postValues(id, 1u << POSTED_GROUP_SPEED, POSTED_SPEED, 1, &speed);
+}
+
+int ScenarioGateway::postObjectWheelStatus(int id, double wheelAngle, double wheelRotation)
+{
+    double values[] = {wheelAngle, wheelRotation};
+    return postValues(id, (1u << POSTED_GROUP_WHEEL_ANGLE) | (1u << POSTED_GROUP_WHEEL_ROT), POSTED_WHEEL_ANGLE, 2, values);
+}
+
+int ScenarioGateway::postObjectState(int         id,
+                                     double      timestamp,
+                                     double      x,
+                                     double      y,
+                                     double      z,
+                                     double      h,
+                                     double      p,
+                                     double      r,
+                                     double      speed,
+                                     double      wheelAngle,
+                                     double      wheelRotation,
+                                     const char* create_name)
+{
+    double values[] = {x, y, z, h, p, r, timestamp, speed, wheelAngle, wheelRotation};
+    return postValues(id,
+                      (1u << POSTED_GROUP_POS) | (1u << POSTED_GROUP_SPEED) | (1u << POSTED_GROUP_WHEEL_ANGLE) | (1u << POSTED_GROUP_WHEEL_ROT),
+                      POSTED_X,
+                      POSTED_N_VALUES,
+                      values,
+                      create_name);
+}
+
+int ScenarioGateway::applyPostedStates()
+{
+    if (!any_posted_.load(std::memory_order_acquire))
+    {
+        return 0;
+    }
+
+    int n_updated = 0;
+    for (unsigned int i = 0; i < GATEWAY_POSTED_STATE_SLOTS; i++)
+    {
+        PostedObjectState& slot = posted_[i];
+        int                id   = slot.id.load(std::memory_order_acquire);
+
+        if (id == -1 || !(slot.middle.load(std::memory_order_relaxed) & POSTED_FRESH))
+        {
+            continue;  // nothing new
+        }
+
+        slot.front                 = slot.middle.exchange(slot.front, std::memory_order_acq_rel) & POSTED_INDEX_MASK;
+        const double*       values = slot.buffer[slot.front].value;
+        const unsigned int* stamp  = slot.buffer[slot.front].stamp;
+
+        if (stamp[POSTED_GROUP_CREATE] != slot.applied_stamp[POSTED_GROUP_CREATE] && getObjectStatePtrById(id) == nullptr)
+        {
+            // Register new object, with same defaults as a car reported by a remote client
+            OSCBoundingBox bbox = {0, 0, 0, 0, 0, 0};
+            reportObject(id,
+                         slot.buffer[slot.front].name,
+                         static_cast<int>(Object::Type::VEHICLE),
+                         static_cast<int>(Vehicle::Category::CAR),
+                         static_cast<int>(Vehicle::Role::NONE),
+                         0,
+                         1,
+                         bbox,
+                         static_cast<int>(EntityScaleMode::NONE),
+                         0xff,
+                         values[POSTED_TIMESTAMP],
+                         values[POSTED_SPEED],
+                         values[POSTED_WHEEL_ANGLE],
+                         values[POSTED_WHEEL_ROT],
+                         0.0,
+                         values[POSTED_X],
+                         values[POSTED_Y],
+                         values[POSTED_Z],
+                         values[POSTED_H],
+                         values[POSTED_P],
+                         values[POSTED_R]);
+        }
+
+        // Apply the groups written since last time
+        if (stamp[POSTED_GROUP_POS] != slot.applied_stamp[POSTED_GROUP_POS])
+        {
+            updateObjectWorldPos(id,
+                                 values[POSTED_TIMESTAMP],
+                                 values[POSTED_X],
+                                 values[POSTED_Y],
+                                 values[POSTED_Z],
+                                 values[POSTED_H],
+                                 values[POSTED_P],
+                                 values[POSTED_R]);
+        }
+        if (stamp[POSTED_GROUP_SPEED] != slot.applied_stamp[POSTED_GROUP_SPEED])
+        {
+            updateObjectSpeed(id, 0.0, values[POSTED_SPEED]);
+        }
+        if (stamp[POSTED_GROUP_WHEEL_ANGLE] != slot.applied_stamp[POSTED_GROUP_WHEEL_ANGLE])
+        {
+            updateObjectWheelAngle(id, 0.0, values[POSTED_WHEEL_ANGLE]);
+        }
+        if (stamp[POSTED_GROUP_WHEEL_ROT] != slot.applied_stamp[POSTED_GROUP_WHEEL_ROT])
+        {
+            updateObjectWheelRotation(id, 0.0, values[POSTED_WHEEL_ROT]);
+        }
+
+        for (int j = 0; j < POSTED_N_GROUPS; j++)
+        {
+            slot.applied_stamp[j] = stamp[j];
+        }
+        n_updated++;
+    }
+
+    return n_updated;
+}
+
 int ScenarioGateway::setObjectPositionMode(int id, int type, int mode)
 {
     ObjectState* obj_state = getObjectStatePtrById(id);
@@ -1027,7 +1292,9 @@ void ScenarioGateway::removeObject(std::string name)
 
 void ScenarioGateway::WriteStatesToFile()
 {
-    if (data_file_.is_open())
+    SE_PROFILE_SCOPE("ScenarioGateway::WriteStatesToFile");
+
+    if (data_file_.is_open() || async_data_file_.IsOpen())
     {
         // Write status to file - for later replay
         for (size_t i = 0; i < objectState_.size(); i++)
@@ -1060,27 +1327,45 @@ void ScenarioGateway::WriteStatesToFile()
             datState.pos.offset = static_cast<float>(objectState_[i]->state_.pos.GetOffset());
             datState.pos.t      = static_cast<float>(objectState_[i]->state_.pos.GetT());
             datState.pos.s      = static_cast<float>(objectState_[i]->state_.pos.GetS());
-            data_file_.write(reinterpret_cast<char*>(&datState), sizeof(datState));
+            if (async_data_file_.IsOpen())
+            {
+                async_data_file_.Write(reinterpret_cast<char*>(&datState), sizeof(datState));
+            }
+            else
+            {
+                data_file_.write(reinterpret_cast<char*>(&datState), sizeof(datState));
+            }
         }
     }
 }
 
-int ScenarioGateway::RecordToFile(std::string filename, std::string odr_filename, std::string model_filename)
+int ScenarioGateway::RecordToFile(std::string filename, std::string odr_filename, std::string model_filename, bool buffered)
 {
     if (!filename.empty())
     {
-        data_file_.open(filename, std::ofstream::binary);
-        if (data_file_.fail())
-        {
-            LOG("Cannot open file: %s", filename.c_str());
-            return -1;
-        }
         DatHeader header;
         header.version = DAT_FILE_FORMAT_VERSION;
         StrCopy(header.odr_filename, odr_filename.c_str(), MIN(odr_filename.length() + 1, DAT_FILENAME_SIZE));
         StrCopy(header.model_filename, model_filename.c_str(), MIN(model_filename.length() + 1, DAT_FILENAME_SIZE));
 
-        data_file_.write(reinterpret_cast<char*>(&header), sizeof(header));
+        if (buffered)
+        {
+            if (async_data_file_.Open(filename) != 0)
+            {
+                return -1;
+            }
+            async_data_file_.Write(reinterpret_cast<char*>(&header), sizeof(header));
+        }
+        else
+        {
+            data_file_.open(filename, std::ofstream::binary);
+            if (data_file_.fail())
+            {
+                LOG("Cannot open file: %s", filename.c_str());
+                return -1;
+            }
+            data_file_.write(reinterpret_cast<char*>(&header), sizeof(header));
+        }
     }
 
     return 0;
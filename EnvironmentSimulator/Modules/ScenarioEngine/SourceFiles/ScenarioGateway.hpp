@@ -11,6 +11,7 @@
  */
 
 #pragma once
+#include <atomic>
 #include "RoadManager.hpp"
 #include "OSCBoundingBox.hpp"
 #include "Entities.hpp"
@@ -18,6 +19,8 @@
 #define DAT_FILE_FORMAT_VERSION 2
 #define DAT_FILENAME_SIZE       512
 
+#define GATEWAY_POSTED_STATE_SLOTS 1024  // max number of objects receiving states posted from other threads
+
 namespace scenarioengine
 {
 
@@ -200,6 +203,8 @@ namespace scenarioengine
         friend class ScenarioGateway;
     };
 
+    struct PostedObjectState;
+
     class ScenarioGateway
     {
     public:
@@ -310,6 +315,7 @@ namespace scenarioengine
         int updateObjectRoadPos(int id, double timestamp, int roadId, double lateralOffset, double s);
         int updateObjectLanePos(int id, double timestamp, int roadId, int laneId, double offset, double s);
         int updateObjectWorldPos(int id, double timestamp, double x, double y, double z, double h, double p, double r);
+        int updateObjectWorldPos(ObjectState *obj_state, double timestamp, double x, double y, double z, double h, double p, double r);
         int updateObjectWorldPosMode(int id, double timestamp, double x, double y, double z, double h, double p, double r, int mode);
         int updateObjectWorldPosXYH(int id, double timestamp, double x, double y, double h);
         int updateObjectWorldPosXYHMode(int id, double timestamp, double x, double y, double h, int mode);
@@ -345,6 +351,43 @@ namespace scenarioengine
         */
         int setObjectPositionModeDefault(int id, int type);
 
+        /**
+        Thread safe alternatives to the corresponding update functions, for reporting from other threads than the one
+        running the scenario. Producers never wait for the scenario engine, values are just stored in a slot per object
+        and applied at start of next ScenarioEngine::step(), see applyPostedStates(). Only the most recent value of
+        each kind is applied. Producers posting to the same object take turns, different objects don't interfere.
+        @param id Id of the object, max GATEWAY_POSTED_STATE_SLOTS different objects
+        @return 0 if successful, -1 if no slot was available
+        */
+        int postObjectWorldPos(int id, double timestamp, double x, double y, double z, double h, double p, double r);
+        int postObjectSpeed(int id, double speed);
+        int postObjectWheelStatus(int id, double wheelAngle, double wheelRotation);
+
+        /**
+        Post complete state in one go, same as the individual post functions above but taking turns only once
+        @param create_name If not nullptr, the object is created as a car with this name unless it already exists
+        @return 0 if successful, -1 if no slot was available
+        */
+        int postObjectState(int         id,
+                            double      timestamp,
+                            double      x,
+                            double      y,
+                            double      z,
+                            double      h,
+                            double      p,
+                            double      r,
+                            double      speed,
+                            double      wheelAngle,
+                            double      wheelRotation,
+                            const char *create_name = nullptr);
+
+        /**
+        Apply states posted since last call, using the ordinary update functions. Consistent snapshot per object, i.e.
+        all values of a post are applied together. To be called from the thread running the scenario only.
+        @return Number of objects updated
+        */
+        int applyPostedStates();
+
         bool isObjectReported(int id);
         void clearDirtyBits();
 
@@ -365,13 +408,19 @@ namespace scenarioengine
         ObjectState *getObjectStatePtrById(int id);
         int          getObjectStateById(int idx, ObjectState &objState);
         void         WriteStatesToFile();
-        int          RecordToFile(std::string filename, std::string odr_filename, std::string model_filename);
+        int          RecordToFile(std::string filename, std::string odr_filename, std::string model_filename, bool buffered = false);
 
         std::vector<std::unique_ptr<ObjectState>> objectState_;
 
     private:
         int updateObjectInfo(ObjectState *obj_state, double timestamp, int visibilityMask, double speed, double wheel_angle, double wheel_rot);
-        std::ofstream data_file_;
+        std::ofstream       data_file_;
+        SE_AsyncFileWriter  async_data_file_;       // used instead of data_file_ in buffered mode
+        std::atomic<size_t> last_lookup_idx_{0};  // index of most recently looked up object, see getObjectStatePtrById()
+
+        int postValues(int id, unsigned int groups, int first, int n, const double* values, const char* create_name = nullptr);
+        std::unique_ptr<PostedObjectState[]> posted_;            // open addressing hash table, key = object id
+        std::atomic<bool>                    any_posted_{false};  // quick check to skip looking through the slots
     };
 
 }  // namespace scenarioengine
@@ -41,6 +41,8 @@ namespace scenarioengine
 
     Parameters ScenarioReader::parameters;
     Parameters ScenarioReader::variables;
+
+    std::map<std::string, std::unique_ptr<pugi::xml_document>> ScenarioReader::template_docs_;
 }  // namespace scenarioengine
 
 typedef struct
@@ -61,10 +63,15 @@ ScenarioReader::ScenarioReader(Entities *entities, Catalogs *catalogs, bool disa
       story_board_(nullptr)
 {
     parameters.Clear();
+    variables.Clear();
 }
 
 ScenarioReader::~ScenarioReader()
 {
+    // Scenario unloaded, reject any handles fetched by the user
+    parameters.InvalidateHandles();
+    variables.InvalidateHandles();
+
     for (size_t i = 0; i < controller_.size(); i++)
     {
         delete controller_[i];
@@ -113,9 +120,49 @@ int ScenarioReader::RemoveController(Controller *controller)
     return -1;
 }
 
+pugi::xml_parse_result ScenarioReader::LoadTemplateDocument(const std::string &filename, pugi::xml_document **doc)
+{
+    pugi::xml_parse_result result;
+
+    auto it = template_docs_.find(filename);
+    if (it != template_docs_.end())
+    {
+        *doc          = it->second.get();
+        result.status = pugi::status_ok;
+        result.offset = 0;
+        return result;
+    }
+
+    std::unique_ptr<pugi::xml_document> new_doc(new pugi::xml_document);
+    result = new_doc->load_file(filename.c_str());
+    if (result)
+    {
+        *doc = new_doc.get();
+        template_docs_.emplace(filename, std::move(new_doc));
+    }
+
+    return result;
+}
+
 int ScenarioReader::loadOSCFile(const char *path)
 {
-    pugi::xml_parse_result result = doc_.load_file(path);
+    pugi::xml_parse_result result;
+
+    if (SE_Env::Inst().GetScenarioTemplateMode())
+    {
+        // Instantiate scenario from the in-memory template document instead of reading and parsing the file again
+        pugi::xml_document *template_doc = nullptr;
+        if ((result = LoadTemplateDocument(path, &template_doc)))
+        {
+            doc_.reset(*template_doc);
+        }
+    }
+    else
+    {
+        ClearTemplateDocuments();
+        result = doc_.load_file(path);
+    }
+
     if (!result)
     {
         LOG("%s at offset (character position): %d", result.description(), result.offset);
@@ -274,9 +321,9 @@ Catalog *ScenarioReader::LoadCatalog(std::string name)
     }
 
     // Not found, try to locate it in one the registered catalog directories
-    pugi::xml_document       catalog_doc;
-    pugi::xml_parse_result   result;
-    std::vector<std::string> file_name_candidates;
+    std::shared_ptr<const pugi::xml_document> catalog_doc;
+    pugi::xml_parse_result                    result;
+    std::vector<std::string>                  file_name_candidates;
     for (size_t i = 0; i < catalogs_->catalog_dirs_.size() && !result; i++)
     {
         file_name_candidates.clear();
@@ -296,8 +343,8 @@ Catalog *ScenarioReader::LoadCatalog(std::string name)
         {
             if (FileExists(file_name_candidates[j].c_str()))
             {
-                // Load it
-                result = catalog_doc.load_file(file_name_candidates[j].c_str());
+                // Load it, or pick it from the cache in case already parsed by any previous scenario
+                catalog_doc = CatalogCache::Inst().Load(file_name_candidates[j], result);
             }
         }
     }
@@ -306,10 +353,10 @@ Catalog *ScenarioReader::LoadCatalog(std::string name)
         throw std::runtime_error("Couldn't locate catalog file: " + name + ". " + result.description());
     }
 
-    pugi::xml_node osc_node_ = catalog_doc.child("OpenSCENARIO");
+    pugi::xml_node osc_node_ = catalog_doc->child("OpenSCENARIO");
     if (!osc_node_)
     {
-        osc_node_ = catalog_doc.child("OpenScenario");
+        osc_node_ = catalog_doc->child("OpenScenario");
         if (!osc_node_)
         {
             throw std::runtime_error("Couldn't find Catalog OpenSCENARIO or OpenScenario element - check XML!");
@@ -324,10 +371,8 @@ Catalog *ScenarioReader::LoadCatalog(std::string name)
     {
         std::string entry_name = parameters.ReadAttribute(entry_n, "name");
 
-        pugi::xml_document root;
-        root.append_copy(entry_n);
-
-        catalog->AddEntry(new Entry(entry_name, std::move(root)));
+        // Refer to the shared node, no copy needed since the entry is only read when instantiated
+        catalog->AddEntry(new Entry(entry_name, catalog_doc, entry_n));
     }
 
     // Get type by inspecting first entry
@@ -25,6 +25,8 @@
 #include "ScenarioGateway.hpp"
 
 #include <iostream>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -181,6 +183,23 @@ namespace scenarioengine
         static Parameters parameters;  // static to enable set via callback during creation of object
         static Parameters variables;
 
+        /**
+         * Scenario template mode: Load XML file and keep the parsed document in memory, so that any subsequent
+         * request for the same file is served without reading and parsing it again.
+         * @param filename File to load
+         * @param doc Will point to the loaded document, owned by the template cache
+         * @return Parse result, check for any error
+         */
+        static pugi::xml_parse_result LoadTemplateDocument(const std::string& filename, pugi::xml_document** doc);
+
+        /**
+         * Release all documents kept by scenario template mode
+         */
+        static void ClearTemplateDocuments()
+        {
+            template_docs_.clear();
+        }
+
     private:
         pugi::xml_document    doc_;
         pugi::xml_node        osc_root_;
@@ -196,6 +215,8 @@ namespace scenarioengine
         std::string           description_;
         StoryBoard*           story_board_;
 
+        static std::map<std::string, std::unique_ptr<pugi::xml_document>> template_docs_;  // key = file path
+
         int             ParseTransitionDynamics(pugi::xml_node node, OSCPrivateAction::TransitionDynamics& td);
         ConditionGroup* ParseConditionGroup(pugi::xml_node node);
         Object*         ResolveObjectReference(std::string name);
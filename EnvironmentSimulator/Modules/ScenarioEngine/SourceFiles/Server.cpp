@@ -18,6 +18,7 @@
 #include "ScenarioGateway.hpp"
 #include "Server.hpp"
 #include "UDP.hpp"
+#include "SharedMemory.hpp"
 
 using namespace scenarioengine;
 
@@ -33,8 +34,8 @@ enum
 
 static int              state = SERV_NOT_STARTED;
 static SE_Thread        thread;
-static SE_Mutex         mutex;
 static ScenarioGateway *scenarioGateway = 0;
+static bool             useSharedMemory = false;
 
 namespace scenarioengine
 {
@@ -45,10 +46,21 @@ namespace scenarioengine
         (void)iPortIn;
         EgoStateBuffer_t buf;
 
-        state                = SERV_NOT_STARTED;
-        UDPServer *udpServer = new UDPServer(ESMINI_DEFAULT_INPORT);
+        state = SERV_NOT_STARTED;
 
-        LOG("Server listening on port %d", ESMINI_DEFAULT_INPORT);
+        UDPServer          *udpServer = nullptr;
+        SharedMemoryServer *shmServer = nullptr;
+
+        if (useSharedMemory)
+        {
+            shmServer = new SharedMemoryServer(ESMINI_DEFAULT_SHM_NAME);
+            LOG("Server listening on shared memory %s", ESMINI_DEFAULT_SHM_NAME);
+        }
+        else
+        {
+            udpServer = new UDPServer(ESMINI_DEFAULT_INPORT);
+            LOG("Server listening on port %d", ESMINI_DEFAULT_INPORT);
+        }
 
         state            = SERV_RUNNING;
         double x_old     = 0.0;
@@ -57,7 +69,8 @@ namespace scenarioengine
 
         while (state == SERV_RUNNING)
         {
-            int ret = udpServer->Receive(reinterpret_cast<char *>(&buf), sizeof(EgoStateBuffer_t));
+            int ret = shmServer != nullptr ? shmServer->Receive(reinterpret_cast<char *>(&buf), sizeof(EgoStateBuffer_t))
+                                           : udpServer->Receive(reinterpret_cast<char *>(&buf), sizeof(EgoStateBuffer_t));
 
 #ifdef SWAP_BYTE_ORDER_ESMINI
             SwapByteOrder((unsigned char *)&buf, 4, sizeof(buf));
@@ -83,46 +96,33 @@ namespace scenarioengine
                        static_cast<double>(buf.wheel_angle),
                        180 * static_cast<double>(buf.wheel_angle) / M_PI);
 
-                // Update Ego state
-                mutex.Lock();
-
-                OSCBoundingBox bbox = {0, 0, 0, 0, 0, 0};  // dummy bariable just to feed into the function
-
-                scenarioGateway->reportObject(0,
-                                              "Ego",
-                                              static_cast<int>(Object::Type::VEHICLE),
-                                              static_cast<int>(Vehicle::Category::CAR),
-                                              static_cast<int>(Vehicle::Role::NONE),
-                                              0,
-                                              1,
-                                              bbox,
-                                              static_cast<int>(EntityScaleMode::NONE),
-                                              0xff,
-                                              0.0,
-                                              buf.speed,
-                                              buf.wheel_angle,
-                                              0.0,
-                                              wheel_rot,
-                                              buf.x,
-                                              buf.y,
-                                              buf.z,
-                                              buf.h,
-                                              buf.p,
-                                              buf.r);
-
-                mutex.Unlock();
+                // Post Ego state, applied by the scenario engine at start of next step. Ego is created unless existing.
+                scenarioGateway->postObjectState(0,
+                                                 0.0,
+                                                 buf.x,
+                                                 buf.y,
+                                                 buf.z,
+                                                 buf.h,
+                                                 buf.p,
+                                                 buf.r,
+                                                 buf.speed,
+                                                 buf.wheel_angle,
+                                                 wheel_rot,
+                                                 "Ego");
             }
         }
 
         delete udpServer;
+        delete shmServer;
 
         state = SERV_STOPPED;
     }
 
-    void StartServer(ScenarioEngine *scenarioEngine)
+    void StartServer(ScenarioEngine *scenarioEngine, bool sharedMemory)
     {
         // Fetch ScenarioGateway
         scenarioGateway = scenarioEngine->getScenarioGateway();
+        useSharedMemory = sharedMemory;
 
         thread.Start(ServerThread, NULL);
     }
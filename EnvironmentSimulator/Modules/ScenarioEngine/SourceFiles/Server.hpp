@@ -33,6 +33,11 @@ typedef struct
 
 namespace scenarioengine
 {
-    void StartServer(ScenarioEngine *scenarioEngine);
+    /**
+        Launch server thread receiving Ego state (EgoStateBuffer_t) from external simulator
+        @param scenarioEngine Scenario to update
+        @param sharedMemory Receive via local shared memory (ESMINI_DEFAULT_SHM_NAME) instead of UDP (ESMINI_DEFAULT_INPORT)
+    */
+    void StartServer(ScenarioEngine *scenarioEngine, bool sharedMemory = false);
     void StopServer();
 }  // namespace scenarioengine
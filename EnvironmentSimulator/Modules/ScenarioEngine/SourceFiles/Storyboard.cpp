@@ -12,6 +12,7 @@
 
 #include "Storyboard.hpp"
 #include "CommonMini.hpp"
+#include "Profiler.hpp"
 
 using namespace scenarioengine;
 
@@ -90,6 +91,8 @@ void StoryBoard::Start(double simTime)
 
 void StoryBoard::Step(double simTime, double dt)
 {
+    SE_PROFILE_SCOPE("StoryBoard::Step");
+
     EvalTriggers(simTime);
 
     for (auto action : init_.private_action_)
@@ -110,6 +113,20 @@ void StoryBoard::Step(double simTime, double dt)
     StoryBoardElement::Step(simTime, dt);
 }
 
+void StoryBoard::SyncState(SE_StateSnapshot& state)
+{
+    for (auto action : init_.private_action_)
+    {
+        action->SyncState(state);
+    }
+    for (auto action : init_.global_action_)
+    {
+        action->SyncState(state);
+    }
+
+    StoryBoardElement::SyncState(state);
+}
+
 void Event::Start(double simTime)
 {
     double adjustedTime = simTime;
@@ -257,6 +257,7 @@ namespace scenarioengine
         void           Print();
         void           Start(double simTime) override;
         void           Step(double simTime, double dt) override;
+        void           SyncState(SE_StateSnapshot& state) override;
 
         std::vector<StoryBoardElement*>* GetChildren() override
         {
@@ -376,6 +376,28 @@ void StoryBoardElement::Reset(State state)
     ResetTransition();
 }
 
+void StoryBoardElement::SyncState(SE_StateSnapshot& state)
+{
+    state.Value(state_);
+    state.Value(transition_);
+    state.Value(num_executions_);
+
+    if (start_trigger_ != nullptr)
+    {
+        start_trigger_->SyncState(state);
+    }
+
+    if (stop_trigger_ != nullptr)
+    {
+        stop_trigger_->SyncState(state);
+    }
+
+    for (auto child : *GetChildren())
+    {
+        child->SyncState(state);
+    }
+}
+
 void StoryBoardElement::SetName(std::string name)
 {
     name_ = name;
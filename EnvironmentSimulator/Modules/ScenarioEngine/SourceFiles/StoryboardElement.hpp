@@ -180,6 +180,12 @@ namespace scenarioengine
 
         virtual void Reset(State state = State::INIT);
 
+        /**
+            Save or restore dynamic state of the element, its triggers and all children
+            @param state Snapshot to save into or restore from, depending on its mode
+        */
+        virtual void SyncState(SE_StateSnapshot& state);
+
         void SetName(std::string name);
 
         const std::string GetName() const
@@ -201,6 +201,132 @@ ExprReturnStruct eval_expr(const char* str)
     return rs;
 }
 
+// Replace constants matching any slot key with references to the slot
+static int bind_slots(struct expr* e, const double* slot_keys, double* slots, int n_slots, int* n_bound)
+{
+    int i;
+    if (e->type == OP_CONST)
+    {
+        for (i = 0; i < n_slots; i++)
+        {
+            if (e->param.num.value == slot_keys[i])
+            {
+                e->type            = OP_VAR;
+                e->param.var.value = &slots[i];
+                n_bound[i]++;
+                break;
+            }
+        }
+    }
+    else if (e->type == OP_FUNC)
+    {
+        for (i = 0; i < vec_len(&e->param.func.args); i++)
+        {
+            if (bind_slots(&vec_nth(&e->param.func.args, i), slot_keys, slots, n_slots, n_bound) != 0)
+            {
+                return -1;
+            }
+        }
+    }
+    else if (e->type == OP_UNKNOWN || e->type == OP_STR || e->type == OP_VAR)
+    {
+        // not a pure numeric expression
+        return -1;
+    }
+    else
+    {
+        for (i = 0; i < vec_len(&e->param.op.args); i++)
+        {
+            if (bind_slots(&vec_nth(&e->param.op.args, i), slot_keys, slots, n_slots, n_bound) != 0)
+            {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+void* compile_expr(const char* str, const double* slot_keys, double* slots, int n_slots)
+{
+    struct expr_var_list vars    = {0};
+    struct expr*         e       = expr_create(str, strlen(str), &vars, user_funcs);
+    int*                 n_bound = 0;
+    int                  i;
+
+    if (e == 0)
+    {
+        return 0;
+    }
+    else if (e->type == OP_STR)
+    {
+        // string expression, variables already released by the parser
+        expr_destroy(e, 0);
+        return 0;
+    }
+    else if (vars.head != 0)
+    {
+        // unresolved variables
+        expr_destroy(e, &vars);
+        return 0;
+    }
+
+    n_bound = calloc(n_slots > 0 ? (size_t)n_slots : 1, sizeof(int));
+    if (n_bound == 0 || bind_slots(e, slot_keys, slots, n_slots, n_bound) != 0)
+    {
+        free(n_bound);
+        expr_destroy(e, 0);
+        return 0;
+    }
+
+    for (i = 0; i < n_slots; i++)
+    {
+        if (n_bound[i] != 1)
+        {
+            // ambiguous, key also used as a plain constant
+            free(n_bound);
+            expr_destroy(e, 0);
+            return 0;
+        }
+    }
+    free(n_bound);
+
+    return e;
+}
+
+ExprReturnStruct eval_compiled_expr(void* compiled)
+{
+    ExprReturnStruct rs    = {EXPR_RETURN_UNDEFINED, NAN, {0, 0}};
+    double           value = expr_eval((struct expr*)compiled);
+
+    if (!isnan(value))
+    {
+        rs.type    = EXPR_RETURN_DOUBLE;
+        rs._double = value;
+    }
+
+    return rs;
+}
+
+void destroy_compiled_expr(void* compiled)
+{
+    expr_destroy((struct expr*)compiled, 0);
+}
+
+int parse_expr_number(const char* str, double* value)
+{
+    size_t len = strlen(str);
+
+    if (len == 0 || !isdigit(str[0]))
+    {
+        return -1;
+    }
+
+    *value = expr_parse_number(str, len);
+
+    return isnan(*value) ? -1 : 0;
+}
+
 void clear_expr_result(ExprReturnStruct* rs)
 {
     if (rs->_string.string != 0)
@@ -51,6 +51,39 @@ extern "C"
      */
     void clear_expr_result(ExprReturnStruct* rs);
 
+    /**
+     * Compile numeric expression for repeated evaluation. Numeric literals in the expression equal to any of the
+     * slot keys are bound to the corresponding slot, which is read on each evaluation. Hence the slot values can be
+     * updated without parsing the expression again.
+     * @param str Expression
+     * @param slot_keys Numeric literal to bind per slot, each must occur exactly once in the expression
+     * @param slots Slot values, must stay valid during the life time of the compiled expression
+     * @param n_slots Number of slots
+     * @return Handle to compiled expression, 0 if expression can't be compiled, e.g. a string expression
+     */
+    void* compile_expr(const char* str, const double* slot_keys, double* slots, int n_slots);
+
+    /**
+     * Evaluate compiled expression given current slot values
+     * @param compiled Handle to compiled expression, see compile_expr()
+     * @return evaluated resulting value
+     */
+    ExprReturnStruct eval_compiled_expr(void* compiled);
+
+    /**
+     * Release compiled expression
+     * @param compiled Handle to compiled expression, see compile_expr()
+     */
+    void destroy_compiled_expr(void* compiled);
+
+    /**
+     * Parse a plain decimal number, e.g. "12.5", the same way as numeric literals are parsed in expressions
+     * @param str Number string
+     * @param value Resulting value
+     * @return 0 on success, -1 if str is not a plain number
+     */
+    int parse_expr_number(const char* str, double* value);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -22,6 +22,14 @@
 #include <osgDB/ReadFile>
 #include <osgUtil/SmoothingVisitor>
 #include <osg/ShapeDrawable>
+#include <osg/PagedLOD>
+#include <osgDB/Registry>
+#include <osgDB/WriteFile>
+#include <osgDB/FileUtils>
+#include <map>
+#include <shared_mutex>
+#include <thread>
+#include <cstdio>
 
 #include "CommonMini.hpp"
 #include "viewer.hpp"
@@ -32,6 +40,11 @@
 #define MAX_GEOM_LENGTH 50                    // maximum length of a road geometry mesh segment
 #define MIN_GEOM_LENGTH 0.1                   // minimum length of a road geometry mesh segment, adjust if possible
 
+#define TILE_CACHE_VERSION 1  // increase whenever generated road geometry changes, to invalidate cached tiles
+
+#define ROAD_TILE_EXT               ".roadtile"  // pseudo file extension of tile requests, handled by RoadTileReader
+#define ROAD_TILE_VIEW_RANGE_FACTOR 2.0f         // tiles are paged in within this number of tile sizes from their bounds
+
 #define POLYGON_OFFSET_SIDEWALK  2.0
 #define POLYGON_OFFSET_ROADMARKS 1.0
 #define POLYGON_OFFSET_BORDER    -1.0
@@ -82,7 +95,10 @@ osg::ref_ptr<osg::Texture2D> RoadGeom::ReadTexture(std::string filename)
     return tex;
 }
 
-void RoadGeom::AddRoadMarkGeom(osg::ref_ptr<osg::Vec3Array> vertices, osg::ref_ptr<osg::DrawElementsUInt> indices, roadmanager::RoadMarkColor color)
+void RoadGeom::AddRoadMarkGeom(osg::ref_ptr<osg::Vec3Array>        vertices,
+                               osg::ref_ptr<osg::DrawElementsUInt> indices,
+                               roadmanager::RoadMarkColor          color,
+                               osg::Group*                         group)
 {
     osg::ref_ptr<osg::Material>  materialRoadmark_ = new osg::Material;
     osg::ref_ptr<osg::Vec4Array> color_array       = new osg::Vec4Array;
@@ -107,12 +123,11 @@ void RoadGeom::AddRoadMarkGeom(osg::ref_ptr<osg::Vec3Array> vertices, osg::ref_p
     osg::ref_ptr<osg::Geode> geode = new osg::Geode;
     geode->addDrawable(geom);
     geode->getOrCreateStateSet()->setAttributeAndModes(materialRoadmark_.get());
-    rm_group_->addChild(geode);
+    group->addChild(geode);
 }
 
 int RoadGeom::AddRoadMarks(roadmanager::Lane* lane, osg::Group* parent)
 {
-    (void)parent;
     for (size_t i = 0; i < static_cast<unsigned int>(lane->GetNumberOfRoadMarks()); i++)
     {
         roadmanager::LaneRoadMark* lane_roadmark = lane->GetLaneRoadMarkByIdx(static_cast<int>(i));
@@ -179,10 +194,10 @@ int RoadGeom::AddRoadMarks(roadmanager::Lane* lane, osg::Group* parent)
                 {
                     for (unsigned int q = 0; q < curr_osi_rm->GetPoints().size(); q++)
                     {
-                        const double                    botts_dot_size = 0.15;
-                        static osg::ref_ptr<osg::Geode> dot            = 0;
+                        const double botts_dot_size = 0.15;
 
-                        if (dot == 0)
+                        // Shared dot model, created once (thread safe since tiles might be generated in parallel)
+                        static osg::ref_ptr<osg::Geode> dot = [&]()
                         {
                             osg::ref_ptr<osg::TessellationHints> th = new osg::TessellationHints();
                             th->setDetailRatio(0.3f);
@@ -192,9 +207,10 @@ int RoadGeom::AddRoadMarks(roadmanager::Lane* lane, osg::Group* parent)
                                                                          0.3f * static_cast<float>(botts_dot_size)),
                                                        th);
                             shape->setColor(viewer::ODR2OSGColor(lane_roadmark->GetColor()));
-                            dot = new osg::Geode;
-                            dot->addDrawable(shape);
-                        }
+                            osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+                            geode->addDrawable(shape);
+                            return geode;
+                        }();
 
                         roadmanager::PointStruct osi_point0 = curr_osi_rm->GetPoint(static_cast<int>(q));
 
@@ -202,7 +218,7 @@ int RoadGeom::AddRoadMarks(roadmanager::Lane* lane, osg::Group* parent)
                         tx->setPosition(
                             osg::Vec3(static_cast<float>(osi_point0.x), static_cast<float>(osi_point0.y), static_cast<float>(osi_point0.z)));
                         tx->addChild(dot);
-                        rm_group_->addChild(tx);
+                        parent->addChild(tx);
                     }
                 }
                 else if (lane_roadmark->GetType() == roadmanager::LaneRoadMark::RoadMarkType::BROKEN ||
@@ -252,7 +268,7 @@ int RoadGeom::AddRoadMarks(roadmanager::Lane* lane, osg::Group* parent)
                         (*indices)[3] = 3;
 
                         // Finally create and add OSG geometries
-                        AddRoadMarkGeom(vertices, indices, lane_roadmarktypeline->GetColor());
+                        AddRoadMarkGeom(vertices, indices, lane_roadmarktypeline->GetColor(), parent);
                     }
                 }
                 else if (lane_roadmark->GetType() == roadmanager::LaneRoadMark::RoadMarkType::SOLID ||
@@ -395,7 +411,7 @@ int RoadGeom::AddRoadMarks(roadmanager::Lane* lane, osg::Group* parent)
                     }
 
                     // Finally create and add OSG geometries
-                    AddRoadMarkGeom(vertices, indices, lane_roadmarktypeline->GetColor());
+                    AddRoadMarkGeom(vertices, indices, lane_roadmarktypeline->GetColor(), parent);
                 }
             }
         }
@@ -537,7 +553,7 @@ int RoadGeom::AddRoadMarks(roadmanager::Lane* lane, osg::Group* parent)
                 }
 
                 // Finally create and add OSG geometries
-                AddRoadMarkGeom(vertices, indices, lane_roadmark->GetColor());
+                AddRoadMarkGeom(vertices, indices, lane_roadmark->GetColor(), parent);
             }
         }
     }
@@ -545,41 +561,118 @@ int RoadGeom::AddRoadMarks(roadmanager::Lane* lane, osg::Group* parent)
     return 0;
 }
 
-RoadGeom::RoadGeom(roadmanager::OpenDrive* odr)
+// Database pager callback, generating road tiles on request instead of reading files
+class RoadTileReader : public osgDB::ReadFileCallback
+{
+public:
+    RoadTileReader(RoadGeom* road_geom) : road_geom_(road_geom)
+    {
+    }
+
+    osgDB::ReaderWriter::ReadResult readNode(const std::string& filename, const osgDB::Options* options) override
+    {
+        if (FileNameExtOf(filename) != ROAD_TILE_EXT)
+        {
+            return osgDB::ReadFileCallback::readNode(filename, options);
+        }
+
+        // shared lock, allowing multiple pager threads to generate tiles in parallel
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (road_geom_ == nullptr)
+        {
+            return osgDB::ReaderWriter::ReadResult::FILE_NOT_HANDLED;
+        }
+
+        osg::ref_ptr<osg::Node> node;
+        try
+        {
+            node = road_geom_->CreateTile(static_cast<unsigned int>(strtoi(FileNameWithoutExtOf(filename))));
+        }
+        catch (std::exception& e)
+        {
+            LOG("Failed to generate road tile %s: %s", filename.c_str(), e.what());
+        }
+
+        if (node == nullptr)
+        {
+            return osgDB::ReaderWriter::ReadResult::ERROR_IN_READING_FILE;
+        }
+
+        return node.release();
+    }
+
+    void Detach()
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        road_geom_ = nullptr;
+    }
+
+private:
+    RoadGeom*         road_geom_;
+    std::shared_mutex mutex_;
+};
+
+RoadGeom::RoadGeom(roadmanager::OpenDrive* odr, double tile_size, std::string tile_cache_dir)
 {
     root_     = new osg::Group;
     rm_group_ = new osg::Group;
 
     root_->addChild(rm_group_);
 
-    osg::ref_ptr<osg::Texture2D> tex_asphalt = ReadTexture("asphalt.jpg");
-    osg::ref_ptr<osg::Texture2D> tex_grass   = ReadTexture("grass.jpg");
-
-    osg::ref_ptr<osg::Vec4Array> color_asphalt      = new osg::Vec4Array;
-    osg::ref_ptr<osg::Vec4Array> color_concrete     = new osg::Vec4Array;
-    osg::ref_ptr<osg::Vec4Array> color_border_inner = new osg::Vec4Array;
-    osg::ref_ptr<osg::Vec4Array> color_grass        = new osg::Vec4Array;
+    tex_asphalt_ = ReadTexture("asphalt.jpg");
+    tex_grass_   = ReadTexture("grass.jpg");
 
-    if (tex_asphalt)
+    if (tex_asphalt_)
     {
-        color_asphalt->push_back(osg::Vec4(1.f, 1.f, 1.f, 1.0f));
+        color_asphalt_ = osg::Vec4(1.f, 1.f, 1.f, 1.0f);
     }
     else
     {
-        color_asphalt->push_back(osg::Vec4(0.3f, 0.3f, 0.3f, 1.0f));
+        color_asphalt_ = osg::Vec4(0.3f, 0.3f, 0.3f, 1.0f);
     }
 
-    if (tex_grass)
+    if (tex_grass_)
     {
-        color_grass->push_back(osg::Vec4(1.f, 1.f, 1.f, 1.0f));
+        color_grass_ = osg::Vec4(1.f, 1.f, 1.f, 1.0f);
     }
     else
     {
-        color_grass->push_back(osg::Vec4(0.25f, 0.5f, 0.35f, 1.0f));
+        color_grass_ = osg::Vec4(0.25f, 0.5f, 0.35f, 1.0f);
     }
 
-    color_concrete->push_back(osg::Vec4(0.61f, 0.61f, 0.61f, 1.0f));
-    color_border_inner->push_back(osg::Vec4(0.45f, 0.45f, 0.45f, 1.0f));
+    color_concrete_     = osg::Vec4(0.61f, 0.61f, 0.61f, 1.0f);
+    color_border_inner_ = osg::Vec4(0.45f, 0.45f, 0.45f, 1.0f);
+
+    if (tile_size > SMALL_NUMBER)
+    {
+        if (!tile_cache_dir.empty())
+        {
+            unsigned long long hash = FileContentHash(odr->GetOpenDriveFilename().c_str());
+            if (hash != 0)
+            {
+                // cached tiles depend on road network, tile layout and how the geometry is generated
+                char key_str[64];
+                snprintf(key_str, sizeof(key_str), "road_tile_v%d_%016llx_%.2f_", TILE_CACHE_VERSION, hash, tile_size);
+                tile_cache_prefix_ = CombineDirectoryPathAndFilepath(tile_cache_dir, key_str);
+
+                // keep texture images for writing, reference them by filename in cached tiles
+                for (osg::Texture2D* tex : {tex_asphalt_.get(), tex_grass_.get()})
+                {
+                    if (tex != nullptr)
+                    {
+                        tex->setUnRefImageDataAfterApply(false);
+                    }
+                }
+            }
+            else
+            {
+                LOG("Failed to read %s for hashing, road tile cache disabled", odr->GetOpenDriveFilename().c_str());
+            }
+        }
+
+        CreateTiles(odr, tile_size);
+        return;
+    }
 
     for (size_t i = 0; i < static_cast<unsigned int>(odr->GetNumOfRoads()); i++)
     {
@@ -594,435 +687,570 @@ RoadGeom::RoadGeom(roadmanager::OpenDrive* odr)
                 continue;
             }
 
-            // First make sure there are OSI points of the center lane
-            roadmanager::Lane* lane = lsec->GetLaneById(0);
-            if (lane->GetOSIPoints() == 0)
-            {
-                LOG("Missing OSI points of centerlane road %d section %d", road->GetId(), j);
-                throw std::runtime_error("Missing OSI points");
-            }
+            CreateLaneSectionGeom(road, lsec, root_, rm_group_);
+        }
+    }
+}
 
-            // create a 2d list of positions for vertices, nr_of_s-values x nr_of_lanes
-            typedef struct
-            {
-                double x;
-                double y;
-                double z;
-                double h;
-                double slope;
-                double s;
-            } GeomPoint;
-
-            typedef struct
-            {
-                int    geom_point_index;
-                double friction;
-            } GeomStrip;  // could be multiple of these per lane
+RoadGeom::~RoadGeom()
+{
+    if (tile_options_ != nullptr)
+    {
+        // pending tile requests of the database pager must not refer to this object anymore
+        static_cast<RoadTileReader*>(tile_options_->getReadFileCallback())->Detach();
+    }
+}
 
-            struct GeomCacheEntry
-            {
-                GeomPoint point;
-                int       osi_point_index = 0;
-                double    friction        = 1.0;
-            };
+void RoadGeom::CreateLaneSectionGeom(roadmanager::Road* road, roadmanager::LaneSection* lsec, osg::Group* group, osg::Group* rm_group)
+{
+    // First make sure there are OSI points of the center lane
+    roadmanager::Lane* lane = lsec->GetLaneById(0);
+    if (lane->GetOSIPoints() == 0)
+    {
+        LOG("Missing OSI points of centerlane road %d section at s %.2f", road->GetId(), lsec->GetS());
+        throw std::runtime_error("Missing OSI points");
+    }
 
-            std::vector<std::vector<GeomPoint>> geom_points_list;  // one list of points per lane
-            std::vector<std::vector<GeomStrip>> geom_strips_list;  // one list of strips info per lane
-            std::vector<GeomCacheEntry>         geom_cache;        // one cache entry per lane
+    // create a 2d list of positions for vertices, nr_of_s-values x nr_of_lanes
+    typedef struct
+    {
+        double x;
+        double y;
+        double z;
+        double h;
+        double slope;
+        double s;
+    } GeomPoint;
+
+    typedef struct
+    {
+        int    geom_point_index;
+        double friction;
+    } GeomStrip;  // could be multiple of these per lane
 
-            roadmanager::Position pos;  // used for calculating points along the road
+    struct GeomCacheEntry
+    {
+        GeomPoint point;
+        int       osi_point_index = 0;
+        double    friction        = 1.0;
+    };
+
+    std::vector<std::vector<GeomPoint>> geom_points_list;  // one list of points per lane
+    std::vector<std::vector<GeomStrip>> geom_strips_list;  // one list of strips info per lane
+    std::vector<GeomCacheEntry>         geom_cache;        // one cache entry per lane
+
+    roadmanager::Position pos;  // used for calculating points along the road
+
+    // First populate s values of the material elements
+    //   - for each material a new friction segment is to be added
+    //   - loop over material friction segments, insert new vertices if needed
+    std::vector<double> friction_s_list;
+    for (size_t k = 0; k < static_cast<unsigned int>(lsec->GetNumberOfLanes()); k++)
+    {
+        lane = lsec->GetLaneByIdx(k);
+        for (size_t l = 0; l < lane->GetNumberOfMaterials(); l++)
+        {
+            friction_s_list.push_back(lsec->GetS() + lane->GetMaterialByIdx(l)->s_offset);
+        }
+    }
 
-            // First populate s values of the material elements
-            //   - for each material a new friction segment is to be added
-            //   - loop over material friction segments, insert new vertices if needed
-            std::vector<double> friction_s_list;
-            for (size_t k = 0; k < static_cast<unsigned int>(lsec->GetNumberOfLanes()); k++)
-            {
-                lane = lsec->GetLaneByIdx(k);
-                for (size_t l = 0; l < lane->GetNumberOfMaterials(); l++)
-                {
-                    friction_s_list.push_back(lsec->GetS() + lane->GetMaterialByIdx(l)->s_offset);
-                }
-            }
+    // sort friction s-values and remove duplicates
+    std::sort(friction_s_list.begin(), friction_s_list.end());
+    friction_s_list.erase(std::unique(friction_s_list.begin(), friction_s_list.end(), compare_s_values), friction_s_list.end());
 
-            // sort friction s-values and remove duplicates
-            std::sort(friction_s_list.begin(), friction_s_list.end());
-            friction_s_list.erase(std::unique(friction_s_list.begin(), friction_s_list.end(), compare_s_values), friction_s_list.end());
+    // collect a list of s values where vertices are needed, considering all lanes
+    int  friction_s_list_index = friction_s_list.size() > 0 ? 1 : -1;
+    bool done_section          = false;
+    for (int counter = 1; !done_section && counter > 0; counter++)
+    {
+        double s_min = lsec->GetS() + lsec->GetLength();
+        done_section = true;
 
-            // collect a list of s values where vertices are needed, considering all lanes
-            int  friction_s_list_index = friction_s_list.size() > 0 ? 1 : -1;
-            bool done_section          = false;
-            for (int counter = 1; !done_section && counter > 0; counter++)
+        if (counter == 1)
+        {
+            // First add s = start of lane section, to set start of mesh
+            s_min        = lsec->GetS();
+            done_section = false;
+        }
+        else
+        {
+            // find next s-value based on accumulated error of each lane
+            for (size_t k = 0; k < static_cast<unsigned int>(lsec->GetNumberOfLanes()); k++)
             {
-                double s_min = lsec->GetS() + lsec->GetLength();
-                done_section = true;
-
-                if (counter == 1)
-                {
-                    // First add s = start of lane section, to set start of mesh
-                    s_min        = lsec->GetS();
-                    done_section = false;
-                }
-                else
+                lane                                                      = lsec->GetLaneByIdx(static_cast<int>(k));
+                const std::vector<roadmanager::PointStruct>& osiPoints    = lane->GetOSIPoints()->GetPoints();
+                unsigned int                                 l            = geom_cache[k].osi_point_index;
+                double                                       next_s       = s_min;
+                bool                                         insert_point = false;
+
+                // Find next s-value for this lane - go forward until error becomes too large
+                for (; l < osiPoints.size(); l++)
                 {
-                    // find next s-value based on accumulated error of each lane
-                    for (size_t k = 0; k < static_cast<unsigned int>(lsec->GetNumberOfLanes()); k++)
+                    // generate point at next OSI point s-value
+                    pos.SetTrackPos(road->GetId(),
+                                    osiPoints[l].s,
+                                    SIGN(lane->GetId()) * lsec->GetOuterOffset(osiPoints[l].s, lane->GetId()),
+                                    true);
+
+                    // calculate horizontal error at this s value
+                    double error_horizontal = DistanceFromPointToLine2DWithAngle(pos.GetX(),
+                                                                                 pos.GetY(),
+                                                                                 geom_cache[k].point.x,
+                                                                                 geom_cache[k].point.y,
+                                                                                 geom_cache[k].point.h);
+
+                    // calculate vertical error at this s value
+                    double error_vertical =
+                        abs((pos.GetZ() - geom_cache[k].point.z) - geom_cache[k].point.slope * (pos.GetS() - geom_cache[k].point.s));
+
+                    if (NEAR_NUMBERS(next_s, osiPoints[l - 1].s) && (error_horizontal > MAX_GEOM_ERROR || error_vertical > MAX_GEOM_ERROR))
                     {
-                        lane                                               = lsec->GetLaneByIdx(static_cast<int>(k));
-                        std::vector<roadmanager::PointStruct> osiPoints    = lane->GetOSIPoints()->GetPoints();
-                        unsigned int                          l            = geom_cache[k].osi_point_index;
-                        double                                next_s       = s_min;
-                        bool                                  insert_point = false;
-
-                        // Find next s-value for this lane - go forward until error becomes too large
-                        for (; l < osiPoints.size(); l++)
+                        // the tested OSI point cause too large error, pick the previous one
+                        if (l > 0)
                         {
-                            // generate point at next OSI point s-value
-                            pos.SetTrackPos(road->GetId(),
-                                            osiPoints[l].s,
-                                            SIGN(lane->GetId()) * lsec->GetOuterOffset(osiPoints[l].s, lane->GetId()),
-                                            true);
-
-                            // calculate horizontal error at this s value
-                            double error_horizontal = DistanceFromPointToLine2DWithAngle(pos.GetX(),
-                                                                                         pos.GetY(),
-                                                                                         geom_cache[k].point.x,
-                                                                                         geom_cache[k].point.y,
-                                                                                         geom_cache[k].point.h);
-
-                            // calculate vertical error at this s value
-                            double error_vertical =
-                                abs((pos.GetZ() - geom_cache[k].point.z) - geom_cache[k].point.slope * (pos.GetS() - geom_cache[k].point.s));
-
-                            if (NEAR_NUMBERS(next_s, osiPoints[l - 1].s) && (error_horizontal > MAX_GEOM_ERROR || error_vertical > MAX_GEOM_ERROR))
+                            if (static_cast<int>(l) - 1 > geom_cache[k].osi_point_index)
                             {
-                                // the tested OSI point cause too large error, pick the previous one
-                                if (l > 0)
-                                {
-                                    if (static_cast<int>(l) - 1 > geom_cache[k].osi_point_index)
-                                    {
-                                        // make sure previous s-value before error exceeded threshold is included
-                                        l--;
-                                        next_s = osiPoints[l].s;
-                                    }
-                                    else
-                                    {
-                                        // avoid adding same value, accept adding s-value exceeding the threshold
-                                        next_s = osiPoints[l].s;
-                                    }
-                                }
-                                else
-                                {
-                                    LOG("Unexpected l == 0\n");
-                                    next_s = osiPoints[l].s;
-                                }
-                                insert_point = true;
+                                // make sure previous s-value before error exceeded threshold is included
+                                l--;
+                                next_s = osiPoints[l].s;
                             }
                             else
                             {
+                                // avoid adding same value, accept adding s-value exceeding the threshold
                                 next_s = osiPoints[l].s;
                             }
-
-                            // we have s-value of a OSI point, check if there is a new friction value before that
-                            // also check for maximum length
-                            double s_next_friction     = (friction_s_list_index > -1 && friction_s_list_index < friction_s_list.size())
-                                                             ? friction_s_list[friction_s_list_index]
-                                                             : lsec->GetS() + lsec->GetLength();
-                            double s_next_geom_max_len = geom_cache[k].point.s + MAX_GEOM_LENGTH;
-
-                            if (s_next_friction < next_s && s_next_friction < s_min &&
-                                s_next_friction < s_next_geom_max_len + MIN_GEOM_LENGTH)  // add min geom len to avoid mini patches
-                            {
-                                next_s = s_next_friction;
-                                friction_s_list_index++;
-                                insert_point = true;
-                            }
-                            else if (s_next_geom_max_len < next_s && s_next_geom_max_len < s_min &&
-                                     s_next_geom_max_len + MIN_GEOM_LENGTH < s_next_friction)  // add min geom len to avoid mini patches
-                            {
-                                next_s       = s_next_geom_max_len;
-                                insert_point = true;
-                            }
-
-                            if (insert_point)
-                            {
-                                done_section = false;
-                                break;
-                            }
-
-                            if (next_s > s_min - SMALL_NUMBER)
-                            {
-                                break;  // no need to check this lane further
-                            }
                         }
-
-                        geom_cache[k].osi_point_index = l;
-
-                        if (next_s < s_min)
+                        else
                         {
-                            s_min = next_s;
+                            LOG("Unexpected l == 0\n");
+                            next_s = osiPoints[l].s;
                         }
+                        insert_point = true;
+                    }
+                    else
+                    {
+                        next_s = osiPoints[l].s;
                     }
-                }
 
-                // s-value for next point established, create vertices for each lane
-                for (size_t k = 0; k < static_cast<unsigned int>(lsec->GetNumberOfLanes()); k++)
-                {
-                    roadmanager::Lane::Material* mat            = nullptr;
-                    int                          lane_id        = lsec->GetLaneIdByIdx(static_cast<int>(k));
-                    int                          friction_index = k;
+                    // we have s-value of a OSI point, check if there is a new friction value before that
+                    // also check for maximum length
+                    double s_next_friction     = (friction_s_list_index > -1 && friction_s_list_index < friction_s_list.size())
+                                                     ? friction_s_list[friction_s_list_index]
+                                                     : lsec->GetS() + lsec->GetLength();
+                    double s_next_geom_max_len = geom_cache[k].point.s + MAX_GEOM_LENGTH;
 
-                    if (k > 0)  // skip friction for first vertex strip (leftmost outer lane boundary)
+                    if (s_next_friction < next_s && s_next_friction < s_min &&
+                        s_next_friction < s_next_geom_max_len + MIN_GEOM_LENGTH)  // add min geom len to avoid mini patches
                     {
-                        // For friction we need to work from left to right. For left lanes, it means shifting friction one lane right
-                        if (lane_id >= 0)
-                        {
-                            friction_index = k - 1;
-                        }
+                        next_s = s_next_friction;
+                        friction_s_list_index++;
+                        insert_point = true;
                     }
-                    else
+                    else if (s_next_geom_max_len < next_s && s_next_geom_max_len < s_min &&
+                             s_next_geom_max_len + MIN_GEOM_LENGTH < s_next_friction)  // add min geom len to avoid mini patches
                     {
-                        friction_index = lsec->GetLaneIdxById(0);
+                        next_s       = s_next_geom_max_len;
+                        insert_point = true;
                     }
 
-                    roadmanager::Lane* lane_for_friction;
-                    lane_for_friction = lsec->GetLaneByIdx(static_cast<int>(friction_index));
-                    mat               = lane_for_friction->GetMaterialByS(s_min - lsec->GetS());
-                    double friction   = mat != nullptr ? mat->friction : FRICTION_DEFAULT;
-
-                    // retrieve position at s-value
-                    pos.SetTrackPos(road->GetId(), s_min, SIGN(lane_id) * lsec->GetOuterOffset(s_min, lane_id), true);
-                    GeomPoint gp = {pos.GetX(), pos.GetY(), pos.GetZ(), pos.GetH(), pos.GetZRoadPrim(), pos.GetS()};
-
-                    if (counter == 1)
+                    if (insert_point)
                     {
-                        // add geometry and strip list for the lane to
-                        std::vector<GeomPoint> geom_points;
-                        geom_points_list.push_back(geom_points);
-
-                        std::vector<GeomStrip> geom_strips;
-                        geom_strips_list.push_back(geom_strips);
+                        done_section = false;
+                        break;
                     }
 
-                    if (counter == 1 || !NEAR_NUMBERS(friction, geom_cache[k].friction))
+                    if (next_s > s_min - SMALL_NUMBER)
                     {
-                        // create initial strip or strip with new friction value
-                        geom_strips_list[k].push_back({static_cast<int>(geom_points_list[k].size()), friction});
+                        break;  // no need to check this lane further
                     }
+                }
+
+                geom_cache[k].osi_point_index = l;
+
+                if (next_s < s_min)
+                {
+                    s_min = next_s;
+                }
+            }
+        }
 
-                    geom_points_list[k].push_back(gp);
+        // s-value for next point established, create vertices for each lane
+        for (size_t k = 0; k < static_cast<unsigned int>(lsec->GetNumberOfLanes()); k++)
+        {
+            roadmanager::Lane::Material* mat            = nullptr;
+            int                          lane_id        = lsec->GetLaneIdByIdx(static_cast<int>(k));
+            int                          friction_index = k;
+
+            if (k > 0)  // skip friction for first vertex strip (leftmost outer lane boundary)
+            {
+                // For friction we need to work from left to right. For left lanes, it means shifting friction one lane right
+                if (lane_id >= 0)
+                {
+                    friction_index = k - 1;
+                }
+            }
+            else
+            {
+                friction_index = lsec->GetLaneIdxById(0);
+            }
 
-                    if (geom_cache.size() <= k)
+            roadmanager::Lane* lane_for_friction;
+            lane_for_friction = lsec->GetLaneByIdx(static_cast<int>(friction_index));
+            mat               = lane_for_friction->GetMaterialByS(s_min - lsec->GetS());
+            double friction   = mat != nullptr ? mat->friction : FRICTION_DEFAULT;
+
+            // retrieve position at s-value
+            pos.SetTrackPos(road->GetId(), s_min, SIGN(lane_id) * lsec->GetOuterOffset(s_min, lane_id), true);
+            GeomPoint gp = {pos.GetX(), pos.GetY(), pos.GetZ(), pos.GetH(), pos.GetZRoadPrim(), pos.GetS()};
+
+            if (counter == 1)
+            {
+                // add geometry and strip list for the lane to
+                std::vector<GeomPoint> geom_points;
+                geom_points_list.push_back(geom_points);
+
+                std::vector<GeomStrip> geom_strips;
+                geom_strips_list.push_back(geom_strips);
+            }
+
+            if (counter == 1 || !NEAR_NUMBERS(friction, geom_cache[k].friction))
+            {
+                // create initial strip or strip with new friction value
+                geom_strips_list[k].push_back({static_cast<int>(geom_points_list[k].size()), friction});
+            }
+
+            geom_points_list[k].push_back(gp);
+
+            if (geom_cache.size() <= k)
+            {
+                geom_cache.push_back({{pos.GetX(), pos.GetY(), pos.GetZ(), pos.GetH(), pos.GetZRoadPrim(), pos.GetS()}, 1, friction});
+            }
+            else
+            {
+                geom_cache[k].point    = {pos.GetX(), pos.GetY(), pos.GetZ(), pos.GetH(), pos.GetZRoadPrim(), pos.GetS()};
+                geom_cache[k].friction = friction;
+            }
+        }
+    }
+
+    // Then create actual vertices and triangle strips for the lane section
+    // Each strip is made of two lanes, so we need to create a separate geometry for each pair of lanes
+    // Also within each lane, we need to create a separate geometry for each material segment
+    unsigned int nr_vertices =
+        static_cast<unsigned int>(geom_points_list[0].size() * geom_strips_list.size());  // same nr vertices in all lanes
+    osg::ref_ptr<osg::Vec3Array> verticesAll  = new osg::Vec3Array(nr_vertices);
+    osg::ref_ptr<osg::Vec2Array> texcoordsAll = new osg::Vec2Array(nr_vertices);
+
+    // Potential optimization: Swap loops, creating all vertices for same s-value for each step
+    int vertex_index_left_local      = 0;
+    int vertex_index_right_local     = 0;
+    int vertex_index_left_local_next = 0;
+    int vertex_idx_all               = 0;
+
+    for (size_t k = 0; k < geom_strips_list.size(); k++)  // loop over lanes
+    {
+        osg::ref_ptr<osg::Vec3Array>        verticesLocal;
+        osg::ref_ptr<osg::Vec2Array>        texcoordsLocal;
+        osg::ref_ptr<osg::Vec4Array>        colorLocal;
+        osg::ref_ptr<osg::DrawElementsUInt> indices;
+        lane                               = lsec->GetLaneByIdx(static_cast<int>(k));
+        roadmanager::Lane* laneForMaterial = nullptr;
+
+        vertex_index_left_local      = vertex_index_left_local_next;
+        vertex_index_right_local     = vertex_idx_all;
+        vertex_index_left_local_next = vertex_index_right_local;
+
+        for (size_t m = 0; m < geom_strips_list[k].size(); m++)  // loop over lane patches with constant friction
+        {
+            double                  friction    = geom_strips_list[k][m].friction;
+            unsigned int            gpi         = geom_strips_list[k][m].geom_point_index;
+            std::vector<GeomPoint>& geom_points = geom_points_list[k];
+            unsigned int            n_points    = 0;
+
+            if (m < geom_strips_list[k].size() - 1)
+            {
+                n_points = geom_strips_list[k][m + 1].geom_point_index - gpi + 1;  // +
+            }
+            else
+            {
+                n_points = geom_points.size() - gpi;
+            }
+
+            if (k > 0)
+            {
+                verticesLocal   = new osg::Vec3Array(static_cast<unsigned int>(n_points * 2));
+                indices         = new osg::DrawElementsUInt(GL_TRIANGLE_STRIP, static_cast<unsigned int>(n_points * 2));
+                texcoordsLocal  = new osg::Vec2Array(static_cast<unsigned int>(n_points * 2));
+                laneForMaterial = lsec->GetLaneByIdx(lane->GetId() < 0 ? static_cast<int>(k) : static_cast<int>(k) - 1);
+            }
+
+            int index_counter = 0;
+
+            for (size_t l = 0; l < n_points; l++)
+            {
+                GeomPoint& gp = geom_points[gpi + l];
+                if (m == 0 || l > 0)
+                {
+                    (*verticesAll)[static_cast<unsigned int>(vertex_idx_all)].set(static_cast<float>(gp.x),
+                                                                                  static_cast<float>(gp.y),
+                                                                                  static_cast<float>(gp.z));
+                    double texscale = TEXTURE_SCALE;
+                    (*texcoordsAll)[static_cast<unsigned int>(vertex_idx_all)].set(
+                        osg::Vec2(static_cast<float>(texscale * gp.x), static_cast<float>(texscale * gp.y)));
+                    vertex_idx_all++;
+                }
+                else
+                {
+                    vertex_index_right_local--;  // reuse previous vertex
+                    vertex_index_left_local--;   // reuse previous vertex
+                }
+
+                // Create indices for the lane strip, referring to the vertex list
+                if (k > 0)
+                {
+                    // vertex of left lane border
+                    (*verticesLocal)[static_cast<unsigned int>(index_counter)]  = (*verticesAll)[vertex_index_left_local];
+                    (*texcoordsLocal)[static_cast<unsigned int>(index_counter)] = (*texcoordsAll)[vertex_index_left_local];
+                    (*indices)[index_counter]                                   = static_cast<unsigned int>(index_counter);
+                    if (l < geom_points.size() - 1)
                     {
-                        geom_cache.push_back({{pos.GetX(), pos.GetY(), pos.GetZ(), pos.GetH(), pos.GetZRoadPrim(), pos.GetS()}, 1, friction});
+                        vertex_index_left_local++;
                     }
-                    else
+                    index_counter++;
+
+                    // vertex of right
+                    (*verticesLocal)[static_cast<unsigned int>(index_counter)]  = (*verticesAll)[vertex_index_right_local];
+                    (*texcoordsLocal)[static_cast<unsigned int>(index_counter)] = (*texcoordsAll)[vertex_index_right_local];
+                    (*indices)[index_counter]                                   = static_cast<unsigned int>(index_counter);
+                    if (l < geom_points.size() - 1)
                     {
-                        geom_cache[k].point    = {pos.GetX(), pos.GetY(), pos.GetZ(), pos.GetH(), pos.GetZRoadPrim(), pos.GetS()};
-                        geom_cache[k].friction = friction;
+                        vertex_index_right_local++;
                     }
+                    index_counter++;
                 }
             }
 
-            // Then create actual vertices and triangle strips for the lane section
-            // Each strip is made of two lanes, so we need to create a separate geometry for each pair of lanes
-            // Also within each lane, we need to create a separate geometry for each material segment
-            unsigned int nr_vertices =
-                static_cast<unsigned int>(geom_points_list[0].size() * geom_strips_list.size());  // same nr vertices in all lanes
-            osg::ref_ptr<osg::Vec3Array> verticesAll  = new osg::Vec3Array(nr_vertices);
-            osg::ref_ptr<osg::Vec2Array> texcoordsAll = new osg::Vec2Array(nr_vertices);
-
-            // Potential optimization: Swap loops, creating all vertices for same s-value for each step
-            int vertex_index_left_local      = 0;
-            int vertex_index_right_local     = 0;
-            int vertex_index_left_local_next = 0;
-            int vertex_idx_all               = 0;
-
-            for (size_t k = 0; k < geom_strips_list.size(); k++)  // loop over lanes
+            if (k != 0)
             {
-                osg::ref_ptr<osg::Vec3Array>        verticesLocal;
-                osg::ref_ptr<osg::Vec2Array>        texcoordsLocal;
-                osg::ref_ptr<osg::Vec4Array>        colorLocal;
-                osg::ref_ptr<osg::DrawElementsUInt> indices;
-                lane                               = lsec->GetLaneByIdx(static_cast<int>(k));
-                roadmanager::Lane* laneForMaterial = nullptr;
-
-                vertex_index_left_local      = vertex_index_left_local_next;
-                vertex_index_right_local     = vertex_idx_all;
-                vertex_index_left_local_next = vertex_index_right_local;
-
-                for (size_t m = 0; m < geom_strips_list[k].size(); m++)  // loop over lane patches with constant friction
+                // Create geometry for the strip made of this and previous lane
+                osg::ref_ptr<osg::Geometry> geom = new osg::Geometry;
+                geom->setUseDisplayList(true);
+                geom->setVertexArray(verticesLocal.get());
+                geom->addPrimitiveSet(indices.get());
+                geom->setTexCoordArray(0, texcoordsLocal.get());
+                osgUtil::SmoothingVisitor::smooth(*geom, 0.5);
+
+                osg::ref_ptr<osg::Texture2D> tex = nullptr;
+
+                if (laneForMaterial->IsType(roadmanager::Lane::LaneType::LANE_TYPE_ANY_ROAD))
                 {
-                    double                  friction    = geom_strips_list[k][m].friction;
-                    unsigned int            gpi         = geom_strips_list[k][m].geom_point_index;
-                    std::vector<GeomPoint>& geom_points = geom_points_list[k];
-                    unsigned int            n_points    = 0;
+                    osg::ref_ptr<osg::Material> materialAsphalt_ = new osg::Material;
+                    osg::Vec4                   new_color        = color_asphalt_;
 
-                    if (m < geom_strips_list[k].size() - 1)
+                    if (friction < friction_default - SMALL_NUMBER)  // low friction, make it blueish
                     {
-                        n_points = geom_strips_list[k][m + 1].geom_point_index - gpi + 1;  // +
+                        double factor = (1.0 - friction) / friction_default;
+                        new_color[0] -= 0.75 * factor;
+                        new_color[1] -= 0.75 * factor;
+                        new_color[2] += factor;
                     }
-                    else
+                    else if (friction > friction_default + SMALL_NUMBER)  // high friction, make it redish
                     {
-                        n_points = geom_points.size() - gpi;
+                        double factor = (MIN(friction, friction_max) - friction_default) / (friction_max - friction_default);
+                        new_color[0] += factor;
+                        new_color[1] -= 0.75 * factor;
+                        new_color[2] -= 0.75 * factor;
                     }
 
-                    if (k > 0)
+                    materialAsphalt_->setDiffuse(osg::Material::FRONT_AND_BACK, new_color);
+                    materialAsphalt_->setAmbient(osg::Material::FRONT_AND_BACK, new_color);
+
+                    if (tex_asphalt_)
                     {
-                        verticesLocal   = new osg::Vec3Array(static_cast<unsigned int>(n_points * 2));
-                        indices         = new osg::DrawElementsUInt(GL_TRIANGLE_STRIP, static_cast<unsigned int>(n_points * 2));
-                        texcoordsLocal  = new osg::Vec2Array(static_cast<unsigned int>(n_points * 2));
-                        laneForMaterial = lsec->GetLaneByIdx(lane->GetId() < 0 ? static_cast<int>(k) : static_cast<int>(k) - 1);
+                        tex = tex_asphalt_.get();
                     }
+                    geom->getOrCreateStateSet()->setAttributeAndModes(materialAsphalt_.get());
+                }
+                else if (laneForMaterial->IsType(roadmanager::Lane::LaneType::LANE_TYPE_BIKING) ||
+                         laneForMaterial->IsType(roadmanager::Lane::LaneType::LANE_TYPE_SIDEWALK))
+                {
+                    osg::ref_ptr<osg::Material> materialConcrete_ = new osg::Material;
+                    materialConcrete_->setDiffuse(osg::Material::FRONT_AND_BACK, color_concrete_);
+                    materialConcrete_->setAmbient(osg::Material::FRONT_AND_BACK, color_concrete_);
 
-                    int index_counter = 0;
+                    geom->getOrCreateStateSet()->setAttributeAndModes(materialConcrete_.get());
 
-                    for (size_t l = 0; l < n_points; l++)
-                    {
-                        GeomPoint& gp = geom_points[gpi + l];
-                        if (m == 0 || l > 0)
-                        {
-                            (*verticesAll)[static_cast<unsigned int>(vertex_idx_all)].set(static_cast<float>(gp.x),
-                                                                                          static_cast<float>(gp.y),
-                                                                                          static_cast<float>(gp.z));
-                            double texscale = TEXTURE_SCALE;
-                            (*texcoordsAll)[static_cast<unsigned int>(vertex_idx_all)].set(
-                                osg::Vec2(static_cast<float>(texscale * gp.x), static_cast<float>(texscale * gp.y)));
-                            vertex_idx_all++;
-                        }
-                        else
-                        {
-                            vertex_index_right_local--;  // reuse previous vertex
-                            vertex_index_left_local--;   // reuse previous vertex
-                        }
+                    // Use PolygonOffset feature to avoid z-fighting with road surface
+                    geom->getOrCreateStateSet()->setAttributeAndModes(
+                        new osg::PolygonOffset(-POLYGON_OFFSET_SIDEWALK, -SIGN(POLYGON_OFFSET_SIDEWALK)));
+                }
+                else if (laneForMaterial->IsType(roadmanager::Lane::LaneType::LANE_TYPE_BORDER) && k != 1 &&
+                         k != static_cast<unsigned int>(lsec->GetNumberOfLanes()) - 1)
+                {
+                    osg::ref_ptr<osg::Material> materialBorderInner_ = new osg::Material;
+                    materialBorderInner_->setDiffuse(osg::Material::FRONT_AND_BACK, color_border_inner_);
+                    materialBorderInner_->setAmbient(osg::Material::FRONT_AND_BACK, color_border_inner_);
 
-                        // Create indices for the lane strip, referring to the vertex list
-                        if (k > 0)
-                        {
-                            // vertex of left lane border
-                            (*verticesLocal)[static_cast<unsigned int>(index_counter)]  = (*verticesAll)[vertex_index_left_local];
-                            (*texcoordsLocal)[static_cast<unsigned int>(index_counter)] = (*texcoordsAll)[vertex_index_left_local];
-                            (*indices)[index_counter]                                   = static_cast<unsigned int>(index_counter);
-                            if (l < geom_points.size() - 1)
-                            {
-                                vertex_index_left_local++;
-                            }
-                            index_counter++;
+                    geom->getOrCreateStateSet()->setAttributeAndModes(materialBorderInner_.get());
 
-                            // vertex of right
-                            (*verticesLocal)[static_cast<unsigned int>(index_counter)]  = (*verticesAll)[vertex_index_right_local];
-                            (*texcoordsLocal)[static_cast<unsigned int>(index_counter)] = (*texcoordsAll)[vertex_index_right_local];
-                            (*indices)[index_counter]                                   = static_cast<unsigned int>(index_counter);
-                            if (l < geom_points.size() - 1)
-                            {
-                                vertex_index_right_local++;
-                            }
-                            index_counter++;
-                        }
-                    }
+                    // Use PolygonOffset feature to avoid z-fighting with road surface
+                    geom->getOrCreateStateSet()->setAttributeAndModes(
+                        new osg::PolygonOffset(-POLYGON_OFFSET_BORDER, -SIGN(POLYGON_OFFSET_BORDER)));
+                }
+                else
+                {
+                    osg::ref_ptr<osg::Material> materialGrass_ = new osg::Material;
 
-                    if (k != 0)
+                    materialGrass_->setDiffuse(osg::Material::FRONT_AND_BACK, color_grass_);
+                    materialGrass_->setAmbient(osg::Material::FRONT_AND_BACK, color_grass_);
+
+                    if (tex_grass_)
                     {
-                        // Create geometry for the strip made of this and previous lane
-                        osg::ref_ptr<osg::Geometry> geom = new osg::Geometry;
-                        geom->setUseDisplayList(true);
-                        geom->setVertexArray(verticesLocal.get());
-                        geom->addPrimitiveSet(indices.get());
-                        geom->setTexCoordArray(0, texcoordsLocal.get());
-                        osgUtil::SmoothingVisitor::smooth(*geom, 0.5);
+                        tex = tex_grass_.get();
+                    }
+                    geom->getOrCreateStateSet()->setAttributeAndModes(materialGrass_.get());
 
-                        osg::ref_ptr<osg::Texture2D> tex = nullptr;
+                    // Use PolygonOffset feature to avoid z-fighting with road surface
+                    geom->getOrCreateStateSet()->setAttributeAndModes(
+                        new osg::PolygonOffset(-POLYGON_OFFSET_GRASS, -SIGN(POLYGON_OFFSET_GRASS)));
+                }
+                geom->setColorBinding(osg::Geometry::BIND_OVERALL);
 
-                        if (laneForMaterial->IsType(roadmanager::Lane::LaneType::LANE_TYPE_ANY_ROAD))
-                        {
-                            osg::ref_ptr<osg::Material> materialAsphalt_ = new osg::Material;
-                            osg::Vec4                   new_color        = color_asphalt->at(0);
+                if (tex != nullptr)
+                {
+                    geom->getOrCreateStateSet()->setTextureAttributeAndModes(0, tex.get());
+                }
 
-                            if (friction < friction_default - SMALL_NUMBER)  // low friction, make it blueish
-                            {
-                                double factor = (1.0 - friction) / friction_default;
-                                new_color[0] -= 0.75 * factor;
-                                new_color[1] -= 0.75 * factor;
-                                new_color[2] += factor;
-                            }
-                            else if (friction > friction_default + SMALL_NUMBER)  // high friction, make it redish
-                            {
-                                double factor = (MIN(friction, friction_max) - friction_default) / (friction_max - friction_default);
-                                new_color[0] += factor;
-                                new_color[1] -= 0.75 * factor;
-                                new_color[2] -= 0.75 * factor;
-                            }
+                osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+                geode->addDrawable(geom.get());
 
-                            materialAsphalt_->setDiffuse(osg::Material::FRONT_AND_BACK, new_color);
-                            materialAsphalt_->setAmbient(osg::Material::FRONT_AND_BACK, new_color);
+                // osgUtil::Optimizer optimizer;
+                // optimizer.optimize(geode);
 
-                            if (tex_asphalt)
-                            {
-                                tex = tex_asphalt.get();
-                            }
-                            geom->getOrCreateStateSet()->setAttributeAndModes(materialAsphalt_.get());
-                        }
-                        else if (laneForMaterial->IsType(roadmanager::Lane::LaneType::LANE_TYPE_BIKING) ||
-                                 laneForMaterial->IsType(roadmanager::Lane::LaneType::LANE_TYPE_SIDEWALK))
-                        {
-                            osg::ref_ptr<osg::Material> materialConcrete_ = new osg::Material;
-                            materialConcrete_->setDiffuse(osg::Material::FRONT_AND_BACK, color_concrete->at(0));
-                            materialConcrete_->setAmbient(osg::Material::FRONT_AND_BACK, color_concrete->at(0));
+                group->addChild(geode);
+            }
+        }
+        AddRoadMarks(lane, rm_group);
+    }
+}
 
-                            geom->getOrCreateStateSet()->setAttributeAndModes(materialConcrete_.get());
+void RoadGeom::CreateTiles(roadmanager::OpenDrive* odr, double tile_size)
+{
+    std::map<std::pair<int, int>, unsigned int> tile_index;  // grid cell -> tile
 
-                            // Use PolygonOffset feature to avoid z-fighting with road surface
-                            geom->getOrCreateStateSet()->setAttributeAndModes(
-                                new osg::PolygonOffset(-POLYGON_OFFSET_SIDEWALK, -SIGN(POLYGON_OFFSET_SIDEWALK)));
-                        }
-                        else if (laneForMaterial->IsType(roadmanager::Lane::LaneType::LANE_TYPE_BORDER) && k != 1 &&
-                                 k != static_cast<unsigned int>(lsec->GetNumberOfLanes()) - 1)
-                        {
-                            osg::ref_ptr<osg::Material> materialBorderInner_ = new osg::Material;
-                            materialBorderInner_->setDiffuse(osg::Material::FRONT_AND_BACK, color_border_inner->at(0));
-                            materialBorderInner_->setAmbient(osg::Material::FRONT_AND_BACK, color_border_inner->at(0));
+    // Assign each lane section to the tile containing its center, tile extent is grown to include all its lane sections
+    for (int i = 0; i < odr->GetNumOfRoads(); i++)
+    {
+        roadmanager::Road* road = odr->GetRoadByIdx(i);
 
-                            geom->getOrCreateStateSet()->setAttributeAndModes(materialBorderInner_.get());
+        for (int j = 0; j < road->GetNumberOfLaneSections(); j++)
+        {
+            roadmanager::LaneSection* lsec = road->GetLaneSectionByIdx(j);
+            if (lsec->GetNumberOfLanes() < 2)
+            {
+                continue;
+            }
 
-                            // Use PolygonOffset feature to avoid z-fighting with road surface
-                            geom->getOrCreateStateSet()->setAttributeAndModes(
-                                new osg::PolygonOffset(-POLYGON_OFFSET_BORDER, -SIGN(POLYGON_OFFSET_BORDER)));
-                        }
-                        else
-                        {
-                            osg::ref_ptr<osg::Material> materialGrass_ = new osg::Material;
+            osg::BoundingBox bb;
+            for (int k = 0; k < lsec->GetNumberOfLanes(); k++)
+            {
+                roadmanager::Lane* lane = lsec->GetLaneByIdx(k);
+                if (lane->GetOSIPoints() == nullptr)
+                {
+                    continue;
+                }
+                for (auto& p : lane->GetOSIPoints()->GetPoints())
+                {
+                    bb.expandBy(static_cast<float>(p.x), static_cast<float>(p.y), static_cast<float>(p.z));
+                }
+            }
 
-                            materialGrass_->setDiffuse(osg::Material::FRONT_AND_BACK, color_grass->at(0));
-                            materialGrass_->setAmbient(osg::Material::FRONT_AND_BACK, color_grass->at(0));
+            if (!bb.valid())
+            {
+                continue;
+            }
 
-                            if (tex_grass)
-                            {
-                                tex = tex_grass.get();
-                            }
-                            geom->getOrCreateStateSet()->setAttributeAndModes(materialGrass_.get());
+            std::pair<int, int> cell(static_cast<int>(floor(bb.center().x() / tile_size)), static_cast<int>(floor(bb.center().y() / tile_size)));
+            if (tile_index.find(cell) == tile_index.end())
+            {
+                tile_index[cell] = static_cast<unsigned int>(tiles_.size());
+                tiles_.push_back(Tile());
+            }
 
-                            // Use PolygonOffset feature to avoid z-fighting with road surface
-                            geom->getOrCreateStateSet()->setAttributeAndModes(
-                                new osg::PolygonOffset(-POLYGON_OFFSET_GRASS, -SIGN(POLYGON_OFFSET_GRASS)));
-                        }
-                        geom->setColorBinding(osg::Geometry::BIND_OVERALL);
+            Tile& tile = tiles_[tile_index[cell]];
+            tile.sections.push_back(std::make_pair(road, lsec));
+            tile.bb.expandBy(bb);
+        }
+    }
 
-                        if (tex != nullptr)
-                        {
-                            geom->getOrCreateStateSet()->setTextureAttributeAndModes(0, tex.get());
-                        }
+    tile_options_ = new osgDB::Options;
+    tile_options_->setReadFileCallback(new RoadTileReader(this));
+
+    for (unsigned int i = 0; i < tiles_.size(); i++)
+    {
+        osg::ref_ptr<osg::PagedLOD> plod = new osg::PagedLOD;
+        plod->setDatabaseOptions(tile_options_.get());
+        plod->setCenterMode(osg::LOD::USER_DEFINED_CENTER);
+        plod->setCenter(tiles_[i].bb.center());
+        plod->setRadius(tiles_[i].bb.radius());
+        plod->setFileName(0, std::to_string(i) + ROAD_TILE_EXT);
+        plod->setRange(0, 0.0f, tiles_[i].bb.radius() + ROAD_TILE_VIEW_RANGE_FACTOR * static_cast<float>(tile_size));
+        root_->addChild(plod);
+    }
 
-                        osg::ref_ptr<osg::Geode> geode = new osg::Geode;
-                        geode->addDrawable(geom.get());
+    LOG("Road model split into %d tiles of size %.0f m, generated on demand", static_cast<int>(tiles_.size()), tile_size);
+}
 
-                        // osgUtil::Optimizer optimizer;
-                        // optimizer.optimize(geode);
+osg::ref_ptr<osg::Node> RoadGeom::CreateTile(unsigned int index)
+{
+    if (index >= tiles_.size())
+    {
+        return nullptr;
+    }
 
-                        root_->addChild(geode);
-                    }
-                }
-                AddRoadMarks(lane, root_);
+    std::string cache_filename;
+    if (!tile_cache_prefix_.empty())
+    {
+        cache_filename = tile_cache_prefix_ + std::to_string(index) + ".osgb";
+        if (FileExists(cache_filename.c_str()))
+        {
+            osg::ref_ptr<osg::Node> node = osgDB::readRefNodeFile(cache_filename);
+            if (node != nullptr)
+            {
+                return node;
             }
+            LOG("Failed to read cached road tile %s, generating it", cache_filename.c_str());
+        }
+    }
+
+    osg::ref_ptr<osg::Group> group    = new osg::Group;
+    osg::ref_ptr<osg::Group> rm_group = new osg::Group;
+    group->addChild(rm_group);
+
+    for (auto& section : tiles_[index].sections)
+    {
+        CreateLaneSectionGeom(section.first, section.second, group, rm_group);
+    }
+
+    if (!cache_filename.empty())
+    {
+        // Write to a temporary file first, so that other threads or processes never read a partially written tile.
+        // Keep the extension, it selects the OSG writer plugin.
+        char tmp_str[32];
+        snprintf(tmp_str, sizeof(tmp_str), "_%zx.tmp.osgb", std::hash<std::thread::id>()(std::this_thread::get_id()));
+        std::string tmp_filename = tile_cache_prefix_ + std::to_string(index) + tmp_str;
+
+        osg::ref_ptr<osgDB::Options> options = new osgDB::Options("WriteImageHint=UseExternal");
+        if (!osgDB::makeDirectoryForFile(tmp_filename) || !osgDB::writeNodeFile(*group, tmp_filename, options.get()))
+        {
+            LOG("Failed to write road tile cache file %s", tmp_filename.c_str());
+        }
+        else if (std::rename(tmp_filename.c_str(), cache_filename.c_str()) != 0)
+        {
+            // e.g. on Windows, where existing files are not replaced. Then the tile has already been written by someone else.
+            std::remove(tmp_filename.c_str());
         }
     }
-}
\ No newline at end of file
+
+    return group;
+}
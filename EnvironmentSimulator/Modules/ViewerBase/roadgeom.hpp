@@ -17,6 +17,7 @@
 #include <osg/Texture2D>
 #include <osg/Group>
 #include <osg/Geometry>
+#include <osgDB/Options>
 #include "RoadManager.hpp"
 
 class RoadGeom
@@ -25,10 +26,60 @@ public:
     osg::ref_ptr<osg::Group> root_;
     osg::ref_ptr<osg::Group> rm_group_;
 
-    RoadGeom(roadmanager::OpenDrive* odr);
+    /**
+     * Generate 3D model of the road network
+     * @param odr Road network
+     * @param tile_size If > 0 the model is split into square tiles of given size (m), each built on demand
+     *  by the OSG database pager threads when the camera gets near and released when out of range
+     * @param tile_cache_dir If not empty, generated tiles are stored in and reused from this directory,
+     *  keyed by a hash of the OpenDRIVE file content, the tile size and the tile format version
+     */
+    RoadGeom(roadmanager::OpenDrive* odr, double tile_size = 0.0, std::string tile_cache_dir = "");
+    ~RoadGeom();
+
     int  AddRoadMarks(roadmanager::Lane* lane, osg::Group* group);
-    void AddRoadMarkGeom(osg::ref_ptr<osg::Vec3Array> vertices, osg::ref_ptr<osg::DrawElementsUInt> indices, roadmanager::RoadMarkColor color);
+    void AddRoadMarkGeom(osg::ref_ptr<osg::Vec3Array>        vertices,
+                         osg::ref_ptr<osg::DrawElementsUInt> indices,
+                         roadmanager::RoadMarkColor          color,
+                         osg::Group*                         group);
     osg::ref_ptr<osg::Texture2D> ReadTexture(std::string filename);
+
+    /**
+     * Create road surface and road mark geometry of one lane section
+     * @param group Parent node of road surface geometry
+     * @param rm_group Parent node of road mark geometry
+     */
+    void CreateLaneSectionGeom(roadmanager::Road* road, roadmanager::LaneSection* lsec, osg::Group* group, osg::Group* rm_group);
+
+    /**
+     * Create the complete model of one tile, or read it from tile cache if available. Thread safe.
+     * @return Tile model node, nullptr if index is out of range
+     */
+    osg::ref_ptr<osg::Node> CreateTile(unsigned int index);
+
+    unsigned int GetNumberOfTiles()
+    {
+        return static_cast<unsigned int>(tiles_.size());
+    }
+
+private:
+    typedef struct
+    {
+        std::vector<std::pair<roadmanager::Road*, roadmanager::LaneSection*>> sections;
+        osg::BoundingBox                                                        bb;
+    } Tile;
+
+    std::vector<Tile>            tiles_;
+    std::string                  tile_cache_prefix_;  // cache directory and key, empty = no cache
+    osg::ref_ptr<osgDB::Options> tile_options_;       // database options referring tile requests back to this object
+    osg::ref_ptr<osg::Texture2D> tex_asphalt_;
+    osg::ref_ptr<osg::Texture2D> tex_grass_;
+    osg::Vec4                    color_asphalt_;
+    osg::Vec4                    color_concrete_;
+    osg::Vec4                    color_border_inner_;
+    osg::Vec4                    color_grass_;
+
+    void CreateTiles(roadmanager::OpenDrive* odr, double tile_size);
 };
 
 #endif  // ROADGEOM_HPP_
@@ -21,6 +21,7 @@
 #include <osg/Geode>
 #include <osg/Group>
 #include <osg/CullFace>
+#include <osg/BufferObject>
 #include <osgGA/StateSetManipulator>
 #include <osgGA/TrackballManipulator>
 #include <osgGA/KeySwitchMatrixManipulator>
@@ -172,6 +173,96 @@ protected:
     osg::ref_ptr<osg::Group> _node;
 };
 
+// Copy operator creating model instances: Group and transform nodes are copied, while
+// leaf nodes (geodes and drawables) and all state sets are shared with the original
+class InstanceCopyOp : public osg::CopyOp
+{
+public:
+    InstanceCopyOp() : osg::CopyOp(osg::CopyOp::SHALLOW_COPY)
+    {
+    }
+
+    using osg::CopyOp::operator();
+    osg::Node* operator()(const osg::Node* node) const override
+    {
+        if (node != nullptr && node->asGroup() != nullptr && node->asGeode() == nullptr)
+        {
+            return osg::clone(node, *this);
+        }
+        return const_cast<osg::Node*>(node);
+    }
+};
+
+osg::ref_ptr<osg::Node> ModelCache::Get(const std::vector<std::string>& file_name_candidates, osg::BoundingBox& bb, std::string& path)
+{
+    path.clear();
+
+    if (file_name_candidates.empty())
+    {
+        return nullptr;
+    }
+
+    std::map<std::string, std::string>::iterator resolved = resolved_.find(file_name_candidates[0]);
+    if (resolved != resolved_.end())
+    {
+        path = resolved->second;
+    }
+    else
+    {
+        for (size_t i = 0; i < file_name_candidates.size() && path.empty(); i++)
+        {
+            if (!FileExists(file_name_candidates[i].c_str()))
+            {
+                continue;
+            }
+
+            if (models_.find(file_name_candidates[i]) == models_.end())
+            {
+                Model model;
+                model.node = osgDB::readNodeFile(file_name_candidates[i]);
+                if (model.node)
+                {
+                    osg::ComputeBoundsVisitor cbv;
+                    model.node->accept(cbv);
+                    model.bb = cbv.getBoundingBox();
+                }
+                models_[file_name_candidates[i]] = model;  // store failed loads as well, to avoid retrying
+            }
+
+            if (models_[file_name_candidates[i]].node)
+            {
+                path = file_name_candidates[i];
+            }
+        }
+        resolved_[file_name_candidates[0]] = path;
+    }
+
+    if (path.empty())
+    {
+        return nullptr;
+    }
+
+    bb = models_[path].bb;
+
+    return models_[path].node;
+}
+
+osg::ref_ptr<osg::Node> ModelCache::CreateInstance(osg::Node* model)
+{
+    if (model == nullptr)
+    {
+        return nullptr;
+    }
+
+    return InstanceCopyOp()(model);
+}
+
+void ModelCache::Clear()
+{
+    resolved_.clear();
+    models_.clear();
+}
+
 osg::ref_ptr<osg::Geode> CreateDotGeometry(double size, osg::Vec4 color, int nrPoints)
 {
     nrPoints = MAX(nrPoints, 3);
@@ -1377,7 +1468,7 @@ void EntityModel::SetTransparency(double factor)
     blend_color_->setConstantColor(osg::Vec4(1.0f, 1.0f, 1.0f, 1.0f - static_cast<float>(factor)));
 }
 
-Viewer::FetchImage::FetchImage(Viewer* viewer)
+Viewer::FetchImage::FetchImage(Viewer* viewer) : flush_request_(false), pbo_index_(0), pbo_pending_(0), pbo_size_(0), pbo_frame_(-1)
 {
     image_                  = new osg::Image;
     viewer_                 = viewer;
@@ -1386,59 +1477,47 @@ Viewer::FetchImage::FetchImage(Viewer* viewer)
 
 void Viewer::FetchImage::operator()(osg::RenderInfo& renderInfo) const
 {
-    if (viewer_ != nullptr && !viewer_->GetQuitRequest() && viewer_->IsOffScreenRequested())
+    if (flush_request_ || (viewer_ != nullptr && viewer_->GetQuitRequest() && HasPixelBuffers()))
+    {
+        // Final frame, fetch any frames in flight while the graphics context is current
+        Flush(renderInfo.getState());
+        flush_request_ = false;
+    }
+    else if (viewer_ != nullptr && !viewer_->GetQuitRequest() && viewer_->IsOffScreenRequested())
     {
         osg::Camera*   camera   = renderInfo.getCurrentCamera();
         osg::Viewport* viewport = camera ? camera->getViewport() : 0;
 
         if (viewport && image_.valid())
         {
-            viewer_->imageMutex.Lock();
+            unsigned int nrOfBuffers = static_cast<unsigned int>(SE_Env::Inst().GetImageCaptureBuffers());
+            bool         complete    = true;
 
-            image_->readPixels(int(viewport->x()),
-                               int(viewport->y()),
-                               int(viewport->width()),
-                               int(viewport->height()),
-                               GL_BGR,  // only GL_RGB and GL_BGR supported for now
-                               GL_UNSIGNED_BYTE);
+            viewer_->imageMutex.Lock();
 
-            if (image_->getPixelFormat() == GL_RGB || image_->getPixelFormat() == GL_BGR)
+            if (nrOfBuffers > 1)
             {
-                viewer_->capturedImage_.width       = image_->s();
-                viewer_->capturedImage_.height      = image_->t();
-                viewer_->capturedImage_.pixelSize   = 3;
-                viewer_->capturedImage_.pixelFormat = static_cast<int>(image_->getPixelFormat());
-                viewer_->capturedImage_.data        = image_->data();
-
-                if (viewer_->GetSaveImagesToFile() != 0)
-                {
-                    static char filename[64];
-                    snprintf(filename, 64, "screen_shot_%05d.tga", viewer_->captureCounter_);
-                    SE_WriteTGA(filename,
-                                viewer_->capturedImage_.width,
-                                viewer_->capturedImage_.height,
-                                viewer_->capturedImage_.data,
-                                viewer_->capturedImage_.pixelSize,
-                                viewer_->capturedImage_.pixelFormat,
-                                true);
-                    viewer_->captureCounter_++;
-
-                    // If not continuous (-1), decrement frame counter
-                    if (viewer_->GetSaveImagesToFile() > 0)
-                    {
-                        viewer_->SaveImagesToFile(viewer_->GetSaveImagesToFile() - 1);
-                    }
-                }
+                // Issue read back of this frame, and fetch the one issued nrOfBuffers - 1 frames ago, if any
+                complete = ReadPixelsAsync(renderInfo.getState(),
+                                           int(viewport->x()),
+                                           int(viewport->y()),
+                                           int(viewport->width()),
+                                           int(viewport->height()),
+                                           nrOfBuffers);
             }
             else
             {
-                printf("Unsupported pixel format 0x%x\n", image_->getPixelFormat());
-                viewer_->capturedImage_ = {0, 0, 0, 0, 0};  // Reset image data
+                image_->readPixels(int(viewport->x()),
+                                   int(viewport->y()),
+                                   int(viewport->width()),
+                                   int(viewport->height()),
+                                   GL_BGR,  // only GL_RGB and GL_BGR supported for now
+                                   GL_UNSIGNED_BYTE);
             }
 
-            if (viewer_->imgCallback_.func != nullptr)
+            if (complete)
             {
-                viewer_->imgCallback_.func(&viewer_->capturedImage_, viewer_->imgCallback_.data);
+                ProcessImage();
             }
 
             viewer_->imageMutex.Unlock();
@@ -1454,6 +1533,153 @@ void Viewer::FetchImage::operator()(osg::RenderInfo& renderInfo) const
     viewer_->renderSemaphore.Release();  // Lower flag to indicate rendering done
 }
 
+void Viewer::FetchImage::ProcessImage() const
+{
+    if (image_->getPixelFormat() == GL_RGB || image_->getPixelFormat() == GL_BGR)
+    {
+        viewer_->capturedImage_.width       = image_->s();
+        viewer_->capturedImage_.height      = image_->t();
+        viewer_->capturedImage_.pixelSize   = 3;
+        viewer_->capturedImage_.pixelFormat = static_cast<int>(image_->getPixelFormat());
+        viewer_->capturedImage_.data        = image_->data();
+
+        if (viewer_->GetSaveImagesToFile() != 0)
+        {
+            char filename[64];
+            snprintf(filename, 64, "screen_shot_%05d.%s", viewer_->captureCounter_, SE_Env::Inst().GetImageFileFormat().c_str());
+
+            // Image data is copied, encoding and file I/O is done by writer thread not to slow down rendering
+            viewer_->imageWriter_.Write(filename,
+                                        viewer_->capturedImage_.width,
+                                        viewer_->capturedImage_.height,
+                                        viewer_->capturedImage_.data,
+                                        viewer_->capturedImage_.pixelSize,
+                                        viewer_->capturedImage_.pixelFormat,
+                                        true);
+            viewer_->captureCounter_++;
+
+            // If not continuous (-1), decrement frame counter
+            if (viewer_->GetSaveImagesToFile() > 0)
+            {
+                viewer_->SaveImagesToFile(viewer_->GetSaveImagesToFile() - 1);
+            }
+        }
+    }
+    else
+    {
+        printf("Unsupported pixel format 0x%x\n", image_->getPixelFormat());
+        viewer_->capturedImage_ = {0, 0, 0, 0, 0};  // Reset image data
+    }
+
+    if (viewer_->imgCallback_.func != nullptr)
+    {
+        viewer_->imgCallback_.func(&viewer_->capturedImage_, viewer_->imgCallback_.data);
+    }
+}
+
+bool Viewer::FetchImage::ReadPixelsAsync(osg::State* state, int x, int y, int width, int height, unsigned int nrOfBuffers) const
+{
+    osg::GLExtensions* ext  = state != nullptr ? state->get<osg::GLExtensions>() : nullptr;
+    unsigned int       size = static_cast<unsigned int>(width * height * 3);
+
+    if (ext == nullptr || !ext->isPBOSupported)
+    {
+        // No pixel buffer object support, fall back to synchronous read back
+        image_->readPixels(x, y, width, height, GL_BGR, GL_UNSIGNED_BYTE);
+        return true;
+    }
+
+    if (size != pbo_size_ || nrOfBuffers != pbo_.size())
+    {
+        // (Re)create buffer ring, e.g. first frame or changed window size. Any frames in flight are dropped.
+        if (!pbo_.empty())
+        {
+            ext->glDeleteBuffers(static_cast<GLsizei>(pbo_.size()), pbo_.data());
+        }
+        pbo_.resize(nrOfBuffers);
+        ext->glGenBuffers(static_cast<GLsizei>(pbo_.size()), pbo_.data());
+        for (size_t i = 0; i < pbo_.size(); i++)
+        {
+            ext->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, pbo_[i]);
+            ext->glBufferData(GL_PIXEL_PACK_BUFFER_ARB, size, nullptr, GL_STREAM_READ_ARB);
+        }
+        pbo_size_    = size;
+        pbo_index_   = 0;
+        pbo_pending_ = 0;
+        image_->allocateImage(width, height, 1, GL_BGR, GL_UNSIGNED_BYTE, 1);
+    }
+
+    if (viewer_->frameCounter_ != pbo_frame_ + 1)
+    {
+        // Capture has been paused, frames in flight are outdated
+        pbo_pending_ = 0;
+    }
+    pbo_frame_ = viewer_->frameCounter_;
+
+    // Start transfer of current frame into next buffer. With a bound PBO glReadPixels returns without waiting for the GPU.
+    ext->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, pbo_[pbo_index_]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(x, y, width, height, GL_BGR, GL_UNSIGNED_BYTE, nullptr);
+    pbo_index_   = (pbo_index_ + 1) % nrOfBuffers;
+    pbo_pending_ = MIN(pbo_pending_ + 1, nrOfBuffers);
+
+    bool complete = false;
+    if (pbo_pending_ == nrOfBuffers)
+    {
+        // Ring full, the oldest transfer was issued nrOfBuffers - 1 frames ago and should be done by now
+        complete = MapPixelBuffer(ext, pbo_index_);
+        pbo_pending_--;
+    }
+    ext->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+    return complete;
+}
+
+bool Viewer::FetchImage::MapPixelBuffer(osg::GLExtensions* ext, unsigned int index) const
+{
+    ext->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, pbo_[index]);
+
+    const void* src = ext->glMapBuffer(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB);
+    if (src == nullptr)
+    {
+        return false;
+    }
+
+    memcpy(image_->data(), src, pbo_size_);
+    ext->glUnmapBuffer(GL_PIXEL_PACK_BUFFER_ARB);
+    image_->dirty();
+
+    return true;
+}
+
+void Viewer::FetchImage::Flush(osg::State* state) const
+{
+    osg::GLExtensions* ext = state != nullptr ? state->get<osg::GLExtensions>() : nullptr;
+
+    if (ext == nullptr || pbo_.empty())
+    {
+        return;
+    }
+
+    viewer_->imageMutex.Lock();
+
+    // Fetch remaining frames in flight, oldest first
+    for (; pbo_pending_ > 0; pbo_pending_--)
+    {
+        unsigned int index = (pbo_index_ + static_cast<unsigned int>(pbo_.size()) - pbo_pending_) % static_cast<unsigned int>(pbo_.size());
+        if (MapPixelBuffer(ext, index))
+        {
+            ProcessImage();
+        }
+    }
+    ext->glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+    ext->glDeleteBuffers(static_cast<GLsizei>(pbo_.size()), pbo_.data());
+    pbo_.clear();
+    pbo_size_ = 0;
+
+    viewer_->imageMutex.Unlock();
+}
+
 int Viewer::InitTraits(osg::ref_ptr<osg::GraphicsContext::Traits> traits,
                        int                                        x,
                        int                                        y,
@@ -1752,7 +1978,12 @@ Viewer::Viewer(roadmanager::OpenDrive* odrManager,
             // Generate a simplistic 3D model based on OpenDRIVE content
             LOG("No scenegraph 3D model loaded. Generating a simplistic one...");
 
-            roadGeom     = std::make_unique<RoadGeom>(odrManager);
+            double tile_size = 0.0;
+            if (opt && (arg_str = opt->GetOptionArg("road_tile_size")) != "")
+            {
+                tile_size = strtod(arg_str);
+            }
+            roadGeom     = std::make_unique<RoadGeom>(odrManager, tile_size, opt ? opt->GetOptionArg("road_tile_cache") : "");
             environment_ = roadGeom->root_;
             envTx_->addChild(environment_);
 
@@ -1788,7 +2019,11 @@ Viewer::Viewer(roadmanager::OpenDrive* odrManager,
         }
     }
 
-    if (roadGeom && opt && (opt->GetOptionSet("save_generated_model")))
+    if (roadGeom && roadGeom->GetNumberOfTiles() > 0 && opt && (opt->GetOptionSet("save_generated_model")))
+    {
+        LOG("Saving generated 3D model not supported in combination with road tiles, see --road_tile_cache");
+    }
+    else if (roadGeom && opt && (opt->GetOptionSet("save_generated_model")))
     {
         // If road model was generated AND user want to save it
         if (osgDB::writeNodeFile(*envTx_, "generated_road.osgb"))
@@ -1976,6 +2211,15 @@ Viewer::~Viewer()
         SE_sleep(100);  // In case viewer still not closed
     }
 
+    if (osgViewer_->getDatabasePager() != nullptr)
+    {
+        osgViewer_->getDatabasePager()->cancel();  // stop any ongoing road tile generation
+    }
+
+    // Frames in flight have been fetched by FlushImageCapture(), any remaining pixel buffers are released with the
+    // graphics context. Just wait for queued images to be written.
+    imageWriter_.Flush();
+
     for (size_t i = 0; i < entities_.size(); i++)
     {
         delete (entities_[i]);
@@ -2152,19 +2396,8 @@ EntityModel* Viewer::CreateEntityModel(std::string             modelFilepath,
     double                   carStdDim[]  = {4.5, 1.8, 1.5};
     double                   carStdOrig[] = {1.5, 0.0, 0.75};
 
-    // Check if model already loaded
-    for (size_t i = 0; i < entities_.size(); i++)
-    {
-        if (entities_[i]->filename_ == modelFilepath)
-        {
-            modelgroup = dynamic_cast<osg::Group*>(entities_[i]->group_->getChild(0)->asGroup()->getChild(0)->clone(osg::CopyOp::DEEP_COPY_NODES));
-            modelBB    = entities_[i]->modelBB_;
-            break;
-        }
-    }
-
-    // First try to load 3d model
-    if (modelgroup == nullptr && !modelFilepath.empty())
+    // First try to load 3d model, already loaded models are shared via the model cache
+    if (!modelFilepath.empty())
     {
         file_name_candidates.push_back(modelFilepath);
 
@@ -2176,16 +2409,7 @@ EntityModel* Viewer::CreateEntityModel(std::string             modelFilepath,
             file_name_candidates.push_back(CombineDirectoryPathAndFilepath(SE_Env::Inst().GetPaths()[i], "/../resources/models/" + modelFilepath));
             file_name_candidates.push_back(CombineDirectoryPathAndFilepath(SE_Env::Inst().GetPaths()[i], FileNameOf(modelFilepath)));
         }
-        for (size_t i = 0; i < file_name_candidates.size(); i++)
-        {
-            if (FileExists(file_name_candidates[i].c_str()))
-            {
-                if (modelgroup = LoadEntityModel(file_name_candidates[i].c_str(), modelBB))
-                {
-                    break;
-                }
-            }
-        }
+        modelgroup = LoadEntityModel(file_name_candidates, modelBB);
     }
 
     // Make sure we have a 3D model
@@ -2528,23 +2752,21 @@ void Viewer::RemoveCar(std::string name)
     }
 }
 
-osg::ref_ptr<osg::Group> Viewer::LoadEntityModel(const char* filename, osg::BoundingBox& bb)
+osg::ref_ptr<osg::Group> Viewer::LoadEntityModel(const std::vector<std::string>& file_name_candidates, osg::BoundingBox& bb)
 {
     static int                                   elev      = 0;  // Avoid shadow node to flicker, put every second on slightly different Z
     osg::ref_ptr<osg::PositionAttitudeTransform> shadow_tx = 0;
     osg::ref_ptr<osg::Node>                      node;
     osg::ref_ptr<osg::Group>                     group = new osg::Group;
+    std::string                                  filename;
 
-    node = osgDB::readNodeFile(filename);
+    // Geometry is loaded once and shared, each entity gets its own instance nodes
+    node = ModelCache::CreateInstance(model_cache_.Get(file_name_candidates, bb, filename));
     if (!node)
     {
         return 0;
     }
 
-    osg::ComputeBoundsVisitor cbv;
-    node->accept(cbv);
-    bb = cbv.getBoundingBox();
-
     double xc, yc, dx, dy;
     dx = bb._max.x() - bb._min.x();
     dy = bb._max.y() - bb._min.y();
@@ -3023,19 +3245,15 @@ osg::ref_ptr<osg::PositionAttitudeTransform> Viewer::LoadRoadFeature(roadmanager
         file_name_candidates.push_back(CombineDirectoryPathAndFilepath(SE_Env::Inst().GetPaths()[i], "../models/" + filename));
         file_name_candidates.push_back(CombineDirectoryPathAndFilepath(SE_Env::Inst().GetPaths()[i], FileNameOf(filename)));
     }
-    for (size_t i = 0; i < file_name_candidates.size(); i++)
-    {
-        if (FileExists(file_name_candidates[i].c_str()))
-        {
-            node = osgDB::readNodeFile(file_name_candidates[i]);
-            if (!node)
-            {
-                return 0;
-            }
 
-            xform = new osg::PositionAttitudeTransform;
-            xform->addChild(node);
-        }
+    // Road features are static, so the loaded model is shared as is between all instances
+    osg::BoundingBox bb;
+    std::string      path;
+    node = model_cache_.Get(file_name_candidates, bb, path);
+    if (node)
+    {
+        xform = new osg::PositionAttitudeTransform;
+        xform->addChild(node);
     }
 
     return xform;
@@ -3896,6 +4114,20 @@ void Viewer::Frame()
     }
 }
 
+void Viewer::FlushImageCapture()
+{
+    if (!fetch_image_.valid() || !fetch_image_->HasPixelBuffers() || osgViewer_->done() ||
+        osgViewer_->getCamera()->getFinalDrawCallback() != fetch_image_)
+    {
+        return;
+    }
+
+    fetch_image_->flush_request_ = true;
+    renderSemaphore.Set();
+    osgViewer_->frame();
+    renderSemaphore.Wait();  // in case of a separate draw thread
+}
+
 bool ViewerEventHandler::handle(const osgGA::GUIEventAdapter& ea, osgGA::GUIActionAdapter&)
 {
     switch (ea.getEventType())
@@ -23,7 +23,9 @@
 #include <osgAnimation/EaseMotion>
 #include <osg/BlendColor>
 #include <osg/ShapeDrawable>
+#include <osg/GLExtensions>
 #include <string>
+#include <map>
 
 #include "RubberbandManipulator.hpp"
 #include "IdealSensor.hpp"
@@ -458,6 +460,46 @@ namespace viewer
         void*             data;
     } ImageCallback;
 
+    /**
+     * Cache of loaded 3D models, keyed by resolved file path. Each model file is read only once and its
+     * geometry, textures and state sets are shared by all entities and road objects referring to it.
+     */
+    class ModelCache
+    {
+    public:
+        /**
+         * Get model from first loadable file among given candidates. The resolved path is remembered
+         * per requested filename (first candidate), so that the file system is probed only once.
+         * @param file_name_candidates List of file paths to try, first one being the requested filename
+         * @param bb Returns model bounding box
+         * @param path Returns resolved path of model file
+         * @return Shared model node or nullptr if not found or failed to load
+         */
+        osg::ref_ptr<osg::Node> Get(const std::vector<std::string>& file_name_candidates, osg::BoundingBox& bb, std::string& path);
+
+        /**
+         * Create a lightweight instance of a shared model. Group and transform nodes are copied,
+         * e.g. for individual wheel rotation, while geodes, drawables and state sets are shared.
+         */
+        static osg::ref_ptr<osg::Node> CreateInstance(osg::Node* model);
+
+        void   Clear();
+        size_t GetNumberOfModels()
+        {
+            return models_.size();
+        }
+
+    private:
+        typedef struct
+        {
+            osg::ref_ptr<osg::Node> node;
+            osg::BoundingBox        bb;
+        } Model;
+
+        std::map<std::string, std::string> resolved_;  // requested filename -> resolved path, empty if not found
+        std::map<std::string, Model>       models_;    // key = resolved path
+    };
+
     class Viewer
     {
     public:
@@ -467,8 +509,35 @@ namespace viewer
             using osg::Camera::DrawCallback::operator();
             void                             operator()(osg::RenderInfo& renderInfo) const override;
 
+            /**
+             * Complete any frames still in flight and release pixel buffers. Requires the graphics context to be current.
+             */
+            void Flush(osg::State* state) const;
+
+            /**
+             * True while pixel buffers are allocated, i.e. frames may be in flight
+             */
+            bool HasPixelBuffers() const
+            {
+                return !pbo_.empty();
+            }
+
             mutable osg::ref_ptr<osg::Image> image_;
             viewer::Viewer*                  viewer_;
+            mutable bool                     flush_request_;  // at next draw, complete frames in flight instead of capturing
+
+        private:
+            bool ReadPixelsAsync(osg::State* state, int x, int y, int width, int height, unsigned int nrOfBuffers) const;
+            bool MapPixelBuffer(osg::GLExtensions* ext, unsigned int index) const;
+            void ProcessImage() const;
+
+            // Ring of pixel buffer objects (PBO) for asynchronous read back, so that the GPU transfer of a frame
+            // overlaps rendering of the following ones instead of stalling the render thread
+            mutable std::vector<GLuint> pbo_;
+            mutable unsigned int        pbo_index_;    // next buffer to read into
+            mutable unsigned int        pbo_pending_;  // number of frames in flight
+            mutable unsigned int        pbo_size_;     // size of each buffer (bytes)
+            mutable int                 pbo_frame_;    // frame counter at latest read back
         };
 
         int                      currentCarInFocus_;
@@ -478,6 +547,9 @@ namespace viewer
         // Vehicle position debug visualization
         osg::ref_ptr<osg::Node> shadow_node_;
 
+        // Loaded 3D models, shared between entities and road objects
+        ModelCache model_cache_;
+
         // Trail dot model
         osg::ref_ptr<osg::Node> dot_node_;
 
@@ -513,8 +585,9 @@ namespace viewer
         int                    frameCounter_;
         int                    lightCounter_;
 
-        SE_Semaphore renderSemaphore;
-        SE_Mutex     imageMutex;
+        SE_Semaphore        renderSemaphore;
+        SE_Mutex            imageMutex;
+        SE_AsyncImageWriter imageWriter_;
 
         Viewer(roadmanager::OpenDrive* odrManager,
                const char*             modelFilename,
@@ -556,7 +629,7 @@ namespace viewer
         void                     ReplaceCar(int index, EntityModel* model);
         int                      LoadShadowfile(std::string vehicleModelFilename);
         int                      AddEnvironment(const char* filename);
-        osg::ref_ptr<osg::Group> LoadEntityModel(const char* filename, osg::BoundingBox& bb);
+        osg::ref_ptr<osg::Group> LoadEntityModel(const std::vector<std::string>& file_name_candidates, osg::BoundingBox& bb);
         void                     UpdateSensor(PointSensor* sensor);
         void                     SensorSetPivotPos(PointSensor* sensor, double x, double y, double z);
         void                     SensorSetTargetPos(PointSensor* sensor, double x, double y, double z);
@@ -633,6 +706,12 @@ namespace viewer
 
         void Frame();
 
+        /**
+         * Complete any asynchronous image capture still in flight. Renders one final frame in which the pixel buffers
+         * are drained on the rendering thread. Call from the thread calling Frame(), before deleting the viewer.
+         */
+        void FlushImageCapture();
+
     private:
         bool                                         CreateRoadLines(roadmanager::OpenDrive* od);
         bool                                         CreateRoadMarkLines(roadmanager::OpenDrive* od);
@@ -1,6 +1,18 @@
 #include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 #include "CommonMini.hpp"
+#include "Profiler.hpp"
+#include "RealtimeScheduler.hpp"
+#include "SharedMemory.hpp"
 #include "esminiLib.hpp"
 
 struct Coordinate2D
@@ -157,6 +169,340 @@ TEST(MatrixOperations, TestMatrixInvert)
     EXPECT_NEAR(m3[2][2], 1.0, 1E-5);
 }
 
+TEST(FileOperations, TestAsyncFileWriter)
+{
+    // small chunks to force many handovers to the writer thread
+    SE_AsyncFileWriter writer(64, 2);
+    std::string        expected;
+
+    ASSERT_EQ(writer.Open("async_writer_test.txt"), 0);
+    EXPECT_TRUE(writer.IsOpen());
+    for (int i = 0; i < 1000; i++)
+    {
+        std::string line = "line " + std::to_string(i) + "\n";
+        writer.Write(line.c_str(), line.size());
+        expected += line;
+    }
+    writer.Close();
+    EXPECT_FALSE(writer.IsOpen());
+
+    // append mode
+    ASSERT_EQ(writer.Open("async_writer_test.txt", true), 0);
+    writer.Write("end\n", 4);
+    expected += "end\n";
+    writer.Close();
+
+    std::ifstream     file("async_writer_test.txt", std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    EXPECT_EQ(content.str(), expected);
+}
+
+TEST(FileOperations, TestImageWriters)
+{
+    // 3x2 pixels BGR image, lines stored from bottom to top
+    const int     w = 3, h = 2;
+    unsigned char bgr[w * h * 3];
+    for (int i = 0; i < w * h * 3; i++)
+    {
+        bgr[i] = static_cast<unsigned char>(i);
+    }
+
+    ASSERT_EQ(SE_WriteImage("image_writer_test.png", w, h, bgr, 3, static_cast<int>(PixelFormat::BGR), true), 0);
+    EXPECT_EQ(SE_WriteImage("image_writer_test.xyz", w, h, bgr, 3, static_cast<int>(PixelFormat::BGR), true), -4);
+
+    std::ifstream              file("image_writer_test.png", std::ios::binary);
+    std::vector<unsigned char> png((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    ASSERT_GT(png.size(), 33);
+    EXPECT_EQ(png[0], 0x89);
+    EXPECT_EQ(std::string(png.begin() + 1, png.begin() + 4), "PNG");
+    EXPECT_EQ(std::string(png.begin() + 12, png.begin() + 16), "IHDR");
+    EXPECT_EQ(png[19], w);
+    EXPECT_EQ(png[23], h);
+    EXPECT_EQ(std::string(png.begin() + 37, png.begin() + 41), "IDAT");
+
+    // IDAT: 2 bytes zlib header, 5 bytes stored block header, then first line: filter byte + RGB values of top line
+    const unsigned char* line = &png[41 + 2 + 5];
+    EXPECT_EQ(png[41 + 2], 1);  // single and final block
+    EXPECT_EQ(line[0], 0);
+    EXPECT_EQ(line[1], bgr[w * 3 + 2]);
+    EXPECT_EQ(line[2], bgr[w * 3 + 1]);
+    EXPECT_EQ(line[3], bgr[w * 3]);
+    line += 1 + w * 3;
+    EXPECT_EQ(line[0], 0);
+    EXPECT_EQ(line[1], bgr[2]);
+    EXPECT_EQ(line[3], bgr[0]);
+    EXPECT_EQ(std::string(png.end() - 8, png.end() - 4), "IEND");
+
+    // Queue a number of frames, reusing the source buffer right away
+    SE_AsyncImageWriter writer(2);
+    for (int i = 0; i < 10; i++)
+    {
+        bgr[0] = static_cast<unsigned char>(i);
+        writer.Write("image_writer_test_" + std::to_string(i) + ".tga", w, h, bgr, 3, static_cast<int>(PixelFormat::BGR), true);
+    }
+    writer.Flush();
+
+    for (int i = 0; i < 10; i++)
+    {
+        std::ifstream              tga("image_writer_test_" + std::to_string(i) + ".tga", std::ios::binary);
+        std::vector<unsigned char> content((std::istreambuf_iterator<char>(tga)), std::istreambuf_iterator<char>());
+        ASSERT_EQ(content.size(), 18 + w * h * 3);
+        EXPECT_EQ(content[18], i);
+    }
+}
+
+TEST(FileOperations, TestFileContentHash)
+{
+    EXPECT_EQ(FileContentHash("no_such_file.xodr"), 0ULL);
+
+    std::ofstream("hash_test_a.txt", std::ios::binary) << "a";
+    std::ofstream("hash_test_b.txt", std::ios::binary) << "abc";
+    std::ofstream("hash_test_c.txt", std::ios::binary) << "abc";
+
+    EXPECT_EQ(FileContentHash("hash_test_a.txt"), 0xaf63dc4c8601ec8cULL);  // FNV-1a 64 reference value for "a"
+    EXPECT_EQ(FileContentHash("hash_test_b.txt"), FileContentHash("hash_test_c.txt"));
+    EXPECT_NE(FileContentHash("hash_test_a.txt"), FileContentHash("hash_test_b.txt"));
+}
+
+TEST(FileOperations, TestMappedFile)
+{
+    SE_MappedFile file;
+    EXPECT_EQ(file.Open("no_such_file.dat"), -1);
+    EXPECT_EQ(file.Data(), nullptr);
+
+    std::ofstream("mapped_test.txt", std::ios::binary) << "0123456789";
+    ASSERT_EQ(file.Open("mapped_test.txt"), 0);
+    ASSERT_EQ(file.Size(), 10);
+    EXPECT_EQ(std::string(file.Data(), file.Size()), "0123456789");
+    file.Close();
+    EXPECT_EQ(file.Size(), 0);
+
+    std::ofstream("mapped_test_empty.txt", std::ios::binary);
+    EXPECT_EQ(file.Open("mapped_test_empty.txt"), 0);
+    EXPECT_EQ(file.Size(), 0);
+}
+
+#ifndef _WIN32
+TEST(SharedMemory, TestSendReceive)
+{
+    char               buf[SHM_RING_SLOT_SIZE + 1];
+    std::string        name = "/esmini_test_" + std::to_string(getpid());
+    SharedMemoryClient early_client(name);
+    EXPECT_EQ(early_client.GetStatus(), -1);
+    EXPECT_EQ(early_client.Send(const_cast<char*>("a"), 1), -1);  // no server yet
+
+    SharedMemoryServer server(name, 0);
+    ASSERT_EQ(server.GetStatus(), 0);
+    EXPECT_EQ(server.Receive(buf, sizeof(buf)), -1);  // nothing queued
+
+    // client created before server attaches at first send
+    EXPECT_EQ(early_client.Send(const_cast<char*>("first"), 5), 5);
+    SharedMemoryClient client(name);
+    ASSERT_EQ(client.GetStatus(), 0);
+    EXPECT_EQ(client.Send(const_cast<char*>("second"), 6), 6);
+    EXPECT_EQ(client.Send(buf, SHM_RING_SLOT_SIZE + 1), -1);  // too large
+
+    ASSERT_EQ(server.Receive(buf, sizeof(buf)), 5);
+    EXPECT_EQ(std::string(buf, 5), "first");
+    ASSERT_EQ(server.Receive(buf, 3), 3);  // truncated
+    EXPECT_EQ(std::string(buf, 3), "sec");
+    EXPECT_EQ(server.Receive(buf, sizeof(buf)), -1);
+
+    // fill up ring buffer, then one more is rejected
+    for (int i = 0; i < SHM_RING_SLOTS; i++)
+    {
+        EXPECT_EQ(client.Send(reinterpret_cast<char*>(&i), sizeof(i)), sizeof(i));
+    }
+    EXPECT_EQ(client.Send(buf, 1), -1);
+    for (int i = 0; i < SHM_RING_SLOTS; i++)
+    {
+        int value = -1;
+        ASSERT_EQ(server.Receive(reinterpret_cast<char*>(&value), sizeof(value)), sizeof(value));
+        EXPECT_EQ(value, i);
+    }
+}
+
+TEST(SharedMemory, TestBlockingReceive)
+{
+    char               buf[16];
+    std::string        name = "/esmini_test_blocking_" + std::to_string(getpid());
+    SharedMemoryServer server(name, 2000);
+    SharedMemoryClient client(name);
+    ASSERT_EQ(server.GetStatus(), 0);
+
+    // Waiting receiver is woken up by message sent from another thread
+    std::thread sender(
+        [&client]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            client.Send(const_cast<char*>("wake"), 4);
+        });
+    SE_SystemTime timer;
+    EXPECT_EQ(server.Receive(buf, sizeof(buf)), 4);
+    EXPECT_LT(timer.GetS(), 1.0);
+    sender.join();
+
+    // Timeout when no message
+    SharedMemoryServer server_short_timeout(name + "_timeout", 50);
+    timer.Reset();
+    EXPECT_EQ(server_short_timeout.Receive(buf, sizeof(buf)), -1);
+    EXPECT_GT(timer.GetS(), 0.04);
+}
+#endif
+
+TEST(RealtimeScheduler, TestPacingAndStats)
+{
+    RealtimeScheduler scheduler(0.005);
+
+    scheduler.Start();  // priority might not be permitted, which is fine
+    SE_SystemTime timer;
+    for (int i = 0; i < 20; i++)
+    {
+        scheduler.WaitForNextFrame();
+    }
+
+    // Absolute deadlines, so total time is given by the period regardless of frame execution time
+    EXPECT_NEAR(timer.GetS(), 20 * 0.005, 0.02);
+
+    RealtimeStats stats = scheduler.GetStats();
+    EXPECT_EQ(stats.n_frames, 20);
+    EXPECT_EQ(stats.n_deadline_misses, 0);
+    EXPECT_LT(stats.exec_time_max, 0.005);
+
+    // Overrun of more than two periods is counted as one miss, and the following deadline is one period ahead
+    std::this_thread::sleep_for(std::chrono::milliseconds(12));
+    scheduler.WaitForNextFrame();
+    timer.Reset();
+    scheduler.WaitForNextFrame();
+    EXPECT_NEAR(timer.GetS(), 0.005, 0.004);
+
+    stats = scheduler.GetStats();
+    EXPECT_EQ(stats.n_frames, 22);
+    EXPECT_EQ(stats.n_deadline_misses, 1);
+    EXPECT_GT(stats.exec_time_max, 0.012);
+    EXPECT_EQ(stats.exec_time_histogram[RT_HISTOGRAM_BINS - 1], 1);
+
+    int sum = 0;
+    for (int i = 0; i < RT_HISTOGRAM_BINS; i++)
+    {
+        sum += stats.exec_time_histogram[i];
+    }
+    EXPECT_EQ(sum, stats.n_frames);
+}
+
+#ifdef _USE_PROFILER
+static void ProfiledSleep(int ms)
+{
+    SE_PROFILE_SCOPE("test sleep");
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+TEST(Profiler, TestFrameStatsAndTrace)
+{
+    ProfiledSleep(1);  // not measured before profiler is enabled
+
+    Profiler::Inst().Enable("profile_test.json");
+    for (int i = 0; i < 3; i++)
+    {
+        SE_PROFILE_FRAME("test frame");
+        ProfiledSleep(i == 1 ? 6 : 2);
+        std::thread worker(ProfiledSleep, 1);  // zones are summed over threads
+        worker.join();
+    }
+    Profiler::Inst().Disable();
+    ProfiledSleep(1);  // not measured after profiler is disabled
+
+    EXPECT_EQ(Profiler::Inst().GetNumberOfFrames(), 3);
+
+    std::vector<ProfileZoneStats> stats = Profiler::Inst().GetStats();
+    ProfileZoneStats*             sleep = nullptr;
+    ProfileZoneStats*             frame = nullptr;
+    for (size_t i = 0; i < stats.size(); i++)
+    {
+        if (stats[i].name == "test sleep")
+        {
+            sleep = &stats[i];
+        }
+        else if (stats[i].name == "test frame")
+        {
+            frame = &stats[i];
+        }
+    }
+    ASSERT_NE(sleep, nullptr);
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(sleep->n_calls, 6);
+    EXPECT_EQ(frame->n_calls, 3);
+    EXPECT_GE(sleep->total_time, 0.013);
+    EXPECT_GE(sleep->max_frame_time, 0.007);
+    EXPECT_LT(sleep->max_frame_time, sleep->total_time);
+    EXPECT_GE(frame->total_time, sleep->total_time);
+
+    std::ifstream     file("profile_test.json");
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string trace = buffer.str();
+    EXPECT_NE(trace.find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(trace.find("{\"name\":\"test sleep\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("\"ph\":\"C\""), std::string::npos);
+}
+
+static void ProfiledLoop(std::atomic<bool>* running)
+{
+    while (running->load())
+    {
+        SE_PROFILE_SCOPE("test loop");
+        std::this_thread::yield();  // thread may inherit realtime priority from the scheduler test
+    }
+}
+
+TEST(Profiler, TestDisableWhileRecording)
+{
+    std::atomic<bool> running(true);
+
+    Profiler::Inst().Enable("profile_test.json");
+    std::thread worker(ProfiledLoop, &running);
+    for (int i = 0; i < 5; i++)
+    {
+        SE_PROFILE_FRAME("test frame");
+        ProfiledSleep(1);
+    }
+    Profiler::Inst().Disable();  // worker keeps recording, trace is written from a copy
+    running = false;
+    worker.join();
+
+    std::ifstream     file("profile_test.json");
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string trace = buffer.str();
+    EXPECT_NE(trace.find("{\"name\":\"test loop\",\"ph\":\"X\""), std::string::npos);
+    ASSERT_GE(trace.size(), 4);
+    EXPECT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+}
+#endif
+
+TEST(StringOperations, TestStrAppendFixed)
+{
+    std::string str;
+    char        buf[64];
+    double      values[] = {0.0, -0.0, 1.0005, 2.5e-4, -13.4567, 123456.789, 1e20, 0.1f, -7.0f / 3.0f};
+
+    for (double value : values)
+    {
+        for (int decimals : {0, 3, 6})
+        {
+            str.clear();
+            StrAppendFixed(str, value, decimals);
+            snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+            EXPECT_EQ(str, buf);
+        }
+    }
+
+    str = "id ";
+    StrAppendInt(str, -42);
+    EXPECT_EQ(str, "id -42");
+}
+
 int main(int argc, char **argv)
 {
     // testing::GTEST_FLAG(filter) = "*TestIsPointWithinSectorBetweenTwoLines*";
@@ -118,6 +118,124 @@ TEST_F(FollowRouteTestSmall, FindPathSmall1)
     ASSERT_EQ(path.back().road->GetId(), 5);
 }
 
+TEST_F(FollowRouteTestSmall, ReuseRouterAndLaneGraph)
+{
+    OpenDrive *odr = Position::GetOpenDrive();
+    ASSERT_NE(odr, nullptr);
+
+    // Graph is built once and shared
+    std::shared_ptr<LaneGraph> graph = odr->GetLaneGraph();
+    ASSERT_NE(graph, nullptr);
+    ASSERT_EQ(graph, odr->GetLaneGraph());
+    ASSERT_EQ(graph->GetNumberOfExitGroups(), static_cast<unsigned int>(6 * odr->GetNumOfRoads()));
+    ASSERT_GT(graph->GetNumberOfEdges(), 0u);
+
+    Position start(0, -1, 10, 0);
+    start.SetHeadingRelativeRoadDirection(0);
+    Position target1(5, -2, 20, 0);
+    Position target2(2, -1, 20, 0);
+
+    LaneIndependentRouter router(odr);
+    std::vector<Node>     path1 = router.CalculatePath(start, target1);
+    std::vector<Node>     path2 = router.CalculatePath(start, target2);
+
+    // Results of a reused router should not depend on previous queries
+    LaneIndependentRouter freshRouter(odr);
+    std::vector<Node>     path1Fresh = freshRouter.CalculatePath(start, target1);
+    std::vector<Node>     path2Fresh = LaneIndependentRouter(odr).CalculatePath(start, target2);
+
+    ASSERT_FALSE(path1.empty());
+    ASSERT_FALSE(path2.empty());
+    ASSERT_EQ(path1.size(), path1Fresh.size());
+    ASSERT_EQ(path2.size(), path2Fresh.size());
+    for (size_t i = 0; i < path1.size(); i++)
+    {
+        ASSERT_TRUE(path1[i] == path1Fresh[i]);
+        ASSERT_NEAR(path1[i].weight, path1Fresh[i].weight, SMALL_NUMBER);
+    }
+    for (size_t i = 0; i < path2.size(); i++)
+    {
+        ASSERT_TRUE(path2[i] == path2Fresh[i]);
+    }
+
+    // Shortest path: remaining part of start road, full length of intermediate roads and first part of target road
+    double expected = odr->GetRoadById(0)->GetLength() - start.GetS() + target1.GetS();
+    for (size_t i = 1; i < path1.size() - 1; i++)
+    {
+        expected += path1[i].road->GetLength();
+    }
+    ASSERT_NEAR(path1.back().weight, expected, 1e-3);
+}
+
+TEST_F(FollowRouteTestSmall, RouteCache)
+{
+    OpenDrive  *odr   = Position::GetOpenDrive();
+    RouteCache &cache = odr->GetLaneGraph()->GetRouteCache();
+    cache.Clear();
+
+    Position start(0, -1, 10, 0);
+    start.SetHeadingRelativeRoadDirection(0);
+    Position target1(5, -2, 20, 0);
+    Position target2(2, -1, 20, 0);
+
+    LaneIndependentRouter router1(odr);
+    std::vector<Node>     path = router1.CalculatePath(start, target1);
+    ASSERT_FALSE(path.empty());
+    ASSERT_EQ(cache.GetMisses(), 1);
+    ASSERT_EQ(cache.GetHits(), 0);
+    ASSERT_EQ(cache.GetSize(), 1);
+
+    // Another router, e.g. of another vehicle, starting further along same road and lane
+    Position start2(0, -1, 30, 0);
+    start2.SetHeadingRelativeRoadDirection(0);
+    LaneIndependentRouter router2(odr);
+    std::vector<Node>     path2 = router2.CalculatePath(start2, target1);
+    ASSERT_EQ(cache.GetMisses(), 1);
+    ASSERT_EQ(cache.GetHits(), 1);
+    ASSERT_EQ(path2.size(), path.size());
+    for (size_t i = 0; i < path.size(); i++)
+    {
+        ASSERT_TRUE(path2[i] == path[i]);
+        ASSERT_NEAR(path2[i].weight, path[i].weight - 20.0, 1e-6);  // shorter part of start road remaining
+    }
+
+    // Different route strategy is another entry
+    target1.SetRouteStrategy(Position::RouteStrategy::FASTEST);
+    ASSERT_FALSE(router2.CalculatePath(start, target1).empty());
+    ASSERT_EQ(cache.GetMisses(), 2);
+    ASSERT_EQ(cache.GetSize(), 2);
+
+    // Least recently used entry is dropped
+    cache.SetCapacity(1);
+    ASSERT_EQ(cache.GetSize(), 1);
+    target1.SetRouteStrategy(Position::RouteStrategy::SHORTEST);
+    ASSERT_FALSE(router1.CalculatePath(start, target1).empty());
+    ASSERT_EQ(cache.GetMisses(), 3);
+    ASSERT_FALSE(router1.CalculatePath(start, target2).empty());
+    ASSERT_EQ(cache.GetMisses(), 4);
+    ASSERT_FALSE(router1.CalculatePath(start, target2).empty());
+    ASSERT_EQ(cache.GetHits(), 2);
+
+    // Disabled cache
+    cache.SetCapacity(0);
+    ASSERT_EQ(cache.GetSize(), 0);
+    ASSERT_FALSE(router1.CalculatePath(start, target2).empty());
+    ASSERT_EQ(cache.GetSize(), 0);
+    ASSERT_EQ(cache.GetMisses(), 5);
+
+    // Reused road network, e.g. in scenario template mode, keeps the cached routes but starts over counting
+    cache.SetCapacity(1000);
+    ASSERT_FALSE(router1.CalculatePath(start, target2).empty());
+    ASSERT_EQ(cache.GetSize(), 1);
+    odr->ResetState();
+    ASSERT_EQ(cache.GetSize(), 1);
+    ASSERT_EQ(cache.GetMisses(), 0);
+    ASSERT_EQ(cache.GetHits(), 0);
+    ASSERT_EQ(&odr->GetLaneGraph()->GetRouteCache(), &cache);  // graph itself is kept
+    ASSERT_FALSE(router1.CalculatePath(start, target2).empty());
+    ASSERT_EQ(cache.GetHits(), 1);
+}
+
 TEST_F(FollowRouteTestSmall, FindPathSmall2)
 {
     ASSERT_NE(Position::GetOpenDrive(), nullptr);
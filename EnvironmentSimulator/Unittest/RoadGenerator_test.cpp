@@ -0,0 +1,123 @@
+#include <iostream>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstdio>
+
+#include "ScenarioEngine.hpp"
+#include "RoadGenerator.hpp"
+
+using namespace roadmanager;
+using namespace scenarioengine;
+
+TEST(RoadGeneratorTest, TestGenerateLoadAndStep)
+{
+    roadgenerator::Network network;
+    network.n_lanes    = 2;
+    network.lane_width = 3.5;
+
+    ASSERT_EQ(roadgenerator::CreateGrid(network, 3, 200.0, true), 0);
+    ASSERT_EQ(roadgenerator::WriteOpenDRIVE("roadgen_grid.xodr", network), 0);
+    ASSERT_EQ(roadgenerator::WriteOpenSCENARIO("roadgen_grid.xosc", "roadgen_grid.xodr", network, 20, 40.0, 15.0, 60.0, "", 0), 20);
+
+    // 12 roads between 9 junctions, each junction connecting every arm to all other arms
+    EXPECT_EQ(network.roads.size(), 56);
+    EXPECT_EQ(network.junctions.size(), 9);
+    EXPECT_EQ(roadgenerator::CreateGrid(network, 1, 200.0, true), -1);
+
+    ASSERT_EQ(Position::LoadOpenDrive("roadgen_grid.xodr"), true);
+    OpenDrive* odr = Position::GetOpenDrive();
+    EXPECT_EQ(odr->GetNumOfRoads(), 56);
+    EXPECT_EQ(odr->GetNumOfJunctions(), 9);
+
+    // Connecting roads end where the road they lead to begins or ends
+    for (size_t i = 0; i < network.roads.size(); i++)
+    {
+        const roadgenerator::Road& road = network.roads[i];
+        ASSERT_NE(odr->GetRoadById(road.id), nullptr);
+        EXPECT_NEAR(odr->GetRoadById(road.id)->GetLength(), road.length, 1e-3);
+
+        if (road.junction >= 0)
+        {
+            Road*    next = odr->GetRoadById(road.successor.id);
+            Position pos0(road.id, road.length, 0.0);
+            Position pos1(road.successor.id, road.successor.contact_start ? 0.0 : next->GetLength(), 0.0);
+            EXPECT_NEAR(pos0.GetX(), pos1.GetX(), 1e-2);
+            EXPECT_NEAR(pos0.GetY(), pos1.GetY(), 1e-2);
+        }
+    }
+
+    // Vehicles drive through the junctions without leaving the road network
+    ScenarioEngine* se = new ScenarioEngine("roadgen_grid.xosc");
+    ASSERT_NE(se, nullptr);
+    ASSERT_EQ(se->entities_.object_.size(), 20);
+
+    for (int i = 0; i < 500; i++)
+    {
+        se->step(0.05);
+        se->prepareGroundTruth(0.05);
+    }
+
+    for (size_t i = 0; i < se->entities_.object_.size(); i++)
+    {
+        Object* obj = se->entities_.object_[i];
+        EXPECT_GT(obj->odometer_, 300.0);
+        EXPECT_GE(obj->pos_.GetTrackId(), 0);
+        EXPECT_LT(fabs(obj->pos_.GetT()), 2 * network.n_lanes * network.lane_width);
+    }
+
+    delete se;
+    std::remove("roadgen_grid.xodr");
+    std::remove("roadgen_grid.xosc");
+}
+
+TEST(RoadGeneratorTest, TestRing)
+{
+    roadgenerator::Network network;
+    network.n_lanes    = 2;
+    network.lane_width = 3.5;
+
+    ASSERT_EQ(roadgenerator::CreateRing(network, 10, 100.0), 0);
+    ASSERT_EQ(roadgenerator::WriteOpenDRIVE("roadgen_ring.xodr", network), 0);
+    ASSERT_EQ(Position::LoadOpenDrive("roadgen_ring.xodr"), true);
+    EXPECT_EQ(Position::GetOpenDrive()->GetNumOfRoads(), 10);
+
+    // Each road continues where the previous one ends, also from the last to the first road
+    for (int i = 0; i < 10; i++)
+    {
+        Position pos0(i, -1, 100.0, 0.0);
+        Position pos1((i + 1) % 10, -1, 0.0, 0.0);
+        EXPECT_NEAR(pos0.GetX(), pos1.GetX(), 1e-3);
+        EXPECT_NEAR(pos0.GetY(), pos1.GetY(), 1e-3);
+        EXPECT_NEAR(GetAngleDifference(pos0.GetH(), pos1.GetH()), 0.0, 1e-3);
+    }
+
+    Position pos(9, -1, 95.0, 0.0);
+    EXPECT_EQ(pos.MoveAlongS(10.0), Position::ReturnCode::ENTERED_NEW_ROAD);
+    EXPECT_EQ(pos.GetTrackId(), 0);
+    EXPECT_EQ(pos.GetLaneId(), -1);
+
+    std::remove("roadgen_ring.xodr");
+}
+
+// Uncomment to print log output to console
+// #define LOG_TO_CONSOLE
+
+#ifdef LOG_TO_CONSOLE
+static void log_callback(const char* str)
+{
+    printf("%s\n", str);
+}
+#endif
+
+int main(int argc, char** argv)
+{
+#ifdef LOG_TO_CONSOLE
+    if (!(Logger::Inst().IsCallbackSet()))
+    {
+        Logger::Inst().SetCallback(log_callback);
+    }
+#endif
+
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -930,6 +930,47 @@ INSTANTIATE_TEST_SUITE_P(TestEvaluateParamPoly3DsArgumentParam,
                          testing::Values(std::make_tuple(0.0, -2.0, 0.0, M_PI + atan2(-2.0, -2.0)),
                                          std::make_tuple(10.0, 214.0, 216.0, M_PI + atan2(-2.0, -2.0))));
 
+TEST(GeometryBatchTest, TestEvaluateDSBatchEqualsEvaluateDS)
+{
+    Line       line(0.0, 1.0, 2.0, 0.3, 50.0);
+    Arc        arc_pos(0.0, 1.0, 2.0, 0.3, 50.0, 0.02);
+    Arc        arc_neg(0.0, 1.0, 2.0, 5 * M_PI, 50.0, -0.05);
+    Spiral     spiral(0.0, 1.0, 2.0, 0.3, 50.0, 0.01, 0.04);
+    Spiral     spiral_arc(0.0, 1.0, 2.0, 0.3, 50.0, 0.03, 0.03);
+    Poly3      poly3(0.0, 1.0, 2.0, 0.3, 50.0, 0.0, 0.0, 0.001, 0.0001);
+    ParamPoly3 parampoly3(0.0, 1.0, 2.0, 0.3, 50.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.1, -0.001, ParamPoly3::P_RANGE_ARC_LENGTH);
+
+    Geometry* geometries[] = {&line, &arc_pos, &arc_neg, &spiral, &spiral_arc, &poly3, &parampoly3};
+
+    // a sorted sequence followed by a few random and out of range values
+    std::vector<double> ds;
+    for (int i = 0; i < 101; i++)
+    {
+        ds.push_back(i * 0.5);
+    }
+    ds.push_back(33.3);
+    ds.push_back(0.1);
+    ds.push_back(49.99);
+    ds.push_back(-1.0);
+    ds.push_back(51.0);
+
+    std::vector<double> x(ds.size()), y(ds.size()), h(ds.size());
+
+    for (auto geom : geometries)
+    {
+        geom->EvaluateDSBatch(ds.data(), ds.size(), x.data(), y.data(), h.data());
+
+        for (size_t i = 0; i < ds.size(); i++)
+        {
+            double x_ref, y_ref, h_ref;
+            geom->EvaluateDS(ds[i], &x_ref, &y_ref, &h_ref);
+            EXPECT_NEAR(x[i], x_ref, 1e-9);
+            EXPECT_NEAR(y[i], y_ref, 1e-9);
+            EXPECT_NEAR(h[i], h_ref, 1e-9);
+        }
+    }
+}
+
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
@@ -2932,6 +2973,80 @@ TEST(LaneMaterialTest, TestLaneFriction)
     EXPECT_EQ(lane->GetMaterialByIdx(5), nullptr);
 }
 
+// Road of 2000 m with 200 geometries, 100 lane sections and 500 entries each of elevation, superelevation and lane offset
+// Profiles are piecewise linear samples of sine functions, every 4 m
+static double DenseProfileSample(double s, double amplitude, double period)
+{
+    double s0 = 4.0 * floor(s / 4.0);
+    double v0 = amplitude * sin(s0 / period);
+    double v1 = amplitude * sin((s0 + 4.0) / period);
+    return v0 + (v1 - v0) * (s - s0) / 4.0;
+}
+
+TEST(RoadLookupTest, TestDenseProfiles)
+{
+    ASSERT_EQ(roadmanager::Position::LoadOpenDrive("../../../EnvironmentSimulator/Unittest/xodr/straight_2000m_dense_profiles.xodr"), true);
+    roadmanager::OpenDrive *odr = Position::GetOpenDrive();
+    ASSERT_NE(odr, nullptr);
+
+    Road *road = odr->GetRoadById(1);
+    ASSERT_NE(road, nullptr);
+    EXPECT_EQ(road->GetNumberOfGeometries(), 200);
+    EXPECT_EQ(road->GetNumberOfLaneSections(), 100);
+    EXPECT_EQ(road->GetNumberOfElevations(), 500);
+    EXPECT_EQ(road->GetNumberOfSuperElevations(), 500);
+
+    // Jump back and forth along the road, so that both forward and backward searches are exercised
+    Position pos;
+    for (int i = 0; i < 1000; i++)
+    {
+        double s = fmod(i * 733.3 + 1.1, 1999.0);
+
+        ASSERT_EQ(pos.SetTrackPos(1, s, 0.0), Position::ReturnCode::OK);
+        EXPECT_EQ(road->GetLaneSectionIdxByS(s), static_cast<int>(s / 20.0));
+        EXPECT_EQ(road->GetLaneSectionIdxByS(s, 50), static_cast<int>(s / 20.0));
+        EXPECT_EQ(road->GetGeometryIdxByS(s, 100), static_cast<int>(s / 10.0));
+        EXPECT_NEAR(road->GetLaneOffset(s), DenseProfileSample(s, 0.5, 100.0), 1e-6);
+        EXPECT_NEAR(pos.GetZRoad(), DenseProfileSample(s, 2.0, 50.0) + tan(pos.GetRRoad()) * road->GetLaneOffset(s), 1e-6);
+        EXPECT_NEAR(pos.GetRRoad(), DenseProfileSample(s, 0.02, 80.0), 1e-6);
+    }
+
+    // Exact breakpoints belong to the section starting there
+    EXPECT_EQ(road->GetLaneSectionIdxByS(0.0), 0);
+    EXPECT_EQ(road->GetLaneSectionIdxByS(20.0), 1);
+    EXPECT_EQ(road->GetLaneSectionIdxByS(1980.0), 99);
+    EXPECT_EQ(road->GetLaneSectionIdxByS(2000.0), 99);
+    EXPECT_EQ(road->GetLaneSectionIdxByS(-1.0), 0);
+}
+
+TEST(RoadLookupTest, TestMoveAlongSDenseProfiles)
+{
+    ASSERT_EQ(roadmanager::Position::LoadOpenDrive("../../../EnvironmentSimulator/Unittest/xodr/straight_2000m_dense_profiles.xodr"), true);
+
+    Position pos;
+    Position ref;
+    ASSERT_EQ(pos.SetLanePos(1, -1, 1.0, 0.0), Position::ReturnCode::OK);
+
+    // Step all the way to the end and back, passing every geometry, lane section and profile entry.
+    // Incremental lookups should give the same result as a fresh position at the same s.
+    for (int i = 0; i < 2 * 19900; i++)
+    {
+        pos.MoveAlongS(i < 19900 ? 0.1 : -0.1);
+
+        if (i % 997 == 0)
+        {
+            ASSERT_EQ(ref.SetLanePos(1, -1, pos.GetS(), 0.0), Position::ReturnCode::OK);
+            EXPECT_NEAR(pos.GetX(), ref.GetX(), 1e-6);
+            EXPECT_NEAR(pos.GetY(), ref.GetY(), 1e-6);
+            EXPECT_NEAR(pos.GetZ(), ref.GetZ(), 1e-6);
+            EXPECT_NEAR(pos.GetR(), ref.GetR(), 1e-6);
+        }
+    }
+
+    EXPECT_NEAR(pos.GetS(), 1.0, 1e-3);
+    EXPECT_NEAR(pos.GetZ(), DenseProfileSample(1.0, 2.0, 50.0) + tan(pos.GetRRoad()) * (pos.GetT()), 1e-3);
+}
+
 // Uncomment to print log output to console
 // #define LOG_TO_CONSOLE
 
@@ -8,10 +8,13 @@
 #include "osi_version.pb.h"
 #endif  // _USE_OSI
 #include "Replay.hpp"
+#include "CollisionAnalysis.hpp"
 #include "CommonMini.hpp"
 #include "esminiLib.hpp"
 #include "RoadManager.hpp"
 #include <vector>
+#include <thread>
+#include <atomic>
 #include <stdexcept>
 #include <fstream>
 
@@ -2671,6 +2674,64 @@ TEST(ParameterTest, GetTypedParameterValues)
     SE_Close();
 }
 
+TEST(ParameterTest, GetSetParameterByHandle)
+{
+    std::string scenario_file = "../../../resources/xosc/lane_change.xosc";
+    EXPECT_EQ(SE_Init(scenario_file.c_str(), 0, 0, 0, 0), 0);
+
+    int handle = SE_GetParameterHandle("DummyParameter");
+    EXPECT_GE(handle, 0);
+    EXPECT_EQ(SE_GetParameterHandle("$DummyParameter"), handle);
+    EXPECT_EQ(SE_GetParameterHandle("DoesNotExist"), -1);
+
+    double value = 0.0;
+    EXPECT_EQ(SE_GetParameterByHandle(handle, &value), 0);
+    EXPECT_NEAR(value, 2.0, 1e-10);
+
+    value = 7.5;
+    EXPECT_EQ(SE_SetParameterByHandle(handle, &value), 0);
+    EXPECT_EQ(SE_GetParameterDouble("DummyParameter", &value), 0);
+    EXPECT_NEAR(value, 7.5, 1e-10);
+
+    // Handle still valid after stepping
+    SE_StepDT(0.1f);
+    EXPECT_EQ(SE_GetParameterByHandle(handle, &value), 0);
+    EXPECT_NEAR(value, 7.5, 1e-10);
+
+    EXPECT_EQ(SE_GetParameterByHandle(-1, &value), -1);
+    EXPECT_EQ(SE_GetParameterByHandle(10000, &value), -1);
+
+    SE_Close();
+    EXPECT_EQ(SE_GetParameterByHandle(handle, &value), -1);
+
+    // Handles from an earlier load are rejected, also when the same scenario is loaded again
+    EXPECT_EQ(SE_Init(scenario_file.c_str(), 0, 0, 0, 0), 0);
+    EXPECT_EQ(SE_GetParameterByHandle(handle, &value), -1);
+    EXPECT_EQ(SE_SetParameterByHandle(handle, &value), -1);
+    int new_handle = SE_GetParameterHandle("DummyParameter");
+    EXPECT_NE(new_handle, handle);
+    EXPECT_EQ(SE_GetParameterByHandle(new_handle, &value), 0);
+    EXPECT_NEAR(value, 2.0, 1e-10);
+    SE_Close();
+
+    scenario_file = "../../../EnvironmentSimulator/Unittest/xosc/lane_change_trig_by_variable.xosc";
+    EXPECT_EQ(SE_Init(scenario_file.c_str(), 0, 0, 0, 0), 0);
+
+    handle = SE_GetVariableHandle("DummyVariable2");
+    EXPECT_GE(handle, 0);
+
+    bool bool_value = false;
+    EXPECT_EQ(SE_GetVariableByHandle(handle, &bool_value), 0);
+    EXPECT_EQ(bool_value, true);
+
+    bool_value = false;
+    EXPECT_EQ(SE_SetVariableByHandle(handle, &bool_value), 0);
+    EXPECT_EQ(SE_GetVariableBool("DummyVariable2", &bool_value), 0);
+    EXPECT_EQ(bool_value, false);
+
+    SE_Close();
+}
+
 TEST(VariableTest, GetTypedVariableValues)
 {
     std::string scenario_file = "../../../EnvironmentSimulator/Unittest/xosc/lane_change_trig_by_variable.xosc";
@@ -3384,6 +3445,353 @@ TEST(TestGetAndSet, SeedTest)
     SE_Close();
 }
 
+class StateTest : public ::testing::TestWithParam<std::string>
+{
+};
+
+static void RunAndRecordStates(int n_steps, std::vector<SE_ScenarioObjectState>& states)
+{
+    states.clear();
+    for (int i = 0; i < n_steps; i++)
+    {
+        SE_StepDT(0.05f);
+        for (int j = 0; j < SE_GetNumberOfObjects(); j++)
+        {
+            SE_ScenarioObjectState state;
+            SE_GetObjectState(SE_GetId(j), &state);
+            states.push_back(state);
+        }
+    }
+}
+
+TEST_P(StateTest, TestSaveAndRestore)
+{
+    std::string scenario_file = GetParam();
+
+    SE_SetSeed(12345);
+    ASSERT_EQ(SE_Init(scenario_file.c_str(), 0, 0, 0, 0), 0);
+
+    std::vector<SE_ScenarioObjectState> states_ref;
+    std::vector<SE_ScenarioObjectState> states;
+
+    RunAndRecordStates(60, states);
+    double save_time = SE_GetSimulationTimeDouble();
+    void*  handle    = SE_SaveState();
+    ASSERT_NE(handle, nullptr);
+
+    RunAndRecordStates(200, states_ref);
+
+    // Branch from saved state twice, both should continue exactly like the original run
+    for (int k = 0; k < 2; k++)
+    {
+        ASSERT_EQ(SE_RestoreState(handle), 0);
+        EXPECT_DOUBLE_EQ(SE_GetSimulationTimeDouble(), save_time);
+
+        RunAndRecordStates(200, states);
+        ASSERT_EQ(states.size(), states_ref.size());
+        for (size_t i = 0; i < states.size(); i++)
+        {
+            ASSERT_EQ(states[i].id, states_ref[i].id);
+            ASSERT_FLOAT_EQ(states[i].x, states_ref[i].x);
+            ASSERT_FLOAT_EQ(states[i].y, states_ref[i].y);
+            ASSERT_FLOAT_EQ(states[i].h, states_ref[i].h);
+            ASSERT_FLOAT_EQ(states[i].speed, states_ref[i].speed);
+        }
+    }
+
+    EXPECT_EQ(SE_RestoreState(nullptr), -1);
+    SE_DeleteState(handle);
+    SE_Close();
+}
+
+INSTANTIATE_TEST_SUITE_P(StateTests,
+                         StateTest,
+                         ::testing::Values("../../../resources/xosc/cut-in.xosc",
+                                           "../../../resources/xosc/acc-test.xosc",
+                                           "../../../resources/xosc/synchronize.xosc",
+                                           "../../../resources/xosc/speed-profile.xosc",
+                                           "../../../resources/xosc/cut-in_sloppy.xosc",
+                                           "../../../resources/xosc/routing-test.xosc"));
+
+TEST(StateInstanceTest, TestRestoreParametersAndInstance)
+{
+    ASSERT_EQ(SE_Init("../../../resources/xosc/cut-in.xosc", 0, 0, 0, 0), 0);
+    for (int i = 0; i < 20; i++)
+    {
+        SE_StepDT(0.05f);
+    }
+
+    int handle = SE_GetParameterHandle("EgoStartS");
+    ASSERT_GE(handle, 0);
+    void* state = SE_SaveState();
+    ASSERT_NE(state, nullptr);
+
+    // Parameter values are restored in place, so handles stay valid
+    double value = 99.0;
+    EXPECT_EQ(SE_SetParameterByHandle(handle, &value), 0);
+    ASSERT_EQ(SE_RestoreState(state), 0);
+    EXPECT_EQ(SE_GetParameterByHandle(handle, &value), 0);
+    EXPECT_DOUBLE_EQ(value, 50.0);
+
+    // Snapshot refers to the scenario instance it was taken from
+    SE_Close();
+    ASSERT_EQ(SE_Init("../../../resources/xosc/cut-in.xosc", 0, 0, 0, 0), 0);
+    EXPECT_EQ(SE_RestoreState(state), -1);
+    EXPECT_DOUBLE_EQ(SE_GetSimulationTimeDouble(), 0.0);
+
+    SE_DeleteState(state);
+    SE_Close();
+}
+
+TEST(BulkStateTest, TestGetAllObjectStatesAndReportBatch)
+{
+    const int              capacity = 8;
+    int                    id[capacity], lane_id[capacity];
+    float                  x[capacity], y[capacity], h[capacity], speed[capacity], s[capacity];
+    SE_StateArrays         states = {};
+    SE_ScenarioObjectState obj_state;
+
+    EXPECT_EQ(SE_GetAllObjectStates(&states), -1);  // not initialized
+
+    ASSERT_EQ(SE_Init("../../../resources/xosc/cut-in.xosc", 0, 0, 0, 0), 0);
+    for (int i = 0; i < 20; i++)
+    {
+        SE_StepDT(0.1f);
+    }
+
+    states.capacity = capacity;
+    states.id       = id;
+    states.x        = x;
+    states.y        = y;
+    states.h        = h;
+    states.speed    = speed;
+    states.laneId   = lane_id;
+    states.s        = s;
+
+    ASSERT_EQ(SE_GetAllObjectStates(&states), 2);
+    ASSERT_EQ(states.n_objects, 2);
+    for (int i = 0; i < states.n_objects; i++)
+    {
+        ASSERT_EQ(SE_GetObjectState(SE_GetId(i), &obj_state), 0);
+        EXPECT_EQ(id[i], obj_state.id);
+        EXPECT_EQ(lane_id[i], obj_state.laneId);
+        EXPECT_FLOAT_EQ(x[i], obj_state.x);
+        EXPECT_FLOAT_EQ(y[i], obj_state.y);
+        EXPECT_FLOAT_EQ(h[i], obj_state.h);
+        EXPECT_FLOAT_EQ(speed[i], obj_state.speed);
+        EXPECT_FLOAT_EQ(s[i], obj_state.s);
+    }
+
+    // Too small arrays, only first object filled in
+    states.capacity = 1;
+    EXPECT_EQ(SE_GetAllObjectStates(&states), 2);
+    EXPECT_EQ(states.n_objects, 1);
+
+    // Move both objects 10 m forward in one call
+    for (int i = 0; i < 2; i++)
+    {
+        x[i] += 10.0f * cosf(h[i]);
+        y[i] += 10.0f * sinf(h[i]);
+        speed[i] = 5.0f;
+    }
+    EXPECT_EQ(SE_ReportObjectPosBatch(2, id, 0.0f, x, y, nullptr, h, nullptr, nullptr), 0);
+    EXPECT_EQ(SE_ReportObjectSpeedBatch(2, id, speed), 0);
+
+    for (int i = 0; i < 2; i++)
+    {
+        ASSERT_EQ(SE_GetObjectState(id[i], &obj_state), 0);
+        EXPECT_NEAR(obj_state.x, x[i], 1e-3);
+        EXPECT_NEAR(obj_state.y, y[i], 1e-3);
+        EXPECT_NEAR(obj_state.s, s[i] + 10.0f, 1e-2);
+        EXPECT_FLOAT_EQ(obj_state.speed, 5.0f);
+    }
+
+    // Invalid id reported as failure, valid ones still updated
+    int ids_invalid[2] = {id[0], 99};
+    speed[0]           = 7.0f;
+    EXPECT_EQ(SE_ReportObjectSpeedBatch(2, ids_invalid, speed), -1);
+    ASSERT_EQ(SE_GetObjectState(id[0], &obj_state), 0);
+    EXPECT_FLOAT_EQ(obj_state.speed, 7.0f);
+
+    SE_Close();
+}
+
+TEST(PostStateTest, TestPostFromOtherThreads)
+{
+    std::atomic<bool> stop{false};
+    float             last_x[3] = {0.0f, 0.0f, 0.0f};
+
+    ASSERT_EQ(SE_Init("../../../resources/xosc/cut-in.xosc", 0, 0, 0, 0), 0);
+    SE_StepDT(0.1f);
+
+    // Posted values are not applied until next step
+    SE_ScenarioObjectState obj_state;
+    ASSERT_EQ(SE_GetObjectState(0, &obj_state), 0);
+    float x0 = obj_state.x;
+    EXPECT_EQ(SE_PostObjectPos(0, 0.0f, x0 + 5.0f, obj_state.y, std::nanf(""), obj_state.h, std::nanf(""), std::nanf("")), 0);
+    EXPECT_EQ(SE_PostObjectSpeed(0, 3.0f), 0);
+    ASSERT_EQ(SE_GetObjectState(0, &obj_state), 0);
+    EXPECT_FLOAT_EQ(obj_state.x, x0);
+    SE_StepDT(0.001f);
+    ASSERT_EQ(SE_GetObjectState(0, &obj_state), 0);
+    EXPECT_NEAR(obj_state.x, x0 + 5.0f, 0.05);
+    EXPECT_FLOAT_EQ(obj_state.speed, 3.0f);
+
+    // Several threads posting positions at high rate while the scenario is running. Two threads share object 1.
+    // In each post y = x + object id, so a torn snapshot would break that relation. Speed 0 to keep the objects
+    // in place in case a step happens to find no new post.
+    auto producer = [&stop, &last_x](int thread_idx, int id)
+    {
+        float x = 0.0f;
+        for (int i = 0; !stop; i++)
+        {
+            x = 100.0f * static_cast<float>(thread_idx + 1) + static_cast<float>(i % 100);
+            SE_PostObjectPos(id, 0.0f, x, x + static_cast<float>(id), std::nanf(""), 0.0f, std::nanf(""), std::nanf(""));
+            SE_PostObjectSpeed(id, 0.0f);
+        }
+        last_x[thread_idx] = x;
+    };
+
+    for (int id = 0; id < 2; id++)
+    {
+        SE_PostObjectPos(id, 0.0f, 0.0f, static_cast<float>(id), std::nanf(""), 0.0f, std::nanf(""), std::nanf(""));
+        SE_PostObjectSpeed(id, 0.0f);
+    }
+
+    std::vector<std::thread> threads;
+    threads.emplace_back(producer, 0, 0);
+    threads.emplace_back(producer, 1, 1);
+    threads.emplace_back(producer, 2, 1);
+
+    for (int i = 0; i < 200; i++)
+    {
+        SE_StepDT(0.001f);
+        for (int id = 0; id < 2; id++)
+        {
+            ASSERT_EQ(SE_GetObjectState(id, &obj_state), 0);
+            EXPECT_NEAR(obj_state.y - obj_state.x, static_cast<float>(id), 0.01);
+        }
+    }
+
+    stop = true;
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Last post of each object is applied
+    SE_StepDT(0.001f);
+    ASSERT_EQ(SE_GetObjectState(0, &obj_state), 0);
+    EXPECT_NEAR(obj_state.x, last_x[0], 0.01);
+
+    SE_Close();
+}
+
+TEST(RealtimeTest, TestFixedStepAndStats)
+{
+    SE_RealtimeStats stats;
+    const char*      args[] = {"--osc", "../../../resources/xosc/cut-in_simple.xosc", "--headless", "--realtime", "0.01"};
+
+    ASSERT_EQ(SE_InitWithArgs(sizeof(args) / sizeof(char*), args), 0);
+    ASSERT_EQ(SE_GetRealtimeStats(&stats), 0);
+    int n_init_frames = stats.n_frames;  // any frame executed as part of init
+
+    SE_SystemTime timer;
+    for (int i = 0; i < 10; i++)
+    {
+        SE_Step();
+    }
+
+    // Simulation time advances by the fixed timestep, paced to wall clock
+    EXPECT_NEAR(SE_GetSimulationTime(), 0.1f, 1e-4);
+    EXPECT_GT(timer.GetS(), 0.08);
+
+    ASSERT_EQ(SE_GetRealtimeStats(&stats), 0);
+    EXPECT_EQ(stats.n_frames, n_init_frames + 10);
+    EXPECT_LE(stats.exec_time_min, stats.exec_time_avg);
+    EXPECT_LE(stats.exec_time_avg, stats.exec_time_max);
+    SE_Close();
+
+    // Not available in normal mode
+    ASSERT_EQ(SE_Init("../../../resources/xosc/cut-in_simple.xosc", 0, 0, 0, 0), 0);
+    EXPECT_EQ(SE_GetRealtimeStats(&stats), -1);
+    SE_Close();
+}
+
+TEST(KPITest, TestStopOnCollision)
+{
+    std::string scenario_file = "../../../resources/xosc/pedestrian_collision.xosc";
+    std::string kpi_file        = "kpi.csv";
+    std::string kpi_entity_file = "kpi_entities.csv";
+    double      end_time[2]     = {0.0, 0.0};
+
+    remove(kpi_file.c_str());
+    remove(kpi_entity_file.c_str());
+    SE_SetKPIFilePath(kpi_file.c_str());
+    SE_SetKPIEntityFilePath(kpi_entity_file.c_str());
+
+    for (int i = 0; i < 2; i++)
+    {
+        // first run without, then with early termination
+        SE_SetStopCriteria(i == 1, -1.0);
+        ASSERT_EQ(SE_Init(scenario_file.c_str(), 0, 0, 0, 0), 0);
+
+        for (int j = 0; j < 2000 && SE_GetQuitFlag() == 0; j++)
+        {
+            SE_StepDT(0.05f);
+        }
+        end_time[i] = static_cast<double>(SE_GetSimulationTime());
+        SE_Close();
+    }
+
+    SE_SetKPIFilePath("");
+    SE_SetKPIEntityFilePath("");
+    SE_SetStopCriteria(false, -1.0);
+
+    EXPECT_LT(end_time[1], end_time[0] - 1.0);
+
+    std::ifstream            file(kpi_file);
+    std::string              line;
+    std::vector<std::string> lines;
+    while (std::getline(file, line))
+    {
+        lines.push_back(line);
+    }
+    file.close();
+
+    // fixed header, then one row per run
+    ASSERT_EQ(lines.size(), 3);
+    EXPECT_EQ(lines[0], "scenario, permutation, end_time, stop_reason, collision, collision_time, min_ttc, min_gap, max_decel");
+
+    std::vector<std::string> values[2] = {SplitString(lines[1], ','), SplitString(lines[2], ',')};
+    ASSERT_EQ(values[0].size(), 9);
+    ASSERT_EQ(values[1].size(), 9);
+    EXPECT_NEAR(std::stod(values[0][2]), end_time[0], 1e-3);
+    EXPECT_EQ(values[0][3], " none");
+    EXPECT_EQ(values[0][4], " 1");
+    EXPECT_NEAR(std::stod(values[1][2]), end_time[1], 1e-3);
+    EXPECT_EQ(values[1][3], " collision");
+    EXPECT_EQ(values[1][4], " 1");
+    EXPECT_NEAR(std::stod(values[1][5]), end_time[1], 0.051);
+    EXPECT_NEAR(std::stod(values[1][7]), 0.0, 1e-3);
+
+    // per-entity file, one row per entity and run
+    std::ifstream entity_file(kpi_entity_file);
+    lines.clear();
+    while (std::getline(entity_file, line))
+    {
+        lines.push_back(line);
+    }
+
+    ASSERT_GT(lines.size(), 1);
+    EXPECT_EQ(lines[0], "scenario, permutation, entity, collision_time, min_ttc, min_gap, max_decel");
+    EXPECT_EQ((lines.size() - 1) % 2, 0);
+    for (size_t i = 1; i < lines.size(); i++)
+    {
+        EXPECT_EQ(SplitString(lines[i], ',').size(), 7);
+    }
+}
+
 TEST(SimpleVehicleTest, TestControl)
 {
     float dt = 0.01f;
@@ -3821,10 +4229,75 @@ TEST(ReplayTest, TestMultiReplayDifferentTimeSteps)
             EXPECT_NEAR(replay->data_[4201].state.info.id, 1, 1E-3);
         }
 
+        // Merge directly to file, then compare with merged data in memory
+        scenarioengine::Replay(".", "multirep_test", "multirep_merged.dat");
+        scenarioengine::Replay merged("multirep_merged.dat", false);
+        ASSERT_EQ(merged.data_.size(), replay->data_.size());
+        for (size_t i = 0; i < merged.data_.size(); i++)
+        {
+            ASSERT_EQ(merged.data_[i].state.info.id, replay->data_[i].state.info.id);
+            ASSERT_EQ(merged.data_[i].state.info.timeStamp, replay->data_[i].state.info.timeStamp);
+            ASSERT_EQ(merged.data_[i].state.pos.x, replay->data_[i].state.pos.x);
+        }
+
         delete replay;
     }
 }
 
+TEST(ReplayTest, TestCollisionAnalysis)
+{
+    scenarioengine::OSCBoundingBox bb;
+    bb.center_.x_          = 1.0;
+    bb.center_.y_          = 0.0;
+    bb.center_.z_          = 0.0;
+    bb.dimensions_.length_ = 4.0;
+    bb.dimensions_.width_  = 2.0;
+    bb.dimensions_.height_ = 1.5;
+
+    scenarioengine::CollisionBox box0, box1;
+    scenarioengine::CollisionBoxFromPos(0.0, 0.0, 0.0, bb, box0);
+    EXPECT_NEAR(box0.corner[0][0], 3.0, 1E-5);
+    EXPECT_NEAR(box0.corner[0][1], -1.0, 1E-5);
+    EXPECT_NEAR(box0.x_min, -1.0, 1E-5);
+    EXPECT_NEAR(box0.x_max, 3.0, 1E-5);
+
+    // rotated box overlapping front right corner
+    scenarioengine::CollisionBoxFromPos(3.5, -1.5, M_PI_4, bb, box1);
+    EXPECT_TRUE(scenarioengine::CollisionBoxesOverlap(box0, box1));
+    EXPECT_TRUE(scenarioengine::CollisionBoxesOverlap(box1, box0));
+
+    // bounding circles overlap but separated along the rotated box axis
+    scenarioengine::CollisionBoxFromPos(4.0, -2.6, M_PI_4, bb, box1);
+    EXPECT_FALSE(scenarioengine::CollisionBoxesOverlap(box0, box1));
+
+    // far away
+    scenarioengine::CollisionBoxFromPos(100.0, 0.0, 0.0, bb, box1);
+    EXPECT_FALSE(scenarioengine::CollisionBoxesOverlap(box0, box1));
+
+    // relative speed from velocity vectors, e.g. head-on collision at equal speed is not 0
+    EXPECT_NEAR(scenarioengine::CollisionRelativeSpeed(10.0, 0.0, 10.0, M_PI), 20.0, 1E-5);
+    EXPECT_NEAR(scenarioengine::CollisionRelativeSpeed(10.0, 0.3, 12.0, 0.3), 2.0, 1E-5);
+    EXPECT_NEAR(scenarioengine::CollisionRelativeSpeed(10.0, 0.0, 10.0, M_PI_2), 10.0 * sqrt(2.0), 1E-5);
+    EXPECT_NEAR(scenarioengine::CollisionRelativeSpeed(-5.0, 0.0, 5.0, M_PI), 0.0, 1E-5);  // reversing, same velocity
+
+    const char* args[] = {"--osc", "../../../resources/xosc/pedestrian_collision.xosc", "--record", "collision_test.dat", "--headless"};
+    ASSERT_EQ(SE_InitWithArgs(sizeof(args) / sizeof(char*), args), 0);
+    while (SE_GetQuitFlag() != 1 && SE_GetSimulationTime() < 20.0f)
+    {
+        SE_StepDT(0.05f);
+    }
+    SE_Close();
+
+    std::vector<scenarioengine::CollisionEvent> events;
+    EXPECT_EQ(scenarioengine::CollisionAnalysis::AnalyzeFiles({"collision_test.dat", "collision_test.dat", "missing.dat"}, 2, events), 1);
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_STREQ(events[0].name0.c_str(), "Ego");
+    EXPECT_STREQ(events[0].name1.c_str(), "pedestrian_adult");
+    EXPECT_EQ(events[0].filename, events[1].filename);
+    EXPECT_NEAR(events[0].time, events[1].time, 1E-5);
+    EXPECT_GT(events[0].rel_speed, 1.0);
+}
+
 void ConditionCallbackInstance1(const char* element_name, double timestamp)
 {
     EXPECT_STREQ(element_name, "act_start_condition");
@@ -4156,6 +4629,54 @@ TEST(ParamDistTest, TestRunAll)
     SE_ResetParameterDistribution();
 }
 
+TEST(ParamDistTest, TestScenarioTemplateMode)
+{
+    std::string            scenario_file = "../../../resources/xosc/cut-in.xosc";
+    const int              n_runs        = 4;
+    SE_ScenarioObjectState state[2][n_runs][2];
+
+    // Run a few permutations, first reading the files for each run then making use of the in-memory scenario template
+    for (int i = 0; i < 2; i++)
+    {
+        ASSERT_EQ(SE_SetParameterDistribution("../../../resources/xosc/cut-in_parameter_set.xosc"), 0);
+
+        // Mode stays in effect over SE_Close, until disabled
+        SE_SetScenarioTemplateMode(i == 1);
+
+        for (int j = 0; j < n_runs; j++)
+        {
+            SE_SelectPermutation(j);
+            ASSERT_EQ(SE_Init(scenario_file.c_str(), 0, 0, 0, 0), 0);
+            ASSERT_EQ(SE_GetNumberOfObjects(), 2);
+
+            for (int k = 0; k < 100 && SE_GetQuitFlag() == 0; k++)
+            {
+                SE_StepDT(0.1f);
+            }
+
+            SE_GetObjectState(SE_GetId(0), &state[i][j][0]);
+            SE_GetObjectState(SE_GetId(1), &state[i][j][1]);
+            SE_Close();
+        }
+
+        SE_ResetParameterDistribution();
+    }
+    SE_SetScenarioTemplateMode(false);
+
+    for (int j = 0; j < n_runs; j++)
+    {
+        for (int k = 0; k < 2; k++)
+        {
+            EXPECT_NEAR(state[1][j][k].x, state[0][j][k].x, 1e-5);
+            EXPECT_NEAR(state[1][j][k].y, state[0][j][k].y, 1e-5);
+            EXPECT_NEAR(state[1][j][k].speed, state[0][j][k].speed, 1e-5);
+        }
+    }
+
+    // Permutations differ, so the template must not have frozen the first parameter values
+    EXPECT_GT(fabs(state[1][0][1].x - state[1][n_runs - 1][1].x) + fabs(state[1][0][1].speed - state[1][n_runs - 1][1].speed), 0.1);
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
@@ -4,6 +4,8 @@
 #include <vector>
 #include <stdexcept>
 #include <array>
+#include <filesystem>
+#include <fstream>
 
 #include "ScenarioEngine.hpp"
 #include "ScenarioReader.hpp"
@@ -11,6 +13,7 @@
 #include "ControllerLooming.hpp"
 #include "ControllerALKS_R157SM.hpp"
 #include "OSCParameterDistribution.hpp"
+#include "OSCAABBTree.hpp"
 #include "pugixml.hpp"
 #include "simple_expr.h"
 
@@ -619,6 +622,139 @@ TEST(ParameterTest, ResolveParameterTest)
     ASSERT_EQ(params.ResolveParametersInString(" $turnsignal "), " true ");
 }
 
+static std::string EvalExpressionByString(Parameters& params, std::string expr)
+{
+    // Reference evaluation, parameter values substituted as text and expression parsed from scratch
+    expr = params.ResolveParametersInString(expr.substr(2, expr.length() - 3));
+
+    const char* ops[][2] = {{"not ", "!"}, {"not(", "!("}, {"and ", "&& "}, {"or ", "|| "}, {"true ", "1 "}, {"false ", "0 "}};
+    for (auto op : ops)
+    {
+        size_t pos;
+        while ((pos = expr.find(op[0])) != std::string::npos)
+        {
+            expr.replace(pos, strlen(op[0]), op[1]);
+        }
+    }
+    ExprReturnStruct rs = eval_expr(expr.c_str());
+    std::string      result;
+    if (rs.type == EXPR_RETURN_DOUBLE)
+    {
+        result = std::to_string(rs._double);
+    }
+    else if (rs.type == EXPR_RETURN_STRING)
+    {
+        result = rs._string.string;
+    }
+    clear_expr_result(&rs);
+    return result;
+}
+
+TEST(ParameterTest, CompiledExpressions)
+{
+    Parameters params;
+    params.parameterDeclarations_.Parameter.push_back({"a", OSCParameterDeclarations::ParameterType::PARAM_TYPE_DOUBLE, {0, 2.5, "2.5", false}});
+    params.parameterDeclarations_.Parameter.push_back({"b", OSCParameterDeclarations::ParameterType::PARAM_TYPE_INTEGER, {-3, 0, "-3", false}});
+    params.parameterDeclarations_.Parameter.push_back({"c", OSCParameterDeclarations::ParameterType::PARAM_TYPE_BOOL, {0, 0, "true", true}});
+    params.parameterDeclarations_.Parameter.push_back({"s", OSCParameterDeclarations::ParameterType::PARAM_TYPE_STRING, {0, 0, "car", false}});
+
+    const char* expressions[] = {"${$a + 1}",
+                                 "${$a * $b - 2 / $a}",
+                                 "${$b ** 2}",
+                                 "${2 ** $b}",
+                                 "${-$b + $a % 2}",
+                                 "${10 - $b}",
+                                 "${($a + $a) * ($b - $b)}",
+                                 "${max($a, $b) + min(pow($a, 2), sqrt(16))}",
+                                 "${$c and ($a > $b)}",
+                                 "${not ($a == 2.5)}",
+                                 "${$a >= 2.5 or $b != -3}",
+                                 "${round($a) + floor($a) + ceil($a)}",
+                                 "${$s + _suffix}"};
+
+    pugi::xml_document xml_doc;
+    pugi::xml_node     node = xml_doc.append_child("node");
+    for (int k = 0; k < 2; k++)
+    {
+        for (auto expr : expressions)
+        {
+            node.remove_attribute("attr");
+            node.append_attribute("attr") = expr;
+            EXPECT_EQ(params.ReadAttribute(node, "attr"), EvalExpressionByString(params, expr)) << expr;
+        }
+
+        // Same expressions, new values
+        params.setParameterValueByString("a", "7.25");
+        params.setParameterValueByString("b", "4");
+        params.setParameterValueByString("c", "false");
+    }
+}
+
+TEST(ParameterTest, ScopedParameterLookup)
+{
+    pugi::xml_document xml_doc;
+    pugi::xml_node     globalDeclsNode = xml_doc.append_child("ParameterDeclarations");
+    pugi::xml_node     localDeclsNode  = xml_doc.append_child("ParameterDeclarations");
+
+    pugi::xml_node node                    = globalDeclsNode.append_child("ParameterDeclaration");
+    node.append_attribute("name")          = "speed";
+    node.append_attribute("parameterType") = "double";
+    node.append_attribute("value")         = "10.0";
+    node                                   = globalDeclsNode.append_child("ParameterDeclaration");
+    node.append_attribute("name")          = "lane";
+    node.append_attribute("parameterType") = "integer";
+    node.append_attribute("value")         = "-1";
+
+    node                                   = localDeclsNode.append_child("ParameterDeclaration");
+    node.append_attribute("name")          = "speed";
+    node.append_attribute("parameterType") = "double";
+    node.append_attribute("value")         = "$speed";
+
+    Parameters params;
+    params.parseGlobalParameterDeclarations(globalDeclsNode);
+    int handle = params.GetParameterHandle("lane");
+    EXPECT_GE(handle, 0);
+
+    // Local declaration shadows the global one, catalog parameter assignment overrides default value
+    OSCParameterDeclarations::ParameterStruct assignment;
+    assignment.name          = "speed";
+    assignment.value._string = "20.0";
+    params.catalog_param_assignments.push_back(assignment);
+    params.addParameterDeclarations(localDeclsNode);
+    EXPECT_EQ(params.GetNumberOfParameters(), 3);
+    EXPECT_EQ(params.getParameter("$speed"), "20.0");
+    EXPECT_EQ(params.getParameter("lane"), "-1");
+    int local_handle = params.GetParameterHandle("speed");
+
+    // Compiled expressions refer to the declaration in current scope
+    pugi::xml_node exprNode            = xml_doc.append_child("Expression");
+    exprNode.append_attribute("value") = "${$speed * 2}";
+    EXPECT_EQ(params.ReadAttribute(exprNode, "value"), "40.000000");
+    EXPECT_GE(local_handle, 0);
+
+    // Back to global scope
+    params.RestoreParameterDeclarations();
+    EXPECT_EQ(params.GetNumberOfParameters(), 2);
+    EXPECT_EQ(params.getParameter("$speed"), "10.0");
+    EXPECT_EQ(params.ReadAttribute(exprNode, "value"), "20.000000");
+
+    // Handle to the removed local declaration is rejected, also when another declaration takes its place
+    double speed = 0.0;
+    EXPECT_EQ(params.getParameterValueByHandle(local_handle, &speed), -1);
+    params.addParameterDeclarations(localDeclsNode);
+    EXPECT_EQ(params.getParameterValueByHandle(local_handle, &speed), -1);
+    params.RestoreParameterDeclarations();
+
+    int value = 0;
+    EXPECT_EQ(params.getParameterValueByHandle(handle, &value), 0);
+    EXPECT_EQ(value, -1);
+    value = 3;
+    EXPECT_EQ(params.setParameterValueByHandle(handle, &value), 0);
+    EXPECT_EQ(params.getParameterValueInt("lane", value), 0);
+    EXPECT_EQ(value, 3);
+    EXPECT_EQ(params.GetParameterHandle("DoesNotExist"), -1);
+}
+
 TEST(ParameterTest, ParseParameterTest)
 {
     // Create parameter declarations
@@ -664,6 +800,64 @@ TEST(ParameterTest, ParseParameterTest)
     ASSERT_EQ(params.ReadAttribute(someNode0, "attr9", false), "2.000000");
 }
 
+TEST(CatalogTest, TestCatalogCache)
+{
+    CatalogCache::Inst().Clear();
+
+    std::shared_ptr<const pugi::xml_document> doc[2];
+    for (int i = 0; i < 2; i++)
+    {
+        ScenarioEngine* se = new ScenarioEngine("../../../resources/xosc/cut-in.xosc");
+        ASSERT_NE(se, nullptr);
+        Catalog* catalog = se->GetScenarioReader()->GetCatalogs()->FindCatalogByName("VehicleCatalog");
+        ASSERT_NE(catalog, nullptr);
+        ASSERT_GT(catalog->entry_.size(), 0);
+        EXPECT_STREQ(catalog->entry_[0]->GetNode().name(), "Vehicle");
+        doc[i] = catalog->entry_[0]->root_;
+        delete se;
+    }
+
+    // Second scenario instance should share the catalog parsed by the first one
+    EXPECT_EQ(CatalogCache::Inst().GetNumberOfFiles(), 1);
+    EXPECT_NE(doc[0], nullptr);
+    EXPECT_EQ(doc[0], doc[1]);
+
+    // Modified file should be parsed again
+    std::string                               filename = "catalog_cache_test.xosc";
+    pugi::xml_parse_result                    result;
+    std::shared_ptr<const pugi::xml_document> cached[3];
+    for (int i = 0; i < 2; i++)
+    {
+        std::ofstream file(filename);
+        file << "<OpenSCENARIO><Catalog name=\"test\"><Vehicle name=\"car" << i << "\"/></Catalog></OpenSCENARIO>";
+        file.close();
+        std::filesystem::last_write_time(filename, std::filesystem::last_write_time(filename) + std::chrono::seconds(10 * i));
+        cached[i] = CatalogCache::Inst().Load(filename, result);
+        ASSERT_NE(cached[i], nullptr);
+        EXPECT_EQ(static_cast<bool>(result), true);
+    }
+    cached[2] = CatalogCache::Inst().Load(filename, result);
+    EXPECT_NE(cached[0], cached[1]);
+    EXPECT_EQ(cached[1], cached[2]);
+    EXPECT_STREQ(cached[0]->child("OpenSCENARIO").child("Catalog").child("Vehicle").attribute("name").value(), "car0");
+    EXPECT_STREQ(cached[2]->child("OpenSCENARIO").child("Catalog").child("Vehicle").attribute("name").value(), "car1");
+    EXPECT_EQ(CatalogCache::Inst().GetNumberOfFiles(), 2);
+
+    // Edit within timestamp resolution, here simulated by restoring the timestamp, should be detected by the changed size
+    std::filesystem::file_time_type mod_time = std::filesystem::last_write_time(filename);
+    std::ofstream                   file(filename);
+    file << "<OpenSCENARIO><Catalog name=\"test\"><Vehicle name=\"car10\"/></Catalog></OpenSCENARIO>";
+    file.close();
+    std::filesystem::last_write_time(filename, mod_time);
+    std::shared_ptr<const pugi::xml_document> edited = CatalogCache::Inst().Load(filename, result);
+    ASSERT_NE(edited, nullptr);
+    EXPECT_NE(edited, cached[2]);
+    EXPECT_STREQ(edited->child("OpenSCENARIO").child("Catalog").child("Vehicle").attribute("name").value(), "car10");
+
+    CatalogCache::Inst().Clear();
+    std::remove(filename.c_str());
+}
+
 // Test junction selector functionality
 // Utilizing fabriksgatan 4 way intersection
 // Car will always drive on road 0, north towards the intersection
@@ -1001,6 +1195,83 @@ TEST(ControllerTest, UDPDriverModelTestSynchronous)
     delete udpClient2;
 }
 
+#ifndef _WIN32
+TEST(ControllerTest, UDPDriverModelTestSharedMemory)
+{
+    double dt = 0.01;
+
+    ScenarioEngine* se = new ScenarioEngine("../../../scripts/udp_driver/two_cars_in_open_space.xosc");
+    ASSERT_NE(se, nullptr);
+    ASSERT_EQ(se->entities_.object_.size(), 2);
+
+    // Replace controller of first vehicle
+    scenarioengine::Controller::InitArgs args;
+    args.name       = "UDPDriverModel Controller";
+    args.type       = ControllerUDPDriver::GetTypeNameStatic();
+    args.parameters = 0;
+    args.gateway    = se->getScenarioGateway();
+    args.properties = new OSCProperties();
+    OSCProperties::Property property;
+    property.name_  = "execMode";
+    property.value_ = "synchronous";
+    args.properties->property_.push_back(property);
+    property.name_  = "transport";
+    property.value_ = "sharedMemory";
+    args.properties->property_.push_back(property);
+    property.name_  = "port";
+    property.value_ = std::to_string(61920);
+    args.properties->property_.push_back(property);
+    property.name_  = "inputMode";
+    property.value_ = "vehicleStateXYZHPR";
+    args.properties->property_.push_back(property);
+    ControllerUDPDriver* controller = reinterpret_cast<ControllerUDPDriver*>(InstantiateControllerUDPDriver(&args));
+
+    for (auto ctrl : se->entities_.object_[0]->controllers_)
+    {
+        se->entities_.object_[0]->UnassignController(ctrl);
+        delete ctrl;
+    }
+    delete args.properties;
+    se->scenarioReader->controller_[0] = controller;
+    se->entities_.object_[0]->AssignController(controller);
+    controller->LinkObject(se->entities_.object_[0]);
+
+    // assign controller, which creates the shared memory
+    se->step(dt);
+
+    SharedMemoryClient* shmClient = new SharedMemoryClient(UDP_DRIVER_SHM_NAME_PREFIX + std::to_string(61920));
+    ASSERT_EQ(shmClient->GetStatus(), 0);
+
+    ControllerUDPDriver::DMMessage msg;
+    memset(&msg, 0, sizeof(msg));
+
+    msg.header.version                 = 1;
+    msg.header.objectId                = 0;
+    msg.header.inputMode               = static_cast<int>(ControllerUDPDriver::InputMode::VEHICLE_STATE_XYZHPR);
+    msg.message.stateXYZHPR.h          = 0.3;
+    msg.message.stateXYZHPR.x          = 20.0;
+    msg.message.stateXYZHPR.y          = 30.0;
+    msg.message.stateXYZHPR.deadReckon = 0;
+    ASSERT_EQ(shmClient->Send(reinterpret_cast<char*>(&msg), sizeof(msg)), sizeof(msg));
+
+    msg.header.frameNumber++;
+    msg.message.stateXYZHPR.y = 40;
+    ASSERT_EQ(shmClient->Send(reinterpret_cast<char*>(&msg), sizeof(msg)), sizeof(msg));
+
+    // In synchronous mode one message is consumed each time step, then applied next step
+    se->step(dt);
+    se->step(dt);
+    EXPECT_DOUBLE_EQ(se->entities_.object_[0]->pos_.GetX(), 20.0);
+    EXPECT_DOUBLE_EQ(se->entities_.object_[0]->pos_.GetY(), 30.0);
+
+    se->step(dt);
+    EXPECT_DOUBLE_EQ(se->entities_.object_[0]->pos_.GetY(), 40.0);
+
+    delete se;
+    delete shmClient;
+}
+#endif
+
 TEST(RoadOrientationTest, TestElevationPitchRoll)
 {
     double dt = 0.1;
@@ -1883,6 +2154,90 @@ TEST(DistributionTest, TestDeterministicDistribution)
     dist.Reset();
 }
 
+TEST(DistributionTest, TestStochasticDistribution)
+{
+    OSCParameterDistribution& dist = OSCParameterDistribution::Inst();
+
+    EXPECT_EQ(dist.Load("../../../resources/xosc/cut-in_parameter_stochastic.xosc"), 0);
+    EXPECT_EQ(dist.GetNumPermutations(), 20);
+
+    EXPECT_EQ(dist.SetIndex(0), 0);
+    EXPECT_EQ(dist.GetNumParameters(), 5);
+    EXPECT_EQ(dist.GetParamName(0), "EgoSpeed");
+    EXPECT_EQ(dist.GetParamName(4), "TargetVehicle");
+    EXPECT_EQ(dist.GetParamName(5), "");
+    EXPECT_EQ(dist.SetIndex(20), -1);
+
+    // samples are reproducible and generated on demand in any order
+    EXPECT_EQ(dist.SetIndex(7), 0);
+    std::string sample7 = dist.GetParamValue(0);
+    EXPECT_EQ(dist.SetIndex(3), 0);
+    EXPECT_NE(dist.GetParamValue(0), sample7);
+    EXPECT_EQ(dist.SetIndex(7), 0);
+    EXPECT_EQ(dist.GetParamValue(0), sample7);
+
+    for (auto method : {OSCParameterDistribution::SamplingMethod::RANDOM,
+                        OSCParameterDistribution::SamplingMethod::LATIN_HYPERCUBE,
+                        OSCParameterDistribution::SamplingMethod::SOBOL})
+    {
+        dist.SetSamplingMethod(method);
+        std::vector<int> strata(dist.GetNumPermutations(), 0);
+
+        for (unsigned int i = 0; i < dist.GetNumPermutations(); i++)
+        {
+            EXPECT_EQ(dist.SetIndex(i), 0);
+
+            double ego_speed = std::atof(dist.GetParamValue(0).c_str());
+            EXPECT_GE(ego_speed, 70.0);
+            EXPECT_LE(ego_speed, 110.0);
+
+            double speed_factor = std::atof(dist.GetParamValue(1).c_str());
+            EXPECT_GE(speed_factor, 1.1);
+            EXPECT_LE(speed_factor, 1.5);
+            int stratum = static_cast<int>((speed_factor - 1.1) / 0.4 * dist.GetNumPermutations());
+            strata[static_cast<size_t>(CLAMP(stratum, 0, static_cast<int>(dist.GetNumPermutations()) - 1))]++;
+
+            double headway = std::atof(dist.GetParamValue(2).c_str());
+            EXPECT_GE(headway, 0.2);
+            EXPECT_LE(headway, 0.8);
+
+            double start_s = std::atof(dist.GetParamValue(3).c_str());
+            EXPECT_GE(start_s, 40.0);
+            EXPECT_LE(start_s, 60.0);
+
+            std::string vehicle = dist.GetParamValue(4);
+            EXPECT_TRUE(vehicle == "car_red" || vehicle == "van_red");
+        }
+
+        if (method == OSCParameterDistribution::SamplingMethod::LATIN_HYPERCUBE)
+        {
+            // exactly one sample per stratum
+            for (size_t i = 0; i < strata.size(); i++)
+            {
+                EXPECT_EQ(strata[i], 1);
+            }
+        }
+    }
+
+    dist.Reset();
+    EXPECT_EQ(dist.GetNumPermutations(), 0);
+
+    // A distribution failing after some parameters are parsed should not leave any of them behind
+    std::string   filename = "stochastic_invalid.xosc";
+    std::ofstream file(filename);
+    file << "<OpenSCENARIO><ParameterValueDistribution><ScenarioFile filepath=\"cut-in.xosc\"/>"
+         << "<Stochastic numberOfTestRuns=\"10\" randomSeed=\"1\">"
+         << "<StochasticDistribution parameterName=\"A\"><UniformDistribution><Range lowerLimit=\"0\" upperLimit=\"1\"/>"
+         << "</UniformDistribution></StochasticDistribution>"
+         << "<StochasticDistribution parameterName=\"B\"><PoissonDistribution expectedValue=\"-1\"/></StochasticDistribution>"
+         << "</Stochastic></ParameterValueDistribution></OpenSCENARIO>";
+    file.close();
+    EXPECT_EQ(dist.Load(filename), -1);
+    EXPECT_EQ(dist.GetNumPermutations(), 0);
+    EXPECT_EQ(dist.GetFilename(), "");
+    std::remove(filename.c_str());
+}
+
 TEST_F(StraightRoadTest, TestObjectOverlap)
 {
     Object ego(Object::Type::VEHICLE);
@@ -2611,6 +2966,52 @@ TEST(ClothoidSplineTest, TestTrajectoryShape)
     delete se;
 }
 
+TEST(SwarmTest, TestCurveToTriangles)
+{
+    ASSERT_EQ(Position::LoadOpenDrive("../../../resources/xodr/curves.xodr"), true);
+    OpenDrive* odr = Position::GetOpenDrive();
+    int        n   = 0;
+
+    for (int i = 0; i < odr->GetNumOfRoads(); i++)
+    {
+        Road* road = odr->GetRoadByIdx(i);
+        for (int j = 0; j < road->GetNumberOfGeometries(); j++)
+        {
+            Geometry* gm = road->GetGeometry(j);
+            if (gm->GetType() == Geometry::GeometryType::GEOMETRY_TYPE_LINE)
+            {
+                continue;
+            }
+
+            aabbTree::BBoxVec vec;
+            aabbTree::curve2triangles(gm, 10.0, M_PI / 36, vec);
+            ASSERT_GT(vec.size(), 0);
+            EXPECT_NEAR(vec.front()->triangle()->sI, 0.0, 1e-10);
+            EXPECT_NEAR(vec.back()->triangle()->sF, gm->GetLength(), 1e-10);
+
+            // Consecutive triangles, all corners on the curve
+            for (size_t k = 0; k < vec.size(); k++)
+            {
+                aabbTree::ptTriangle tr = vec[k]->triangle();
+                double               x, y, h;
+
+                if (k > 0)
+                {
+                    EXPECT_EQ(tr->sI, vec[k - 1]->triangle()->sF);
+                }
+                gm->EvaluateDS(tr->sI, &x, &y, &h);
+                EXPECT_NEAR(tr->a.x, x, 1e-6);
+                EXPECT_NEAR(tr->a.y, y, 1e-6);
+                gm->EvaluateDS(tr->sF, &x, &y, &h);
+                EXPECT_NEAR(tr->b.x, x, 1e-6);
+                EXPECT_NEAR(tr->b.y, y, 1e-6);
+                n++;
+            }
+        }
+    }
+    EXPECT_GT(n, 0);
+}
+
 TEST(RelativePositionRouting, TestRelativePositionWithRoutes)
 {
     ScenarioEngine* se = new ScenarioEngine("../../../EnvironmentSimulator/Unittest/xosc/relative_pos_over_intersection.xosc");
@@ -3015,6 +3416,35 @@ TEST(LaneChange, TestLaneChangeEdgeCase)
     delete se;
 }
 
+TEST(GatewayTest, TestPostObjectState)
+{
+    ASSERT_EQ(roadmanager::Position::LoadOpenDrive("../../../EnvironmentSimulator/Unittest/xodr/mw_100m.xodr"), true);
+    ScenarioGateway gateway;
+
+    // Unknown object is only created when asked for
+    EXPECT_EQ(gateway.postObjectState(3, 0.0, 10.0, 1.0, 0.0, 0.0, 0.0, 0.0, 5.0, 0.1, 0.2), 0);
+    EXPECT_EQ(gateway.applyPostedStates(), 1);
+    EXPECT_EQ(gateway.getObjectStatePtrById(3), nullptr);
+
+    EXPECT_EQ(gateway.postObjectState(3, 0.0, 10.0, 1.0, 0.0, 0.0, 0.0, 0.0, 5.0, 0.1, 0.2, "Ego"), 0);
+    EXPECT_EQ(gateway.applyPostedStates(), 1);
+    ObjectState* obj_state = gateway.getObjectStatePtrById(3);
+    ASSERT_NE(obj_state, nullptr);
+    EXPECT_STREQ(obj_state->state_.info.name, "Ego");
+    EXPECT_NEAR(obj_state->state_.pos.GetX(), 10.0, 1e-5);
+    EXPECT_NEAR(obj_state->state_.info.speed, 5.0, 1e-5);
+    EXPECT_NEAR(obj_state->state_.info.wheel_angle, 0.1, 1e-5);
+    EXPECT_NEAR(obj_state->state_.info.wheel_rot, 0.2, 1e-5);
+
+    // Then all values of one post are applied together
+    EXPECT_EQ(gateway.postObjectState(3, 0.0, 20.0, 1.0, 0.0, 0.0, 0.0, 0.0, 6.0, 0.0, 0.3, "Ego"), 0);
+    EXPECT_EQ(gateway.applyPostedStates(), 1);
+    EXPECT_EQ(gateway.getNumberOfObjects(), 1);
+    EXPECT_NEAR(obj_state->state_.pos.GetX(), 20.0, 1e-5);
+    EXPECT_NEAR(obj_state->state_.info.speed, 6.0, 1e-5);
+    EXPECT_NEAR(obj_state->state_.info.wheel_rot, 0.3, 1e-5);
+}
+
 // Uncomment to print log output to console
 // #define LOG_TO_CONSOLE
 
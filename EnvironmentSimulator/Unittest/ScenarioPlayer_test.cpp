@@ -3,6 +3,8 @@
 #include <gmock/gmock.h>
 #include <vector>
 #include <stdexcept>
+#include <fstream>
+#include <sstream>
 
 #include "playerbase.hpp"
 
@@ -438,6 +440,77 @@ TEST(Controllers, TestSeparateControllersOnLatLong)
     delete se;
 }
 
+static std::string ReadFileContent(const char* filename)
+{
+    std::ifstream     file(filename, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+TEST(ThroughputTest, TestBufferedOutputEqualsDefault)
+{
+    const char* args_default[] = {"esmini",
+                                  "--osc",
+                                  "../../../resources/xosc/cut-in.xosc",
+                                  "--headless",
+                                  "--fixed_timestep",
+                                  "0.05",
+                                  "--record",
+                                  "sim_default.dat",
+                                  "--csv_logger",
+                                  "sim_default.csv",
+                                  "--disable_stdout"};
+    const char* args_throughput[] = {"esmini",
+                                     "--osc",
+                                     "../../../resources/xosc/cut-in.xosc",
+                                     "--throughput",
+                                     "--record",
+                                     "sim_throughput.dat",
+                                     "--csv_logger",
+                                     "sim_throughput.csv",
+                                     "--disable_stdout"};
+
+    for (int i = 0; i < 2; i++)
+    {
+        int             argc   = i == 0 ? sizeof(args_default) / sizeof(char*) : sizeof(args_throughput) / sizeof(char*);
+        ScenarioPlayer* player = new ScenarioPlayer(argc, const_cast<char**>(i == 0 ? args_default : args_throughput));
+        ASSERT_NE(player, nullptr);
+        ASSERT_EQ(player->Init(), 0);
+        EXPECT_NEAR(player->GetFixedTimestep(), 0.05, 1e-10);
+
+        while (!player->IsQuitRequested())
+        {
+            player->Frame(player->GetFixedTimestep());
+        }
+        delete player;
+    }
+
+    std::string dat_default    = ReadFileContent("sim_default.dat");
+    std::string dat_throughput = ReadFileContent("sim_throughput.dat");
+    EXPECT_GT(dat_default.size(), 10000);
+    ASSERT_EQ(dat_default.size(), dat_throughput.size());
+
+    // compare records field by field, since any bytes after the terminator of string fields are undefined
+    size_t n_records = (dat_default.size() - sizeof(DatHeader)) / sizeof(ObjectStateStructDat);
+    for (size_t i = 0; i < n_records; i++)
+    {
+        const ObjectStateStructDat* s0 =
+            reinterpret_cast<const ObjectStateStructDat*>(&dat_default[sizeof(DatHeader) + i * sizeof(ObjectStateStructDat)]);
+        const ObjectStateStructDat* s1 =
+            reinterpret_cast<const ObjectStateStructDat*>(&dat_throughput[sizeof(DatHeader) + i * sizeof(ObjectStateStructDat)]);
+        ASSERT_EQ(s0->info.id, s1->info.id);
+        ASSERT_STREQ(s0->info.name, s1->info.name);
+        ASSERT_EQ(s0->info.timeStamp, s1->info.timeStamp);
+        ASSERT_EQ(memcmp(&s0->pos, &s1->pos, sizeof(s0->pos)), 0);
+    }
+
+    std::string csv_default    = ReadFileContent("sim_default.csv");
+    std::string csv_throughput = ReadFileContent("sim_throughput.csv");
+    EXPECT_GT(csv_default.size(), 10000);
+    EXPECT_EQ(csv_default, csv_throughput);
+}
+
 // #define LOG_TO_CONSOLE
 
 #ifdef LOG_TO_CONSOLE
@@ -0,0 +1,128 @@
+/*
+ * This example measures round trip latency of the transports available for external driver models
+ * (see UDPDriverController), UDP on loopback versus shared memory. An echo thread returns each message
+ * right away, like a driver model responding to the state of each frame.
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "CommonMini.hpp"
+#include "UDP.hpp"
+#include "SharedMemory.hpp"
+
+#define N_MESSAGES    10000
+#define MESSAGE_SIZE  96  // about the size of a driver model message
+#define UDP_BASE_PORT 49990
+
+typedef struct
+{
+    int  counter;  // -1 = stop
+    char payload[MESSAGE_SIZE - sizeof(int)];
+} Message;
+
+// Receive messages on one channel and send them back on another, until stop message
+template <class Server, class Client>
+static void Echo(Server* server, Client* client)
+{
+    Message msg;
+    while (true)
+    {
+        if (server->Receive(reinterpret_cast<char*>(&msg), sizeof(msg)) == -1)
+        {
+            continue;  // timeout, keep waiting
+        }
+        if (msg.counter == -1)
+        {
+            break;
+        }
+        client->Send(reinterpret_cast<char*>(&msg), sizeof(msg));
+    }
+}
+
+template <class Server, class Client>
+static void Measure(const char* label, Server* request_server, Client* request_client, Server* reply_server, Client* reply_client)
+{
+    std::vector<double> round_trip_us;
+    Message             msg;
+
+    memset(&msg, 0, sizeof(msg));
+    round_trip_us.reserve(N_MESSAGES);
+
+    std::thread echo_thread(Echo<Server, Client>, request_server, reply_client);
+
+    for (int i = 1; i <= N_MESSAGES; i++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        msg.counter = i;
+        request_client->Send(reinterpret_cast<char*>(&msg), sizeof(msg));
+        if (reply_server->Receive(reinterpret_cast<char*>(&msg), sizeof(msg)) == -1 || msg.counter != i)
+        {
+            printf("%s: lost message %d\n", label, i);
+            continue;
+        }
+
+        std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+        round_trip_us.push_back(1e-3 * static_cast<double>(elapsed.count()));
+    }
+
+    msg.counter = -1;
+    request_client->Send(reinterpret_cast<char*>(&msg), sizeof(msg));
+    echo_thread.join();
+
+    if (round_trip_us.empty())
+    {
+        return;
+    }
+
+    double sum = 0.0;
+    for (double value : round_trip_us)
+    {
+        sum += value;
+    }
+    std::sort(round_trip_us.begin(), round_trip_us.end());
+
+    printf("%-14s round trip (us): mean %7.2f  median %7.2f  p99 %7.2f  max %8.2f  (%d messages)\n",
+           label,
+           sum / static_cast<double>(round_trip_us.size()),
+           round_trip_us[round_trip_us.size() / 2],
+           round_trip_us[round_trip_us.size() * 99 / 100],
+           round_trip_us.back(),
+           static_cast<int>(round_trip_us.size()));
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    {
+        UDPServer request_server(UDP_BASE_PORT, 500);
+        UDPClient request_client(UDP_BASE_PORT, "127.0.0.1");
+        UDPServer reply_server(UDP_BASE_PORT + 1, 500);
+        UDPClient reply_client(UDP_BASE_PORT + 1, "127.0.0.1");
+
+        Measure("UDP loopback", &request_server, &request_client, &reply_server, &reply_client);
+    }
+
+    {
+        SharedMemoryServer request_server("/esmini_latency_request", 500);
+        SharedMemoryClient request_client("/esmini_latency_request");
+        SharedMemoryServer reply_server("/esmini_latency_reply", 500);
+        SharedMemoryClient reply_client("/esmini_latency_reply");
+
+        if (request_server.GetStatus() != 0 || reply_server.GetStatus() != 0)
+        {
+            printf("Shared memory not supported on this platform\n");
+            return -1;
+        }
+
+        Measure("Shared memory", &request_server, &request_client, &reply_server, &reply_client);
+    }
+
+    return 0;
+}
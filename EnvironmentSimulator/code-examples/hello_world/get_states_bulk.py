@@ -0,0 +1,67 @@
+import ctypes
+import numpy as np
+from sys import platform
+
+if platform == "linux" or platform == "linux2":
+    se = ctypes.CDLL("../bin/libesminiLib.so")
+elif platform == "darwin":
+    se = ctypes.CDLL("../bin/libesminiLib.dylib")
+elif platform == "win32":
+    se = ctypes.CDLL("../bin/esminiLib.dll")
+else:
+    print("Unsupported platform: {}".format(platform))
+    quit()
+
+# Definition of SE_StateArrays struct, one array per value
+c_int_p = ctypes.POINTER(ctypes.c_int)
+c_float_p = ctypes.POINTER(ctypes.c_float)
+
+class SEStateArrays(ctypes.Structure):
+    _fields_ = [
+        ("capacity", ctypes.c_int),
+        ("n_objects", ctypes.c_int),
+        ("id", c_int_p),
+        ("ctrl_type", c_int_p),
+        ("x", c_float_p),
+        ("y", c_float_p),
+        ("z", c_float_p),
+        ("h", c_float_p),
+        ("p", c_float_p),
+        ("r", c_float_p),
+        ("speed", c_float_p),
+        ("roadId", c_int_p),
+        ("junctionId", c_int_p),
+        ("laneId", c_int_p),
+        ("laneOffset", c_float_p),
+        ("s", c_float_p),
+        ("t", c_float_p),
+        ("wheel_angle", c_float_p),
+        ("wheel_rot", c_float_p),
+        ("objectType", c_int_p),
+        ("visibilityMask", c_int_p),
+    ]
+
+se.SE_GetSimulationTime.restype = ctypes.c_float
+
+se.SE_Init(b"../resources/xosc/cut-in.xosc", 0, 1, 0, 0)
+
+# esmini fills numpy arrays directly, no per object calls or copies needed
+capacity = 100
+ids = np.zeros(capacity, dtype=np.int32)
+xs = np.zeros(capacity, dtype=np.float32)
+ys = np.zeros(capacity, dtype=np.float32)
+speeds = np.zeros(capacity, dtype=np.float32)
+
+states = SEStateArrays()  # arrays not of interest are left as null pointers
+states.capacity = capacity
+states.id = ids.ctypes.data_as(c_int_p)
+states.x = xs.ctypes.data_as(c_float_p)
+states.y = ys.ctypes.data_as(c_float_p)
+states.speed = speeds.ctypes.data_as(c_float_p)
+
+for i in range(500):
+    se.SE_GetAllObjectStates(ctypes.byref(states))
+    n = states.n_objects
+    print('Frame {} Time {:.2f} ids {} mean speed {:.2f} max x {:.2f}'.format(
+        i, se.SE_GetSimulationTime(), ids[:n], np.mean(speeds[:n]) * 3.6, np.max(xs[:n])))
+    se.SE_Step()
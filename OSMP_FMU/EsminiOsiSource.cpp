@@ -147,6 +147,28 @@ void EsminiOsiSource::reset_fmi_traffic_command_out()
     integer_vars[FMI_INTEGER_TRAFFICCOMMAND_OUT_BASELO_IDX]=0;
 }
 
+string EsminiOsiSource::get_fmi_out_bytes(int base_hi_idx, int base_lo_idx, int size_idx)
+{
+    if (integer_vars[size_idx] <= 0)
+        return string();
+    const char* buffer = (const char*)decode_integer_to_pointer(integer_vars[base_hi_idx],integer_vars[base_lo_idx]);
+    return string(buffer,(size_t)integer_vars[size_idx]);
+}
+
+void EsminiOsiSource::set_fmi_out_bytes(const string& data, int base_hi_idx, int base_lo_idx, int size_idx)
+{
+    if (data.empty()) {
+        integer_vars[size_idx]=0;
+        integer_vars[base_hi_idx]=0;
+        integer_vars[base_lo_idx]=0;
+        return;
+    }
+    *currentBuffer=data;
+    encode_pointer_to_integer(currentBuffer->data(),integer_vars[base_hi_idx],integer_vars[base_lo_idx]);
+    integer_vars[size_idx]=(fmi2Integer)currentBuffer->length();
+    swap(currentBuffer,lastBuffer);
+}
+
 /*
  * Actual Core Content
  */
@@ -517,6 +539,71 @@ fmi2Status EsminiOsiSource::SetString(const fmi2ValueReference vr[], size_t nvr,
   return fmi2OK;
 }
 
+/*
+ * FMU state: Simulation state is saved by esmini, outputs as the serialized messages last provided
+ */
+struct EsminiOsiSourceState {
+    void* se_state;
+    fmi2Boolean boolean_vars[FMI_BOOLEAN_VARS];
+    fmi2Real real_vars[FMI_REAL_VARS];
+    string string_vars[FMI_STRING_VARS];
+    string sensor_view_out;
+    string traffic_command_out;
+};
+
+fmi2Status EsminiOsiSource::GetFMUstate(fmi2FMUstate* FMUstate)
+{
+    fmi_verbose_log("fmi2GetFMUstate()");
+    void* se_state = SE_SaveState();
+    if (se_state == NULL)
+        return fmi2Error;
+
+    EsminiOsiSourceState* state = (EsminiOsiSourceState*)*FMUstate;
+    if (state == NULL) {
+        state = new EsminiOsiSourceState();
+    } else {
+        SE_DeleteState(state->se_state);  // overwrite previously saved state
+    }
+
+    state->se_state = se_state;
+    copy(boolean_vars, boolean_vars + FMI_BOOLEAN_VARS, state->boolean_vars);
+    copy(real_vars, real_vars + FMI_REAL_VARS, state->real_vars);
+    copy(string_vars, string_vars + FMI_STRING_VARS, state->string_vars);
+    state->sensor_view_out = get_fmi_out_bytes(FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX,FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX,FMI_INTEGER_SENSORVIEW_OUT_SIZE_IDX);
+    state->traffic_command_out = get_fmi_out_bytes(FMI_INTEGER_TRAFFICCOMMAND_OUT_BASEHI_IDX,FMI_INTEGER_TRAFFICCOMMAND_OUT_BASELO_IDX,FMI_INTEGER_TRAFFICCOMMAND_OUT_SIZE_IDX);
+
+    *FMUstate = (fmi2FMUstate)state;
+    return fmi2OK;
+}
+
+fmi2Status EsminiOsiSource::SetFMUstate(fmi2FMUstate FMUstate)
+{
+    fmi_verbose_log("fmi2SetFMUstate()");
+    EsminiOsiSourceState* state = (EsminiOsiSourceState*)FMUstate;
+    if (state == NULL || SE_RestoreState(state->se_state) != 0)
+        return fmi2Error;
+
+    copy(state->boolean_vars, state->boolean_vars + FMI_BOOLEAN_VARS, boolean_vars);
+    copy(state->real_vars, state->real_vars + FMI_REAL_VARS, real_vars);
+    copy(state->string_vars, state->string_vars + FMI_STRING_VARS, string_vars);
+    set_fmi_out_bytes(state->sensor_view_out,FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX,FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX,FMI_INTEGER_SENSORVIEW_OUT_SIZE_IDX);
+    set_fmi_out_bytes(state->traffic_command_out,FMI_INTEGER_TRAFFICCOMMAND_OUT_BASEHI_IDX,FMI_INTEGER_TRAFFICCOMMAND_OUT_BASELO_IDX,FMI_INTEGER_TRAFFICCOMMAND_OUT_SIZE_IDX);
+
+    return fmi2OK;
+}
+
+fmi2Status EsminiOsiSource::FreeFMUstate(fmi2FMUstate* FMUstate)
+{
+    fmi_verbose_log("fmi2FreeFMUstate()");
+    EsminiOsiSourceState* state = (EsminiOsiSourceState*)*FMUstate;
+    if (state != NULL) {
+        SE_DeleteState(state->se_state);
+        delete state;
+        *FMUstate = NULL;
+    }
+    return fmi2OK;
+}
+
 /*
  * FMI 2.0 Co-Simulation Interface API
  */
@@ -656,23 +743,30 @@ return myc->SetString(vr, nvr, value);
 }
 
 /*
- * Unsupported Features (FMUState, Derivatives, Async DoStep, Status Enquiries)
+ * FMU State Functions
  */
 FMI2_Export fmi2Status fmi2GetFMUstate(fmi2Component c, fmi2FMUstate* FMUstate)
 {
-return fmi2Error;
+EsminiOsiSource* myc = (EsminiOsiSource*)c;
+return myc->GetFMUstate(FMUstate);
 }
 
 FMI2_Export fmi2Status fmi2SetFMUstate(fmi2Component c, fmi2FMUstate FMUstate)
 {
-return fmi2Error;
+EsminiOsiSource* myc = (EsminiOsiSource*)c;
+return myc->SetFMUstate(FMUstate);
 }
 
 FMI2_Export fmi2Status fmi2FreeFMUstate(fmi2Component c, fmi2FMUstate* FMUstate)
 {
-return fmi2Error;
+EsminiOsiSource* myc = (EsminiOsiSource*)c;
+return myc->FreeFMUstate(FMUstate);
 }
 
+/*
+ * Unsupported Features (FMUState Serialization, Derivatives, Async DoStep, Status Enquiries)
+ */
+
 FMI2_Export fmi2Status fmi2SerializedFMUstateSize(fmi2Component c, fmi2FMUstate FMUstate, size_t *size)
 {
 return fmi2Error;
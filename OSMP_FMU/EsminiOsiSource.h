@@ -107,6 +107,9 @@ public:
     fmi2Status SetInteger(const fmi2ValueReference vr[], size_t nvr, const fmi2Integer value[]);
     fmi2Status SetBoolean(const fmi2ValueReference vr[], size_t nvr, const fmi2Boolean value[]);
     fmi2Status SetString(const fmi2ValueReference vr[], size_t nvr, const fmi2String value[]);
+    fmi2Status GetFMUstate(fmi2FMUstate* FMUstate);
+    fmi2Status SetFMUstate(fmi2FMUstate FMUstate);
+    fmi2Status FreeFMUstate(fmi2FMUstate* FMUstate);
 
 protected:
     /* Internal Implementation */
@@ -220,4 +223,6 @@ protected:
     //bool get_fmi_traffic_command_update_in(osi3::TrafficCommandUpdate& data);     //TODO: Wait for OSI update
     void set_fmi_traffic_command_out(const osi3::TrafficCommand& data);
     void reset_fmi_traffic_command_out();
+    string get_fmi_out_bytes(int base_hi_idx, int base_lo_idx, int size_idx);
+    void set_fmi_out_bytes(const string& data, int base_hi_idx, int base_lo_idx, int size_idx);
 };
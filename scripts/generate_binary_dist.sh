@@ -163,6 +163,8 @@ bin/esmini?(.exe) \
 bin/odrviewer?(.exe) \
 bin/replayer?(.exe) \
 bin/dat2csv?(.exe) \
+bin/dat2collisions?(.exe) \
+bin/osi2csv?(.exe) \
 bin/odrplot?(.exe) \
 bin/*esminiLib.* \
 EnvironmentSimulator/Applications/odrplot/xodr.py \
@@ -103,6 +103,11 @@ if [[ "$OSTYPE" == "msys" ]] || [[ "$OSTYPE" == "linux-gnu"* ]]; then
         exit_with_msg "FollowRoute_test failed"
     fi
 
+    echo $'\n'RoadGenerator_test:
+    if ! ${EXE_FOLDER}/RoadGenerator_test; then
+        exit_with_msg "RoadGenerator_test failed"
+    fi
+
     echo $'\n'FollowRouteController_test:
     if ! ${EXE_FOLDER}/FollowRouteController_test; then
         exit_with_msg "FollowRouteController_test failed"
@@ -34,4 +34,8 @@ macro(set_definitions)
         add_definitions(-D_USE_IMPLOT)
     endif(USE_IMPLOT)
 
+    if(USE_PROFILER)
+        add_definitions(-D_USE_PROFILER)
+    endif(USE_PROFILER)
+
 endmacro()
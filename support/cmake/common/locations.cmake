@@ -32,6 +32,8 @@ macro(set_project_internal_paths)
         ${MODULES_PATH}/Controllers)
     set(PLAYER_BASE_PATH
         ${MODULES_PATH}/PlayerBase)
+    set(ROAD_GENERATOR_PATH
+        ${MODULES_PATH}/RoadGenerator)
     set(ROAD_MANAGER_PATH
         ${MODULES_PATH}/RoadManager)
     set(SCENARIO_ENGINE_PATH
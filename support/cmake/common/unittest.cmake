@@ -27,6 +27,7 @@ macro(
                 ${COMMON_MINI_PATH}
                 ${VIEWER_BASE_PATH}
                 ${PLAYER_BASE_PATH}
+                ${ROAD_GENERATOR_PATH}
                 ${CONTROLLERS_PATH}
                 ${REPLAYER_PATH})
 